@@ -0,0 +1,65 @@
+// Measures the write-ahead action log: tables on separate threads each append an action
+// and wait for it to be durable before the next, as a table does before acknowledging.
+// Compares one fsync per action (a single table) with group commit across many tables.
+//
+// Usage: ActionLogBench [directory] [actionsPerTable]
+
+#include "../include/ActionLog.h"
+#include <atomic>
+#include <chrono>
+#include <dirent.h>
+#include <unistd.h>
+
+using Clock = chrono::steady_clock;
+
+static void removeSegments(const string& directory) {
+    DIR* dir = opendir(directory.c_str());
+    if (dir == nullptr) return;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') unlink((directory + "/" + entry->d_name).c_str());
+    }
+    closedir(dir);
+}
+
+static void run(const string& directory, int numTables, int actionsPerTable, chrono::microseconds commitDelay) {
+    removeSegments(directory);
+    ActionLogOptions options;
+    options.directory = directory;
+    options.commitDelay = commitDelay;
+    ActionLog log(options);
+
+    Clock::time_point start = Clock::now();
+    vector<thread> tables;
+    for (int t = 0; t < numTables; ++t) {
+        tables.emplace_back([&log, t, actionsPerTable]() {
+            HandAction action;
+            action.type = CALL;
+            for (int i = 0; i < actionsPerTable; ++i) {
+                action.amount = i;
+                log.waitDurable(log.appendAction(t, 1, action));
+            }
+        });
+    }
+    for (thread& table : tables) table.join();
+    chrono::duration<double> elapsed = Clock::now() - start;
+
+    uint64_t numActions = log.getNumAppended();
+    cout << numTables << " tables, commit delay " << commitDelay.count() << "us: "
+         << numActions / elapsed.count() << " durable actions/s | "
+         << static_cast<double>(numActions) / log.getNumSyncs() << " actions per fsync | "
+         << elapsed.count() / actionsPerTable * 1e6 << "us per action per table" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    string directory = (argc > 1) ? argv[1] : "/tmp/action_log_bench";
+    int actionsPerTable = (argc > 2) ? atoi(argv[2]) : 500;
+
+    run(directory, 1, actionsPerTable, chrono::microseconds(0));
+    for (int numTables : {16, 64, 256}) {
+        run(directory, numTables, actionsPerTable / 4, chrono::microseconds(0));
+        run(directory, numTables, actionsPerTable / 4, chrono::microseconds(200));
+    }
+    removeSegments(directory);
+    rmdir(directory.c_str());
+    return 0;
+}
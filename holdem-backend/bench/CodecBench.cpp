@@ -0,0 +1,196 @@
+// Compares the binary wire codec with a naive JSON encoding built from
+// std::string concatenation and the toString() helpers.
+// Reports messages/sec and bytes/message for a typical six handed hand state.
+//
+// Usage: CodecBench [numIterations]
+
+#include "../include/WireCodec.h"
+#include <chrono>
+
+using Clock = chrono::steady_clock;
+
+typedef struct BenchState {
+    vector<shared_ptr<Player>> players;
+    Board board;
+    PotManager potManager;
+    StreetState streetState;
+    vector<PossibleAction> possibleActions;
+    ClientAction lastAction;
+} BenchState;
+
+static BenchState makeState() {
+    BenchState state;
+    const char* names[] = {"alice", "bob", "charlie", "dave", "erin", "frank"};
+    for (int i = 0; i < 6; ++i) {
+        auto player = make_shared<Player>(names[i], static_cast<Position>(i), 1000 + 250 * i);
+        player->addHoleCard(Card(static_cast<Suit>(i % 4), static_cast<Value>(2 + i)));
+        player->addHoleCard(Card(static_cast<Suit>((i + 1) % 4), static_cast<Value>(14 - i)));
+        state.players.push_back(player);
+        state.potManager.addPlayerBet(player, 100, false);
+    }
+    state.potManager.calculatePots();
+
+    state.board.addCommunityCard(Card(Suit::CLUBS, Value::TEN));
+    state.board.addCommunityCard(Card(Suit::DIAMONDS, Value::JACK));
+    state.board.addCommunityCard(Card(Suit::HEARTS, Value::QUEEN));
+    state.board.addCommunityCard(Card(Suit::SPADES, Value::NINE));
+
+    state.streetState.setStreet(Street::TURN);
+    state.streetState.setCurPlayer(state.players[2]);
+    state.streetState.setActiveBet(200);
+    state.streetState.setPlayerInitialChips(1500);
+    state.streetState.setBigStackAmongOthers(2250);
+    state.possibleActions = {{CALL, 200}, {RAISE, 400}, {FOLD, 0}};
+    state.lastAction = ClientAction{state.players[1], BET, 200};
+    return state;
+}
+
+// Naive encoders
+
+static string jsonSeats(uint32_t tableId, const vector<shared_ptr<Player>>& players) {
+    string json = "{\"type\":\"seats\",\"tableId\":" + to_string(tableId) + ",\"seats\":[";
+    for (size_t i = 0; i < players.size(); ++i) {
+        if (i > 0) json += ",";
+        json += "{\"position\":\"" + Player::positionToStr(players[i]->getPosition()) + "\",\"name\":\"" +
+                players[i]->getName() + "\",\"chips\":" + to_string(players[i]->getChips()) + "}";
+    }
+    return json + "]}";
+}
+
+static string jsonCards(const vector<Card>& cards) {
+    string json = "[";
+    for (size_t i = 0; i < cards.size(); ++i) {
+        if (i > 0) json += ",";
+        json += "\"" + cards[i].toString() + "\"";
+    }
+    return json + "]";
+}
+
+static string jsonHoleCards(uint32_t tableId, const Player& player) {
+    return "{\"type\":\"holeCards\",\"tableId\":" + to_string(tableId) + ",\"position\":\"" +
+           Player::positionToStr(player.getPosition()) + "\",\"cards\":" + jsonCards(player.getHand()) + "}";
+}
+
+static string jsonBoard(uint32_t tableId, const Board& board) {
+    return "{\"type\":\"board\",\"tableId\":" + to_string(tableId) + ",\"cards\":" +
+           jsonCards(board.getCommunityCards()) + "}";
+}
+
+static string jsonPots(uint32_t tableId, const PotManager& potManager) {
+    string json = "{\"type\":\"pots\",\"tableId\":" + to_string(tableId) + ",\"pots\":[";
+    for (int i = 0; i < potManager.getNumPots(); ++i) {
+        const Pot& pot = potManager.getPot(i);
+        if (i > 0) json += ",";
+        json += "{\"chips\":" + to_string(pot.getChips()) + ",\"eligible\":[";
+        for (size_t j = 0; j < pot.getEligiblePlayers().size(); ++j) {
+            if (j > 0) json += ",";
+            json += "\"" + pot.getEligiblePlayers()[j]->getName() + "\"";
+        }
+        json += "]}";
+    }
+    return json + "]}";
+}
+
+static string jsonActionRequest(uint32_t tableId, const StreetState& streetState,
+                                const vector<PossibleAction>& possibleActions) {
+    string json = "{\"type\":\"actionRequest\",\"tableId\":" + to_string(tableId) +
+                  ",\"street\":" + to_string(streetState.getStreet()) +
+                  ",\"player\":\"" + streetState.getCurPlayer()->getName() +
+                  "\",\"activeBet\":" + to_string(streetState.getActiveBet()) +
+                  ",\"initialChips\":" + to_string(streetState.getPlayerInitialChips()) +
+                  ",\"bigStackAmongOthers\":" + to_string(streetState.getBigStackAmongOthers()) +
+                  ",\"canRaise\":" + (streetState.getPlayerCanRaise() ? "true" : "false") + ",\"actions\":[";
+    for (size_t i = 0; i < possibleActions.size(); ++i) {
+        if (i > 0) json += ",";
+        json += "{\"type\":" + to_string(possibleActions[i].type) + ",\"amount\":" +
+                to_string(possibleActions[i].amount) + "}";
+    }
+    return json + "]}";
+}
+
+static string jsonActionResult(uint32_t tableId, const ClientAction& action) {
+    return "{\"type\":\"actionResult\",\"tableId\":" + to_string(tableId) + ",\"player\":\"" +
+           action.player->getName() + "\",\"action\":" + to_string(action.type) + ",\"amount\":" +
+           to_string(action.amount) + ",\"chips\":" + to_string(action.player->getChips()) + "}";
+}
+
+static void report(const string& name, size_t numMessages, size_t numBytes, chrono::duration<double> elapsed) {
+    cout << name << ": " << static_cast<size_t>(numMessages / elapsed.count()) << " msgs/s | "
+         << static_cast<double>(numBytes) / numMessages << " bytes/msg" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t numIterations = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 200000;
+    const size_t messagesPerIteration = 6;
+    BenchState state = makeState();
+    uint8_t buffer[FRAME_HEADER_SIZE + MAX_FRAME_PAYLOAD];
+
+    // Binary encode
+    size_t binaryBytes = 0;
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < numIterations; ++i) {
+        WireWriter writer(buffer, sizeof(buffer));
+        WireCodec::encodeSeats(writer, 1, state.players);
+        WireCodec::encodeHoleCards(writer, 1, *state.players[0]);
+        WireCodec::encodeBoard(writer, 1, state.board);
+        WireCodec::encodePots(writer, 1, state.potManager);
+        WireCodec::encodeActionRequest(writer, 1, state.streetState, state.possibleActions);
+        WireCodec::encodeActionResult(writer, 1, state.lastAction);
+        binaryBytes += writer.getSize();
+    }
+    report("Binary encode", numIterations * messagesPerIteration, binaryBytes, Clock::now() - start);
+
+    // Binary decode of the same frames
+    WireWriter writer(buffer, sizeof(buffer));
+    WireCodec::encodeSeats(writer, 1, state.players);
+    WireCodec::encodeHoleCards(writer, 1, *state.players[0]);
+    WireCodec::encodeBoard(writer, 1, state.board);
+    WireCodec::encodePots(writer, 1, state.potManager);
+    WireCodec::encodeActionRequest(writer, 1, state.streetState, state.possibleActions);
+    WireCodec::encodeActionResult(writer, 1, state.lastAction);
+
+    size_t numDecoded = 0;
+    SeatsMessage seats;
+    HoleCardsMessage holeCards;
+    BoardMessage board;
+    PotsMessage pots;
+    ActionRequestMessage request;
+    ActionResultMessage result;
+    start = Clock::now();
+    for (size_t i = 0; i < numIterations; ++i) {
+        size_t offset = 0;
+        FrameHeader header;
+        while (decodeFrameHeader(buffer + offset, writer.getSize() - offset, header)) {
+            const uint8_t* payload = buffer + offset + FRAME_HEADER_SIZE;
+            bool isDecoded = false;
+            switch (header.type) {
+                case MSG_SEATS: isDecoded = WireCodec::decodeSeats(payload, header.payloadSize, seats); break;
+                case MSG_HOLE_CARDS: isDecoded = WireCodec::decodeHoleCards(payload, header.payloadSize, holeCards); break;
+                case MSG_BOARD: isDecoded = WireCodec::decodeBoard(payload, header.payloadSize, board); break;
+                case MSG_POTS: isDecoded = WireCodec::decodePots(payload, header.payloadSize, pots); break;
+                case MSG_ACTION_REQUEST: isDecoded = WireCodec::decodeActionRequest(payload, header.payloadSize, request); break;
+                case MSG_ACTION_RESULT: isDecoded = WireCodec::decodeActionResult(payload, header.payloadSize, result); break;
+                default: break;
+            }
+            numDecoded += isDecoded;
+            offset += FRAME_HEADER_SIZE + header.payloadSize;
+        }
+    }
+    report("Binary decode", numDecoded, writer.getSize() * numIterations, Clock::now() - start);
+
+    // Naive JSON encode
+    size_t jsonBytes = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < numIterations; ++i) {
+        jsonBytes += jsonSeats(1, state.players).size();
+        jsonBytes += jsonHoleCards(1, *state.players[0]).size();
+        jsonBytes += jsonBoard(1, state.board).size();
+        jsonBytes += jsonPots(1, state.potManager).size();
+        jsonBytes += jsonActionRequest(1, state.streetState, state.possibleActions).size();
+        jsonBytes += jsonActionResult(1, state.lastAction).size();
+    }
+    report("JSON encode", numIterations * messagesPerIteration, jsonBytes, Clock::now() - start);
+
+    cout << "Size ratio (JSON / binary): " << static_cast<double>(jsonBytes) / binaryBytes << endl;
+    return (numDecoded == numIterations * messagesPerIteration) ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+// Measures exact heads-up equity: every preflop runout (1.7M boards) of a few matchups,
+// single threaded and split over threads, along with the raw HandRank evaluation rate.
+// Compares exact multiway enumeration with and without the suit reduction, then samples six
+// handed preflop equity with MonteCarloEquity to a fixed error target. Finally runs range
+// against range queries on each street and reports queries per minute, and times the outs of
+// six hands on a flop and turn and the hand strength percentile of every pair on a river.
+//
+// Usage: EquityBench [numThreads]
+
+#include "../include/HandStrength.h"
+#include "../include/Outs.h"
+#include "../include/RangeEquity.h"
+#include <chrono>
+#include <thread>
+
+using Clock = chrono::steady_clock;
+
+static void run(const string& name, const vector<Card>& first, const vector<Card>& second, int numThreads) {
+    Clock::time_point start = Clock::now();
+    EquityResult result = Equity::computeHeadsUp(first, second, {}, numThreads);
+    chrono::duration<double, milli> elapsed = Clock::now() - start;
+
+    cout << name << ", " << numThreads << " thread(s): " << elapsed.count() << "ms | "
+         << result.numBoards << " boards | win " << result.getWinFraction(0) << " tie " << result.getTieFraction(0)
+         << " loss " << result.getLossFraction(0) << " | " << 2 * result.numBoards / elapsed.count() / 1e3
+         << "M evals/s" << endl;
+}
+
+static void runExact(const string& name, const vector<uint64_t>& hands, int numThreads) {
+    Clock::time_point start = Clock::now();
+    EquityResult bruteForce = Equity::computeExact(hands, 0, numThreads, false);
+    chrono::duration<double, milli> bruteForceTime = Clock::now() - start;
+
+    start = Clock::now();
+    EquityResult reduced = Equity::computeExact(hands, 0, numThreads, true);
+    chrono::duration<double, milli> reducedTime = Clock::now() - start;
+
+    bool isSame = reduced.wins == bruteForce.wins && reduced.ties == bruteForce.ties;
+    cout << name << ", " << numThreads << " thread(s): brute force " << bruteForceTime.count() << "ms ("
+         << bruteForce.numRanked << " ranked) | suit reduced " << reducedTime.count() << "ms (" << reduced.numRanked
+         << " ranked) | " << bruteForceTime.count() / reducedTime.count() << "x | "
+         << (isSame ? "same tally" : "TALLY MISMATCH") << endl;
+}
+
+static void runMonteCarlo(const vector<uint64_t>& hands, double targetError, int numThreads) {
+    MonteCarloOptions options;
+    options.numThreads = numThreads;
+    options.targetError = targetError;
+    MonteCarloResult result = MonteCarloEquity::compute(hands, 0, options);
+
+    double seconds = result.elapsed.count() / 1e6;
+    cout << hands.size() << " hands, " << numThreads << " thread(s), error target " << targetError << ": "
+         << result.elapsed.count() / 1e3 << "ms | " << result.tally.numBoards << " samples | "
+         << result.tally.numBoards / seconds / 1e6 << "M samples/s | max standard error "
+         << result.getMaxStandardError() << endl;
+}
+
+static void runRanges(const string& name, const vector<HandRange>& ranges, uint64_t board, int numThreads) {
+    RangeEquityOptions options;
+    options.sampling.numThreads = numThreads;
+    options.sampling.targetError = 0.002;
+
+    const int numQueries = 5;
+    Clock::time_point start = Clock::now();
+    RangeEquityResult result;
+    for (int i = 0; i < numQueries; ++i) result = RangeEquity::compute(ranges, board, options);
+    chrono::duration<double, milli> elapsed = Clock::now() - start;
+
+    cout << name << ", " << numThreads << " thread(s): " << (result.isExact ? "exact" : "sampled") << " | "
+         << elapsed.count() / numQueries << "ms per query | " << 60000.0 * numQueries / elapsed.count()
+         << " queries/min | equity " << result.tally.getEquity(0) << endl;
+}
+
+static void runOuts(const string& name, const vector<uint64_t>& hands, uint64_t board) {
+    const int numQueries = 10000;
+    Clock::time_point start = Clock::now();
+    int numOuts = 0;
+    for (int i = 0; i < numQueries; ++i) {
+        OutsResult result = Outs::compute(hands, board);
+        numOuts += result.getNumOuts(i % result.numHands);
+    }
+    chrono::duration<double, micro> elapsed = Clock::now() - start;
+
+    cout << name << ": " << elapsed.count() / numQueries << "us per street | "
+         << static_cast<double>(numOuts) / numQueries << " outs per hand" << endl;
+}
+
+static void runHandStrength(const string& name, uint64_t board) {
+    const int numBoards = 1000;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < numBoards; ++i) HandStrength strength(board);
+    chrono::duration<double, micro> buildTime = Clock::now() - start;
+
+    // Every pair that can be dealt, as a table of players would query them
+    HandStrength strength(board);
+    int numQueries = 0;
+    double total = 0;
+    start = Clock::now();
+    for (int combo = 0; combo < NUM_COMBOS; ++combo) {
+        uint64_t hole = HandRange::getComboMask(combo);
+        if (hole & board) continue;
+        total += strength.getStrength(hole).getStrength();
+        numQueries++;
+    }
+    chrono::duration<double, micro> queryTime = Clock::now() - start;
+
+    cout << name << ": " << buildTime.count() / numBoards << "us to rank the board | "
+         << queryTime.count() / numQueries << "us per query | mean strength " << total / numQueries << endl;
+}
+
+int main(int argc, char* argv[]) {
+    int numThreads = (argc > 1) ? atoi(argv[1]) : static_cast<int>(thread::hardware_concurrency());
+
+    vector<Card> aces = {Card(Suit::HEARTS, Value::ACE), Card(Suit::SPADES, Value::ACE)};
+    vector<Card> kings = {Card(Suit::CLUBS, Value::KING), Card(Suit::DIAMONDS, Value::KING)};
+    vector<Card> suitedConnectors = {Card(Suit::HEARTS, Value::SEVEN), Card(Suit::HEARTS, Value::EIGHT)};
+    vector<Card> bigSlick = {Card(Suit::CLUBS, Value::ACE), Card(Suit::DIAMONDS, Value::KING)};
+
+    for (int threads : {1, max(1, numThreads)}) {
+        run("AA vs KK", aces, kings, threads);
+        run("87s vs AKo", suitedConnectors, bigSlick, threads);
+    }
+
+    auto mask = [](Suit suit, Value value) { return Card(suit, value).getBitMask(); };
+    vector<uint64_t> pairs = {
+        mask(Suit::HEARTS, Value::ACE) | mask(Suit::SPADES, Value::ACE),
+        mask(Suit::CLUBS, Value::KING) | mask(Suit::DIAMONDS, Value::KING),
+        mask(Suit::HEARTS, Value::QUEEN) | mask(Suit::SPADES, Value::QUEEN),
+        mask(Suit::CLUBS, Value::JACK) | mask(Suit::DIAMONDS, Value::JACK),
+        mask(Suit::HEARTS, Value::NINE) | mask(Suit::SPADES, Value::NINE),
+        mask(Suit::CLUBS, Value::EIGHT) | mask(Suit::DIAMONDS, Value::EIGHT)};
+    vector<uint64_t> clubs = {
+        mask(Suit::CLUBS, Value::ACE) | mask(Suit::CLUBS, Value::KING),
+        mask(Suit::CLUBS, Value::SEVEN) | mask(Suit::CLUBS, Value::SIX),
+        mask(Suit::CLUBS, Value::TWO) | mask(Suit::CLUBS, Value::THREE)};
+    vector<uint64_t> mixed = {
+        mask(Suit::HEARTS, Value::ACE) | mask(Suit::SPADES, Value::KING),
+        mask(Suit::CLUBS, Value::SEVEN) | mask(Suit::CLUBS, Value::SIX),
+        mask(Suit::DIAMONDS, Value::TEN) | mask(Suit::HEARTS, Value::TEN),
+        mask(Suit::SPADES, Value::FOUR) | mask(Suit::HEARTS, Value::FIVE)};
+    for (int threads : {1, max(1, numThreads)}) {
+        runExact("AA vs KK", {pairs[0], pairs[1]}, threads);
+        runExact("3 hands in one suit", clubs, threads);
+        runExact("4 hands, no swappable suits", mixed, threads);
+        runExact("6 pocket pairs", pairs, threads);
+    }
+
+    // AA, KK, AKo, 87s, 22 and one unknown hand
+    vector<uint64_t> hands = {HandRank::getMask(aces), HandRank::getMask(kings),
+                              HandRank::getMask({Card(Suit::CLUBS, Value::ACE), Card(Suit::SPADES, Value::KING)}),
+                              HandRank::getMask(suitedConnectors),
+                              HandRank::getMask({Card(Suit::SPADES, Value::TWO), Card(Suit::DIAMONDS, Value::TWO)}), 0};
+    for (int threads : {1, max(1, numThreads)}) {
+        runMonteCarlo(hands, 0.001, threads);
+    }
+
+    vector<HandRange> ranges = {HandRange::parse("QQ+, AKs, 50% AQo"), HandRange::parse("22+, A2s+, KTs+, QJs, ATo+, KJo+")};
+    uint64_t flop = Card(Suit::HEARTS, Value::QUEEN).getBitMask() | Card(Suit::DIAMONDS, Value::SEVEN).getBitMask() |
+                    Card(Suit::HEARTS, Value::TWO).getBitMask();
+    uint64_t turn = flop | Card(Suit::SPADES, Value::KING).getBitMask();
+    uint64_t river = turn | Card(Suit::CLUBS, Value::THREE).getBitMask();
+    for (int threads : {1, max(1, numThreads)}) {
+        runRanges("Ranges preflop", ranges, 0, threads);
+        runRanges("Ranges on the flop", ranges, flop, threads);
+        runRanges("Ranges on the turn", ranges, turn, threads);
+        runRanges("Ranges on the river", ranges, river, threads);
+    }
+
+    uint64_t board = mask(Suit::HEARTS, Value::TEN) | mask(Suit::CLUBS, Value::FOUR) | mask(Suit::SPADES, Value::KING);
+    runOuts("Outs of 6 pocket pairs on the flop", pairs, board);
+    runOuts("Outs of 6 pocket pairs on the turn", pairs, board | mask(Suit::CLUBS, Value::TWO));
+    runHandStrength("Hand strength on the river", river);
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Measures the hand archive: bytes per hand against a naive fixed width encoding and
+// the hand history log codec, encode and decode throughput, and single hand lookups.
+// Hands are real six handed records played once through GameController and re-stamped.
+//
+// Usage: HandArchiveBench [numHands] [handsPerBlock]
+
+#include "../include/HandArchive.h"
+#include "../include/GameController.h"
+#include <chrono>
+#include <random>
+
+using Clock = chrono::steady_clock;
+
+const int NUM_TEMPLATE_HANDS = 64;
+
+// Plays hands where everyone calls or checks down, with the odd raise
+static vector<HandRecord> playTemplateHands() {
+    GameController game(5, 10);
+    const char* names[] = {"alice", "bob", "charlie", "dave", "erin", "frank"};
+    for (const char* name : names) game.addPlayerToGame(name, 100000);
+
+    vector<HandRecord> hands;
+    size_t step = 0;
+    for (int i = 0; i < NUM_TEMPLATE_HANDS; ++i) {
+        game.beginRound();
+        while (game.isAwaitingAction()) {
+            ClientAction action = ClientAction{game.getStreetState().getCurPlayer(), CHECK, 0};
+            for (const auto& possible : game.getPossibleActions()) {
+                if (possible.type == CALL) action.type = CALL;
+            }
+            ClientAction raise = ClientAction{action.player, RAISE, 0};
+            for (const auto& possible : game.getPossibleActions()) raise.amount = possible.amount * 3;
+            if (++step % 9 != 0 || !game.processClientAction(raise)) game.processClientAction(action);
+        }
+        hands.push_back(game.getHandRecord());
+        game.setupNewRound();
+    }
+    return hands;
+}
+
+// Every number as its own 8 byte field (4 for enums and cards), names padded to 32 bytes
+static size_t getNaiveSize(const HandRecord& hand) {
+    const size_t seatSize = 8 + MAX_PLAYER_NAME + 8 + 2 * 4;
+    const size_t actionSize = 3 * 4 + 8;
+    size_t size = 5 * 8;
+    size += 8 + hand.seats.size() * seatSize;
+    size += 8 + hand.actions.size() * actionSize;
+    size += 8 + 5 * 4;
+    size += 8 + hand.pots.size() * 16;
+    size += 8 + hand.results.size() * 16;
+    return size;
+}
+
+int main(int argc, char* argv[]) {
+    size_t numHands = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 200000;
+    size_t handsPerBlock = (argc > 2) ? strtoul(argv[2], nullptr, 10) : DEFAULT_HANDS_PER_BLOCK;
+
+    cout.setstate(ios_base::badbit);
+    vector<HandRecord> templates = playTemplateHands();
+    cout.clear();
+
+    vector<HandRecord> hands(numHands);
+    for (size_t i = 0; i < numHands; ++i) {
+        hands[i] = templates[i % templates.size()];
+        hands[i].tableId = static_cast<uint32_t>(i % 8);
+        hands[i].handNumber = i / 8 + 1;
+        hands[i].startTime = 1700000000000 + i * 5000;
+    }
+
+    size_t naiveBytes = 0, logBytes = 0;
+    uint8_t buffer[MAX_HAND_RECORD_SIZE];
+    for (const HandRecord& hand : hands) {
+        WireWriter writer(buffer, sizeof(buffer));
+        HandRecordCodec::encode(hand, writer);
+        logBytes += writer.getSize();
+        naiveBytes += getNaiveSize(hand);
+    }
+
+    Clock::time_point start = Clock::now();
+    HandArchiveWriter writer(handsPerBlock);
+    for (const HandRecord& hand : hands) writer.add(hand);
+    vector<uint8_t> archive = writer.finish();
+    chrono::duration<double> encodeElapsed = Clock::now() - start;
+
+    HandArchiveReader reader(archive.data(), archive.size());
+    vector<HandRecord> decoded;
+    decoded.reserve(handsPerBlock);
+    uint64_t checksum = 0;
+    size_t numMismatched = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < reader.getNumBlocks(); ++i) {
+        decoded.clear();
+        reader.getBlock(i, decoded);
+        checksum += decoded.size();
+    }
+    chrono::duration<double> decodeElapsed = Clock::now() - start;
+
+    // Lookups decode a block header and one hand
+    const size_t numLookups = 100000;
+    mt19937 rng(7);
+    HandRecord hand;
+    start = Clock::now();
+    for (size_t i = 0; i < numLookups; ++i) {
+        size_t index = rng() % numHands;
+        if (!reader.getHand(index, hand) || !(hand == hands[index])) numMismatched++;
+    }
+    chrono::duration<double> lookupElapsed = Clock::now() - start;
+
+    double archiveBytes = archive.size() / static_cast<double>(numHands);
+    cout << "Hands: " << numHands << " | Hands per block: " << handsPerBlock << " | Blocks: "
+         << reader.getNumBlocks() << endl;
+    cout << "bytes/hand: naive " << naiveBytes / numHands << " | log codec " << logBytes / numHands
+         << " | archive " << archiveBytes << endl;
+    cout << "ratio: " << naiveBytes / static_cast<double>(archive.size()) << "x vs naive | "
+         << logBytes / static_cast<double>(archive.size()) << "x vs log codec" << endl;
+    cout << "encode: " << numHands / encodeElapsed.count() << " hands/s | decode: "
+         << checksum / decodeElapsed.count() << " hands/s | random lookup: "
+         << numLookups / lookupElapsed.count() << " hands/s (" << numMismatched << " mismatched)" << endl;
+    return 0;
+}
@@ -0,0 +1,124 @@
+// Measures the hand history log: the cost of append() on the table threads, how fast the
+// writer thread drains to disk, and how fast the mmap reader scans and decodes segments.
+// Hands are real six handed records played once through GameController and re-stamped.
+//
+// Usage: HandHistoryBench [numHands] [numTableThreads] [fsyncIntervalMs] [directory]
+
+#include "../include/HandHistoryLog.h"
+#include "../include/GameController.h"
+#include <thread>
+#include <unistd.h>
+
+using Clock = chrono::steady_clock;
+
+const int NUM_TEMPLATE_HANDS = 64;
+
+// Plays hands where everyone calls or checks down, returning their records
+static vector<HandRecord> playTemplateHands() {
+    GameController game(1, 2);
+    const char* names[] = {"alice", "bob", "charlie", "dave", "erin", "frank"};
+    for (const char* name : names) game.addPlayerToGame(name, 100000);
+
+    vector<HandRecord> hands;
+    for (int i = 0; i < NUM_TEMPLATE_HANDS; ++i) {
+        game.beginRound();
+        while (game.isAwaitingAction()) {
+            ClientAction action = ClientAction{game.getStreetState().getCurPlayer(), CHECK, 0};
+            for (const auto& possible : game.getPossibleActions()) {
+                if (possible.type == CALL) action.type = CALL;
+            }
+            game.processClientAction(action);
+        }
+        hands.push_back(game.getHandRecord());
+        game.setupNewRound();
+    }
+    return hands;
+}
+
+int main(int argc, char* argv[]) {
+    size_t numHands = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t numTables = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 4;
+    long fsyncIntervalMs = (argc > 3) ? strtol(argv[3], nullptr, 10) : 100;
+    string parent = (argc > 4) ? argv[4] : "/tmp";
+
+    cout.setstate(ios_base::badbit);
+    vector<HandRecord> hands = playTemplateHands();
+    cout.clear();
+
+    string directory = parent + "/handhistorybenchXXXXXX";
+    if (mkdtemp(&directory[0]) == nullptr) {
+        cerr << "Failed to create a directory under " << parent << endl;
+        return 1;
+    }
+
+    HandHistoryOptions options;
+    options.directory = directory;
+    options.fsyncInterval = chrono::milliseconds(fsyncIntervalMs);
+
+    cout << "Hands: " << numHands << " | Table threads: " << numTables << " | fsync every "
+         << fsyncIntervalMs << " ms | " << directory << endl;
+
+    // Table threads only pay for encoding and queueing
+    Clock::time_point start = Clock::now();
+    double appendNs = 0;
+    uint32_t numSegments;
+    {
+        HandHistoryWriter writer(options);
+        vector<thread> tables;
+        vector<double> tableNs(numTables);
+        for (size_t t = 0; t < numTables; ++t) {
+            tables.emplace_back([&, t]() {
+                size_t count = numHands / numTables;
+                Clock::time_point tableStart = Clock::now();
+                for (size_t i = 0; i < count; ++i) {
+                    HandRecord& record = hands[i % hands.size()];
+                    writer.append(record);
+                }
+                chrono::duration<double, nano> elapsed = Clock::now() - tableStart;
+                tableNs[t] = elapsed.count() / max<size_t>(count, 1);
+            });
+        }
+        for (auto& table : tables) table.join();
+        for (double ns : tableNs) appendNs += ns / numTables;
+
+        writer.close();
+        numSegments = writer.getSegmentIndex();
+    }
+    chrono::duration<double> writeElapsed = Clock::now() - start;
+
+    // Scan in place, then decode everything
+    size_t numRecords = 0, numBytes = 0;
+    uint64_t checksum = 0;
+    start = Clock::now();
+    for (const string& path : HandHistoryReader::listSegments(directory)) {
+        HandHistoryReader reader(path);
+        HandRecordView view;
+        while (reader.next(view)) {
+            checksum += view.getTableId() + view.getHandNumber();
+            numRecords++;
+            numBytes += view.size;
+        }
+    }
+    chrono::duration<double> scanElapsed = Clock::now() - start;
+
+    HandRecord record;
+    start = Clock::now();
+    for (const string& path : HandHistoryReader::listSegments(directory)) {
+        HandHistoryReader reader(path);
+        HandRecordView view;
+        while (reader.next(view)) checksum += view.decode(record) ? record.actions.size() : 0;
+    }
+    chrono::duration<double> decodeElapsed = Clock::now() - start;
+
+    for (const string& path : HandHistoryReader::listSegments(directory)) unlink(path.c_str());
+    rmdir(directory.c_str());
+
+    double handsPerHour = numRecords / writeElapsed.count() * 3600.0;
+    cout << "append (table thread): " << appendNs << " ns/hand" << endl;
+    cout << "write: " << numRecords / writeElapsed.count() << " hands/s (" << handsPerHour / 1e6
+         << "M hands/hour) | " << numBytes / max<size_t>(numRecords, 1) << " bytes/hand | "
+         << numSegments << " segments" << endl;
+    cout << "mmap scan: " << numRecords / scanElapsed.count() << " hands/s | decode: "
+         << numRecords / decodeElapsed.count() << " hands/s (checksum " << checksum << ")" << endl;
+    return 0;
+}
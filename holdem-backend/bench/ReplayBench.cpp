@@ -0,0 +1,87 @@
+// Measures the replay engine on logged six handed sessions: hands per minute re-driven
+// through GameController in full and fast-forward mode, and checks every replay ends
+// with the chips the session was played to.
+//
+// Usage: ReplayBench [numSessions] [handsPerSession]
+
+#include "../include/HandReplay.h"
+#include <chrono>
+
+using Clock = chrono::steady_clock;
+
+// Plays a seeded session where everyone calls or checks down, with the odd raise and fold
+static ReplayLog playSession(uint64_t seed, int numHands, vector<size_t>& finalChips) {
+    ReplayLog log;
+    log.seed = seed;
+    log.smallBlind = 5;
+    log.bigBlind = 10;
+    log.players = {{"alice", 100000}, {"bob", 100000}, {"charlie", 100000},
+                   {"dave", 100000}, {"erin", 100000}, {"frank", 100000}};
+
+    GameController game(log.smallBlind, log.bigBlind);
+    game.setDeckSeed(seed);
+    for (const auto& [name, chips] : log.players) game.addPlayerToGame(name, chips);
+
+    size_t step = 0;
+    for (int i = 0; i < numHands; ++i) {
+        game.beginRound();
+        while (game.isAwaitingAction()) {
+            ClientAction action = ClientAction{game.getStreetState().getCurPlayer(), CHECK, 0};
+            for (const auto& possible : game.getPossibleActions()) {
+                if (possible.type == CALL) action.type = CALL;
+            }
+            ClientAction raise = ClientAction{action.player, RAISE, 0};
+            for (const auto& possible : game.getPossibleActions()) raise.amount = possible.amount * 3;
+            ClientAction fold = ClientAction{action.player, FOLD, 0};
+
+            step++;
+            bool isRaised = step % 9 == 0 && game.processClientAction(raise);
+            bool isFolded = !isRaised && action.type == CALL && step % 4 == 0 && game.processClientAction(fold);
+            if (!isRaised && !isFolded) game.processClientAction(action);
+        }
+        ReplayEngine::appendHand(game.getHandRecord(), log);
+        game.setupNewRound();
+    }
+
+    finalChips.clear();
+    for (const auto& [name, chips] : log.players) {
+        for (const auto& player : game.getGamePlayers()) {
+            if (player->getName() == name) finalChips.push_back(player->getChips());
+        }
+    }
+    return log;
+}
+
+int main(int argc, char* argv[]) {
+    size_t numSessions = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 200;
+    int handsPerSession = (argc > 2) ? atoi(argv[2]) : 100;
+
+    cout.setstate(ios_base::badbit);
+    vector<ReplayLog> logs;
+    vector<vector<size_t>> expectedChips(numSessions);
+    size_t numActions = 0;
+    for (size_t i = 0; i < numSessions; ++i) {
+        logs.push_back(playSession(i + 1, handsPerSession, expectedChips[i]));
+        numActions += logs.back().actions.size();
+    }
+    cout.clear();
+
+    cout << "Sessions: " << numSessions << " | Hands: " << numSessions * handsPerSession
+         << " | Logged decisions: " << numActions << endl;
+
+    for (ReplayMode mode : {REPLAY_FULL, REPLAY_FAST_FORWARD}) {
+        size_t numHands = 0, numMismatched = 0;
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < numSessions; ++i) {
+            ReplayResult result = ReplayEngine::replay(logs[i], mode);
+            numHands += result.numHands;
+            if (result.isDiverged || result.finalChips != expectedChips[i]) numMismatched++;
+        }
+        chrono::duration<double> elapsed = Clock::now() - start;
+
+        cout << (mode == REPLAY_FULL ? "full:         " : "fast-forward: ") << numHands / elapsed.count()
+             << " hands/s (" << numHands / elapsed.count() * 60 / 1e6 << "M hands/min) | "
+             << numMismatched << " sessions mismatched" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+// Measures action-to-broadcast latency of the epoll game server on loopback.
+// Every table seats two non-blocking clients that call/check every decision.
+// Latency is the time from an action being sent to its ACTION_RESULT arriving.
+//
+// Usage: ServerLatencyBench [numConnections] [numRounds] [numWorkers]
+
+#include "../include/GameServer.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using Clock = chrono::steady_clock;
+
+typedef struct BenchClient {
+    int fd = -1;
+    uint32_t tableId = 0;
+    int position = -1;
+    int roundsPlayed = 0;
+    vector<uint8_t> readBuffer;
+    Clock::time_point sentAt;
+    bool isAwaitingResult = false;
+} BenchClient;
+
+static void sendFrame(BenchClient& client, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t numWritten = send(client.fd, data, size, MSG_NOSIGNAL);
+        if (numWritten <= 0) continue;
+        data += numWritten;
+        size -= numWritten;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t numConnections = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 4000;
+    int numRounds = (argc > 2) ? atoi(argv[2]) : 3;
+    size_t numWorkers = (argc > 3) ? strtoul(argv[3], nullptr, 10) : thread::hardware_concurrency();
+    size_t numTables = numConnections / 2;
+
+    cout << "Connections: " << numConnections << " | Tables: " << numTables
+         << " | Rounds per table: " << numRounds << " | Workers: " << numWorkers << endl;
+    cout.setstate(ios_base::badbit);
+
+    GameServer server(0, numTables, numWorkers, 1, 2);
+    thread serverThread([&server]() { server.run(); });
+
+    int epollFd = epoll_create1(0);
+    vector<BenchClient> clients(numConnections);
+    uint8_t buffer[FRAME_HEADER_SIZE + MAX_FRAME_PAYLOAD];
+
+    for (size_t i = 0; i < numConnections; ++i) {
+        BenchClient& client = clients[i];
+        client.fd = socket(AF_INET, SOCK_STREAM, 0);
+        int enable = 1;
+        setsockopt(client.fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(server.getPort());
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        if (connect(client.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            cerr << "Failed to connect client " << i << endl;
+            return 1;
+        }
+
+        client.tableId = static_cast<uint32_t>(i / 2);
+        string name = "p" + to_string(i % 2);
+        WireWriter writer(buffer, sizeof(buffer));
+        size_t frame = beginFrame(writer, MSG_JOIN_TABLE);
+        writer.putU32(client.tableId);
+        writer.putU32(100000);
+        writer.putU8(static_cast<uint8_t>(name.size()));
+        writer.putBytes(name.data(), name.size());
+        endFrame(writer, frame);
+        sendFrame(client, buffer, writer.getSize());
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = i;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &event);
+    }
+
+    vector<double> latenciesUs;
+    size_t numFinished = 0;
+    epoll_event events[256];
+    Clock::time_point start = Clock::now();
+
+    while (numFinished < numConnections) {
+        int numEvents = epoll_wait(epollFd, events, 256, 5000);
+        if (numEvents <= 0) {
+            cerr << "Timed out waiting for the server!" << endl;
+            break;
+        }
+
+        for (int e = 0; e < numEvents; ++e) {
+            BenchClient& client = clients[events[e].data.u64];
+            uint8_t chunk[16384];
+            ssize_t numRead = recv(client.fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+            if (numRead <= 0) continue;
+            client.readBuffer.insert(client.readBuffer.end(), chunk, chunk + numRead);
+
+            size_t offset = 0;
+            FrameHeader header;
+            while (decodeFrameHeader(client.readBuffer.data() + offset, client.readBuffer.size() - offset, header)) {
+                if (client.readBuffer.size() - offset < FRAME_HEADER_SIZE + header.payloadSize) break;
+
+                uint8_t type = header.type;
+                const uint8_t* payload = client.readBuffer.data() + offset + FRAME_HEADER_SIZE;
+                offset += FRAME_HEADER_SIZE + header.payloadSize;
+
+                if (type == MSG_HAND_STARTED) {
+                    client.position = payload[4];
+                } else if (type == MSG_ACTION_RESULT && client.isAwaitingResult) {
+                    chrono::duration<double, micro> elapsed = Clock::now() - client.sentAt;
+                    latenciesUs.push_back(elapsed.count());
+                    client.isAwaitingResult = false;
+                } else if (type == MSG_ROUND_COMPLETE) {
+                    if (++client.roundsPlayed == numRounds) numFinished++;
+                } else if (type == MSG_ACTION_REQUEST && client.roundsPlayed < numRounds) {
+                    ActionRequestMessage request;
+                    WireCodec::decodeActionRequest(payload, header.payloadSize, request);
+                    if (request.position != client.position) continue;
+
+                    ActionType choice = CHECK;
+                    for (uint8_t i = 0; i < request.numActions; ++i) {
+                        if (request.actions[i].type == CALL) choice = CALL;
+                    }
+
+                    WireWriter writer(buffer, sizeof(buffer));
+                    size_t frame = beginFrame(writer, MSG_PLAYER_ACTION);
+                    writer.putU32(client.tableId);
+                    writer.putU8(choice);
+                    writer.putU32(0);
+                    endFrame(writer, frame);
+
+                    client.sentAt = Clock::now();
+                    client.isAwaitingResult = true;
+                    sendFrame(client, buffer, writer.getSize());
+                }
+            }
+            client.readBuffer.erase(client.readBuffer.begin(), client.readBuffer.begin() + offset);
+        }
+    }
+    chrono::duration<double> elapsed = Clock::now() - start;
+
+    server.stop();
+    serverThread.join();
+    for (auto& client : clients) close(client.fd);
+    close(epollFd);
+
+    cout.clear();
+    if (latenciesUs.empty()) {
+        cout << "No actions completed!" << endl;
+        return 1;
+    }
+    sort(latenciesUs.begin(), latenciesUs.end());
+    auto percentile = [&latenciesUs](double p) {
+        return latenciesUs[min(latenciesUs.size() - 1, static_cast<size_t>(p * latenciesUs.size()))];
+    };
+
+    cout << "Actions: " << latenciesUs.size() << " in " << elapsed.count() << " s ("
+         << latenciesUs.size() / elapsed.count() << " actions/s)" << endl;
+    cout << "Action-to-broadcast latency (us): p50 " << percentile(0.50)
+         << " | p99 " << percentile(0.99) << " | max " << latenciesUs.back() << endl;
+    return 0;
+}
@@ -0,0 +1,149 @@
+// Load test for spectator fan-out: one featured table watched by many local spectators.
+// The table runs on its own thread with two call/check bots and publishes each public frame
+// once into its broadcast ring. Spectator threads sweep every cursor and rebuild the table
+// state from keyframes and deltas; a fraction of spectators are slow and only read every
+// SLOW_INTERVAL sweeps, so they fall behind the ring and get skipped to a keyframe.
+//
+// Usage: SpectatorLoadBench [numSpectators] [numActions] [actionIntervalUs] [numReaderThreads]
+
+#include "../include/GameTable.h"
+#include <chrono>
+#include <thread>
+
+using Clock = chrono::steady_clock;
+
+const size_t SLOW_SPECTATOR_EVERY = 10;
+const size_t SLOW_INTERVAL = 200;
+
+// Seated bots don't need their frames, spectators read the ring directly
+class NullOutput : public TableOutput {
+public:
+    void sendToClient(uint64_t clientId, const uint8_t* data, size_t size) override {}
+};
+
+typedef struct Spectator {
+    BroadcastCursor cursor;
+    TableState state;
+    bool isInSync = true;
+    uint64_t numFrames = 0;
+} Spectator;
+
+// Applies a frame to a spectator's state, as a client would
+static void applyFrame(Spectator& spectator, const BroadcastFrame& frame) {
+    FrameHeader header;
+    if (!decodeFrameHeader(frame.data.data(), frame.data.size(), header)) return;
+    const uint8_t* payload = frame.data.data() + FRAME_HEADER_SIZE;
+
+    spectator.numFrames++;
+    if (header.type == MSG_STATE_KEYFRAME) {
+        spectator.isInSync = spectator.state.decodeKeyframe(payload, header.payloadSize);
+    } else if (header.type == MSG_STATE_DELTA && spectator.isInSync) {
+        spectator.isInSync = spectator.state.applyDelta(payload, header.payloadSize);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t numSpectators = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 10000;
+    size_t numActions = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 2000;
+    size_t actionIntervalUs = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 1000;
+    size_t numReaders = (argc > 4) ? strtoul(argv[4], nullptr, 10) : max(1u, thread::hardware_concurrency());
+
+    cout << "Spectators: " << numSpectators << " | Actions: " << numActions << " every "
+         << actionIntervalUs << " us | Reader threads: " << numReaders << endl;
+    cout.setstate(ios_base::badbit);
+
+    NullOutput output;
+    GameTable table(0, 1, 2, output);
+    BroadcastRing& ring = table.getSpectatorRing();
+    vector<Spectator> spectators(numSpectators);
+    atomic<bool> isTableDone(false);
+
+    // Table thread: the latency of each command is what the players feel
+    vector<double> commandLatenciesUs;
+    thread tableThread([&]() {
+        for (uint64_t clientId = 1; clientId <= 2; ++clientId) {
+            TableCommand join;
+            join.type = JOIN_TABLE;
+            join.clientId = clientId;
+            join.amount = 1000000;
+            join.playerName = "bot" + to_string(clientId);
+            table.handleCommand(join);
+        }
+
+        for (size_t i = 0; i < numActions; ++i) {
+            const GameController& game = table.getGame();
+            if (!game.isAwaitingAction()) break;
+
+            TableCommand command;
+            command.type = PLAYER_ACTION;
+            command.clientId = (game.getStreetState().getCurPlayer()->getName() == "bot1") ? 1 : 2;
+            command.action = CHECK;
+            for (const auto& action : game.getPossibleActions()) {
+                if (action.type == CALL) command.action = CALL;
+            }
+
+            Clock::time_point start = Clock::now();
+            table.handleCommand(command);
+            chrono::duration<double, micro> elapsed = Clock::now() - start;
+            commandLatenciesUs.push_back(elapsed.count());
+            this_thread::sleep_for(chrono::microseconds(actionIntervalUs));
+        }
+        isTableDone = true;
+    });
+
+    // Spectator threads: each sweeps its own slice of cursors until the table is done and drained
+    vector<thread> readers;
+    Clock::time_point start = Clock::now();
+    for (size_t r = 0; r < numReaders; ++r) {
+        readers.emplace_back([&, r]() {
+            size_t begin = numSpectators * r / numReaders;
+            size_t end = numSpectators * (r + 1) / numReaders;
+
+            for (size_t sweep = 0; ; ++sweep) {
+                bool isFinalSweep = isTableDone;
+                for (size_t i = begin; i < end; ++i) {
+                    bool isSlow = (i % SLOW_SPECTATOR_EVERY == SLOW_SPECTATOR_EVERY - 1);
+                    if (isSlow && !isFinalSweep && sweep % SLOW_INTERVAL != 0) continue;
+
+                    Spectator& spectator = spectators[i];
+                    while (auto frame = ring.next(spectator.cursor)) applyFrame(spectator, *frame);
+                }
+                if (isFinalSweep) break;
+                this_thread::yield();
+            }
+        });
+    }
+
+    tableThread.join();
+    for (auto& reader : readers) reader.join();
+    chrono::duration<double> elapsed = Clock::now() - start;
+    cout.clear();
+
+    // Everyone must end up with the table's final state
+    size_t numInSync = 0;
+    uint64_t numDelivered = 0;
+    uint64_t numSlowSkips = 0;
+    uint64_t numFastSkips = 0;
+    for (size_t i = 0; i < numSpectators; ++i) {
+        const Spectator& spectator = spectators[i];
+        numInSync += spectator.isInSync && spectator.state.sequence == spectators[0].state.sequence &&
+                     spectator.state.isSameState(spectators[0].state);
+        numDelivered += spectator.numFrames;
+        bool isSlow = (i % SLOW_SPECTATOR_EVERY == SLOW_SPECTATOR_EVERY - 1);
+        (isSlow ? numSlowSkips : numFastSkips) += spectator.cursor.numSkips;
+    }
+
+    sort(commandLatenciesUs.begin(), commandLatenciesUs.end());
+    auto percentile = [&commandLatenciesUs](double p) {
+        if (commandLatenciesUs.empty()) return 0.0;
+        return commandLatenciesUs[min(commandLatenciesUs.size() - 1, static_cast<size_t>(p * commandLatenciesUs.size()))];
+    };
+
+    cout << "Frames published: " << ring.getNumPublished() << " | Frames delivered: " << numDelivered
+         << " (" << numDelivered / elapsed.count() << " frames/s)" << endl;
+    cout << "Table command latency (us): p50 " << percentile(0.50) << " | p99 " << percentile(0.99)
+         << " | max " << (commandLatenciesUs.empty() ? 0.0 : commandLatenciesUs.back()) << endl;
+    cout << "Skips to keyframe: slow spectators " << numSlowSkips << " | others " << numFastSkips << endl;
+    cout << "Spectators in sync with the table: " << numInSync << " / " << numSpectators << endl;
+    return (numInSync == numSpectators) ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+// Measures table snapshots taken at every decision of six handed games:
+// nanoseconds per save and per restore, and the snapshot size.
+//
+// Usage: TableSnapshotBench [numHands]
+
+#include "../include/TableSnapshot.h"
+#include <algorithm>
+#include <chrono>
+
+using Clock = chrono::steady_clock;
+
+// Collects a snapshot at every decision of a seeded six handed session
+static vector<vector<uint8_t>> playSession(uint64_t seed, int numHands) {
+    GameController game(5, 10);
+    game.setDeckSeed(seed);
+    for (const string& name : {"alice", "bob", "charlie", "dave", "erin", "frank"}) {
+        game.addPlayerToGame(name, 100000);
+    }
+
+    vector<vector<uint8_t>> snapshots;
+    vector<uint8_t> buffer(MAX_TABLE_SNAPSHOT_SIZE);
+    size_t step = 0;
+    for (int i = 0; i < numHands; ++i) {
+        game.beginRound();
+        while (game.isAwaitingAction()) {
+            size_t size = TableSnapshot::save(game, buffer.data(), buffer.size());
+            snapshots.emplace_back(buffer.begin(), buffer.begin() + size);
+
+            ClientAction action = ClientAction{game.getStreetState().getCurPlayer(), CHECK, 0};
+            for (const auto& possible : game.getPossibleActions()) {
+                if (possible.type == CALL) action.type = CALL;
+            }
+            ClientAction raise = ClientAction{action.player, RAISE, 0};
+            for (const auto& possible : game.getPossibleActions()) raise.amount = possible.amount * 3;
+
+            step++;
+            if (step % 9 != 0 || !game.processClientAction(raise)) game.processClientAction(action);
+        }
+        game.setupNewRound();
+    }
+    return snapshots;
+}
+
+int main(int argc, char* argv[]) {
+    int numHands = (argc > 1) ? atoi(argv[1]) : 2000;
+
+    cout.setstate(ios_base::badbit);
+    vector<vector<uint8_t>> snapshots = playSession(1, numHands);
+    cout.clear();
+
+    size_t maxSize = 0, totalSize = 0;
+    for (const auto& snapshot : snapshots) {
+        maxSize = max(maxSize, snapshot.size());
+        totalSize += snapshot.size();
+    }
+    cout << "Snapshots: " << snapshots.size() << " | Avg size: " << totalSize / snapshots.size()
+         << " bytes | Max size: " << maxSize << " bytes" << endl;
+
+    // Restore every snapshot, then save it again from the restored game
+    vector<unique_ptr<GameController>> games;
+    for (size_t i = 0; i < snapshots.size(); ++i) games.push_back(make_unique<GameController>(5, 10));
+
+    size_t numFailed = 0;
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < snapshots.size(); ++i) {
+        if (!TableSnapshot::restore(*games[i], snapshots[i].data(), snapshots[i].size())) numFailed++;
+    }
+    chrono::duration<double, nano> restoreTime = Clock::now() - start;
+
+    vector<uint8_t> buffer(MAX_TABLE_SNAPSHOT_SIZE);
+    size_t numMismatched = 0;
+    chrono::duration<double, nano> saveTime(0);
+    for (size_t i = 0; i < snapshots.size(); ++i) {
+        start = Clock::now();
+        size_t size = TableSnapshot::save(*games[i], buffer.data(), buffer.size());
+        saveTime += Clock::now() - start;
+        if (!equal(buffer.begin(), buffer.begin() + size, snapshots[i].begin(), snapshots[i].end())) numMismatched++;
+    }
+
+    cout << "save:    " << saveTime.count() / snapshots.size() << " ns" << endl;
+    cout << "restore: " << restoreTime.count() / snapshots.size() << " ns" << endl;
+    cout << numFailed << " restores failed | " << numMismatched << " snapshots changed by a round trip" << endl;
+    return 0;
+}
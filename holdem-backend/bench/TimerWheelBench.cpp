@@ -0,0 +1,67 @@
+// Measures the timer wheel under a shot clock workload: every decision arms a clock,
+// most are cancelled when the player acts and the rest expire.
+// Reports ns per schedule, cancel and expiry, and the cost of a tick with nothing due.
+//
+// Usage: TimerWheelBench [numTimers]
+
+#include "../include/TimerWheel.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using Clock = chrono::steady_clock;
+
+// Shot clock plus time bank, in 10ms ticks
+const uint64_t MAX_BENCH_DELAY = 4500;
+const size_t CANCEL_EVERY = 4;
+
+static double nsPer(Clock::time_point start, size_t count) {
+    chrono::duration<double, nano> elapsed = Clock::now() - start;
+    return count ? elapsed.count() / count : 0.0;
+}
+
+int main(int argc, char* argv[]) {
+    size_t numTimers = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 1000000;
+
+    mt19937_64 rng(7);
+    vector<uint64_t> delays(numTimers);
+    for (auto& delay : delays) delay = 1 + rng() % MAX_BENCH_DELAY;
+
+    TimerWheel wheel;
+    vector<TimerId> ids(numTimers);
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < numTimers; ++i) ids[i] = wheel.schedule(delays[i], i);
+    double scheduleNs = nsPer(start, numTimers);
+
+    // Most players act before their clock runs out
+    size_t numCancelled = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < numTimers; ++i) {
+        if (i % CANCEL_EVERY != 0) numCancelled += wheel.cancel(ids[i]);
+    }
+    double cancelNs = nsPer(start, numCancelled);
+
+    vector<uint64_t> expired;
+    expired.reserve(numTimers);
+    size_t numTicks = 0;
+    start = Clock::now();
+    while (wheel.size() > 0) {
+        wheel.advance(1, expired);
+        numTicks++;
+    }
+    double expireNs = nsPer(start, expired.size());
+    double tickNs = nsPer(start, numTicks);
+
+    // Re-arming into a warm pool doesn't allocate
+    start = Clock::now();
+    for (size_t i = 0; i < numTimers; ++i) ids[i] = wheel.schedule(delays[i], i);
+    double rescheduleNs = nsPer(start, numTimers);
+
+    cout << "Timers: " << numTimers << " | cancelled " << numCancelled << " | expired " << expired.size()
+         << " over " << numTicks << " ticks" << endl;
+    cout << "schedule: " << scheduleNs << " ns | schedule (pooled): " << rescheduleNs
+         << " ns | cancel: " << cancelNs << " ns | expire: " << expireNs << " ns" << endl;
+    cout << "advance one tick (incl. expiries): " << tickNs << " ns" << endl;
+    return 0;
+}
@@ -0,0 +1,24 @@
+#include "include/HandPotentialTable.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+// Usage: HandPotentialTableGen [path] [numThreads] [includeTurn (0 or 1)] [board ...], boards like "Th4hKs"
+int main(int argc, char* argv[]) {
+    string path = (argc > 1) ? argv[1] : "hand_potential.bin";
+    HandPotentialOptions options;
+    options.numThreads = (argc > 2) ? atoi(argv[2]) : static_cast<int>(thread::hardware_concurrency());
+    options.includeTurn = (argc > 3) && atoi(argv[3]) != 0;
+    for (int i = 4; i < argc; ++i) options.boards.push_back(HandPotentialTable::parseCards(argv[i]));
+
+    cout << "Generating " << path << " with " << options.numThreads << " threads." << endl;
+    auto start = chrono::steady_clock::now();
+    if (!HandPotentialTable::generate(path, options)) {
+        cerr << "Failed to write " << path << endl;
+        return 1;
+    }
+    auto elapsed = chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now() - start);
+    cout << "Done in " << elapsed.count() << "s." << endl;
+    return 0;
+}
@@ -30,6 +30,10 @@ public:
         return player->getName();
     }
 
+    const shared_ptr<Player>& getPlayer() const {
+        return player;
+    }
+
     static string actionTypeToStr(ActionType action) {
         switch (action) {
             case CHECK: return "Check";
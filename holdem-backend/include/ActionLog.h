@@ -0,0 +1,177 @@
+#ifndef ACTION_LOG_H
+#define ACTION_LOG_H
+
+#include "HandHistory.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+class GameController;
+
+// Segment files start with a 16 byte header: u32 magic, u16 version, u16 reserved, u32 segment index, u32 reserved.
+// Records follow back to back: u32 payload size, u32 CRC-32 of the payload, payload.
+// Payload: u8 kind, u32 table id, u32 hand number, then for actions u8 street, u8 position,
+// u8 type, u32 amount, and for snapshots the TableSnapshot image.
+const uint32_t ACTION_LOG_MAGIC = 0x4C414157; // "WAAL"
+const uint16_t ACTION_LOG_VERSION = 1;
+const size_t ACTION_LOG_HEADER_SIZE = 16;
+const size_t ACTION_LOG_RECORD_HEADER_SIZE = 8;
+const size_t MAX_ACTION_LOG_RECORD_SIZE = 64 * 1024;
+
+enum ActionLogRecordKind {
+    LOG_ACTION = 1,
+    LOG_SNAPSHOT = 2
+};
+
+typedef struct ActionLogOptions {
+    string directory;
+
+    // A new segment is started once the current one would grow past this
+    size_t segmentSize = 16 * 1024 * 1024;
+
+    // How long the writer waits after the first record of a batch for other tables to join
+    // the same fsync. Zero commits as soon as the previous fsync is done.
+    chrono::microseconds commitDelay = chrono::microseconds(0);
+} ActionLogOptions;
+
+// Callback run once a table's records are durable, see ActionLog::notifyDurable
+typedef struct DurableNotice {
+    uint32_t tableId = 0;
+    function<void(bool)> done;
+} DurableNotice;
+
+// What the log holds for one table: its last snapshot and the actions applied after it
+typedef struct RecoveredTable {
+    uint32_t tableId = 0;
+    uint32_t handNumber = 0;
+    vector<uint8_t> snapshot;
+    vector<HandAction> actions;
+} RecoveredTable;
+
+// Write-ahead log of every action applied at every table on a node.
+// Appends are sequenced in memory and return a log sequence number. A writer thread writes
+// everything appended since its last fsync in one go and fsyncs once for all of it (group
+// commit), so the cost of an fsync is shared by every table that acted in the meantime.
+// Tables ask to be notified with notifyDurable and acknowledge an action once told, so no
+// table thread waits on the disk. waitDurable blocks instead, for tools and tests.
+//
+// Tables append a snapshot at the start of every hand. On startup the log recovers each table
+// from its last snapshot plus the actions after it. A segment is deleted once every table has a
+// snapshot in a later segment.
+class ActionLog {
+private:
+    ActionLogOptions options;
+
+    thread writerThread;
+    mutex logMutex;
+    condition_variable writerCv;
+    condition_variable durableCv;
+    bool isStopping;
+    bool isClosed;
+    bool isFailed;
+
+    // Records appended since the writer last took a batch
+    vector<uint8_t> pending;
+    vector<uint32_t> pendingSnapshots;
+    uint64_t nextSequence;
+    uint64_t durableSequence;
+    uint64_t numSyncs;
+
+    // Segment of each table's latest snapshot, oldest segments no table needs are deleted
+    map<uint32_t, uint32_t> snapshotSegments;
+
+    // Notices waiting for their sequence number to be durable, run by the writer
+    multimap<uint64_t, DurableNotice> durableNotices;
+
+    // Tables found in the log at startup
+    map<uint32_t, RecoveredTable> recoveredTables;
+
+    // Writer thread state
+    int fd;
+    uint32_t segmentIndex;
+    size_t segmentOffset;
+    uint32_t oldestSegment;
+
+    // Reads every segment in the directory into recoveredTables
+    void recover();
+
+    // Appends a record under the lock and wakes the writer, returns its sequence number
+    uint64_t appendRecord(ActionLogRecordKind kind, uint32_t tableId, uint32_t handNumber,
+                          const uint8_t* body, size_t size);
+
+    // Writer thread main loop
+    void writerLoop();
+
+    // Writes a batch to the current segment and fsyncs it, rotating first if it would not fit.
+    // Returns true if it rotated. Throws runtime_error if the batch could not be made durable.
+    bool commitBatch(const vector<uint8_t>& batch);
+
+    // Runs the notices that are settled, durable or not. Called under the lock.
+    void runDurableNotices();
+
+    // Deletes segments older than every table's latest snapshot
+    void removeOldSegments();
+
+    // Opens a new segment, then closes the current one
+    void openSegment(uint32_t index);
+
+    // Writes all of data to the current segment, throws on failure
+    void writeAll(const uint8_t* data, size_t size);
+
+public:
+    // Recovers the tables held by any segments already in the directory, then starts a new segment.
+    // Throws runtime_error if the directory can't be written.
+    explicit ActionLog(const ActionLogOptions& options);
+    ~ActionLog();
+
+    ActionLog(const ActionLog&) = delete;
+    ActionLog& operator=(const ActionLog&) = delete;
+
+    // Appends an applied action. Safe to call from any thread.
+    uint64_t appendAction(uint32_t tableId, uint32_t handNumber, const HandAction& action);
+
+    // Appends a TableSnapshot image. Safe to call from any thread.
+    // Returns 0 (and appends nothing) if it is larger than a record can hold.
+    uint64_t appendSnapshot(uint32_t tableId, uint32_t handNumber, const uint8_t* snapshot, size_t size);
+
+    // Blocks until the record with this sequence number (and every one before it) is fsynced.
+    // Returns false if the log failed to write, nothing appended since is durable.
+    bool waitDurable(uint64_t sequence);
+
+    // Calls done once the record with this sequence number (and every one before it) is fsynced,
+    // with false if the log failed first. done runs on the writer thread (or right away if that is
+    // already settled) under the log's lock, so it must only hand the result on, e.g. post it to a
+    // table, and not call back into the log.
+    void notifyDurable(uint32_t tableId, uint64_t sequence, function<void(bool)> done);
+
+    // Drops a table's notices that haven't run. None of them runs once this returns.
+    void cancelNotices(uint32_t tableId);
+
+    // Writes and fsyncs everything still appended and stops the writer thread
+    void close();
+
+    // Returns the tables found in the log at startup
+    const map<uint32_t, RecoveredTable>& getRecoveredTables() const;
+
+    // Stops a table from holding on to old segments, e.g. once it is closed for good
+    void forgetTable(uint32_t tableId);
+
+    uint64_t getNumAppended();
+    uint64_t getNumSyncs();
+    uint32_t getSegmentIndex();
+
+    // Restores a game created with the table's blinds from its snapshot and replays its actions.
+    // Returns false if the snapshot is rejected or an action no longer applies.
+    static bool restoreGame(GameController& game, const RecoveredTable& table);
+
+    // Returns the file name of a segment
+    static string getSegmentName(uint32_t index);
+};
+
+#endif // ACTION_LOG_H
@@ -56,6 +56,8 @@ typedef struct PossibleAction {
     }
 } PossibleAction;
 
+class TableSnapshot;
+
 class ActionManager {
 private:
     // Ordered list of betting actions in a given betting street
@@ -74,6 +76,9 @@ private:
     // Helper function to update the action state given a new action
     void updateActionState(shared_ptr<Action> action);
 
+
+    // Saves and restores the private state
+    friend class TableSnapshot;
 public:
     ActionManager();
 
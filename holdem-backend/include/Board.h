@@ -7,10 +7,15 @@
 #include <string>
 using namespace std;
 
+class TableSnapshot;
+
 class Board {
 private:
     vector<Card> communityCards;
     void validateAddition() const;
+
+    // Saves and restores the private state
+    friend class TableSnapshot;
 public:
     Board();
     void addCommunityCard(const Card& card);
@@ -0,0 +1,132 @@
+#ifndef BOARD_CLASS_H
+#define BOARD_CLASS_H
+
+#include "HandRank.h"
+#include <array>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+using namespace std;
+
+// Boards of each size up to suit permutation
+const int NUM_FLOP_CLASSES = 1755;
+const int NUM_TURN_CLASSES = 16432;
+const int NUM_RIVER_CLASSES = 134459;
+
+const int MIN_CLASS_BOARD_CARDS = 3;
+const int MAX_CLASS_BOARD_CARDS = 5;
+
+// A board with its suits renamed to those of its class representative
+typedef struct CanonicalBoard {
+    uint64_t cards;                     // The representative
+    uint32_t index;                     // Dense index among the classes of boards this size
+    int numCards;
+    array<uint8_t, 4> suitMap;          // suitMap[suit] is the suit it becomes
+
+    // Renames the suits of other cards the way the board's were, e.g. hole cards
+    uint64_t apply(uint64_t other) const;
+
+    // Renames representative suits back to the board's
+    uint64_t revert(uint64_t other) const;
+} CanonicalBoard;
+
+// Maps flops, turns and rivers to their class up to suit permutation. The representative
+// of a class has its suits ordered by the ranks they hold (highest rank mask in hearts),
+// so canonicalizing is a sort of four 13 bit masks. Per-class data computed on the
+// representative holds for every board in the class once other cards are renamed with
+// CanonicalBoard::apply.
+//
+// The representatives of each board size are enumerated the first time that size is
+// looked up (the river takes the longest, about 2.6M subsets) and are shared by every thread.
+class BoardClass {
+public:
+    // Canonicalizes Board::getCommunityCards (3 to 5 cards), throwing on any other size
+    static CanonicalBoard canonicalize(const vector<Card>& board);
+    static CanonicalBoard canonicalize(uint64_t board);
+
+    // Returns the number of classes of boards this size
+    static int getNumClasses(int numCards);
+
+    // Returns the representative of a class
+    static uint64_t getRepresentative(int numCards, uint32_t index);
+};
+
+// Per-class results of an expensive computation on the board, e.g. a texture or hand
+// strength table. Each class is computed on its representative and shared read-only with
+// every caller whose board falls in it. Slots for a board size are allocated on first use.
+//
+// With a capacity, only that many classes are kept and the least recently used is dropped
+// to make room (callers still holding it keep their copy), so the cache stays bounded when
+// the classes are many and their results large. Without one every class is kept.
+//
+// The computation runs outside the lock so threads don't queue behind it. Two threads
+// missing on the same class both compute it and the first result is kept.
+template <typename T>
+class BoardClassCache {
+private:
+    // Board size and class index, most recently used first
+    typedef list<pair<int, uint32_t>> Recency;
+
+    typedef struct Slot {
+        shared_ptr<const T> value;
+        typename Recency::iterator position;
+    } Slot;
+
+    mutable mutex cacheMutex;
+    array<vector<Slot>, MAX_CLASS_BOARD_CARDS + 1> slots;
+    Recency recency;
+    function<T(const CanonicalBoard&)> compute;
+    size_t capacity;
+
+public:
+    // A capacity of 0 keeps every class
+    explicit BoardClassCache(function<T(const CanonicalBoard&)> compute, size_t capacity = 0) :
+        compute(move(compute)),
+        capacity(capacity)
+    {}
+
+    BoardClassCache(const BoardClassCache&) = delete;
+    BoardClassCache& operator=(const BoardClassCache&) = delete;
+
+    // Returns the result for a board's class, computing it if it isn't cached
+    shared_ptr<const T> get(const CanonicalBoard& board) {
+        {
+            lock_guard<mutex> lock(cacheMutex);
+            vector<Slot>& sized = slots[board.numCards];
+            if (sized.empty()) sized.resize(BoardClass::getNumClasses(board.numCards));
+            Slot& slot = sized[board.index];
+            if (slot.value != nullptr) {
+                recency.splice(recency.begin(), recency, slot.position);
+                return slot.value;
+            }
+        }
+
+        shared_ptr<const T> computed = make_shared<const T>(compute(board));
+        lock_guard<mutex> lock(cacheMutex);
+        Slot& slot = slots[board.numCards][board.index];
+        if (slot.value != nullptr) return slot.value;
+
+        slot.value = computed;
+        slot.position = recency.emplace(recency.begin(), board.numCards, board.index);
+        if (capacity > 0 && recency.size() > capacity) {
+            slots[recency.back().first][recency.back().second].value.reset();
+            recency.pop_back();
+        }
+        return computed;
+    }
+
+    shared_ptr<const T> get(const vector<Card>& board) {
+        return get(BoardClass::canonicalize(board));
+    }
+
+    // Returns the number of classes cached
+    size_t size() const {
+        lock_guard<mutex> lock(cacheMutex);
+        return recency.size();
+    }
+};
+
+#endif // BOARD_CLASS_H
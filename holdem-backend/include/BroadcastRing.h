@@ -0,0 +1,71 @@
+#ifndef BROADCAST_RING_H
+#define BROADCAST_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+using namespace std;
+
+const size_t DEFAULT_BROADCAST_CAPACITY = 1024;
+
+// A frame encoded once and shared (read only) by every subscriber
+typedef struct BroadcastFrame {
+    uint64_t index = 0;
+    bool isKeyframe = false;
+    vector<uint8_t> data;
+} BroadcastFrame;
+
+// A subscriber's position in a ring. Owned by the consumer.
+typedef struct BroadcastCursor {
+    uint64_t nextIndex = 0;
+    bool isSynced = false;    // false until the subscriber has been given a keyframe
+    uint64_t numSkips = 0;    // times the cursor fell behind and was moved to a keyframe
+} BroadcastCursor;
+
+// Bounded single producer ring of refcounted broadcast frames.
+// The producer (a table worker) never waits on subscribers: once the ring is full the oldest
+// frame is overwritten, and any subscriber that falls that far behind is moved forward to the
+// latest keyframe. Subscribers hold a reference to frames they are still writing, so an
+// overwritten frame stays alive until every subscriber is done with it.
+class BroadcastRing {
+private:
+    mutable mutex ringMutex;
+    vector<shared_ptr<const BroadcastFrame>> slots;
+
+    // Index of the next frame to publish
+    uint64_t nextIndex;
+
+    // Kept separately so that a subscriber can always start from it
+    shared_ptr<const BroadcastFrame> latestKeyframe;
+
+    // Set when the consumer needs to be told about new frames (coalesces notifications)
+    atomic<bool> isNotifyPending;
+
+    // Returns the index of the oldest frame still in the ring. Caller holds ringMutex.
+    uint64_t getOldestIndex() const;
+
+public:
+    explicit BroadcastRing(size_t capacity = DEFAULT_BROADCAST_CAPACITY);
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    // Copies an encoded frame into a new shared buffer and appends it to the ring.
+    // Returns true if the consumer should be notified (the first publish since clearNotifyPending).
+    bool publish(const uint8_t* data, size_t size, bool isKeyframe);
+
+    // Returns the next frame for a cursor, or nullptr once it has caught up.
+    // Unsynced cursors (new subscribers, and those that fell behind the ring) start at the
+    // latest keyframe, or wait for the next one if the frames after it have been overwritten.
+    shared_ptr<const BroadcastFrame> next(BroadcastCursor& cursor) const;
+
+    // Called by the consumer before it reads, so later publishes notify it again
+    void clearNotifyPending();
+
+    uint64_t getNumPublished() const;
+    size_t getCapacity() const;
+};
+
+#endif // BROADCAST_RING_H
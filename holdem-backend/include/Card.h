@@ -3,6 +3,7 @@
 
 #include <stdexcept>
 #include <string>
+#include <cstdint>
 using namespace std;
 
 const int NUM_VALUES = 13;
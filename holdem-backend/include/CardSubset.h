@@ -0,0 +1,150 @@
+#ifndef CARD_SUBSET_H
+#define CARD_SUBSET_H
+
+#include "Deck.h"
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+using namespace std;
+
+// Largest subset ranked: seven cards, hole cards and a full board
+const int MAX_SUBSET_CARDS = 7;
+
+typedef array<array<uint64_t, MAX_SUBSET_CARDS + 1>, DECK_SIZE + 1> BinomialTable;
+
+// C(n, k) for every n up to the deck size and k up to MAX_SUBSET_CARDS
+constexpr BinomialTable buildBinomials() {
+    BinomialTable binomials{};
+    for (int n = 0; n <= DECK_SIZE; ++n) {
+        binomials[n][0] = 1;
+        for (int k = 1; k <= MAX_SUBSET_CARDS && k <= n; ++k) {
+            binomials[n][k] = binomials[n - 1][k - 1] + (k < n ? binomials[n - 1][k] : 0);
+        }
+    }
+    return binomials;
+}
+
+constexpr BinomialTable BINOMIALS = buildBinomials();
+
+// Bijections between the k card subsets of the deck (card masks in the PokerHand::bitwise
+// layout) and 0 to C(52, k) - 1, by the combinatorial number system: cards c1 < ... < ck
+// rank C(c1, 1) + C(c2, 2) + ... + C(ck, k). Ranks follow colex order, so the subsets of
+// the cards below c rank below every subset holding c. A two card rank is the HandRange
+// combo index.
+//
+// Everything is constexpr, so tables can be indexed by ranks computed at compile time.
+class CardSubset {
+public:
+    // Returns C(n, k), 0 when k > n
+    static constexpr uint64_t choose(int n, int k) {
+        return (k < 0 || k > n) ? 0 : BINOMIALS[n][k];
+    }
+
+    // Ranks a mask of up to MAX_SUBSET_CARDS cards among the subsets of its size
+    static constexpr uint64_t getRank(uint64_t cards) {
+        if (cards >> DECK_SIZE) throw runtime_error("Subset holds an invalid card");
+        uint64_t rank = 0;
+        for (int k = 1; cards != 0; ++k, cards &= cards - 1) {
+            if (k > MAX_SUBSET_CARDS) throw runtime_error("Subset has too many cards to rank");
+            rank += BINOMIALS[__builtin_ctzll(cards)][k];
+        }
+        return rank;
+    }
+
+    // Returns the subset of numCards cards with a rank, highest card first by the greedy
+    // inverse of getRank
+    static constexpr uint64_t getMask(uint64_t rank, int numCards) {
+        if (numCards < 0 || numCards > MAX_SUBSET_CARDS || rank >= choose(DECK_SIZE, numCards)) {
+            throw runtime_error("Subset rank out of range");
+        }
+        uint64_t cards = 0;
+        int card = DECK_SIZE;
+        for (int k = numCards; k > 0; --k) {
+            do {
+                --card;
+            } while (BINOMIALS[card][k] > rank);
+            rank -= BINOMIALS[card][k];
+            cards |= 1ULL << card;
+        }
+        return cards;
+    }
+};
+
+// Lazily enumerates the k card subsets of a set of cards (e.g. what is left of the deck) in
+// colex order, so their ranks increase. Nothing is allocated: the cards and the position of
+// each chosen one are held inline, and stepping to the next subset only touches the
+// positions that move.
+//
+//   for (uint64_t runout : CardSubsets(FULL_DECK_MASK & ~dealt, 2)) { ... }
+class CardSubsets {
+private:
+    uint8_t cards[DECK_SIZE];
+    int numCards;
+    int subsetSize;
+
+public:
+    class Iterator {
+    private:
+        const CardSubsets* subsets;
+        uint8_t positions[MAX_SUBSET_CARDS];
+        uint64_t subset;
+        bool isDone;
+
+    public:
+        Iterator(const CardSubsets* subsets, bool isDone) : subsets(subsets), positions(), subset(0), isDone(isDone) {
+            if (isDone) return;
+            for (int i = 0; i < subsets->subsetSize; ++i) {
+                positions[i] = static_cast<uint8_t>(i);
+                subset |= 1ULL << subsets->cards[i];
+            }
+        }
+
+        uint64_t operator*() const {
+            return subset;
+        }
+
+        // Moves the lowest position that can move up by one and resets those below it
+        Iterator& operator++() {
+            int size = subsets->subsetSize;
+            int i = 0;
+            while (i < size && positions[i] + 1 == (i + 1 < size ? positions[i + 1] : subsets->numCards)) ++i;
+            if (i == size) {
+                isDone = true;
+                return *this;
+            }
+            for (int j = 0; j <= i; ++j) subset &= ~(1ULL << subsets->cards[positions[j]]);
+            positions[i]++;
+            subset |= 1ULL << subsets->cards[positions[i]];
+            for (int j = 0; j < i; ++j) {
+                positions[j] = static_cast<uint8_t>(j);
+                subset |= 1ULL << subsets->cards[j];
+            }
+            return *this;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return isDone != other.isDone || (!isDone && subset != other.subset);
+        }
+    };
+
+    CardSubsets(uint64_t deck, int subsetSize) : cards(), numCards(0), subsetSize(subsetSize) {
+        if (deck >> DECK_SIZE) throw runtime_error("Deck holds an invalid card");
+        if (subsetSize < 0 || subsetSize > MAX_SUBSET_CARDS) throw runtime_error("Subset size out of range");
+        for (; deck != 0; deck &= deck - 1) cards[numCards++] = static_cast<uint8_t>(__builtin_ctzll(deck));
+    }
+
+    Iterator begin() const {
+        return Iterator(this, subsetSize > numCards);
+    }
+
+    Iterator end() const {
+        return Iterator(this, true);
+    }
+
+    // Returns the number of subsets, C(cards, k)
+    uint64_t size() const {
+        return CardSubset::choose(numCards, subsetSize);
+    }
+};
+
+#endif // CARD_SUBSET_H
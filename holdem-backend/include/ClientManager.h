@@ -9,6 +9,7 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <string>
 using namespace std;
 
 typedef struct ClientAction {
@@ -21,11 +22,58 @@ class ClientManager {
 public:
     ClientManager(size_t bigBlind);
 
+    // Reads every following answer from a script instead of stdin, without prompting.
+    // A script holds the same words a player would type, separated by whitespace, and
+    // '#' starts a comment to the end of the line. Invalid input in a script throws.
+    void setScript(istream& script);
+
+    // Returns true once stdin or the script has nothing left to read
+    bool isInputExhausted();
+
     // Queries the client for a valid client action object to be processed by the action manager
     ClientAction getClientAction(const StreetState& streetState, vector<PossibleAction>& possibleActions);
+
+    // Asks a yes or no question. Anything but "y" (including the end of input) is a no.
+    bool queryYesNo(const string& question);
+
+    // Queries a non empty player name, in lower case
+    string queryPlayerName();
+
+    // Queries a number of chips of at least minChips
+    size_t queryChips(const string& prompt, size_t minChips);
+
+    // Returns the maximum amount the player to act can commit this street.
+    // You can't bet more than your stack, or more than the biggest other stack can call!
+    size_t getMaxBet(const StreetState& streetState) const;
+
+    // Returns the amount committed by a call, capped at the player's max bet (all in to call)
+    size_t getCallAmount(const StreetState& streetState, vector<PossibleAction>& possibleActions);
+
+    // Returns the minimum amount for a bet or raise.
+    // If this equals the max bet, the player has no choice but to go all in.
+    size_t getMinBet(const StreetState& streetState, vector<PossibleAction>& possibleActions, ActionType clientAction);
+
+    // Checks if the client chosen action is valid given a possible actions array
+    bool isValidAction(vector<PossibleAction>& possibleActions, ActionType chosenAction);
 private:
     size_t bigBlind;
 
+    // Where answers are read from, stdin unless a script is set
+    istream* input;
+    bool isScripted;
+
+    // Prints a prompt, unless reading from a script
+    void prompt(const string& text);
+
+    // Reads the next whitespace separated word, skipping comments. Returns false at the end of input.
+    bool readToken(string& token);
+
+    // Reads a number, returning false if the next word is not one. Throws at the end of input.
+    bool readNumber(size_t& number);
+
+    // Re-prompts on invalid interactive input, throws on invalid scripted input
+    void rejectInput(const string& reason);
+
     // Print possible actions for the player to act
     void displayPossibleActions(const StreetState& streetState, vector<PossibleAction>& possibleActions);
 
@@ -41,9 +89,6 @@ private:
     // Convert string (client input) into an ActionType
     ActionType strToActionType(string& string, bool isBigBlind);
 
-    // Checks if the client chosen action is valid given a possible actions array
-    bool isValidAction(vector<PossibleAction>& possibleActions, ActionType chosenAction);
-
     // Given a valid client action type, fetches the relevant bet size from the possible actions array
     // E.g. If client action type is CALL and the possible actions array contains {CALL, 50}, client calls 50
     size_t getRelevantBet(vector<PossibleAction>& possibleActions, ActionType chosenAction);
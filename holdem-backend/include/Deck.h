@@ -3,19 +3,36 @@
 
 #include "Card.h"
 #include <array>
+#include <random>
 #include <stdexcept>
 using namespace std;
 
 const int DECK_SIZE = 52;
 
+class TableSnapshot;
+
 class Deck {
 private:
     array<Card, DECK_SIZE> deck;
     size_t deckIndex;
     bool isShuffled;
+
+    // Every shuffle starts from the unshuffled order and is determined by the seed and
+    // the number of shuffles before it, so the deck's future fits in two numbers
+    uint64_t seed;
+    uint64_t numShuffles;
+
+    void fillDeck();
     void shuffleDeck();
+
+    // Saves and restores the private state
+    friend class TableSnapshot;
 public:
     Deck();
+
+    // Reseeds the shuffle and reshuffles, so every deal from here on is determined by the seed
+    void setSeed(uint64_t seed);
+
     Card& dealCard();
     void burnCard();
     void resetDeck();
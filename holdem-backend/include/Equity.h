@@ -0,0 +1,60 @@
+#ifndef EQUITY_H
+#define EQUITY_H
+
+#include "HandRank.h"
+#include "GamePlayers.h"
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+const int NUM_HOLE_CARDS = 2;
+const int NUM_BOARD_CARDS = 5;
+const int MAX_EQUITY_HANDS = MAX_NUM_PLAYERS;
+
+// Tally of how a set of hands fare over the runouts of a board, one entry per hand
+typedef struct EquityResult {
+    uint64_t numBoards;         // Runouts counted
+    uint64_t numRanked;         // Runouts actually ranked, the rest were counted through a suit swap
+    vector<uint64_t> wins;      // Runouts the hand won outright
+    vector<uint64_t> ties;      // Runouts the hand split with others
+    vector<double> shares;      // Pots won, a split counting as its share
+
+    EquityResult();
+    explicit EquityResult(size_t numHands);
+
+    // Adds the tally of another set of runouts for the same hands
+    void merge(const EquityResult& other);
+
+    double getWinFraction(size_t hand) const;
+    double getTieFraction(size_t hand) const;
+    double getLossFraction(size_t hand) const;
+
+    // Fraction of the pot the hand wins on average
+    double getEquity(size_t hand) const;
+} EquityResult;
+
+// Exact equity by enumerating every runout of the board, ranking each hand with HandRank.
+// Hands and boards are card masks in the PokerHand::bitwise layout. Work is split over
+// threads by the first runout card, each thread keeping its own tally.
+//
+// Suits that hold the same ranks in every hand and on the board are interchangeable, so a
+// runout and its image under swapping them have the same outcome. With suit reduction on,
+// only the runout whose interchangeable suits are in descending rank mask order is ranked,
+// weighted by how many distinct runouts the swaps produce.
+class Equity {
+public:
+    // Equity of two hole card pairs given 0, 3, 4 or 5 known board cards
+    static EquityResult computeHeadsUp(const vector<Card>& first, const vector<Card>& second,
+                                       const vector<Card>& board, int numThreads = 1);
+
+    // Equity of 2 to MAX_EQUITY_HANDS hole card masks given a board mask.
+    // Throws if a hand is not two cards, the board size is invalid or cards are shared.
+    static EquityResult computeExact(const vector<uint64_t>& hands, uint64_t board, int numThreads = 1,
+                                     bool reduceSuits = true);
+
+    // Checks the hands and board can be dealt out, returning the mask of every dealt card.
+    // Empty hands are unknown opponents when allowUnknown is set.
+    static uint64_t validate(const vector<uint64_t>& hands, uint64_t board, bool allowUnknown = false);
+};
+
+#endif // EQUITY_H
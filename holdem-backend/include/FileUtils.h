@@ -0,0 +1,20 @@
+#ifndef FILE_UTILS_H
+#define FILE_UTILS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+using namespace std;
+
+// CRC-32 (IEEE) used to detect torn records and corrupt files
+uint32_t computeCrc32(const uint8_t* data, size_t size);
+
+// Replaces the file at path with data: a crash leaves either the old or the new contents
+// in place, never a mix
+bool writeFileAtomically(const string& path, const uint8_t* data, size_t size);
+
+// Reads a whole file. Returns false if it could not be read.
+bool readWholeFile(const string& path, vector<uint8_t>& data);
+
+#endif // FILE_UTILS_H
@@ -20,11 +20,17 @@
 #include "Board.h"
 #include "HandEvaluator.h"
 #include "StreetState.h"
+#include "HandHistory.h"
+#include "ActionLog.h"
+#include "RunoutEquity.h"
+#include "StreetStrength.h"
 
 #include <string>
 #include <memory.h>
 using namespace std;
 
+class TableSnapshot;
+
 class GameController {
 private:
     size_t smallBlind;
@@ -80,19 +86,16 @@ private:
     // Round function to award pots when betting action is complete
     void evaluateHandsAndAwardPots();
 
-    // Round helper function to resets the game state before a new round
-    // Called at the end of each round
-    // TurnManager: Resets folded players and rotates posiitions
-    // ActionManager: Clear the action timeline
-    // PotManager: Reset recent bets and dead money
-    // HandEvaluator: Clear the playerHands map
-    void setupNewRound();
-
     // Round helper function to award pots after betting action is complete
     // Evaluates hands and ranks players according to hand strength in HandEvaluator
     // Then, awards pots based on this player ranking
     void evaluatePots();
 
+    // Hand record helper functions, the record is built as the round is played
+    void startHandRecord();
+    void recordAction(const shared_ptr<Player>& player, ActionType type, size_t amount);
+    void finishHandRecord();
+
     // Game helper function if there are at least two players in the game
     bool verifyNumPlayers();
 
@@ -110,16 +113,174 @@ private:
     void validateChipCounts();
 
     // Helper function to query the number of chips to add
-    size_t queryChipsToAdd(size_t minChips, size_t currentChips) const;
+    size_t queryChipsToAdd(size_t minChips, size_t currentChips);
+
+    // STEP STATE
+
+    // Street being played (or next to be set up) in the current round
+    Street curStreet;
+
+    // True between beginRound and the pots being awarded
+    bool isRoundActive;
+
+    // True between setupStreet and cleanupStreet
+    bool isStreetActive;
+
+    // True while a decision from streetState.curPlayer is pending
+    bool isDecisionPending;
+
+    // Possible actions for the pending decision
+    vector<PossibleAction> possibleActions;
+
+    // Table named in hand records
+    uint32_t tableId;
+
+    // History of the current (or last completed) round
+    HandRecord handRecord;
+
+    // Write-ahead log every applied action is appended to (optional)
+    ActionLog* actionLog;
+
+    // Sequence number of the last action appended to the log
+    uint64_t logSequence;
+
+    // Computes contenders' equity before each street of an all-in runout (optional)
+    const RunoutEquityOptions* runoutEquityOptions;
+
+    // Equity before each street of the last hand run out all in
+    vector<StreetEquity> runoutEquities;
+
+    // Deferred runouts not taken yet
+    vector<RunoutJob> runoutJobs;
+
+    // Precomputed strength tables players' hands are looked up in (optional)
+    StreetStrength* streetStrength;
+
+    // Step helper function to deal a street without betting once every contender is all in.
+    // Does nothing when the hand is uncontested.
+    void runOutStreet(Street street);
+
+    // Step helper function to run the street logic until a player decision is required
+    // or the round is complete (pots are awarded when the round completes)
+    void advanceToNextDecision();
+
+    // Step helper function to check a client action against the pending decision.
+    // Normalises the call amount and returns false if the action is not allowed.
+    bool validateClientAction(ClientAction& clientAction);
+
+    // Saves and restores the private state
+    friend class TableSnapshot;
 public:
     GameController(size_t smallBlind, size_t bigBlind);
     
-    // Initiates a new betting street
-    void startStreet(Street newStreet);
-
     // Initiates a new round of poker
     void startRound();
 
+    // STEP METHODS
+    // Drive the same street logic as startRound without blocking on the client,
+    // e.g. from a network table. Every call returns at the next pending decision.
+
+    // Adds a player to the game and the turn manager. Only valid between rounds.
+    shared_ptr<Player> addPlayerToGame(const string& name, size_t chips);
+
+    // Removes a player from the game and the turn manager. Only valid between rounds.
+    shared_ptr<Player> removePlayerFromGame(const string& name);
+
+    // Starts a new round and advances to the first decision.
+    // Returns false if there are not enough players in the game.
+    bool beginRound();
+
+    // Validates a client action against the pending decision and applies it.
+    // The call amount is normalised in place (e.g. all in to call).
+    // Returns false (and leaves the game state untouched) if the action is not allowed.
+    bool processClientAction(ClientAction& clientAction);
+
+    // Round function to reset the game state before a new round
+    // Called at the end of each round
+    // TurnManager: Resets folded players and rotates posiitions
+    // ActionManager: Clear the action timeline
+    // PotManager: Reset recent bets and dead money
+    // HandEvaluator: Clear the playerHands map
+    // Players: Clear hole cards
+    void setupNewRound();
+
+    // Returns true while a round is being played
+    bool isRoundInProgress() const;
+
+    // Returns true while the round is waiting on streetState.curPlayer
+    bool isAwaitingAction() const;
+
+    // Returns the street state of the pending decision
+    const StreetState& getStreetState() const;
+
+    // Returns the possible actions of the pending decision
+    const vector<PossibleAction>& getPossibleActions() const;
+
+    // Returns the players in the game sorted by position
+    const vector<shared_ptr<Player>>& getGamePlayers() const;
+
+    // Returns the community cards
+    const Board& getBoard() const;
+
+    // Returns the players dealt into the round in progress who haven't folded
+    vector<shared_ptr<Player>> getContenders() const;
+
+    // Returns the pots for the current round
+    const PotManager& getPotManager() const;
+
+    // Returns the history of the round in progress, complete once the round is over.
+    // Valid until the next round begins.
+    const HandRecord& getHandRecord() const;
+
+    // Sets the table id written into hand records
+    void setTableId(uint32_t tableId);
+
+    // Appends every action applied from now on to a write-ahead log, or stops if log is null.
+    // The log must outlive the game.
+    void setActionLog(ActionLog* log);
+
+    // Returns the sequence number of the last action appended to the log (0 if none).
+    // Wait for it to be durable before acknowledging the action.
+    uint64_t getLogSequence() const;
+
+    // Computes the contenders' equity before each street is run out once every contender
+    // is all in, or stops if options is null. The options must outlive the game.
+    void setRunoutEquity(const RunoutEquityOptions* options);
+
+    // Returns the equity before each street of the last hand run out all in, complete once
+    // its round is over and any deferred entries are attached. Kept until another hand is
+    // run out, so check the entries' hand number.
+    const vector<StreetEquity>& getRunoutEquities() const;
+
+    // Returns the runouts deferred since the last call, leaving their entries pending
+    vector<RunoutJob> takeRunoutJobs();
+
+    // Fills in the pending entry of a deferred runout, and the hand record while its hand is
+    // the current one. Returns false, attaching nothing, once another hand has been run out.
+    bool attachRunoutEquity(const StreetEquity& equity);
+
+    // Returns the number of a hand's deferred runouts that aren't attached yet
+    size_t getNumPendingRunouts(uint64_t handNumber) const;
+
+    // Looks hands up in precomputed strength tables from now on, or stops if strength is null.
+    // The tables must outlive the game.
+    void setStreetStrength(StreetStrength* strength);
+
+    // Returns the strength and potential of a player's hole cards on the board dealt so far,
+    // not known without tables (or the entry), hole cards or on a board of 1 or 2 cards
+    HandPotential getHandPotential(const Player& player) const;
+
+    // Seeds the deck so that the deals of every following round can be reproduced.
+    // Only valid between rounds.
+    void setDeckSeed(uint64_t seed);
+
+    size_t getSmallBlind() const;
+    size_t getBigBlind() const;
+
+    // Reads decisions and player setup from a script instead of stdin, without prompts.
+    // The main game ends when the script runs out.
+    void setClientScript(istream& script);
+
     // Main game method
     void main();
 
@@ -10,6 +10,8 @@ using namespace std;
 const int MIN_NUM_PLAYERS = 2;
 const int MAX_NUM_PLAYERS = 9;
 
+class TableSnapshot;
+
 class GamePlayers {
 private:
     vector<shared_ptr<Player>> gamePlayers;
@@ -34,6 +36,9 @@ private:
 
     // Helper function to remove a player
     void removePlayer(shared_ptr<Player> playerToRemove);
+
+    // Saves and restores the private state
+    friend class TableSnapshot;
 public:
     GamePlayers();
 
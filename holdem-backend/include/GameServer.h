@@ -0,0 +1,149 @@
+#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+
+#include "GameTable.h"
+#include "MpscQueue.h"
+#include "TableScheduler.h"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+// Frame queued by a table worker for the IO thread
+typedef struct OutgoingFrame {
+    uint64_t clientId = 0;
+    vector<uint8_t> data;
+} OutgoingFrame;
+
+// A table a connection is spectating and its position in the table's broadcast ring
+typedef struct Subscription {
+    uint32_t tableId = 0;
+    BroadcastCursor cursor;
+} Subscription;
+
+// State of a single TCP connection, owned by the IO thread
+typedef struct Connection {
+    int fd = -1;
+    uint64_t clientId = 0;
+    vector<uint8_t> readBuffer;
+    vector<uint8_t> writeBuffer;
+    size_t writeOffset = 0;
+    bool isWriteRegistered = false;
+    vector<uint32_t> joinedTables;
+
+    // Shared broadcast frames being written (the first from broadcastOffset), never copied
+    vector<Subscription> subscriptions;
+    deque<shared_ptr<const BroadcastFrame>> broadcastFrames;
+    size_t broadcastOffset = 0;
+} Connection;
+
+// Linux epoll TCP server hosting many tables.
+// A single IO thread owns every socket. Tables run on the scheduler's workers and
+// hand frames back through a lock-free outbox drained by the IO thread.
+class GameServer : public TableOutput {
+private:
+    int listenFd;
+    int epollFd;
+    int wakeFd;
+    uint16_t port;
+
+    TableScheduler scheduler;
+    vector<shared_ptr<GameTable>> tables;
+
+    // Connections by client id, only touched by the IO thread
+    unordered_map<uint64_t, Connection> connections;
+    uint64_t nextClientId;
+
+    // Spectating client ids by table, only touched by the IO thread
+    unordered_map<uint32_t, vector<uint64_t>> spectators;
+
+    // Frames from table workers waiting to be written
+    MpscQueue<OutgoingFrame> outbox;
+
+    // Tables whose spectator rings have new frames
+    MpscQueue<uint32_t> spectatorNotices;
+    atomic<bool> isWakePending;
+    atomic<bool> isRunning;
+
+    // Sets up the listening socket, epoll instance and wake eventfd
+    void openSockets(uint16_t requestedPort);
+
+    // Accepts every pending connection on the listening socket
+    void acceptConnections();
+
+    // Reads from a client and dispatches complete frames
+    void readFromClient(Connection& connection);
+
+    // Parses a single client frame into a table command. Returns false if malformed.
+    bool dispatchFrame(Connection& connection, uint8_t type, const uint8_t* payload, size_t size);
+
+    // Starts or stops spectating a table. Handled on the IO thread without involving the table.
+    void watchTable(Connection& connection, uint32_t tableId);
+    void unwatchTable(Connection& connection, uint32_t tableId);
+
+    // Writes as much buffered output (then broadcast frames) as the socket accepts.
+    // A spectator whose socket is full simply stops reading its rings until it drains.
+    void flushClient(Connection& connection);
+
+    // Takes the next batch of broadcast frames from a connection's subscriptions
+    void pullBroadcastFrames(Connection& connection);
+
+    // Moves frames from the outbox into connection write buffers and flushes notified spectators
+    void drainOutbox();
+
+    // Wakes the IO thread, coalescing wake ups until it drains
+    void wakeIoThread();
+
+    // Closes a connection and leaves every table it joined
+    void closeClient(uint64_t clientId);
+
+    // Appends an error frame to a connection's write buffer from the IO thread
+    void sendError(Connection& connection, uint32_t tableId, WireError error);
+
+    // Appends a frame carrying just a table id to a connection's write buffer from the IO thread
+    void appendTableMessage(Connection& connection, uint32_t tableId, MessageType type);
+
+    // Enables or disables EPOLLOUT for a connection
+    void updateWriteInterest(Connection& connection, bool wantsWrite);
+
+public:
+    // Binds to port on all interfaces (0 picks a free port) and creates numTables tables.
+    // Throws runtime_error if the socket can't be set up.
+    GameServer(uint16_t port, size_t numTables, size_t numWorkers, size_t smallBlind, size_t bigBlind);
+    ~GameServer();
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    // Logs the hands of every table to writer. Call before run(), the writer must outlive the server.
+    void setHandHistory(HandHistoryWriter* writer);
+
+    // Looks players' hands up in precomputed strength tables at every table. Call before run(),
+    // the tables must outlive the server.
+    void setStreetStrength(StreetStrength* strength);
+
+    // Works out all-in runout equity at every table, see GameTable::setRunoutEquity. Call before
+    // run(), the worker and the preflop table must outlive the server.
+    void setRunoutEquity(const RunoutEquityOptions& options, RunoutEquityWorker* worker);
+
+    // Runs the epoll loop on the calling thread until stop() is called
+    void run();
+
+    // Stops the epoll loop. Safe to call from any thread.
+    void stop();
+
+    // Queues a frame for a client. Safe to call from any thread.
+    void sendToClient(uint64_t clientId, const uint8_t* data, size_t size) override;
+
+    // Queues a flush of a table's spectators. Safe to call from any thread.
+    void notifySpectators(uint32_t tableId) override;
+
+    // Returns the bound port
+    uint16_t getPort() const;
+
+    size_t getNumTables() const;
+};
+
+#endif // GAME_SERVER_H
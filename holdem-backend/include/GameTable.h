@@ -0,0 +1,258 @@
+#ifndef GAME_TABLE_H
+#define GAME_TABLE_H
+
+#include "ActionLog.h"
+#include "BroadcastRing.h"
+#include "GameController.h"
+#include "HandHistoryLog.h"
+#include "TableScheduler.h"
+#include "TableSnapshot.h"
+#include "TableState.h"
+#include "WinProbabilityFeed.h"
+#include <chrono>
+#include <deque>
+#include <map>
+#include <set>
+#include <vector>
+using namespace std;
+
+// Destination for frames produced by a table (e.g. the network server)
+class TableOutput {
+public:
+    virtual ~TableOutput() {}
+
+    // Queues an encoded frame for a client. Called from table worker threads.
+    virtual void sendToClient(uint64_t clientId, const uint8_t* data, size_t size) = 0;
+
+    // Tells the output that a table's spectator ring has new frames. Called from table worker threads.
+    virtual void notifySpectators(uint32_t /*tableId*/) {}
+};
+
+// Time a player has to act before the shot clock runs out
+const chrono::milliseconds DEFAULT_SHOT_CLOCK(15000);
+
+// Extra time each player can draw on once per decision, spent across the session
+const chrono::milliseconds DEFAULT_TIME_BANK(30000);
+
+// A frame sent while action log records it reports on weren't durable yet
+typedef struct HeldFrame {
+    uint64_t logSequence = 0;       // Last record the table had appended when it was sent
+    vector<uint64_t> clientIds;
+    bool isSpectated = false;       // Also published to spectators
+    bool isKeyframe = false;
+    vector<uint8_t> data;
+} HeldFrame;
+
+// A network table. Owns a GameController and drives it with the step methods,
+// one command at a time on a scheduler worker.
+class GameTable : public TableActor {
+private:
+    uint32_t tableId;
+    GameController game;
+    TableOutput& output;
+
+    // Seated players by the client that controls them
+    map<uint64_t, shared_ptr<Player>> clientPlayers;
+
+    // Joins received mid-round, seated when the round completes
+    vector<TableCommand> pendingJoins;
+
+    // Clients that left mid-round, removed when the round completes
+    set<uint64_t> leavingClients;
+
+    // True once a round has been played and setupNewRound is still owed
+    bool isRoundPendingCleanup;
+
+    // Number of hands begun at this table
+    uint32_t handNumber;
+
+    // Public table state, published as deltas after every change
+    TableStateStream stateStream;
+
+    // Public frames encoded once for every spectator
+    BroadcastRing spectatorRing;
+
+    // Action clock settings
+    chrono::milliseconds shotClock;
+    chrono::milliseconds timeBank;
+
+    // Remaining time bank by client
+    map<uint64_t, chrono::milliseconds> timeBanks;
+
+    // Current decision, timeouts for earlier decisions are ignored
+    uint64_t decisionId;
+    uint64_t decisionClientId;
+    uint64_t actionTimerId;
+    bool isOnTimeBank;
+    chrono::steady_clock::time_point timeBankStart;
+
+    // Where completed hands are logged (optional)
+    HandHistoryWriter* handHistory;
+
+    // Where applied actions and a snapshot per hand are logged before they are acknowledged (optional)
+    ActionLog* actionLog;
+    vector<uint8_t> snapshotBuffer;
+
+    // Sequence number of the last snapshot appended to the log
+    uint64_t snapshotSequence;
+
+    // Last record the log said is durable, and the last one a notice was asked for
+    uint64_t durableSequence;
+    uint64_t noticeSequence;
+
+    // Frames held back until the records they report on are durable, oldest first
+    deque<HeldFrame> heldFrames;
+
+    // True once the action log failed. The table is closed and only answers with errors.
+    bool isLogFailed;
+
+    // All-in runout equity settings, and the worker deferred runouts are handed to (optional)
+    RunoutEquityOptions runoutOptions;
+    RunoutEquityWorker* runoutWorker;
+
+    // Hand whose runout equity was last looked at, and how many of its entries were
+    uint64_t runoutHandNumber;
+    size_t numRunoutsSeen;
+
+    // Completed hand waiting for its deferred runout equity before it is logged
+    HandRecord heldHandRecord;
+    bool isHandRecordHeld;
+
+    // Live win probabilities shown to spectators of a featured table (optional)
+    unique_ptr<WinProbabilityFeed> winProbabilityFeed;
+
+    // Scratch buffer for encoding frames
+    uint8_t frameBuffer[FRAME_HEADER_SIZE + MAX_FRAME_PAYLOAD];
+
+    // Command handlers
+    void handleJoin(const TableCommand& command);
+    void handleLeave(const TableCommand& command);
+    void handleAction(const TableCommand& command);
+    void handleTimeout(const TableCommand& command);
+    void handleLogDurable(const TableCommand& command);
+    void handleLogFailed(const TableCommand& command);
+    void handleRunoutEquity(const TableCommand& command);
+
+    // Starts the shot clock for the current player (only when run by a scheduler)
+    void startActionClock();
+
+    // Stops the clock once the current player has acted, charging any time bank used
+    void stopActionClock();
+
+    // Seats a client, returns false and sends an error if they can't sit
+    bool seatClient(const TableCommand& command);
+
+    // Folds for players that left, completes rounds and starts the next one
+    void advanceTable();
+
+    // Removes leaving and busted players, seats pending joins and begins a new round if possible
+    void startNextRound();
+
+    // Seats a client in the seat of a recovered player with their name.
+    // Returns false if there is no such player without a client.
+    bool reclaimSeat(const TableCommand& command);
+
+    // Appends a snapshot of the game to the action log
+    void logSnapshot();
+
+    // Asks the action log to post a LOG_DURABLE (or LOG_FAILED) notice once everything the
+    // table appended is durable. Without a scheduler nothing could run it, so this waits instead.
+    void commitLog();
+
+    // Logs a completed hand, holding it back while its deferred runout equity is worked out
+    void logHand();
+
+    // Logs the held hand with the runout equity attached so far
+    void logHeldHand();
+
+    // Broadcasts the runout equity worked out since the last call and hands the runouts the
+    // game deferred to the worker, which posts each result back as a RUNOUT_EQUITY command.
+    // Without a scheduler nothing could run it, so they are worked out here.
+    void submitRunouts();
+
+    // Returns the sequence number of the last record the table appended to the log
+    uint64_t getLastLogSequence() const;
+
+    // Returns true while frames must wait for the log
+    bool isHoldingFrames() const;
+
+    // Holds the frame in frameBuffer back until the records appended so far are durable
+    void holdFrame(WireWriter& writer, vector<uint64_t> clientIds, bool isSpectated, bool isKeyframe);
+
+    // Sends the held frames whose records are durable
+    void releaseFrames();
+
+    // Returns the client id controlling a player (0 if none)
+    uint64_t getClientForPlayer(const shared_ptr<Player>& player) const;
+
+    // Frame helpers. Broadcasts go to seated players, players waiting for the next round and spectators.
+    // Frames are held back while the table has log records that aren't durable yet.
+    void sendFrame(uint64_t clientId, WireWriter& writer);
+    void broadcastFrame(WireWriter& writer, bool isKeyframe = false);
+    void sendError(uint64_t clientId, WireError error);
+    void sendHandStarted();
+    void sendKeyframe(uint64_t clientId);
+    void publishState();
+    void sendActionRequest();
+    void sendActionResult(const ClientAction& action);
+    void sendTableMessage(uint64_t clientId, MessageType type);
+    void sendTimeBank(const Player& player, chrono::milliseconds remaining);
+    void publishWinProbabilities();
+    void sendRunoutEquity(const StreetEquity& equity);
+
+public:
+    GameTable(uint32_t tableId, size_t smallBlind, size_t bigBlind, TableOutput& output);
+    ~GameTable();
+
+    void handleCommand(const TableCommand& command) override;
+
+    // Sets the shot clock and the time bank given to players seated from now on.
+    // A zero shot clock turns the action clock off.
+    void setActionClock(chrono::milliseconds shotClock, chrono::milliseconds timeBank);
+
+    // Logs every hand completed from now on. The writer must outlive the table.
+    void setHandHistory(HandHistoryWriter* writer);
+
+    // Makes every action applied from now on durable in a write-ahead log before it is
+    // acknowledged, with a snapshot at the start of every hand. The table keeps playing while
+    // the log writes, holding back every frame until the log posts that the records it reports
+    // on are durable. If the log fails the table closes instead. The log must outlive the table.
+    void setActionLog(ActionLog* log);
+
+    // Looks players' hands up in precomputed strength tables, see GameController::setStreetStrength.
+    // The tables must outlive the table.
+    void setStreetStrength(StreetStrength* strength);
+
+    // Works out the contenders' equity before each street of an all-in runout, see
+    // GameController::setRunoutEquity. With a worker only lookups in the preflop table are
+    // done on the table's worker, everything else is attached when the worker posts it back.
+    // Each street's equity is broadcast once it is known, and logged with the hand.
+    // The worker and the preflop table must outlive the table.
+    void setRunoutEquity(const RunoutEquityOptions& options, RunoutEquityWorker* worker = nullptr);
+
+    // Makes this a featured table: spectators are sent every live player's win and tie
+    // chances after each street is dealt, computed within budget on the table's worker.
+    // Seated players never are, as the chances give away the other hands.
+    void setWinProbabilityFeed(chrono::microseconds budget = DEFAULT_WIN_PROBABILITY_BUDGET);
+
+    // Rebuilds the game from what the action log recovered for this table, before any client joins.
+    // Recovered players have no client: the action clock checks or folds for them until a client
+    // joins with their name, and they are removed when the round completes if none does.
+    // Call once the table is registered so the clock restarts. Returns false if the table could
+    // not be rebuilt, in which case the table must be discarded.
+    bool recover(const RecoveredTable& table);
+
+    uint32_t getTableId() const;
+
+    // Returns the number of seated clients (including those waiting for the next round)
+    size_t getNumSeated() const;
+
+    // Returns the ring spectators read public frames from. Safe to read from any thread.
+    BroadcastRing& getSpectatorRing();
+
+    // Returns the underlying game for inspection.
+    // Only safe while the scheduler is idle.
+    const GameController& getGame() const;
+};
+
+#endif // GAME_TABLE_H
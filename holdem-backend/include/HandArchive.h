@@ -0,0 +1,159 @@
+#ifndef HAND_ARCHIVE_H
+#define HAND_ARCHIVE_H
+
+#include "HandHistory.h"
+#include <map>
+#include <string>
+#include <vector>
+using namespace std;
+
+const uint32_t HAND_ARCHIVE_MAGIC = 0x41484848; // "HHHA"
+const uint16_t HAND_ARCHIVE_VERSION = 2;
+const size_t HAND_ARCHIVE_HEADER_SIZE = 16;
+const size_t DEFAULT_HANDS_PER_BLOCK = 256;
+
+// Packs bits least significant first into a byte vector
+class BitWriter {
+private:
+    vector<uint8_t>& out;
+    uint64_t accumulator;
+    int numBits;
+
+public:
+    explicit BitWriter(vector<uint8_t>& out);
+
+    // Writes the low numBits (at most 32) of value
+    void putBits(uint32_t value, int numBits);
+
+    // Elias gamma code of value + 1: small values take few bits, any uint64 fits
+    void putGamma(uint64_t value);
+
+    // Pads to a byte boundary and flushes
+    void alignToByte();
+};
+
+// Reads bits written by BitWriter. Reads past the end return 0 and are flagged.
+class BitReader {
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t bitOffset;
+    bool underflow;
+
+public:
+    BitReader(const uint8_t* data, size_t size);
+
+    uint32_t getBits(int numBits);
+    uint64_t getGamma();
+
+    bool isUnderflow() const;
+
+    // Bytes consumed, counting a partly read byte as whole
+    size_t getByteOffset() const;
+
+    size_t getRemainingBits() const;
+};
+
+// Running state of a block: each hand is coded against the hand before it
+typedef struct ArchiveBlockState {
+    uint32_t tableId;
+    uint64_t handNumber;
+    uint64_t startTime;
+    vector<int64_t> chips;      // Starting chips of each name when last seen, -1 before
+} ArchiveBlockState;
+
+// Archival hand history encoding, built for size over speed of access.
+// Hands are grouped into blocks that share blinds and a player name dictionary.
+// A block is one bit stream:
+//   cards are 6 bits, seat positions 4 bits, runout equities 14 bits, and chip amounts are gamma coded,
+//   in units of the small blind when they divide by it.
+//   Action types are gamma coded by frequency and actors as steps round the table.
+//   Table, hand number and start time are coded against the previous hand, and a seat's
+//   starting chips against the player's starting chips in their previous hand.
+// The archive ends with an index of blocks, so reaching a hand decodes only its block.
+//
+// Layout: header {u32 magic, u16 version, u16 reserved, u64 indexOffset}, blocks, index
+// Block:  {u32 numHands, u32 smallBlind, u32 bigBlind, u32 firstTableId, u64 firstHandNumber,
+//          u64 firstStartTime, u16 numNames, {u8 length, name}, hands}
+// Index:  {u32 numBlocks, {u64 offset, u32 size, u32 numHands}}
+class HandArchiveWriter {
+private:
+    size_t handsPerBlock;
+    vector<uint8_t> archive;
+
+    // Block being filled
+    vector<HandRecord> blockHands;
+
+    typedef struct BlockEntry {
+        uint64_t offset;
+        uint32_t size;
+        uint32_t numHands;
+    } BlockEntry;
+    vector<BlockEntry> blocks;
+
+    // Encodes the buffered hands as a block
+    void writeBlock();
+
+    // Bit packs a hand against the previous hand of its block
+    static void encodeHand(const HandRecord& hand, const map<string, uint32_t>& names, ArchiveBlockState& state,
+                           BitWriter& writer);
+
+public:
+    explicit HandArchiveWriter(size_t handsPerBlock = DEFAULT_HANDS_PER_BLOCK);
+
+    // Adds a hand. A hand with different blinds starts a new block.
+    void add(const HandRecord& hand);
+
+    // Writes the last block and the index, returning the archive. The writer is reset.
+    vector<uint8_t> finish();
+};
+
+// Random access reader over an archive in memory (e.g. a mapped file). Nothing is copied
+// until a hand is decoded.
+class HandArchiveReader {
+private:
+    const uint8_t* data;
+    size_t size;
+    bool isValidArchive;
+
+    typedef struct BlockEntry {
+        uint64_t offset;
+        uint32_t size;
+        uint32_t numHands;
+        uint64_t firstHand;     // Index of the block's first hand in the archive
+    } BlockEntry;
+    vector<BlockEntry> blocks;
+    size_t numHands;
+
+    typedef struct BlockHeader {
+        uint32_t smallBlind;
+        uint32_t bigBlind;
+        vector<string> names;
+        ArchiveBlockState state;
+        size_t handsOffset;     // Offset of the first hand from the block start
+    } BlockHeader;
+
+    // Parses a block's header and name dictionary
+    bool readBlockHeader(const BlockEntry& block, BlockHeader& header) const;
+
+    // Unpacks the next hand of a block
+    static bool decodeHand(BitReader& reader, BlockHeader& header, HandRecord& hand);
+
+public:
+    HandArchiveReader(const uint8_t* data, size_t size);
+
+    // Returns false if the header or index is malformed
+    bool isValid() const;
+
+    size_t getNumHands() const;
+    size_t getNumBlocks() const;
+
+    // Decodes a single hand by its position in the archive, along with the hands
+    // before it in its block
+    bool getHand(size_t index, HandRecord& hand) const;
+
+    // Decodes every hand of a block, appending to hands
+    bool getBlock(size_t blockIndex, vector<HandRecord>& hands) const;
+};
+
+#endif // HAND_ARCHIVE_H
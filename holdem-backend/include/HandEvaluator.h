@@ -7,6 +7,8 @@
 #include <algorithm>
 #include <assert.h>
 #include <iomanip>
+#include <unordered_map>
+#include <bitset>
 #include "Player.h"
 using namespace std;
 
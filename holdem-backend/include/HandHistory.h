@@ -0,0 +1,98 @@
+#ifndef HAND_HISTORY_H
+#define HAND_HISTORY_H
+
+#include "WireCodec.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+// Largest encoded hand record, longer hands are not logged
+const size_t MAX_HAND_RECORD_SIZE = 16384;
+
+// A player as they sat down to the hand
+typedef struct HandSeat {
+    uint8_t position = 0;
+    string name;
+    uint32_t startingChips = 0;             // Before the blinds were posted
+    uint8_t holeCards[2] = {NO_CARD, NO_CARD};
+
+    bool operator==(const HandSeat& other) const;
+} HandSeat;
+
+// A single entry of the action timeline, blinds included
+typedef struct HandAction {
+    uint8_t street = 0;
+    uint8_t position = 0;
+    uint8_t type = 0;                       // ActionType
+    uint32_t amount = 0;
+
+    bool operator==(const HandAction& other) const;
+} HandAction;
+
+typedef struct HandPot {
+    uint32_t chips = 0;
+    uint16_t eligiblePositions = 0;         // Bit per position
+
+    bool operator==(const HandPot& other) const;
+} HandPot;
+
+typedef struct HandResult {
+    uint8_t position = 0;
+    uint32_t chipsWon = 0;
+
+    bool operator==(const HandResult& other) const;
+} HandResult;
+
+// A contender's equity before a street of an all-in runout
+typedef struct HandRunoutEquity {
+    uint8_t street = 0;                     // Street about to be dealt
+    uint8_t position = 0;
+    uint16_t equity = 0;                    // Share of the pot won on average, in 1/10000ths
+
+    bool operator==(const HandRunoutEquity& other) const;
+} HandRunoutEquity;
+
+// Everything needed to audit or replay a completed hand
+typedef struct HandRecord {
+    uint32_t tableId = 0;
+    uint64_t handNumber = 0;
+    uint64_t startTime = 0;                 // Unix time in milliseconds
+    uint32_t smallBlind = 0;
+    uint32_t bigBlind = 0;
+    vector<HandSeat> seats;
+    vector<HandAction> actions;
+    uint8_t numBoardCards = 0;
+    uint8_t board[5] = {NO_CARD, NO_CARD, NO_CARD, NO_CARD, NO_CARD};
+    vector<HandPot> pots;
+    vector<HandResult> results;             // Seats that won chips
+    vector<HandRunoutEquity> runoutEquities;    // By street, for the all-in EV of a hand that was run out
+
+    // Empties the record, keeping the capacity of its vectors
+    void clear();
+
+    // Adds the contenders' equity before a street, keeping the streets in order
+    void addRunoutEquity(const StreetEquity& equity);
+
+    bool operator==(const HandRecord& other) const;
+} HandRecord;
+
+// Binary hand record encoding, little endian through WireWriter:
+// u32 tableId, u64 handNumber, u64 startTime, u32 smallBlind, u32 bigBlind,
+// u8 numSeats, {u8 position, u8 nameLength, name, u32 startingChips, u8 card, u8 card},
+// u16 numActions, {u8 street, u8 position, u8 type, u32 amount},
+// u8 numBoardCards, {u8 card}, u8 numPots, {u32 chips, u16 eligible}, u8 numResults, {u8 position, u32 chipsWon},
+// u8 numRunoutEquities, {u8 street, u8 position, u16 equity}
+class HandRecordCodec {
+public:
+    // Offsets of the fixed header fields, so records can be filtered without decoding
+    static const size_t TABLE_ID_OFFSET = 0;
+    static const size_t HAND_NUMBER_OFFSET = 4;
+
+    // Returns false if the record doesn't fit in the writer
+    static bool encode(const HandRecord& record, WireWriter& writer);
+
+    // Returns false if the payload is truncated or out of range
+    static bool decode(const uint8_t* payload, size_t size, HandRecord& record);
+};
+
+#endif // HAND_HISTORY_H
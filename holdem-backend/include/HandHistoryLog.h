@@ -0,0 +1,163 @@
+#ifndef HAND_HISTORY_LOG_H
+#define HAND_HISTORY_LOG_H
+
+#include "HandHistory.h"
+#include "MpscQueue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+using namespace std;
+
+// Segment files start with a 16 byte header: u32 magic, u16 version, u16 reserved, u32 segment index, u32 reserved.
+// Records follow back to back: u32 payload size, u32 CRC-32 of the payload, payload (HandRecordCodec).
+const uint32_t HAND_LOG_MAGIC = 0x4C484848; // "HHHL"
+const uint16_t HAND_LOG_VERSION = 2;
+const size_t HAND_LOG_HEADER_SIZE = 16;
+const size_t HAND_LOG_RECORD_HEADER_SIZE = 8;
+
+typedef struct HandHistoryOptions {
+    string directory;
+
+    // A new segment is started once the current one would grow past this
+    size_t segmentSize = 64 * 1024 * 1024;
+
+    // Records are gathered into one write() of up to this many bytes
+    size_t bufferSize = 1024 * 1024;
+
+    // How often written records are fsynced (batched across every table). Zero leaves it to the OS.
+    chrono::milliseconds fsyncInterval = chrono::milliseconds(0);
+} HandHistoryOptions;
+
+// Append-only hand history log shared by any number of tables.
+// append() encodes the record on the caller's thread and queues the bytes. A writer thread
+// batches queued records into large writes, rotates segments and fsyncs on the configured
+// interval, so table threads never block on the disk.
+class HandHistoryWriter {
+private:
+    HandHistoryOptions options;
+
+    // Encoded records waiting for the writer thread
+    MpscQueue<vector<uint8_t>> pending;
+
+    thread writerThread;
+    mutex writerMutex;
+    condition_variable writerCv;
+    condition_variable flushedCv;
+    bool isStopping;
+    bool isClosed;
+
+    // True while the writer thread sleeps with nothing queued
+    atomic<bool> isParked;
+
+    // Appended counts records queued, written counts records handed to the OS
+    atomic<uint64_t> numAppended;
+    atomic<uint64_t> numWritten;
+    atomic<uint64_t> numDropped;
+    uint64_t numSynced;
+    uint64_t syncTarget;
+
+    // Records lost to failed writes (writer thread only)
+    uint64_t numFailed;
+
+    // Writer thread state
+    int fd;
+    atomic<uint32_t> segmentIndex;
+    size_t segmentOffset;
+    vector<uint8_t> buffer;
+    size_t numBuffered;
+    chrono::steady_clock::time_point lastSync;
+
+    // Writer thread main loop
+    void writerLoop();
+
+    // Copies a record into the write buffer, writing and rotating segments as needed
+    void bufferRecord(const vector<uint8_t>& record);
+
+    // Writes out the buffer
+    void writeBuffer();
+
+    // Fsyncs the current segment
+    void syncSegment();
+
+    // Opens a new segment, then closes the current one
+    void openSegment(uint32_t index);
+
+    // Writes all of data to the current segment, throws on failure
+    void writeAll(const uint8_t* data, size_t size);
+
+public:
+    // Starts a new segment after any already in the directory.
+    // Throws runtime_error if the directory can't be written.
+    explicit HandHistoryWriter(const HandHistoryOptions& options);
+    ~HandHistoryWriter();
+
+    HandHistoryWriter(const HandHistoryWriter&) = delete;
+    HandHistoryWriter& operator=(const HandHistoryWriter&) = delete;
+
+    // Queues a record. Safe to call from any thread.
+    // Returns false (and drops the record) if it is larger than MAX_HAND_RECORD_SIZE.
+    // Records that fail to write are dropped too, both count towards getNumDropped.
+    bool append(const HandRecord& record);
+
+    // Blocks until every record appended so far is written and fsynced
+    void flush();
+
+    // Writes everything still queued and stops the writer thread
+    void close();
+
+    uint64_t getNumAppended() const;
+    uint64_t getNumWritten() const;
+    uint64_t getNumDropped() const;
+    uint32_t getSegmentIndex() const;
+};
+
+// A record inside a mapped segment. Points into the mapping, nothing is copied.
+typedef struct HandRecordView {
+    const uint8_t* payload = nullptr;
+    size_t size = 0;
+
+    uint32_t getTableId() const;
+    uint64_t getHandNumber() const;
+
+    // Decodes the whole record, returns false if it is malformed
+    bool decode(HandRecord& record) const;
+} HandRecordView;
+
+// Maps a single segment read only and iterates its records in place.
+// Iteration stops at the first torn or corrupt record, e.g. the tail of a segment
+// that was being written when the process died.
+class HandHistoryReader {
+private:
+    int fd;
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+    uint32_t segmentIndex;
+    bool isCorrupt;
+
+public:
+    // Throws runtime_error if the file can't be mapped or isn't a hand history segment
+    explicit HandHistoryReader(const string& path);
+    ~HandHistoryReader();
+
+    HandHistoryReader(const HandHistoryReader&) = delete;
+    HandHistoryReader& operator=(const HandHistoryReader&) = delete;
+
+    // Moves to the next record. Returns false at the end of the segment.
+    bool next(HandRecordView& view);
+
+    // Returns true if iteration ended early at a torn or corrupt record
+    bool isTruncated() const;
+
+    uint32_t getSegmentIndex() const;
+
+    // Returns the segment paths in a directory, oldest first
+    static vector<string> listSegments(const string& directory);
+
+    // Returns the file name of a segment
+    static string getSegmentName(uint32_t index);
+};
+
+#endif // HAND_HISTORY_LOG_H
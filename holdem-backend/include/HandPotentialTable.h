@@ -0,0 +1,87 @@
+#ifndef HAND_POTENTIAL_TABLE_H
+#define HAND_POTENTIAL_TABLE_H
+
+#include "BoardClass.h"
+#include "MappedTable.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+const uint32_t HAND_POTENTIAL_TABLE_MAGIC = 0x544F5048; // "HPOT"
+const uint16_t HAND_POTENTIAL_TABLE_VERSION = 1;
+const size_t HAND_POTENTIAL_TABLE_HEADER_SIZE = MAPPED_TABLE_HEADER_SIZE;
+const uint16_t HAND_POTENTIAL_TABLE_HAS_TURN = 1;
+
+// Fractions are stored as 0 to HAND_POTENTIAL_SCALE, entries not computed as all ones
+const uint16_t HAND_POTENTIAL_SCALE = 65534;
+const uint16_t HAND_POTENTIAL_UNKNOWN = 65535;
+
+// How a hole card pair stands against one random opponent now and how that may change as
+// the rest of the board comes (Billings et al.'s hand potential)
+typedef struct HandPotential {
+    bool isKnown;
+    double strength;        // HS: combos beaten now, a tie counting as half
+    double positive;        // PPot: chance of ending ahead when behind now (ties weighted half)
+    double negative;        // NPot: chance of ending behind when ahead now (ties weighted half)
+    double effective;       // EHS: HS * (1 - NPot) + (1 - HS) * PPot
+
+    HandPotential();
+} HandPotential;
+
+typedef struct HandPotentialOptions {
+    int numThreads;
+    bool includeTurn;           // Also write the turn classes (110MB)
+    vector<uint64_t> boards;    // Only compute the classes of these flops and turns, all when empty
+
+    HandPotentialOptions();
+} HandPotentialOptions;
+
+// Hand potential on the flop and turn, generated offline and mapped read-only at startup.
+// The flop looks two cards ahead against every opponent combo, about 1M pairs of board and
+// opponent per hand, so it is never worked out at a table.
+//
+// Entries are keyed by the BoardClass of the board and the hole cards renamed the same way,
+// so every board of a class shares its representative's entries. A class has one slot per
+// pair of the cards left (C(49, 2) on the flop, C(48, 2) on the turn), the pair's colex rank
+// once the board cards are taken out of the deck, and a slot holds HS, PPot and NPot as
+// three u16s. A lookup is a canonicalization and one read.
+//
+// The file is a MappedTable header (the sizes are the flop and turn class counts) followed
+// by the flop classes, then optionally the turn classes, in host (little endian) order.
+class HandPotentialTable {
+private:
+    MappedTable mapping;
+    const uint16_t* flopEntries;
+    const uint16_t* turnEntries;
+
+    void close();
+
+public:
+    HandPotentialTable();
+    ~HandPotentialTable();
+    HandPotentialTable(const HandPotentialTable&) = delete;
+    HandPotentialTable& operator=(const HandPotentialTable&) = delete;
+
+    // Maps a table file, returning false if it is missing, another version or corrupt
+    bool open(const string& path);
+
+    bool isOpen() const;
+    bool hasTurn() const;
+
+    // Hand potential of hole cards on a flop or turn, not known when its class wasn't
+    // generated. Throws if the table isn't open or the cards can't be dealt.
+    HandPotential lookup(uint64_t hole, uint64_t board) const;
+    HandPotential lookup(const vector<Card>& hole, const vector<Card>& board) const;
+
+    // Works hand potential out directly, enumerating every opponent and runout
+    static HandPotential compute(uint64_t hole, uint64_t board);
+
+    // Parses cards written rank then suit, e.g. "Th4hKs"
+    static uint64_t parseCards(const string& text);
+
+    // Computes every class (or those of the listed boards) across threads, all hole card
+    // pairs of a class at once, then writes the table to a file
+    static bool generate(const string& path, const HandPotentialOptions& options);
+};
+
+#endif // HAND_POTENTIAL_TABLE_H
@@ -0,0 +1,62 @@
+#ifndef HAND_RANGE_H
+#define HAND_RANGE_H
+
+#include "HandRank.h"
+#include <array>
+#include <bitset>
+#include <string>
+using namespace std;
+
+// Number of two card combos in a deck, C(52, 2)
+const int NUM_COMBOS = 1326;
+const uint8_t FULL_WEIGHT = 100;
+
+// A weighted set of hole card combos. Combo i is the two card mask with colex index i
+// (cards b < a have index a * (a - 1) / 2 + b), and carries a weight in whole percent.
+// Card removal is a masked operation: each card has the bitset of combos holding it.
+//
+// Ranges are parsed from comma separated tokens, each optionally prefixed by a weight:
+//   "QQ+, 22-55, AKs, AQo, KT+, A2s+, KTs-K7s, AhKh, 50% AJo"
+class HandRange {
+private:
+    bitset<NUM_COMBOS> combos;
+    array<uint8_t, NUM_COMBOS> weights;
+
+    // Adds a token without its weight, e.g. "A2s+"
+    void addToken(const string& token, uint8_t weight);
+
+    // Adds the combos of two ranks (indices 0 to 12), any, suited ('s') or offsuit ('o')
+    void addHand(int first, int second, char suitedness, uint8_t weight);
+
+public:
+    HandRange();
+
+    // Parses a range, throwing on a malformed token
+    static HandRange parse(const string& text);
+
+    // Every combo at full weight, e.g. an unknown opponent
+    static HandRange createFull();
+
+    void addCombo(int combo, uint8_t weight = FULL_WEIGHT);
+
+    // Removes every combo holding one of the cards
+    void removeCards(uint64_t cards);
+
+    // Returns the combos that don't hold any of the cards
+    bitset<NUM_COMBOS> getLiveCombos(uint64_t cards) const;
+
+    bool contains(int combo) const;
+    uint8_t getWeight(int combo) const;
+    const bitset<NUM_COMBOS>& getCombos() const;
+    size_t size() const;
+    bool isEmpty() const;
+
+    // Converts between a combo index and its two card mask
+    static int getComboIndex(uint64_t cards);
+    static uint64_t getComboMask(int combo);
+
+    // Returns the combos holding a card (bit index in the mask layout)
+    static const bitset<NUM_COMBOS>& getCombosWithCard(int card);
+};
+
+#endif // HAND_RANGE_H
@@ -0,0 +1,38 @@
+#ifndef HAND_RANK_H
+#define HAND_RANK_H
+
+#include "Card.h"
+#include "HandEvaluator.h"
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+// Card masks use the PokerHand::bitwise layout: bit suit * 13 + (value - 2)
+const uint64_t FULL_DECK_MASK = (1ULL << 52) - 1;
+
+// Number of bits the category is shifted by in a rank
+const int HAND_RANK_CATEGORY_SHIFT = 26;
+
+// Branch-light evaluator working straight on card masks. A rank orders hands by strength
+// (higher is stronger, equal ranks split the pot) and holds the HandCategory in its top bits.
+// Below the category, ranks compare the cards that matter as 13 bit rank masks, e.g. the pair
+// then the three kickers for one pair. Any 0 to 7 cards can be ranked, fewer than five simply
+// have fewer kickers and can't make straights or flushes.
+//
+// Tables are built once at startup, evaluate allocates nothing and is safe from any thread.
+class HandRank {
+public:
+    // Ranks the best five card hand among the cards in a mask
+    static uint32_t evaluate(uint64_t cards);
+
+    // Returns the category of a rank (ROYAL_FLUSH for an ace high straight flush)
+    static HandCategory getCategory(uint32_t rank);
+
+    // Returns the mask of a set of cards
+    static uint64_t getMask(const vector<Card>& cards);
+
+    // Returns the number of cards in a mask
+    static int countCards(uint64_t cards);
+};
+
+#endif // HAND_RANK_H
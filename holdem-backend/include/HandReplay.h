@@ -0,0 +1,64 @@
+#ifndef HAND_REPLAY_H
+#define HAND_REPLAY_H
+
+#include "GameController.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+// Everything needed to re-drive a session of hands through GameController
+typedef struct ReplayLog {
+    uint64_t seed = 0;
+    size_t smallBlind = 0;
+    size_t bigBlind = 0;
+
+    // Names and chips in the order the players were added to the game
+    vector<pair<string, size_t>> players;
+
+    // Every decision in order, hand after hand. Blinds are posted by the engine.
+    vector<HandAction> actions;
+} ReplayLog;
+
+enum ReplayMode {
+    REPLAY_FULL,            // Keeps the record of every hand
+    REPLAY_FAST_FORWARD     // Keeps only the chip counts
+};
+
+typedef struct ReplayResult {
+    // An action was not allowed, or was logged for another player or street
+    bool isDiverged = false;
+
+    // The log ended in the middle of a hand
+    bool isTruncated = false;
+
+    size_t numHands = 0;
+    size_t numActions = 0;
+
+    // Chips of each player after the last complete hand, in the order of the log
+    vector<size_t> finalChips;
+
+    // Running hash of every player's chips after every hand, to compare replays at a glance
+    uint64_t chipDigest = 0;
+
+    // Records of the complete hands in full mode
+    vector<HandRecord> hands;
+} ReplayResult;
+
+// Re-executes logged sessions. The deck is seeded from the log, so the same log always
+// deals the same cards and ends with the same chips. Nothing is written to the console.
+class ReplayEngine {
+private:
+    // Folds the chip counts of every player into the digest
+    static uint64_t updateDigest(uint64_t digest, const vector<shared_ptr<Player>>& players);
+
+public:
+    static ReplayResult replay(const ReplayLog& log, ReplayMode mode = REPLAY_FULL);
+
+    // Appends the decisions of a completed hand to a log
+    static void appendHand(const HandRecord& hand, ReplayLog& log);
+
+    // Maps a logged action type back onto the client action that produced it
+    static ActionType getClientActionType(const HandAction& action, const vector<PossibleAction>& possibleActions);
+};
+
+#endif // HAND_REPLAY_H
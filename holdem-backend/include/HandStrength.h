@@ -0,0 +1,53 @@
+#ifndef HAND_STRENGTH_H
+#define HAND_STRENGTH_H
+
+#include "HandRange.h"
+#include <vector>
+using namespace std;
+
+// How a hole card pair stands against every opponent combo that can be dealt
+typedef struct HandStrengthResult {
+    int numCombos;      // Opponent combos holding neither a board nor a hole card
+    int wins;           // Combos the pair beats
+    int ties;
+    int losses;
+
+    HandStrengthResult();
+
+    double getWinFraction() const;
+    double getTieFraction() const;
+    double getLossFraction() const;
+
+    // Percentile of the pair among the combos, a tie counting as half
+    double getStrength() const;
+} HandStrengthResult;
+
+// Hand strength of any hole card pair on one flop, turn or river. Every combo is ranked with
+// the board once, when the object is built (at most 1176 evaluations), and kept as its place
+// in the ranking: how many combos rank below it and how many rank the same. A query then
+// reads its own place and corrects it for the at most 95 combos sharing a hole card, so it
+// costs well under a microsecond and allocates nothing.
+//
+// Build one per board and share it with every player and query on that board. The strength
+// of a pair is unchanged by renaming suits, so a BoardClassCache<HandStrength> built on class
+// representatives serves any board once the hole cards are renamed with CanonicalBoard::apply.
+class HandStrength {
+private:
+    uint64_t board;
+    int numCombos;                  // Combos holding no board card
+
+    // By combo index, 0 for combos holding a board card
+    vector<uint16_t> numBelow;      // Combos ranked below it
+    vector<uint16_t> numSame;       // Combos ranked the same, itself included
+
+public:
+    // Ranks every combo with a 3 to 5 card board, throwing on any other size
+    explicit HandStrength(uint64_t board);
+
+    // Strength of a hole card pair, throwing if it isn't two cards off the board
+    HandStrengthResult getStrength(uint64_t hole) const;
+
+    uint64_t getBoard() const;
+};
+
+#endif // HAND_STRENGTH_H
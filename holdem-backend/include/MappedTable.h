@@ -0,0 +1,58 @@
+#ifndef MAPPED_TABLE_H
+#define MAPPED_TABLE_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Precomputed table files start with a header of this size
+const size_t MAPPED_TABLE_HEADER_SIZE = 32;
+
+// Header of a precomputed table file: u32 magic, u16 version, u16 flags, two u32 sizes
+// whose meaning is up to the table, a crc32 of everything after the header, then zeros
+typedef struct MappedTableHeader {
+    uint32_t magic = 0;
+    uint16_t version = 0;
+    uint16_t flags = 0;
+    array<uint32_t, 2> sizes = {0, 0};
+    uint32_t crc = 0;
+} MappedTableHeader;
+
+// A precomputed table file mapped read-only. Opening checks the header and the crc of the
+// body, so the tables built on it only have to check their own sizes.
+class MappedTable {
+private:
+    const uint8_t* mapping;
+    size_t mappingSize;
+    MappedTableHeader header;
+
+public:
+    MappedTable();
+    ~MappedTable();
+    MappedTable(const MappedTable&) = delete;
+    MappedTable& operator=(const MappedTable&) = delete;
+
+    // Maps a file with this magic and version whose header and body size pass isValid and
+    // whose body matches its crc. Returns false, leaving it closed, if it is missing or any
+    // of those checks fail.
+    bool open(const string& path, uint32_t magic, uint16_t version,
+              const function<bool(const MappedTableHeader&, size_t)>& isValid);
+
+    void close();
+    bool isOpen() const;
+
+    const MappedTableHeader& getHeader() const;
+
+    // Returns what follows the header
+    const uint8_t* getBody() const;
+    size_t getBodySize() const;
+
+    // Writes header, with the crc of the body, over the first MAPPED_TABLE_HEADER_SIZE
+    // bytes of file and then replaces the file at path with it
+    static bool write(const string& path, MappedTableHeader header, vector<uint8_t>& file);
+};
+
+#endif // MAPPED_TABLE_H
@@ -0,0 +1,75 @@
+#ifndef MONTE_CARLO_EQUITY_H
+#define MONTE_CARLO_EQUITY_H
+
+#include "Equity.h"
+#include "HandRange.h"
+#include "Player.h"
+#include <chrono>
+#include <memory>
+using namespace std;
+
+// Runouts sampled and scored together by a worker between checks of the stopping rules
+const int MONTE_CARLO_BATCH_SIZE = 1024;
+
+typedef struct MonteCarloOptions {
+    int numThreads;                     // Workers, each drawing from its own RNG stream
+    uint64_t seed;                      // Seeds every stream, so a run can be repeated
+    double targetError;                 // Stop once every hand's standard error is below this (0 to ignore)
+    chrono::microseconds timeBudget;    // Stop once this much time has passed (0 to ignore)
+    uint64_t maxSamples;                // Stop after this many runouts regardless
+
+    MonteCarloOptions();
+} MonteCarloOptions;
+
+typedef struct MonteCarloResult {
+    EquityResult tally;                 // Sampled runouts, counted like an exact enumeration
+    vector<double> squaredShares;       // Sum of each hand's squared pot share per runout
+    chrono::microseconds elapsed;
+
+    MonteCarloResult();
+    explicit MonteCarloResult(size_t numHands);
+
+    void merge(const MonteCarloResult& other);
+
+    // Standard error of a hand's equity estimate
+    double getStandardError(size_t hand) const;
+
+    // Largest standard error of any hand
+    double getMaxStandardError() const;
+} MonteCarloResult;
+
+// Where a hand's hole cards come from in each sample: known, dealt from the deck (no mask
+// and no combos) or drawn from a range by weight
+typedef struct HandSource {
+    uint64_t known;
+    vector<uint64_t> combos;
+    vector<uint32_t> cumulativeWeights;
+} HandSource;
+
+// Estimates multiway equity by sampling runouts when there are too many hands to enumerate.
+// A player without hole cards is an unknown opponent whose cards are dealt at random in
+// every sample. Ranges are drawn from by weight, redrawing when their combos clash.
+// Workers deal batches of runouts, rank them with HandRank, then fold the batch into the
+// shared result and check whether the error target or time budget is met.
+class MonteCarloEquity {
+private:
+    // Runs the workers over the hands, dealt being every card known up front
+    static MonteCarloResult sample(const vector<HandSource>& sources, uint64_t board, uint64_t dealt,
+                                   const MonteCarloOptions& options);
+
+public:
+    // Equity of each player (in order) given the board, the way HandEvaluator::populatePlayerHandsMap takes them
+    static MonteCarloResult compute(const vector<shared_ptr<Player>>& players, const vector<Card>& board,
+                                    const MonteCarloOptions& options = MonteCarloOptions());
+
+    // Equity of hole card masks, an empty mask being an unknown hand, given a board mask
+    static MonteCarloResult compute(const vector<uint64_t>& hands, uint64_t board,
+                                    const MonteCarloOptions& options = MonteCarloOptions());
+
+    // Equity of weighted ranges given a board mask, each sample weighing range combos by
+    // their weight and leaving out those that clash with the board or each other
+    static MonteCarloResult compute(const vector<HandRange>& ranges, uint64_t board,
+                                    const MonteCarloOptions& options = MonteCarloOptions());
+};
+
+#endif // MONTE_CARLO_EQUITY_H
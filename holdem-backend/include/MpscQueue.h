@@ -0,0 +1,69 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <utility>
+using namespace std;
+
+// Unbounded lock-free multi-producer single-consumer queue (Vyukov style).
+// Any thread may push. Only the owning consumer may pop or check empty.
+template <typename T>
+class MpscQueue {
+private:
+    struct Node {
+        atomic<Node*> next;
+        T value;
+
+        Node() : next(nullptr), value() {}
+        explicit Node(T&& v) : next(nullptr), value(std::move(v)) {}
+    };
+
+    // Producers swap themselves in at the head
+    atomic<Node*> head;
+
+    // Consumer owned stub node, the next node holds the oldest value
+    Node* tail;
+
+public:
+    MpscQueue() {
+        Node* stub = new Node();
+        head.store(stub);
+        tail = stub;
+    }
+
+    ~MpscQueue() {
+        T discard;
+        while (pop(discard)) {}
+        delete tail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Appends a value. Wait-free for producers.
+    void push(T value) {
+        Node* node = new Node(std::move(value));
+        Node* prev = head.exchange(node);
+        prev->next.store(node);
+    }
+
+    // Removes the oldest value into out. Returns false if the queue is empty.
+    // A push that has swapped the head but not yet linked is treated as empty,
+    // the producer is responsible for rescheduling the consumer afterwards.
+    bool pop(T& out) {
+        Node* next = tail->next.load();
+        if (next == nullptr) return false;
+
+        out = std::move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+    // Consumer side check for pending values
+    bool empty() const {
+        return tail->next.load() == nullptr;
+    }
+};
+
+#endif // MPSC_QUEUE_H
@@ -0,0 +1,31 @@
+#ifndef OUTS_H
+#define OUTS_H
+
+#include "Equity.h"
+using namespace std;
+
+typedef struct OutsResult {
+    int numHands;
+    uint64_t remaining;                 // Cards that can still come next
+    uint16_t leaders;                   // Hands leading or tied for the lead on the board now, by bit
+    uint64_t outs[MAX_EQUITY_HANDS];    // Next cards taking each trailing hand to the lead or a tie
+
+    OutsResult();
+
+    bool isLeading(int hand) const;
+    int getNumOuts(int hand) const;
+} OutsResult;
+
+// Outs of every hand in a pot on the flop or turn: the cards which, dealt next, leave a hand
+// that is behind now ranked first or level first. Hands are ranked with HandRank on each of
+// the (at most 47) cards left, so a result costs under 500 evaluations and nothing is
+// allocated. Leading hands have no outs, the cards that beat them are the others' outs.
+class Outs {
+public:
+    // Outs of 2 to MAX_EQUITY_HANDS hole card masks given a 3 or 4 card board mask. Dead
+    // cards (e.g. folded hands that were shown) can't come next.
+    // Throws if a hand is not two cards, the board is not a flop or turn or cards are shared.
+    static OutsResult compute(const vector<uint64_t>& hands, uint64_t board, uint64_t dead = 0);
+};
+
+#endif // OUTS_H
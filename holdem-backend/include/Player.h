@@ -5,6 +5,7 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include <memory>
 using namespace std;
 
 enum class Position {
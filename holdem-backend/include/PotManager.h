@@ -23,6 +23,8 @@ typedef struct Pot {
     bool isPlayerInPot(const shared_ptr<Player>& player);
 } Pot;
 
+class TableSnapshot;
+
 class PotManager {
 private:
     // Vector of all pots
@@ -46,6 +48,9 @@ private:
     // Helper function to find the minimum bet of all players.
     size_t findMinBet() const;
 
+
+    // Saves and restores the private state
+    friend class TableSnapshot;
 public:
     // Initalises a single pot.
     PotManager();
@@ -0,0 +1,84 @@
+#ifndef PREFLOP_EQUITY_TABLE_H
+#define PREFLOP_EQUITY_TABLE_H
+
+#include "HandRange.h"
+#include "MappedTable.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+const uint32_t PREFLOP_TABLE_MAGIC = 0x51454650; // "PFEQ"
+const uint16_t PREFLOP_TABLE_VERSION = 1;
+const size_t PREFLOP_TABLE_HEADER_SIZE = MAPPED_TABLE_HEADER_SIZE;
+const uint16_t PREFLOP_TABLE_HAS_COMBOS = 1;
+
+// Starting hands up to suits: 13 pairs, 78 suited and 78 offsuit hands
+const int NUM_STARTING_HANDS = 169;
+
+typedef struct PreflopTableOptions {
+    int numThreads;
+    bool includeCombos;             // Also write the 1326 x 1326 combo matrix (7MB)
+    vector<int> startingHands;      // Only compute matchups among these, all when empty
+
+    PreflopTableOptions();
+} PreflopTableOptions;
+
+// Heads-up preflop all-in equity, generated offline and mapped read-only at startup.
+//
+// The file is a MappedTable header (the sizes are the starting hand and combo counts)
+// followed by 169 x 169 floats, the equity of the row starting hand against the
+// column one averaged over the combo pairs that don't share a card, then optionally
+// 1326 x 1326 floats for every combo pair. Floats are in host (little endian) order and
+// entries that weren't computed, or whose combos share a card, are NaN.
+//
+// Starting hand i * 13 + j (rank indices, ace 12) is the pair when i == j, suited when
+// i > j and offsuit when i < j.
+class PreflopEquityTable {
+private:
+    MappedTable mapping;
+    const float* startingHandEquities;
+    const float* comboEquities;
+    vector<float> startingHandStrengths;
+
+    void close();
+
+    // Averages each starting hand's equities over every opponent combo it can face
+    void computeStrengths();
+
+public:
+    PreflopEquityTable();
+    ~PreflopEquityTable();
+    PreflopEquityTable(const PreflopEquityTable&) = delete;
+    PreflopEquityTable& operator=(const PreflopEquityTable&) = delete;
+
+    // Maps a table file, returning false if it is missing, another version or corrupt
+    bool open(const string& path);
+
+    bool isOpen() const;
+    bool hasCombos() const;
+
+    // Equity of the first combo against the second, from the combo matrix when there is
+    // one and the starting hand matrix otherwise
+    float getEquity(int firstCombo, int secondCombo) const;
+
+    // Equity of the first starting hand against the second
+    float getStartingHandEquity(int first, int second) const;
+
+    // Equity of a starting hand against one random hand, NaN if a matchup it needs wasn't
+    // generated. Worked out when the table is opened, so preflop hands have a strength
+    // even though HandEvaluator can't rank fewer than five cards.
+    float getStartingHandStrength(int startingHand) const;
+
+    // Returns the starting hand of a combo
+    static int getStartingHand(int combo);
+
+    // Returns the name of a starting hand, e.g. "AKs", and the other way round
+    static string getStartingHandName(int startingHand);
+    static int parseStartingHand(const string& name);
+
+    // Computes the tables with every distinct matchup (up to suits and seat order)
+    // enumerated once across threads, then writes them to a file
+    static bool generate(const string& path, const PreflopTableOptions& options);
+};
+
+#endif // PREFLOP_EQUITY_TABLE_H
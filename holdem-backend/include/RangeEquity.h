@@ -0,0 +1,41 @@
+#ifndef RANGE_EQUITY_H
+#define RANGE_EQUITY_H
+
+#include "MonteCarloEquity.h"
+using namespace std;
+
+typedef struct RangeEquityOptions {
+    MonteCarloOptions sampling;     // Used when the ranges are sampled, numThreads for both
+    uint64_t maxExactWork;          // Runouts times combo pairs above which ranges are sampled
+
+    RangeEquityOptions();
+} RangeEquityOptions;
+
+typedef struct RangeEquityResult {
+    EquityResult tally;             // Exact: runouts weighted by both combo weights. Sampled: samples.
+    vector<double> standardErrors;  // Zero when exact
+    bool isExact;
+    chrono::microseconds elapsed;
+
+    RangeEquityResult();
+} RangeEquityResult;
+
+// Equity between weighted ranges. Two ranges are enumerated exactly when the runouts times
+// the live combo pairs are few enough (river, turn and most flops); anything else is
+// sampled with MonteCarloEquity. Combos that clash with the board are masked out up front.
+class RangeEquity {
+public:
+    static RangeEquityResult compute(const vector<HandRange>& ranges, const vector<Card>& board,
+                                     const RangeEquityOptions& options = RangeEquityOptions());
+    static RangeEquityResult compute(const vector<HandRange>& ranges, uint64_t board,
+                                     const RangeEquityOptions& options = RangeEquityOptions());
+
+    // Exact equity of two ranges, ranking each live combo once per runout then scoring
+    // every pair of combos that don't share a card
+    static EquityResult computeExact(const HandRange& first, const HandRange& second, uint64_t board, int numThreads = 1);
+
+    // Returns the runouts times live combo pairs an exact computation would score
+    static uint64_t estimateExactWork(const HandRange& first, const HandRange& second, uint64_t board);
+};
+
+#endif // RANGE_EQUITY_H
@@ -0,0 +1,122 @@
+#ifndef RUNOUT_EQUITY_H
+#define RUNOUT_EQUITY_H
+
+#include "MonteCarloEquity.h"
+#include "PreflopEquityTable.h"
+#include "StreetState.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+using namespace std;
+
+const chrono::microseconds DEFAULT_RUNOUT_EQUITY_BUDGET(2000);
+
+// Runouts (times contenders) an exact enumeration may rank within the budget. Every flop
+// and turn fits, while a preflop all-in (1.7M runouts heads-up) is sampled instead.
+const uint64_t MAX_EXACT_RUNOUT_WORK = 200000;
+
+typedef struct RunoutEquityOptions {
+    chrono::microseconds budget;    // Time a sampled estimate may take
+    uint64_t seed;                  // Seeds sampled estimates, so a table's numbers can be repeated
+
+    // Heads-up preflop all-ins are read from this table when it has the matchup (optional)
+    const PreflopEquityTable* preflopTable;
+
+    // Leaves everything the preflop table can't answer to whoever takes the jobs (e.g. a table
+    // handing them to a RunoutEquityWorker) instead of working it out on the calling thread
+    bool isDeferred;
+
+    RunoutEquityOptions();
+} RunoutEquityOptions;
+
+// How the contenders of an all-in pot stand before a street is dealt
+typedef struct StreetEquity {
+    uint64_t handNumber;            // Hand of the game it belongs to
+    Street street;                  // Street about to be dealt
+    vector<uint8_t> positions;      // Contenders, in the order of the tally
+    EquityResult tally;             // Empty when read from the preflop table, which only keeps equity
+    vector<double> equities;        // Share of the pot each contender wins on average
+    bool isExact;
+    bool isPending;                 // Deferred and not attached yet, only the hand, street and positions are filled in
+    chrono::microseconds elapsed;
+
+    StreetEquity();
+} StreetEquity;
+
+// A deferred runout, worked out off the table thread
+typedef struct RunoutJob {
+    uint64_t handNumber;
+    Street street;
+    vector<uint8_t> positions;
+    vector<uint64_t> hands;
+    uint64_t board;
+    RunoutEquityOptions options;
+
+    RunoutJob();
+} RunoutJob;
+
+// Win and tie chances of all-in contenders as the remaining streets are run out.
+// Runouts are enumerated exactly when there are few enough to rank within the budget
+// (from the flop on), otherwise they are sampled until the budget is spent. A heads-up
+// preflop all-in is one read of the preflop table when there is one.
+class RunoutEquity {
+public:
+    static StreetEquity compute(const vector<shared_ptr<Player>>& contenders, const vector<Card>& board, Street street,
+                                const RunoutEquityOptions& options = RunoutEquityOptions());
+
+    // Describes the runout of the contenders' hands from a board, with no hand number
+    static RunoutJob createJob(const vector<shared_ptr<Player>>& contenders, const vector<Card>& board, Street street,
+                               const RunoutEquityOptions& options);
+
+    // Works a deferred runout out on the calling thread
+    static StreetEquity compute(const RunoutJob& job);
+
+    // Fills equity in from the preflop table, returning false unless it is a heads-up preflop
+    // all-in whose matchup the table has
+    static bool lookup(const RunoutJob& job, StreetEquity& equity);
+};
+
+// Background threads that work deferred runouts out for tables, so a sampled preflop all-in
+// never holds up a table's worker. Results are handed to a callback, which should only post
+// them back to the table.
+class RunoutEquityWorker {
+private:
+    typedef struct QueuedJob {
+        const void* owner;
+        RunoutJob job;
+        function<void(StreetEquity)> done;
+    } QueuedJob;
+
+    vector<thread> threads;
+    mutex jobsMutex;
+    condition_variable jobsCv;
+    deque<QueuedJob> jobs;
+    bool isStopping;
+
+    // Owner of the job each thread is working on, cleared if the owner cancels it
+    vector<const void*> runningOwners;
+
+    // Thread main loop
+    void workerLoop(size_t threadIndex);
+
+public:
+    explicit RunoutEquityWorker(size_t numThreads = 1);
+    ~RunoutEquityWorker();
+
+    RunoutEquityWorker(const RunoutEquityWorker&) = delete;
+    RunoutEquityWorker& operator=(const RunoutEquityWorker&) = delete;
+
+    // Queues a job. done runs on a worker thread with the result unless owner cancels first.
+    // Safe to call from any thread.
+    void submit(const void* owner, RunoutJob job, function<void(StreetEquity)> done);
+
+    // Drops an owner's jobs. None of their callbacks runs once this returns.
+    void cancel(const void* owner);
+
+    // Drops every queued job and joins the threads
+    void stop();
+};
+
+#endif // RUNOUT_EQUITY_H
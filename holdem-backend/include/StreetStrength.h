@@ -0,0 +1,39 @@
+#ifndef STREET_STRENGTH_H
+#define STREET_STRENGTH_H
+
+#include "HandPotentialTable.h"
+#include "HandStrength.h"
+#include "PreflopEquityTable.h"
+using namespace std;
+
+// River classes whose HandStrength is kept, about 5KB each
+const size_t DEFAULT_RIVER_STRENGTH_CACHE_SIZE = 4096;
+
+// Strength and potential of hole cards on any street from precomputed tables, for states
+// HandEvaluator can't rank (fewer than five cards) as well as complete ones:
+//   - preflop: the starting hand's equity against one random hand, from the 169 strengths
+//     of the PreflopEquityTable, with no potential as the whole board is still to come
+//   - flop and turn: HS, PPot, NPot and EHS from the HandPotentialTable
+//   - river: HS from a HandStrength shared per board class, with nothing left to come
+// Every query is a table read, apart from rivers whose class isn't among the most recently
+// used, which are ranked (about 30us). There are 134,459 river classes, so only a bounded
+// number of them are kept.
+// Missing tables or entries give a HandPotential that isn't known.
+class StreetStrength {
+private:
+    const PreflopEquityTable& preflopTable;
+    const HandPotentialTable& potentialTable;
+    BoardClassCache<HandStrength> riverStrengths;
+
+public:
+    // The tables are opened by the caller and must outlive this
+    StreetStrength(const PreflopEquityTable& preflopTable, const HandPotentialTable& potentialTable,
+                   size_t riverCacheSize = DEFAULT_RIVER_STRENGTH_CACHE_SIZE);
+
+    // Strength of two hole cards with 0, 3, 4 or 5 board cards, throwing on any other board
+    // size or if a card is dealt twice
+    HandPotential lookup(uint64_t hole, uint64_t board);
+    HandPotential lookup(const vector<Card>& hole, const vector<Card>& board);
+};
+
+#endif // STREET_STRENGTH_H
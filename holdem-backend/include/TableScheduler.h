@@ -0,0 +1,201 @@
+#ifndef TABLE_SCHEDULER_H
+#define TABLE_SCHEDULER_H
+
+#include "Action.h"
+#include "MpscQueue.h"
+#include "TimerWheel.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+class TableScheduler;
+struct StreetEquity;
+
+// Resolution of table timers
+const chrono::milliseconds TIMER_TICK(10);
+
+// Where a command entered the process
+enum CommandSource {
+    NETWORK,
+    TIMER,
+    BOT,
+    LOG_WRITER,     // The action log's writer thread
+    RUNOUT_WORKER   // A RunoutEquityWorker thread
+};
+
+enum CommandType {
+    PLAYER_ACTION,
+    JOIN_TABLE,     // Sit down with amount chips under playerName
+    LEAVE_TABLE,    // Stand up (folds when it is the client's turn)
+    ACTION_TIMEOUT, // A decision clock ran out (TIMER)
+    LOG_DURABLE,    // Every record up to logSequence is durable (LOG_WRITER)
+    LOG_FAILED,     // The action log failed before logSequence was durable (LOG_WRITER)
+    RUNOUT_EQUITY   // A deferred runout was worked out (RUNOUT_WORKER)
+};
+
+// A single player command addressed to a table
+typedef struct TableCommand {
+    CommandType type = PLAYER_ACTION;
+    CommandSource source = NETWORK;
+    int seat = -1;                      // Position of the acting player
+    ActionType action = INVALID_ACTION;
+    size_t amount = 0;
+    uint64_t clientId = 0;              // Connection the command came from (NETWORK)
+    uint64_t decisionId = 0;            // Decision a clock belongs to (TIMER)
+    uint64_t logSequence = 0;           // Log record a durability notice is for (LOG_WRITER)
+    string playerName;
+    shared_ptr<const StreetEquity> runoutEquity;    // (RUNOUT_WORKER)
+} TableCommand;
+
+// A table actor owns its game state and is only ever run by one worker at a time.
+// Producers post commands into the inbox, the scheduler runs the table when it has mail.
+class TableActor {
+private:
+    friend class TableScheduler;
+
+    MpscQueue<TableCommand> inbox;
+
+    // Commands posted and not yet handled. The table sits in the run queue or is being run
+    // by a worker while this is non-zero, and only that worker touches the inbox's consumer side.
+    atomic<size_t> numPending;
+
+    TableScheduler* scheduler;
+
+    // Worker whose timer wheel holds this table's timers
+    size_t timerShard;
+
+public:
+    TableActor();
+    virtual ~TableActor() {}
+
+    // Applies a single command to the table state.
+    // Always called from a worker thread, never concurrently for the same table.
+    virtual void handleCommand(const TableCommand& command) = 0;
+
+    // Posts a command to this table's scheduler.
+    // Safe to call from any thread once the table is registered.
+    void post(TableCommand command);
+
+    // Posts a command to this table once delay has passed (at most one TIMER_TICK late).
+    // Returns an id for cancelTimer. Safe to call from any thread once the table is registered.
+    uint64_t postAfter(chrono::milliseconds delay, TableCommand command);
+
+    // Cancels a timer started with postAfter. Cancelling a timer that already fired does nothing,
+    // so a table should still ignore commands from clocks it no longer cares about.
+    void cancelTimer(uint64_t timerId);
+
+    // Returns true once the table has been added to a scheduler
+    bool isRegistered() const;
+};
+
+// Request from a table to its worker's timer wheel
+typedef struct TimerRequest {
+    uint64_t requestId = 0;
+    bool isCancel = false;
+    uint64_t delayTicks = 0;
+    TableActor* table = nullptr;
+    TableCommand command;
+} TimerRequest;
+
+// A timer waiting in a wheel, keyed by request id
+typedef struct ArmedTimer {
+    TimerId timerId = INVALID_TIMER;
+    TableActor* table = nullptr;
+    TableCommand command;
+} ArmedTimer;
+
+// Timers of every table homed on one worker. The wheel is only touched by its worker,
+// tables on other workers hand it requests through the lock-free queue.
+typedef struct WorkerTimers {
+    MpscQueue<TimerRequest> requests;
+    TimerWheel wheel;
+    unordered_map<uint64_t, ArmedTimer> armedTimers;
+    chrono::steady_clock::time_point epoch;
+
+    // True while the worker sleeps without a deadline (no timers armed)
+    atomic<bool> isParked{false};
+} WorkerTimers;
+
+class TableScheduler {
+private:
+    vector<thread> workers;
+    vector<shared_ptr<TableActor>> tables;
+
+    // One timer wheel per worker, shared by every table homed on that worker
+    vector<unique_ptr<WorkerTimers>> workerTimers;
+    atomic<uint64_t> nextTimerId;
+    atomic<size_t> numArmedTimers;
+
+    // Tables with a non-empty inbox waiting for a worker
+    deque<TableActor*> runQueue;
+    mutex runQueueMutex;
+    condition_variable runQueueCv;
+    condition_variable idleCv;
+
+    // Number of tables queued or running
+    size_t numActiveTables;
+    bool isStopping;
+
+    // Maximum commands handled per run so busy tables can't starve others
+    size_t batchSize;
+
+    // Worker thread main loop
+    void workerLoop(size_t workerIndex);
+
+    // Applies queued timer requests to a worker's wheel and posts the commands of expired timers
+    void runTimers(WorkerTimers& timers);
+
+    // Queues a timer request for a table's worker and wakes the worker if it is parked
+    void requestTimer(TableActor& table, TimerRequest request);
+
+    // Drains up to batchSize commands from a table, then reschedules it if more mail arrived
+    void runTable(TableActor* table);
+
+    // Pushes a table onto the run queue and wakes a worker
+    void enqueueTable(TableActor* table);
+
+    // Marks a table run as finished and wakes waiters when the scheduler goes idle
+    void finishTable();
+
+public:
+    explicit TableScheduler(size_t numWorkers = thread::hardware_concurrency(), size_t batchSize = 64);
+    ~TableScheduler();
+
+    TableScheduler(const TableScheduler&) = delete;
+    TableScheduler& operator=(const TableScheduler&) = delete;
+
+    // Takes shared ownership of a table so commands can be posted to it.
+    // Must be called before any command is posted to the table.
+    void addTable(const shared_ptr<TableActor>& table);
+
+    // Adds a command to a table's inbox and schedules the table if it was idle.
+    // Safe to call from any thread.
+    void post(TableActor& table, TableCommand command);
+
+    // Posts a command to a table after a delay, see TableActor::postAfter
+    uint64_t postAfter(TableActor& table, chrono::milliseconds delay, TableCommand command);
+
+    // Cancels a timer, see TableActor::cancelTimer
+    void cancelTimer(TableActor& table, uint64_t timerId);
+
+    // Returns the number of timers waiting in the wheels (approximate while running)
+    size_t getNumTimers() const;
+
+    // Blocks until every posted command has been handled
+    void waitUntilIdle();
+
+    // Drains outstanding work and joins the worker threads. Pending timers are dropped.
+    void stop();
+
+    size_t getNumWorkers() const;
+    size_t getNumTables() const;
+};
+
+#endif // TABLE_SCHEDULER_H
@@ -0,0 +1,67 @@
+#ifndef TABLE_SNAPSHOT_H
+#define TABLE_SNAPSHOT_H
+
+#include "GameController.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+const uint32_t TABLE_SNAPSHOT_MAGIC = 0x504E5354; // "TSNP"
+const uint8_t TABLE_SNAPSHOT_VERSION = 2;
+const size_t MAX_TABLE_SNAPSHOT_SIZE = 4096 + MAX_HAND_RECORD_SIZE;
+
+// Compact binary snapshot of a game, taken at any point (e.g. after every action) and
+// restored into a fresh GameController that resumes exactly where the snapshot was taken,
+// at the pending decision if there is one.
+//
+// Covered: players and positions, the deck's order, index and shuffle seed, the board,
+// TurnManager, ActionManager's timeline and ActionState, PotManager's pots, bets and dead
+// chips, StreetState, the step state and the hand record so far. HandEvaluator is only
+// filled while pots are awarded, so it is restored empty.
+//
+// Players are referenced by their index in the game's players, which are sorted by position.
+// Layout: u32 magic, u8 version, sections in the order above, u32 crc32 of everything before it
+class TableSnapshot {
+private:
+    static void savePlayerIndex(WireWriter& writer, const vector<shared_ptr<Player>>& players,
+                                const shared_ptr<Player>& player);
+    static bool restorePlayerIndex(WireReader& reader, const vector<shared_ptr<Player>>& players,
+                                   shared_ptr<Player>& player);
+    static bool restoreCard(WireReader& reader, Card& card);
+
+    static void saveController(WireWriter& writer, const GameController& game);
+    static void savePlayers(WireWriter& writer, const vector<shared_ptr<Player>>& players);
+    static void saveDeck(WireWriter& writer, const Deck& deck);
+    static void saveTurnManager(WireWriter& writer, const TurnManager& turnManager,
+                                const vector<shared_ptr<Player>>& players);
+    static void saveActionManager(WireWriter& writer, const ActionManager& actionManager,
+                                  const vector<shared_ptr<Player>>& players);
+    static void savePotManager(WireWriter& writer, const PotManager& potManager,
+                               const vector<shared_ptr<Player>>& players);
+    static void saveStreetState(WireWriter& writer, const StreetState& streetState,
+                                const vector<shared_ptr<Player>>& players);
+
+    static bool restoreController(WireReader& reader, GameController& game);
+    static bool restorePlayers(WireReader& reader, GamePlayers& gamePlayers);
+    static bool restoreDeck(WireReader& reader, Deck& deck);
+    static bool restoreTurnManager(WireReader& reader, TurnManager& turnManager,
+                                   const vector<shared_ptr<Player>>& players);
+    static bool restoreActionManager(WireReader& reader, ActionManager& actionManager,
+                                     const vector<shared_ptr<Player>>& players);
+    static bool restorePotManager(WireReader& reader, PotManager& potManager,
+                                  const vector<shared_ptr<Player>>& players);
+    static bool restoreStreetState(WireReader& reader, StreetState& streetState,
+                                   const vector<shared_ptr<Player>>& players);
+
+public:
+    // Writes a snapshot of the game into buffer and returns its size,
+    // or 0 if it does not fit in capacity
+    static size_t save(const GameController& game, uint8_t* buffer, size_t capacity);
+
+    // Restores a snapshot into a game created with the same blinds, replacing its state.
+    // Returns false if the snapshot is truncated, corrupt or for other blinds, in which
+    // case the game is left partly restored and must be discarded.
+    static bool restore(GameController& game, const uint8_t* data, size_t size);
+};
+
+#endif // TABLE_SNAPSHOT_H
@@ -0,0 +1,100 @@
+#ifndef TABLE_STATE_H
+#define TABLE_STATE_H
+
+#include "GameController.h"
+#include "WireCodec.h"
+#include <array>
+#include <string_view>
+using namespace std;
+
+const uint8_t NO_POSITION = 0xFF;
+const uint8_t NO_STREET = 0xFF;
+const size_t DEFAULT_KEYFRAME_INTERVAL = 64;
+
+// Change records inside a MSG_STATE_DELTA frame
+enum StateChange : uint8_t {
+    CHANGE_HAND = 1,        // u32 handNumber
+    CHANGE_STREET,          // u8 street
+    CHANGE_TO_ACT,          // u8 position
+    CHANGE_SEAT,            // u8 seat, u8 position, u32 chips, u8 nameLength, name (player sat down)
+    CHANGE_SEAT_EMPTY,      // u8 seat
+    CHANGE_STACK,           // u8 seat, u32 chips
+    CHANGE_BOARD,           // u8 numCardsKept, u8 numNewCards, {u8 card}
+    CHANGE_POT,             // u8 index, u32 chips, u16 eligible position mask
+    CHANGE_NUM_POTS,        // u8 numPots
+    CHANGE_POSITION         // u8 seat, u8 position (positions rotate every hand)
+};
+
+// A player keeps the same seat for as long as they are at the table, while their
+// position moves round with the button
+typedef struct SeatState {
+    bool isOccupied = false;
+    uint8_t position = NO_POSITION;
+    uint32_t chips = 0;
+    uint8_t nameLength = 0;
+    array<char, MAX_PLAYER_NAME> name{};
+
+    string_view getName() const { return string_view(name.data(), nameLength); }
+    bool operator==(const SeatState& other) const;
+} SeatState;
+
+// Public state of a table that every client and spectator can see.
+// Fixed size so that it can be diffed and copied without allocating.
+typedef struct TableState {
+    uint32_t sequence = 0;
+    uint32_t handNumber = 0;
+    uint8_t street = NO_STREET;
+    uint8_t toAct = NO_POSITION;
+    array<SeatState, NUM_POSITIONS> seats;
+    uint8_t numBoardCards = 0;
+    array<uint8_t, 5> board{};
+    uint8_t numPots = 0;
+    array<WirePot, MAX_WIRE_POTS> pots{};
+
+    // Copies the public state out of a game. Leaves the sequence number untouched.
+    // Players already seated in this state keep their seat; new players take the first free one.
+    void capture(const GameController& game, uint32_t handNumber);
+
+    // Seat of the player at a position, or nullptr if nobody is there
+    const SeatState* findSeat(uint8_t position) const;
+
+    // Replaces this state with a MSG_STATE_KEYFRAME payload. Returns false if malformed.
+    bool decodeKeyframe(const uint8_t* payload, size_t size);
+
+    // Applies a MSG_STATE_DELTA payload. Returns false if it is malformed or does not
+    // follow on from this state's sequence number, in which case a keyframe is needed.
+    bool applyDelta(const uint8_t* payload, size_t size);
+
+    // Compares everything but the sequence number
+    bool isSameState(const TableState& other) const;
+} TableState;
+
+// Publishes a table's state as sequence numbered deltas, with a full keyframe
+// every keyframeInterval deltas (and on demand for late joiners).
+class TableStateStream {
+private:
+    uint32_t tableId;
+    size_t keyframeInterval;
+    size_t numDeltasSinceKeyframe;
+
+    // State as last published to clients
+    TableState published;
+
+public:
+    TableStateStream(uint32_t tableId, size_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+
+    // Diffs state against the last published state and writes a MSG_STATE_DELTA frame.
+    // Returns false (and writes nothing) if nothing changed.
+    bool encodeDelta(const TableState& state, WireWriter& writer);
+
+    // Writes a MSG_STATE_KEYFRAME frame of the last published state (e.g. for a late joiner)
+    void encodeKeyframe(WireWriter& writer) const;
+
+    // Writes a keyframe once keyframeInterval deltas have been published since the last one.
+    // Returns false if no keyframe is due.
+    bool encodeKeyframeIfDue(WireWriter& writer);
+
+    const TableState& getPublishedState() const;
+};
+
+#endif // TABLE_STATE_H
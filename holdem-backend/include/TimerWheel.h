@@ -0,0 +1,74 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+// Handle to a scheduled timer. Stale handles (fired or cancelled timers) are detected.
+typedef uint64_t TimerId;
+const TimerId INVALID_TIMER = 0;
+
+const int TIMER_WHEEL_LEVELS = 4;
+const int TIMER_WHEEL_SLOT_BITS = 6;
+const uint32_t TIMER_WHEEL_SLOTS = 1u << TIMER_WHEEL_SLOT_BITS;
+
+// Longest delay a timer can have, longer delays are clamped
+const uint64_t MAX_TIMER_DELAY = (1ull << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS)) - 1;
+
+// Hierarchical timing wheel measured in ticks. Single threaded.
+// Level 0 has one slot per tick, each higher level one slot per full turn of the level below.
+// Timers live in a pooled, intrusively linked node array, so schedule and cancel are O(1) and
+// never allocate once the pool has grown. Timers in a higher level slot are cascaded down a
+// level when the wheel reaches that slot, so each timer is moved at most once per level.
+class TimerWheel {
+private:
+    static const uint32_t NIL = UINT32_MAX;
+
+    typedef struct TimerNode {
+        uint64_t expiryTick = 0;
+        uint64_t data = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        uint32_t generation = 1;
+        uint32_t slot = NIL;        // Index into slots, NIL if the node is free
+    } TimerNode;
+
+    vector<TimerNode> nodes;
+    uint32_t freeList;
+    array<uint32_t, TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS> slots;
+    uint64_t currentTick;
+    size_t numTimers;
+
+    // Links a node into the slot matching its expiry relative to the current tick
+    void link(uint32_t index);
+
+    // Removes a node from its slot
+    void unlink(uint32_t index);
+
+    // Returns a node to the free list and invalidates handles to it
+    void release(uint32_t index);
+
+    // Re-links every timer in a higher level slot one level down
+    void cascade(int level);
+
+public:
+    TimerWheel();
+
+    // Schedules a timer delayTicks from now (at least one tick) carrying data.
+    TimerId schedule(uint64_t delayTicks, uint64_t data);
+
+    // Cancels a pending timer. Returns false if it already fired or was cancelled.
+    bool cancel(TimerId timerId);
+
+    // Moves the wheel forward numTicks, appending the data of every expired timer in tick order
+    void advance(uint64_t numTicks, vector<uint64_t>& expired);
+
+    // Returns the number of pending timers
+    size_t size() const;
+
+    uint64_t getCurrentTick() const;
+};
+
+#endif // TIMER_WHEEL_H
@@ -6,6 +6,8 @@
 #include <vector>
 using namespace std;
 
+class TableSnapshot;
+
 class TurnManager {
 private:
     // Contains players in the hand
@@ -36,6 +38,9 @@ private:
 
     // Helper function to return the next player to act.
     shared_ptr<Player> getNextToAct();
+
+    // Saves and restores the private state
+    friend class TableSnapshot;
 public:
     TurnManager();
 
@@ -0,0 +1,76 @@
+#ifndef WIN_PROBABILITY_FEED_H
+#define WIN_PROBABILITY_FEED_H
+
+#include "Equity.h"
+#include "HandRange.h"
+#include "Outs.h"
+#include "Player.h"
+#include <chrono>
+#include <memory>
+using namespace std;
+
+// Time a table may spend enumerating the runouts of a flop
+const chrono::microseconds DEFAULT_WIN_PROBABILITY_BUDGET(500);
+
+// Turn and river pairs ranked between checks of the budget
+const int WIN_PROBABILITY_CHECK_INTERVAL = 64;
+
+typedef struct WinProbabilities {
+    uint32_t handNumber;
+    int numBoardCards;
+    vector<uint8_t> positions;      // Live players, in the order of the tally
+    EquityResult tally;
+    vector<uint64_t> outs;          // Outs of each live player on the flop and turn, see Outs
+    bool isExact;                   // False when the budget ran out before every runout was ranked
+
+    WinProbabilities();
+} WinProbabilities;
+
+// Live win and tie chances of every player still in a hand, for tables whose hole cards
+// are shown. Each flop's turn and river pairs are ranked once, on the flop, with the rank
+// of every hand kept per pair. The turn then only re-scores the pairs holding the turn card
+// and the river the single pair dealt, so later streets cost next to nothing and players
+// folding just drop out of the scoring. Every trailing player's outs to the next card are
+// listed alongside.
+//
+// The flop enumeration stops once the budget is spent. Pairs are ranked in a strided order
+// that spreads over the deck, so a cut short enumeration is an even sample of the runouts,
+// and pairs it didn't reach are ranked when a later street needs them.
+class WinProbabilityFeed {
+private:
+    chrono::microseconds budget;
+
+    // Hands ranked on the flop, by seat, and their flop
+    uint32_t handNumber;
+    uint64_t flop;
+    uint8_t positions[MAX_EQUITY_HANDS];
+    uint64_t hands[MAX_EQUITY_HANDS];
+    int numHands;
+
+    // Rank of each hand with every turn and river pair (by combo index) once ranked
+    vector<array<uint32_t, MAX_EQUITY_HANDS>> pairRanks;
+    vector<bool> isPairRanked;
+
+    WinProbabilities current;
+
+    // Starts over from a new flop with the hands dealt in
+    void reset(const vector<shared_ptr<Player>>& players, uint64_t newFlop, uint32_t newHandNumber);
+
+    // Ranks every hand with the flop and a turn and river pair
+    void rankPair(int pair);
+
+    // Adds a ranked pair's outcome for the live hands to the tally
+    void scorePair(int pair, uint16_t liveHands, WinProbabilities& result) const;
+
+public:
+    explicit WinProbabilityFeed(chrono::microseconds budget = DEFAULT_WIN_PROBABILITY_BUDGET);
+
+    // Brings the probabilities up to date with the board, given the players still in the
+    // hand. Returns true if they changed, i.e. a street was dealt or a new hand started.
+    bool update(const vector<shared_ptr<Player>>& players, const vector<Card>& board, uint32_t handNumber);
+
+    // Returns the latest probabilities, with no positions before the flop
+    const WinProbabilities& getProbabilities() const;
+};
+
+#endif // WIN_PROBABILITY_FEED_H
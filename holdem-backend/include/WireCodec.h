@@ -0,0 +1,154 @@
+#ifndef WIRE_CODEC_H
+#define WIRE_CODEC_H
+
+#include "Board.h"
+#include "ClientManager.h"
+#include "GamePlayers.h"
+#include "PotManager.h"
+#include "RunoutEquity.h"
+#include "StreetState.h"
+#include "WinProbabilityFeed.h"
+#include "WireProtocol.h"
+#include <array>
+#include <string_view>
+using namespace std;
+
+const uint8_t NO_CARD = 0xFF;
+const size_t MAX_WIRE_POTS = MAX_NUM_PLAYERS;
+const size_t MAX_WIRE_ACTIONS = 8;
+
+// Probabilities and equities are sent in 1/10000ths
+const double PROBABILITY_SCALE = 10000;
+
+// Flags carried by an action request
+const uint8_t REQUEST_CAN_RAISE = 0x01;
+const uint8_t REQUEST_BIG_BLIND_PRE_FLOP = 0x02;
+
+// Decoded messages. Names point into the decoded payload, so a message
+// is only valid while the buffer it was decoded from is alive.
+
+typedef struct WireSeat {
+    uint8_t position = 0;
+    uint32_t chips = 0;
+    string_view name;
+} WireSeat;
+
+typedef struct SeatsMessage {
+    uint32_t tableId = 0;
+    uint8_t numSeats = 0;
+    array<WireSeat, MAX_NUM_PLAYERS> seats;
+} SeatsMessage;
+
+typedef struct HoleCardsMessage {
+    uint32_t tableId = 0;
+    uint8_t position = 0;
+    uint8_t numCards = 0;
+    array<uint8_t, 2> cards;
+} HoleCardsMessage;
+
+typedef struct BoardMessage {
+    uint32_t tableId = 0;
+    uint8_t numCards = 0;
+    array<uint8_t, 5> cards;
+} BoardMessage;
+
+typedef struct WirePot {
+    uint32_t chips = 0;
+    uint16_t eligiblePositions = 0;  // bit i set if the player at Position i is eligible
+} WirePot;
+
+typedef struct PotsMessage {
+    uint32_t tableId = 0;
+    uint8_t numPots = 0;
+    array<WirePot, MAX_WIRE_POTS> pots;
+} PotsMessage;
+
+typedef struct WireAction {
+    uint8_t type = 0;
+    uint32_t amount = 0;
+} WireAction;
+
+typedef struct ActionRequestMessage {
+    uint32_t tableId = 0;
+    uint8_t street = 0;
+    uint8_t position = 0;
+    uint8_t flags = 0;
+    uint32_t activeBet = 0;
+    uint32_t playerInitialChips = 0;
+    uint32_t bigStackAmongOthers = 0;
+    uint8_t numActions = 0;
+    array<WireAction, MAX_WIRE_ACTIONS> actions;
+} ActionRequestMessage;
+
+typedef struct ActionResultMessage {
+    uint32_t tableId = 0;
+    uint8_t position = 0;
+    uint8_t type = 0;
+    uint32_t amount = 0;
+    uint32_t chips = 0;
+} ActionResultMessage;
+
+typedef struct WireWinProbability {
+    uint8_t position = 0;
+    uint16_t win = 0;               // Chance of winning outright, in 1/10000ths
+    uint16_t tie = 0;               // Chance of splitting the pot, in 1/10000ths
+    uint64_t outs = 0;              // Cards taking the player to the lead or a tie next, as a mask
+} WireWinProbability;
+
+typedef struct WinProbabilitiesMessage {
+    uint32_t tableId = 0;
+    uint32_t handNumber = 0;
+    uint8_t numBoardCards = 0;
+    bool isExact = false;
+    uint8_t numPlayers = 0;
+    array<WireWinProbability, MAX_NUM_PLAYERS> players;
+} WinProbabilitiesMessage;
+
+typedef struct WireRunoutEquity {
+    uint8_t position = 0;
+    uint16_t equity = 0;            // Share of the pot won on average, in 1/10000ths
+} WireRunoutEquity;
+
+typedef struct RunoutEquityMessage {
+    uint32_t tableId = 0;
+    uint32_t handNumber = 0;
+    uint8_t street = 0;             // Street about to be dealt
+    bool isExact = false;
+    uint8_t numPlayers = 0;
+    array<WireRunoutEquity, MAX_NUM_PLAYERS> players;
+} RunoutEquityMessage;
+
+// Encodes game state straight from the engine objects into a WireWriter and
+// decodes payloads into fixed size messages. Nothing is allocated either way.
+// Encoders write a whole frame (header included). Decoders take the payload
+// after the frame header and return false if it is truncated or out of range.
+class WireCodec {
+public:
+    // Cards are one byte: suit * 13 + (value - 2), the same index as Card::getBitMask
+    static uint8_t encodeCard(const Card& card);
+    static Card decodeCard(uint8_t card);
+
+    static void encodeSeats(WireWriter& writer, uint32_t tableId, const vector<shared_ptr<Player>>& players);
+    static void encodeHoleCards(WireWriter& writer, uint32_t tableId, const Player& player);
+    static void encodeBoard(WireWriter& writer, uint32_t tableId, const Board& board);
+    static void encodePots(WireWriter& writer, uint32_t tableId, const PotManager& potManager);
+    static void encodeActionRequest(WireWriter& writer, uint32_t tableId, const StreetState& streetState,
+                                    const vector<PossibleAction>& possibleActions);
+    static void encodeActionResult(WireWriter& writer, uint32_t tableId, const ClientAction& action);
+    static void encodeWinProbabilities(WireWriter& writer, uint32_t tableId, const WinProbabilities& probabilities);
+    static void encodeRunoutEquity(WireWriter& writer, uint32_t tableId, const StreetEquity& equity);
+
+    // Equity in 1/10000ths, as sent and logged
+    static uint16_t encodeEquity(double equity);
+
+    static bool decodeSeats(const uint8_t* payload, size_t size, SeatsMessage& message);
+    static bool decodeHoleCards(const uint8_t* payload, size_t size, HoleCardsMessage& message);
+    static bool decodeBoard(const uint8_t* payload, size_t size, BoardMessage& message);
+    static bool decodePots(const uint8_t* payload, size_t size, PotsMessage& message);
+    static bool decodeActionRequest(const uint8_t* payload, size_t size, ActionRequestMessage& message);
+    static bool decodeActionResult(const uint8_t* payload, size_t size, ActionResultMessage& message);
+    static bool decodeWinProbabilities(const uint8_t* payload, size_t size, WinProbabilitiesMessage& message);
+    static bool decodeRunoutEquity(const uint8_t* payload, size_t size, RunoutEquityMessage& message);
+};
+
+#endif // WIRE_CODEC_H
@@ -0,0 +1,211 @@
+#ifndef WIRE_PROTOCOL_H
+#define WIRE_PROTOCOL_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+using namespace std;
+
+// Every frame on the wire is: u16 payload length, u8 protocol version, u8 message type, payload.
+// All integers are little endian. Cards are one byte: suit * 13 + (value - 2).
+const uint8_t WIRE_PROTOCOL_VERSION = 1;
+const size_t FRAME_HEADER_SIZE = 4;
+const size_t MAX_FRAME_PAYLOAD = 4096;
+const size_t MAX_PLAYER_NAME = 32;
+
+enum MessageType : uint8_t {
+    // Client to server
+    MSG_JOIN_TABLE = 0x01,      // u32 tableId, u32 chips, u8 nameLength, name
+    MSG_LEAVE_TABLE = 0x02,     // u32 tableId
+    MSG_PLAYER_ACTION = 0x03,   // u32 tableId, u8 actionType, u32 amount
+    MSG_WATCH_TABLE = 0x04,     // u32 tableId
+    MSG_UNWATCH_TABLE = 0x05,   // u32 tableId
+
+    // Server to client (game state messages are encoded by WireCodec)
+    MSG_JOINED = 0x81,          // u32 tableId
+    MSG_LEFT = 0x82,            // u32 tableId (also sent when a spectator stops watching)
+    MSG_ERROR = 0x83,           // u32 tableId, u8 errorCode
+    MSG_HAND_STARTED = 0x84,    // u32 tableId, u8 your position
+    MSG_ACTION_REQUEST = 0x85,  // u32 tableId, u8 street, u8 position, u8 flags, u32 activeBet,
+                                // u32 initialChips, u32 bigStackAmongOthers, u8 numActions, {u8 type, u32 amount}
+    MSG_ACTION_RESULT = 0x86,   // u32 tableId, u8 position, u8 actionType, u32 amount, u32 chips
+    MSG_ROUND_COMPLETE = 0x87,  // u32 tableId
+    MSG_SEATS = 0x88,           // u32 tableId, u8 numSeats, {u8 position, u32 chips, u8 nameLength, name}
+    MSG_HOLE_CARDS = 0x89,      // u32 tableId, u8 position, u8 numCards, {u8 card}
+    MSG_BOARD = 0x8A,           // u32 tableId, u8 numCards, {u8 card}
+    MSG_POTS = 0x8B,            // u32 tableId, u8 numPots, {u32 chips, u16 eligible position mask}
+    MSG_STATE_DELTA = 0x8C,     // u32 tableId, u32 sequence, u16 numChanges, {u8 StateChange, fields}
+    MSG_STATE_KEYFRAME = 0x8D,  // u32 tableId, u32 sequence, u32 handNumber, u8 street, u8 toAct,
+                                // u8 numSeats, {u8 seat, u8 position, u32 chips, u8 nameLength, name},
+                                // u8 numBoardCards, {u8 card}, u8 numPots, {u32 chips, u16 eligible position mask}
+    MSG_WATCHING = 0x8E,        // u32 tableId
+    MSG_TIME_BANK = 0x8F,       // u32 tableId, u8 position, u32 milliseconds (player's time bank started)
+    MSG_WIN_PROBABILITIES = 0x90, // u32 tableId, u32 handNumber, u8 numBoardCards, u8 isExact, u8 numPlayers,
+                                // {u8 position, u16 win, u16 tie, u64 outs} (in 1/10000ths, outs as a card mask,
+                                // spectators of featured tables only)
+    MSG_RUNOUT_EQUITY = 0x91    // u32 tableId, u32 handNumber, u8 street, u8 isExact, u8 numPlayers,
+                                // {u8 position, u16 equity} (in 1/10000ths, before a street of an all-in runout,
+                                // possibly once the next hand has started)
+};
+
+enum WireError : uint8_t {
+    ERR_MALFORMED = 1,
+    ERR_UNSUPPORTED_VERSION,
+    ERR_NO_SUCH_TABLE,
+    ERR_TABLE_FULL,
+    ERR_NAME_TAKEN,
+    ERR_NOT_SEATED,
+    ERR_ALREADY_SEATED,
+    ERR_NOT_YOUR_TURN,
+    ERR_INVALID_ACTION,
+    ERR_ALREADY_WATCHING,
+    ERR_NOT_WATCHING,
+    ERR_TABLE_CLOSED        // The table stopped, e.g. its action log failed
+};
+
+// Writes little endian fields into a caller provided buffer.
+// Writes past the end are dropped and flagged, check isOverflow() before sending.
+class WireWriter {
+private:
+    uint8_t* buffer;
+    size_t capacity;
+    size_t offset;
+    bool overflow;
+
+    bool reserve(size_t size) {
+        if (offset + size > capacity) {
+            overflow = true;
+            return false;
+        }
+        return true;
+    }
+
+public:
+    WireWriter(uint8_t* buffer, size_t capacity) : buffer(buffer), capacity(capacity), offset(0), overflow(false) {}
+
+    void putU8(uint8_t value) {
+        if (!reserve(1)) return;
+        buffer[offset++] = value;
+    }
+
+    void putU16(uint16_t value) {
+        if (!reserve(2)) return;
+        buffer[offset++] = static_cast<uint8_t>(value);
+        buffer[offset++] = static_cast<uint8_t>(value >> 8);
+    }
+
+    void putU32(uint32_t value) {
+        if (!reserve(4)) return;
+        for (int i = 0; i < 4; ++i) buffer[offset++] = static_cast<uint8_t>(value >> (8 * i));
+    }
+
+    void putU64(uint64_t value) {
+        if (!reserve(8)) return;
+        for (int i = 0; i < 8; ++i) buffer[offset++] = static_cast<uint8_t>(value >> (8 * i));
+    }
+
+    void putBytes(const void* data, size_t size) {
+        if (!reserve(size)) return;
+        memcpy(buffer + offset, data, size);
+        offset += size;
+    }
+
+    // Overwrites a u16 at an earlier offset (used to patch frame lengths)
+    void patchU16(size_t at, uint16_t value) {
+        if (at + 2 > offset) return;
+        buffer[at] = static_cast<uint8_t>(value);
+        buffer[at + 1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    size_t getSize() const { return offset; }
+    bool isOverflow() const { return overflow; }
+};
+
+// Reads little endian fields from a buffer.
+// Reads past the end return 0 and are flagged, check isUnderflow() after parsing.
+class WireReader {
+private:
+    const uint8_t* buffer;
+    size_t size;
+    size_t offset;
+    bool underflow;
+
+    bool available(size_t count) {
+        if (offset + count > size) {
+            underflow = true;
+            return false;
+        }
+        return true;
+    }
+
+public:
+    WireReader(const uint8_t* buffer, size_t size) : buffer(buffer), size(size), offset(0), underflow(false) {}
+
+    uint8_t getU8() {
+        if (!available(1)) return 0;
+        return buffer[offset++];
+    }
+
+    uint16_t getU16() {
+        if (!available(2)) return 0;
+        uint16_t value = buffer[offset] | (buffer[offset + 1] << 8);
+        offset += 2;
+        return value;
+    }
+
+    uint32_t getU32() {
+        if (!available(4)) return 0;
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(buffer[offset++]) << (8 * i);
+        return value;
+    }
+
+    uint64_t getU64() {
+        if (!available(8)) return 0;
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) value |= static_cast<uint64_t>(buffer[offset++]) << (8 * i);
+        return value;
+    }
+
+    // Returns a pointer into the buffer (no copy), or nullptr on underflow
+    const uint8_t* getBytes(size_t count) {
+        if (!available(count)) return nullptr;
+        const uint8_t* data = buffer + offset;
+        offset += count;
+        return data;
+    }
+
+    size_t getRemaining() const { return size - offset; }
+    bool isUnderflow() const { return underflow; }
+};
+
+typedef struct FrameHeader {
+    uint16_t payloadSize = 0;
+    uint8_t version = 0;
+    uint8_t type = 0;
+} FrameHeader;
+
+// Starts a frame and returns the offset of its length field
+inline size_t beginFrame(WireWriter& writer, MessageType type) {
+    size_t start = writer.getSize();
+    writer.putU16(0);
+    writer.putU8(WIRE_PROTOCOL_VERSION);
+    writer.putU8(type);
+    return start;
+}
+
+// Parses a frame header. Returns false if fewer than FRAME_HEADER_SIZE bytes are available.
+inline bool decodeFrameHeader(const uint8_t* data, size_t size, FrameHeader& header) {
+    if (size < FRAME_HEADER_SIZE) return false;
+    header.payloadSize = data[0] | (data[1] << 8);
+    header.version = data[2];
+    header.type = data[3];
+    return true;
+}
+
+// Patches the payload length of a frame started with beginFrame
+inline void endFrame(WireWriter& writer, size_t start) {
+    writer.patchU16(start, static_cast<uint16_t>(writer.getSize() - start - FRAME_HEADER_SIZE));
+}
+
+#endif // WIRE_PROTOCOL_H
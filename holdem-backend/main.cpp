@@ -1,7 +1,36 @@
 #include "include/GameController.h"
+#include <cstring>
+#include <fstream>
 
-int main () {
+// Usage: PokerV3 [script] [--quiet]
+// With a script (or "-" for stdin), decisions and player setup are read from it without prompts.
+// --quiet drops the game narration as well.
+int main (int argc, char* argv[]) {
     GameController game(2, 3);
-    game.main();
+
+    ifstream scriptFile;
+    bool isQuiet = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quiet") == 0) {
+            isQuiet = true;
+        } else if (strcmp(argv[i], "-") == 0) {
+            game.setClientScript(cin);
+        } else {
+            scriptFile.open(argv[i]);
+            if (!scriptFile) {
+                cerr << "Could not open script " << argv[i] << endl;
+                return 1;
+            }
+            game.setClientScript(scriptFile);
+        }
+    }
+    if (isQuiet) cout.setstate(ios_base::badbit);
+
+    try {
+        game.main();
+    } catch (const runtime_error& error) {
+        cerr << error.what() << endl;
+        return 1;
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,24 @@
+#include "include/PreflopEquityTable.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+// Usage: PreflopTableGen [path] [numThreads] [includeCombos (0 or 1)] [startingHand ...]
+int main(int argc, char* argv[]) {
+    string path = (argc > 1) ? argv[1] : "preflop_equity.bin";
+    PreflopTableOptions options;
+    options.numThreads = (argc > 2) ? atoi(argv[2]) : static_cast<int>(thread::hardware_concurrency());
+    options.includeCombos = (argc > 3) && atoi(argv[3]) != 0;
+    for (int i = 4; i < argc; ++i) options.startingHands.push_back(PreflopEquityTable::parseStartingHand(argv[i]));
+
+    cout << "Generating " << path << " with " << options.numThreads << " threads." << endl;
+    auto start = chrono::steady_clock::now();
+    if (!PreflopEquityTable::generate(path, options)) {
+        cerr << "Failed to write " << path << endl;
+        return 1;
+    }
+    auto elapsed = chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now() - start);
+    cout << "Done in " << elapsed.count() << "s." << endl;
+    return 0;
+}
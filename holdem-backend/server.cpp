@@ -0,0 +1,70 @@
+#include "include/GameServer.h"
+#include <csignal>
+#include <cstdlib>
+
+GameServer* runningServer = nullptr;
+
+void handleSignal(int) {
+    if (runningServer != nullptr) runningServer->stop();
+}
+
+// Usage: PokerServer [port] [numTables] [numWorkers] [smallBlind] [bigBlind] [handHistoryDirectory]
+//                    [preflopTable] [handPotentialTable]
+// Empty paths leave the hand history off and the tables unloaded.
+int main(int argc, char* argv[]) {
+    uint16_t port = (argc > 1) ? static_cast<uint16_t>(atoi(argv[1])) : 7777;
+    size_t numTables = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 1000;
+    size_t numWorkers = (argc > 3) ? strtoul(argv[3], nullptr, 10) : thread::hardware_concurrency();
+    size_t smallBlind = (argc > 4) ? strtoul(argv[4], nullptr, 10) : 1;
+    size_t bigBlind = (argc > 5) ? strtoul(argv[5], nullptr, 10) : 2;
+    string historyDirectory = (argc > 6) ? argv[6] : "";
+    string preflopTablePath = (argc > 7) ? argv[7] : "";
+    string potentialTablePath = (argc > 8) ? argv[8] : "";
+
+    // Mapped before the tables start so no hand waits on the disk
+    PreflopEquityTable preflopTable;
+    if (!preflopTablePath.empty() && !preflopTable.open(preflopTablePath)) {
+        cerr << "Could not load the preflop equity table " << preflopTablePath << endl;
+        return 1;
+    }
+    HandPotentialTable potentialTable;
+    if (!potentialTablePath.empty() && !potentialTable.open(potentialTablePath)) {
+        cerr << "Could not load the hand potential table " << potentialTablePath << endl;
+        return 1;
+    }
+    StreetStrength streetStrength(preflopTable, potentialTable);
+
+    cout << "Hosting " << numTables << " tables on port " << port << " with " << numWorkers << " workers." << endl;
+
+    // The game engine narrates every step to stdout for the console game.
+    // Table threads must not pay for that, so stdout is silenced from here on.
+    cout.setstate(ios_base::badbit);
+
+    // Declared before the server so it outlives the tables logging to it
+    unique_ptr<HandHistoryWriter> handHistory;
+    if (!historyDirectory.empty()) {
+        HandHistoryOptions options;
+        options.directory = historyDirectory;
+        options.fsyncInterval = chrono::milliseconds(1000);
+        handHistory = make_unique<HandHistoryWriter>(options);
+    }
+
+    // Works out all-in runouts the preflop table doesn't have off the table workers
+    RunoutEquityWorker runoutWorker;
+    RunoutEquityOptions runoutOptions;
+    runoutOptions.preflopTable = &preflopTable;
+
+    GameServer server(port, numTables, numWorkers, smallBlind, bigBlind);
+    server.setHandHistory(handHistory.get());
+    server.setStreetStrength(&streetStrength);
+    server.setRunoutEquity(runoutOptions, &runoutWorker);
+    runningServer = &server;
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+
+    server.run();
+    runningServer = nullptr;
+
+    cerr << "Server stopped." << endl;
+    return 0;
+}
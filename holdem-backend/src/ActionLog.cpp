@@ -0,0 +1,393 @@
+#include "../include/ActionLog.h"
+#include "../include/FileUtils.h"
+#include "../include/HandReplay.h"
+#include "../include/TableSnapshot.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char* SEGMENT_PREFIX = "actions-";
+    const char* SEGMENT_SUFFIX = ".wal";
+    const size_t RECORD_PREFIX_SIZE = 9;
+    const size_t ACTION_BODY_SIZE = 7;
+
+    // Parses "actions-00000012.wal", returns false for any other file name
+    bool parseSegmentName(const string& name, uint32_t& index) {
+        size_t prefixLength = strlen(SEGMENT_PREFIX);
+        size_t suffixLength = strlen(SEGMENT_SUFFIX);
+        if (name.size() <= prefixLength + suffixLength) return false;
+        if (name.compare(0, prefixLength, SEGMENT_PREFIX) != 0) return false;
+        if (name.compare(name.size() - suffixLength, suffixLength, SEGMENT_SUFFIX) != 0) return false;
+
+        string digits = name.substr(prefixLength, name.size() - prefixLength - suffixLength);
+        if (digits.empty() || !all_of(digits.begin(), digits.end(), ::isdigit)) return false;
+        index = static_cast<uint32_t>(stoul(digits));
+        return true;
+    }
+
+    // Returns the segment indexes in a directory, oldest first
+    vector<uint32_t> listSegments(const string& directory) {
+        vector<uint32_t> segments;
+        DIR* dir = opendir(directory.c_str());
+        if (dir == nullptr) return {};
+        while (dirent* entry = readdir(dir)) {
+            uint32_t index;
+            if (parseSegmentName(entry->d_name, index)) segments.push_back(index);
+        }
+        closedir(dir);
+        sort(segments.begin(), segments.end());
+        return segments;
+    }
+}
+
+ActionLog::ActionLog(const ActionLogOptions& options) :
+    options(options),
+    isStopping(false),
+    isClosed(false),
+    isFailed(false),
+    pending(),
+    pendingSnapshots(),
+    nextSequence(1),
+    durableSequence(0),
+    numSyncs(0),
+    snapshotSegments(),
+    durableNotices(),
+    recoveredTables(),
+    fd(-1),
+    segmentIndex(0),
+    segmentOffset(0),
+    oldestSegment(0) {
+
+    if (mkdir(options.directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw runtime_error("Failed to create action log directory " + options.directory + ": " + strerror(errno));
+    }
+    recover();
+
+    // Never reopen an old segment, its tail may be torn
+    vector<uint32_t> segments = listSegments(options.directory);
+    uint32_t lastIndex = segments.empty() ? 0 : segments.back();
+    oldestSegment = segments.empty() ? lastIndex + 1 : segments.front();
+    openSegment(lastIndex + 1);
+
+    writerThread = thread(&ActionLog::writerLoop, this);
+}
+
+ActionLog::~ActionLog() {
+    close();
+}
+
+uint64_t ActionLog::appendAction(uint32_t tableId, uint32_t handNumber, const HandAction& action) {
+    uint8_t body[ACTION_BODY_SIZE];
+    WireWriter writer(body, sizeof(body));
+    writer.putU8(action.street);
+    writer.putU8(action.position);
+    writer.putU8(action.type);
+    writer.putU32(action.amount);
+    return appendRecord(LOG_ACTION, tableId, handNumber, body, sizeof(body));
+}
+
+uint64_t ActionLog::appendSnapshot(uint32_t tableId, uint32_t handNumber, const uint8_t* snapshot, size_t size) {
+    if (RECORD_PREFIX_SIZE + size > MAX_ACTION_LOG_RECORD_SIZE) return 0;
+    return appendRecord(LOG_SNAPSHOT, tableId, handNumber, snapshot, size);
+}
+
+bool ActionLog::waitDurable(uint64_t sequence) {
+    unique_lock<mutex> lock(logMutex);
+    durableCv.wait(lock, [this, sequence]() { return durableSequence >= sequence || isFailed || isClosed; });
+    return durableSequence >= sequence;
+}
+
+void ActionLog::notifyDurable(uint32_t tableId, uint64_t sequence, function<void(bool)> done) {
+    lock_guard<mutex> lock(logMutex);
+    if (durableSequence >= sequence || isFailed || isClosed) {
+        done(durableSequence >= sequence);
+        return;
+    }
+    durableNotices.emplace(sequence, DurableNotice{tableId, move(done)});
+}
+
+void ActionLog::cancelNotices(uint32_t tableId) {
+    lock_guard<mutex> lock(logMutex);
+    for (auto it = durableNotices.begin(); it != durableNotices.end();) {
+        it = (it->second.tableId == tableId) ? durableNotices.erase(it) : next(it);
+    }
+}
+
+void ActionLog::close() {
+    {
+        lock_guard<mutex> lock(logMutex);
+        if (isStopping) return;
+        isStopping = true;
+    }
+    writerCv.notify_one();
+    writerThread.join();
+
+    // Nothing appended after close() is written
+    {
+        lock_guard<mutex> lock(logMutex);
+        isClosed = true;
+        runDurableNotices();
+    }
+    durableCv.notify_all();
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+}
+
+const map<uint32_t, RecoveredTable>& ActionLog::getRecoveredTables() const {
+    return recoveredTables;
+}
+
+void ActionLog::forgetTable(uint32_t tableId) {
+    lock_guard<mutex> lock(logMutex);
+    snapshotSegments.erase(tableId);
+}
+
+uint64_t ActionLog::getNumAppended() {
+    lock_guard<mutex> lock(logMutex);
+    return nextSequence - 1;
+}
+
+uint64_t ActionLog::getNumSyncs() {
+    lock_guard<mutex> lock(logMutex);
+    return numSyncs;
+}
+
+uint32_t ActionLog::getSegmentIndex() {
+    lock_guard<mutex> lock(logMutex);
+    return segmentIndex;
+}
+
+bool ActionLog::restoreGame(GameController& game, const RecoveredTable& table) {
+    if (!TableSnapshot::restore(game, table.snapshot.data(), table.snapshot.size())) return false;
+
+    for (const HandAction& logged : table.actions) {
+        if (!game.isAwaitingAction()) return false;
+        shared_ptr<Player> player = game.getStreetState().getCurPlayer();
+        if (static_cast<uint8_t>(player->getPosition()) != logged.position) return false;
+
+        ActionType type = ReplayEngine::getClientActionType(logged, game.getPossibleActions());
+        ClientAction action = ClientAction{player, type, logged.amount};
+        if (!game.processClientAction(action)) return false;
+    }
+    return true;
+}
+
+string ActionLog::getSegmentName(uint32_t index) {
+    char name[32];
+    snprintf(name, sizeof(name), "%s%08u%s", SEGMENT_PREFIX, index, SEGMENT_SUFFIX);
+    return name;
+}
+
+// Helper Functions
+
+void ActionLog::recover() {
+    for (uint32_t index : listSegments(options.directory)) {
+        ifstream file(options.directory + "/" + getSegmentName(index), ios::binary);
+        vector<uint8_t> data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+        WireReader header(data.data(), min(data.size(), ACTION_LOG_HEADER_SIZE));
+        if (header.getU32() != ACTION_LOG_MAGIC || header.getU16() != ACTION_LOG_VERSION) continue;
+
+        // Records are read up to the first torn or corrupt one, the rest of the segment is lost
+        // with it. Later segments were written by later runs and are still read.
+        size_t offset = ACTION_LOG_HEADER_SIZE;
+        while (offset < data.size()) {
+            WireReader reader(data.data() + offset, data.size() - offset);
+            uint32_t size = reader.getU32();
+            uint32_t crc = reader.getU32();
+            const uint8_t* payload = reader.getBytes(size);
+            if (payload == nullptr || size < RECORD_PREFIX_SIZE || computeCrc32(payload, size) != crc) break;
+            offset += ACTION_LOG_RECORD_HEADER_SIZE + size;
+
+            WireReader record(payload, size);
+            uint8_t kind = record.getU8();
+            uint32_t tableId = record.getU32();
+            uint32_t handNumber = record.getU32();
+
+            if (kind == LOG_SNAPSHOT) {
+                RecoveredTable& table = recoveredTables[tableId];
+                table.tableId = tableId;
+                table.handNumber = handNumber;
+                table.snapshot.assign(payload + RECORD_PREFIX_SIZE, payload + size);
+                table.actions.clear();
+                snapshotSegments[tableId] = index;
+                continue;
+            }
+
+            // Actions before a table's first snapshot, or from a later hand, can't be replayed on it
+            auto it = recoveredTables.find(tableId);
+            if (kind != LOG_ACTION || it == recoveredTables.end() || it->second.handNumber != handNumber) continue;
+            HandAction action;
+            action.street = record.getU8();
+            action.position = record.getU8();
+            action.type = record.getU8();
+            action.amount = record.getU32();
+            if (!record.isUnderflow()) it->second.actions.push_back(action);
+        }
+    }
+}
+
+uint64_t ActionLog::appendRecord(ActionLogRecordKind kind, uint32_t tableId, uint32_t handNumber,
+                                 const uint8_t* body, size_t size) {
+    thread_local uint8_t scratch[ACTION_LOG_RECORD_HEADER_SIZE + MAX_ACTION_LOG_RECORD_SIZE];
+
+    // Encoded outside the lock, only the copy is serialised
+    uint32_t payloadSize = static_cast<uint32_t>(RECORD_PREFIX_SIZE + size);
+    WireWriter writer(scratch, sizeof(scratch));
+    writer.putU32(payloadSize);
+    writer.putU32(0);
+    writer.putU8(static_cast<uint8_t>(kind));
+    writer.putU32(tableId);
+    writer.putU32(handNumber);
+    writer.putBytes(body, size);
+
+    uint8_t* payload = scratch + ACTION_LOG_RECORD_HEADER_SIZE;
+    WireWriter crcWriter(scratch + 4, 4);
+    crcWriter.putU32(computeCrc32(payload, payloadSize));
+
+    uint64_t sequence;
+    {
+        lock_guard<mutex> lock(logMutex);
+        pending.insert(pending.end(), scratch, scratch + writer.getSize());
+        if (kind == LOG_SNAPSHOT) pendingSnapshots.push_back(tableId);
+        sequence = nextSequence++;
+    }
+    writerCv.notify_one();
+    return sequence;
+}
+
+// Writer Thread
+
+void ActionLog::writerLoop() {
+    vector<uint8_t> batch;
+    vector<uint32_t> snapshots;
+
+    unique_lock<mutex> lock(logMutex);
+    while (true) {
+        writerCv.wait(lock, [this]() { return isStopping || !pending.empty(); });
+        if (pending.empty()) break;
+
+        // Give other tables a moment to join this fsync
+        if (options.commitDelay.count() > 0 && !isStopping) {
+            writerCv.wait_for(lock, options.commitDelay, [this]() { return isStopping; });
+        }
+
+        batch.swap(pending);
+        snapshots.swap(pendingSnapshots);
+        uint64_t batchSequence = nextSequence - 1;
+        lock.unlock();
+
+        bool isRotated = false;
+        bool isCommitted = !isFailed;
+        if (isCommitted) {
+            try {
+                isRotated = commitBatch(batch);
+            } catch (const runtime_error& e) {
+                cerr << e.what() << endl;
+                isCommitted = false;
+            }
+        }
+        batch.clear();
+
+        lock.lock();
+        if (isCommitted) {
+            durableSequence = batchSequence;
+            numSyncs++;
+            for (uint32_t tableId : snapshots) snapshotSegments[tableId] = segmentIndex;
+        } else {
+            // Records after a lost batch can't be recovered in order, so nothing more is acknowledged
+            isFailed = true;
+        }
+        snapshots.clear();
+        runDurableNotices();
+        durableCv.notify_all();
+
+        if (isRotated) {
+            lock.unlock();
+            removeOldSegments();
+            lock.lock();
+        }
+    }
+}
+
+void ActionLog::runDurableNotices() {
+    // Run under the lock, so a table that cancels its notices never sees one afterwards
+    auto settled = (isFailed || isClosed) ? durableNotices.end() : durableNotices.upper_bound(durableSequence);
+    for (auto it = durableNotices.begin(); it != settled; ++it) it->second.done(it->first <= durableSequence);
+    durableNotices.erase(durableNotices.begin(), settled);
+}
+
+bool ActionLog::commitBatch(const vector<uint8_t>& batch) {
+    // Rotate before the segment outgrows its size, unless the batch alone is bigger
+    bool isRotated = false;
+    if (segmentOffset + batch.size() > options.segmentSize && segmentOffset > ACTION_LOG_HEADER_SIZE) {
+        if (fdatasync(fd) != 0) throw runtime_error("Failed to sync action log segment: " + string(strerror(errno)));
+        openSegment(segmentIndex + 1);
+        isRotated = true;
+    }
+
+    writeAll(batch.data(), batch.size());
+    segmentOffset += batch.size();
+    if (fdatasync(fd) != 0) throw runtime_error("Failed to sync action log segment: " + string(strerror(errno)));
+    return isRotated;
+}
+
+void ActionLog::removeOldSegments() {
+    uint32_t oldestNeeded;
+    {
+        lock_guard<mutex> lock(logMutex);
+        oldestNeeded = segmentIndex;
+        for (const auto& [tableId, index] : snapshotSegments) oldestNeeded = min(oldestNeeded, index);
+    }
+
+    for (; oldestSegment < oldestNeeded; ++oldestSegment) {
+        unlink((options.directory + "/" + getSegmentName(oldestSegment)).c_str());
+    }
+}
+
+void ActionLog::openSegment(uint32_t index) {
+    string path = options.directory + "/" + getSegmentName(index);
+    int segmentFd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0644);
+    if (segmentFd < 0) throw runtime_error("Failed to create action log segment " + path + ": " + strerror(errno));
+
+    if (fd >= 0) ::close(fd);
+    fd = segmentFd;
+    {
+        lock_guard<mutex> lock(logMutex);
+        segmentIndex = index;
+    }
+
+    uint8_t header[ACTION_LOG_HEADER_SIZE];
+    WireWriter writer(header, sizeof(header));
+    writer.putU32(ACTION_LOG_MAGIC);
+    writer.putU16(ACTION_LOG_VERSION);
+    writer.putU16(0);
+    writer.putU32(index);
+    writer.putU32(0);
+    writeAll(header, sizeof(header));
+    segmentOffset = ACTION_LOG_HEADER_SIZE;
+
+    // The new segment only survives a crash once the directory entry does
+    int dirFd = open(options.directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        ::close(dirFd);
+    }
+}
+
+void ActionLog::writeAll(const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) throw runtime_error("Failed to write action log segment: " + string(strerror(errno)));
+        data += written;
+        size -= written;
+    }
+}
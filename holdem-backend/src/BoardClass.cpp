@@ -0,0 +1,88 @@
+#include "../include/BoardClass.h"
+#include "../include/CardSubset.h"
+#include <algorithm>
+
+namespace {
+    const int NUM_SUITS = 4;
+    const uint64_t RANK_MASK = 0x1FFF;
+
+    // Orders the suits by the ranks they hold, highest first (ties keep suit order), and
+    // returns the board with them renamed in that order
+    uint64_t sortSuits(uint64_t board, array<uint8_t, NUM_SUITS>& suitMap) {
+        uint64_t ranks[NUM_SUITS];
+        int order[NUM_SUITS];
+        for (int suit = 0; suit < NUM_SUITS; ++suit) {
+            ranks[suit] = (board >> (suit * NUM_VALUES)) & RANK_MASK;
+            int i = suit;
+            for (; i > 0 && ranks[order[i - 1]] < ranks[suit]; --i) order[i] = order[i - 1];
+            order[i] = suit;
+        }
+
+        uint64_t sorted = 0;
+        for (int i = 0; i < NUM_SUITS; ++i) {
+            suitMap[order[i]] = static_cast<uint8_t>(i);
+            sorted |= ranks[order[i]] << (i * NUM_VALUES);
+        }
+        return sorted;
+    }
+
+    // Sorted representatives of each board size, enumerated on first use
+    vector<uint64_t> representatives[MAX_CLASS_BOARD_CARDS + 1];
+    once_flag representativesBuilt[MAX_CLASS_BOARD_CARDS + 1];
+
+    const vector<uint64_t>& getRepresentatives(int numCards) {
+        if (numCards < MIN_CLASS_BOARD_CARDS || numCards > MAX_CLASS_BOARD_CARDS) {
+            throw runtime_error("Board classes are for the flop, turn and river");
+        }
+        call_once(representativesBuilt[numCards], [numCards]() {
+            // Colex order is increasing mask order, so they come out sorted
+            array<uint8_t, NUM_SUITS> suitMap;
+            for (uint64_t board : CardSubsets(FULL_DECK_MASK, numCards)) {
+                if (sortSuits(board, suitMap) == board) representatives[numCards].push_back(board);
+            }
+        });
+        return representatives[numCards];
+    }
+
+    uint64_t renameSuits(uint64_t cards, const array<uint8_t, NUM_SUITS>& suitMap) {
+        uint64_t renamed = 0;
+        for (int suit = 0; suit < NUM_SUITS; ++suit) {
+            renamed |= ((cards >> (suit * NUM_VALUES)) & RANK_MASK) << (suitMap[suit] * NUM_VALUES);
+        }
+        return renamed;
+    }
+}
+
+uint64_t CanonicalBoard::apply(uint64_t other) const {
+    return renameSuits(other, suitMap);
+}
+
+uint64_t CanonicalBoard::revert(uint64_t other) const {
+    array<uint8_t, NUM_SUITS> inverse;
+    for (int suit = 0; suit < NUM_SUITS; ++suit) inverse[suitMap[suit]] = static_cast<uint8_t>(suit);
+    return renameSuits(other, inverse);
+}
+
+CanonicalBoard BoardClass::canonicalize(const vector<Card>& board) {
+    uint64_t cards = HandRank::getMask(board);
+    if (HandRank::countCards(cards) != static_cast<int>(board.size())) throw runtime_error("Board repeats a card");
+    return canonicalize(cards);
+}
+
+CanonicalBoard BoardClass::canonicalize(uint64_t board) {
+    if (board & ~FULL_DECK_MASK) throw runtime_error("Board holds an invalid card");
+    CanonicalBoard canonical;
+    canonical.numCards = HandRank::countCards(board);
+    const vector<uint64_t>& sorted = getRepresentatives(canonical.numCards);
+    canonical.cards = sortSuits(board, canonical.suitMap);
+    canonical.index = static_cast<uint32_t>(lower_bound(sorted.begin(), sorted.end(), canonical.cards) - sorted.begin());
+    return canonical;
+}
+
+int BoardClass::getNumClasses(int numCards) {
+    return static_cast<int>(getRepresentatives(numCards).size());
+}
+
+uint64_t BoardClass::getRepresentative(int numCards, uint32_t index) {
+    return getRepresentatives(numCards).at(index);
+}
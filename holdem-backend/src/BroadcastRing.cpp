@@ -0,0 +1,72 @@
+#include "../include/BroadcastRing.h"
+#include <stdexcept>
+
+BroadcastRing::BroadcastRing(size_t capacity) :
+    slots(capacity),
+    nextIndex(0),
+    latestKeyframe(),
+    isNotifyPending(false) {
+    if (capacity == 0) throw invalid_argument("A broadcast ring needs at least one slot!");
+}
+
+bool BroadcastRing::publish(const uint8_t* data, size_t size, bool isKeyframe) {
+    // Encode and allocate outside the lock, subscribers only ever copy the pointer
+    auto frame = make_shared<BroadcastFrame>();
+    frame->isKeyframe = isKeyframe;
+    frame->data.assign(data, data + size);
+
+    // The frame being overwritten is released outside the lock too
+    shared_ptr<const BroadcastFrame> overwritten;
+    {
+        lock_guard<mutex> lock(ringMutex);
+        frame->index = nextIndex;
+        overwritten = std::move(slots[nextIndex % slots.size()]);
+        slots[nextIndex % slots.size()] = frame;
+        if (isKeyframe) latestKeyframe = frame;
+        nextIndex++;
+    }
+
+    return !isNotifyPending.exchange(true);
+}
+
+shared_ptr<const BroadcastFrame> BroadcastRing::next(BroadcastCursor& cursor) const {
+    lock_guard<mutex> lock(ringMutex);
+    uint64_t oldestIndex = getOldestIndex();
+
+    // Fell behind, the frames it needs have been overwritten
+    if (cursor.isSynced && cursor.nextIndex < oldestIndex) {
+        cursor.isSynced = false;
+        cursor.numSkips++;
+    }
+
+    if (!cursor.isSynced) {
+        // The frames following the keyframe must still be in the ring
+        if (latestKeyframe == nullptr || latestKeyframe->index + 1 < oldestIndex) return nullptr;
+
+        cursor.isSynced = true;
+        cursor.nextIndex = latestKeyframe->index + 1;
+        return latestKeyframe;
+    }
+
+    if (cursor.nextIndex >= nextIndex) return nullptr;
+    return slots[cursor.nextIndex++ % slots.size()];
+}
+
+void BroadcastRing::clearNotifyPending() {
+    isNotifyPending = false;
+}
+
+uint64_t BroadcastRing::getNumPublished() const {
+    lock_guard<mutex> lock(ringMutex);
+    return nextIndex;
+}
+
+size_t BroadcastRing::getCapacity() const {
+    return slots.size();
+}
+
+// Helper Functions
+
+uint64_t BroadcastRing::getOldestIndex() const {
+    return (nextIndex > slots.size()) ? nextIndex - slots.size() : 0;
+}
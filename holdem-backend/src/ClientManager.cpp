@@ -3,13 +3,30 @@
 #include "../include/TurnManager.h"
 #include "../include/Action.h"
 #include <algorithm>
+#include <cctype>
+#include <limits>
+#include <stdexcept>
 
-ClientManager::ClientManager(size_t bigBlind) : bigBlind(bigBlind) {}
+ClientManager::ClientManager(size_t bigBlind) : bigBlind(bigBlind), input(&cin), isScripted(false) {}
+
+void ClientManager::setScript(istream& script) {
+    input = &script;
+    isScripted = true;
+}
+
+bool ClientManager::isInputExhausted() {
+    while (true) {
+        *input >> ws;
+        if (input->peek() != '#') break;
+        input->ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    return input->peek() == char_traits<char>::eof();
+}
 
 ClientAction ClientManager::getClientAction(const StreetState& streetState, vector<PossibleAction>& possibleActions) {
     // If betting street is preflop and the player to act is big blind, the 'check' is a call of the active bet.
     // This must be reflected when displaying possible actions, and also fetching of the action type.
-    displayPossibleActions(streetState, possibleActions);
+    if (!isScripted) displayPossibleActions(streetState, possibleActions);
 
     // Fetch action type from client
     ActionType clientActionType = getClientActionType(streetState, possibleActions);
@@ -17,12 +34,8 @@ ClientAction ClientManager::getClientAction(const StreetState& streetState, vect
     // Fetch bet amount from client
     size_t amount = getClientBetAmount(streetState, possibleActions, clientActionType);
 
-    cout << "BET AMOUNT IS " << amount << endl;
-
     ClientAction clientAction = ClientAction{streetState.getCurPlayer(), clientActionType, amount};
-    // displayClientAction(clientAction);
-
-    cout << "\n" << endl;
+    if (!isScripted) cout << "BET AMOUNT IS " << amount << "\n" << endl;
     return clientAction;
 }
 
@@ -33,11 +46,12 @@ ActionType ClientManager::getClientActionType(const StreetState& streetState, ve
     ActionType actionType;
 
     while (true) {
-        cout << "Please enter a valid action: ";
-        getline(cin, actionStr);
+        prompt("Please enter a valid action: ");
+        if (!readToken(actionStr)) throw runtime_error("Client input ended while waiting for an action!");
 
         actionType = strToActionType(actionStr, streetState.isPlayerBigBlindPreFlop());
         if (isValidAction(possibleActions, actionType)) break;
+        rejectInput("'" + actionStr + "' is not a possible action for " + streetState.getCurPlayer()->getName());
     }
     return actionType;
 }
@@ -48,57 +62,120 @@ size_t ClientManager::getClientBetAmount(const StreetState& streetState, vector<
         return 0;
     }
 
+    size_t maxBet = getMaxBet(streetState);
+
+    // Case 2: Call (Call amount is previous bet amount)
+    if (clientAction == ActionType::CALL) {
+        return getCallAmount(streetState, possibleActions);
+    }
+
+    // Case 3: Bet or Raise (Bet amount determined by the client)
+    size_t minBet = getMinBet(streetState, possibleActions, clientAction);
+
+    // Edge case where a player is all in to bet or raise (no choice)
+    if (minBet == maxBet) return maxBet;
+
+    // Fetch client bet amount from the client
+    size_t amount;
+    while (true) {
+        prompt("Please enter a bet size of [" + to_string(minBet) + ", " + to_string(maxBet) + "]: ");
+        if (!readNumber(amount)) {
+            rejectInput("Please enter a valid number!");
+        } else if (isValidAmount(amount, minBet, maxBet)) {
+            return amount;
+        } else {
+            rejectInput("Bet size " + to_string(amount) + " is outside of [" + to_string(minBet) + ", " + to_string(maxBet) + "]");
+        }
+    }
+}
+
+bool ClientManager::queryYesNo(const string& question) {
+    prompt(question);
+    string answer;
+    if (!readToken(answer)) return false;
+
+    transform(answer.begin(), answer.end(), answer.begin(), ::tolower);
+    return answer == "y";
+}
+
+string ClientManager::queryPlayerName() {
+    string name;
+    do {
+        prompt("Enter player's name: ");
+        if (!readToken(name)) throw runtime_error("Client input ended while waiting for a player name!");
+        transform(name.begin(), name.end(), name.begin(), ::tolower);
+    } while (name.empty());
+    return name;
+}
+
+size_t ClientManager::queryChips(const string& text, size_t minChips) {
+    size_t chips;
+    while (true) {
+        prompt(text);
+        if (readNumber(chips) && chips > 0 && chips >= minChips) return chips;
+        rejectInput("Invalid input. Please enter a valid number of chips.");
+    }
+}
+
+size_t ClientManager::getMaxBet(const StreetState& streetState) const {
     // maxBet is the maximum amount the client can 'bet' provided how many chips they have, and the stack of others
     // If the player is the big stack among the table, the max they can bet is the next biggest stack
     // If everyone else has gone all-in or folded, by definition, the player to act must be at least the biggest stack,
     // so they just end up calling the active bet, and the callAmount will never be greater than their initial chips!
     size_t bigStackAmongOthers = streetState.getBigStackAmongOthers();
     size_t initialChips = streetState.getPlayerInitialChips();
-    size_t maxBet = (bigStackAmongOthers == 0) ? initialChips : min(initialChips, bigStackAmongOthers);
-    // cout << "initial, bigStackOthers, maxBet is: " << initialChips << bigStackAmongOthers << maxBet << endl;
+    return (bigStackAmongOthers == 0) ? initialChips : min(initialChips, bigStackAmongOthers);
+}
 
-    // Case 2: Call (Call amount is previous bet amount)
-    if (clientAction == ActionType::CALL) {
-        size_t callAmount = getRelevantBet(possibleActions, clientAction);
-        if (callAmount >= maxBet) callAmount = maxBet; // Edge case where player is all in to call
-        return callAmount;
-    }
+size_t ClientManager::getCallAmount(const StreetState& streetState, vector<PossibleAction>& possibleActions) {
+    size_t maxBet = getMaxBet(streetState);
+    size_t callAmount = getRelevantBet(possibleActions, ActionType::CALL);
+    if (callAmount >= maxBet) callAmount = maxBet; // Edge case where player is all in to call
+    return callAmount;
+}
 
-    // Case 3: Bet or Raise (Bet amount determined by the client)
+size_t ClientManager::getMinBet(const StreetState& streetState, vector<PossibleAction>& possibleActions, ActionType clientAction) {
+    size_t maxBet = getMaxBet(streetState);
     size_t minBet = bigBlind; // Minimum bet is set to big blind by default
 
     // Set minimum bet if the client wishes to raise
     if (clientAction == ActionType::RAISE) {
         size_t prevBetAmount = getRelevantBet(possibleActions, clientAction);
-        size_t standardRaiseSize = 2 * prevBetAmount;
-
-        // Edge case where a player is all in to raise (no choice)
-        if (standardRaiseSize >= maxBet) return maxBet;
-        else {
-            minBet = standardRaiseSize;
-        }
+        minBet = 2 * prevBetAmount;
     }
 
-    // Fetch client bet amount from stdin
-    size_t amount;
-    while (true) {
-        cout << "Please enter a bet size of [" << minBet << ", " << maxBet << "]: ";
-        cin >> amount;
+    // Short stacks may only go all in
+    return min(minBet, maxBet);
+}
 
-        if (cin.fail()) {
-            cout << "Please enter a valid number!" << endl;
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-        } else {
-            if (isValidAmount(amount, minBet, maxBet)) {
-                cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                return amount;
-            }
-        }
+// Helper Functions
+
+void ClientManager::prompt(const string& text) {
+    if (!isScripted) cout << text << flush;
+}
+
+bool ClientManager::readToken(string& token) {
+    if (isInputExhausted()) return false;
+    return static_cast<bool>(*input >> token);
+}
+
+bool ClientManager::readNumber(size_t& number) {
+    string token;
+    if (!readToken(token)) throw runtime_error("Client input ended while waiting for a number!");
+    if (token.empty() || !all_of(token.begin(), token.end(), [](unsigned char c) { return isdigit(c); })) return false;
+
+    try {
+        number = stoull(token);
+    } catch (const out_of_range&) {
+        return false;
     }
+    return true;
 }
 
-// Helper Functions
+void ClientManager::rejectInput(const string& reason) {
+    if (isScripted) throw runtime_error("Invalid scripted input: " + reason);
+    cout << reason << endl;
+}
 
 void ClientManager::displayPossibleActions(const StreetState& streetState, vector<PossibleAction>& possibleActions) {
     cout << "Displaying possible actions for " << streetState.getCurPlayer()->getName() << ":" << endl;
@@ -145,8 +222,5 @@ size_t ClientManager::getRelevantBet(vector<PossibleAction>& possibleActions, Ac
 }
 
 bool ClientManager::isValidAmount(size_t amount, size_t min, size_t max) {
-    if (amount >= min && amount <= max) return true;
-
-    cout << "Entered a bet amount outside of the provided range!" << endl;
-    return false;
+    return amount >= min && amount <= max;
 }
\ No newline at end of file
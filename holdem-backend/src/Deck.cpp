@@ -4,13 +4,18 @@
 #include <assert.h>
 using namespace std;
 
-Deck::Deck() : deckIndex(0), isShuffled(false) {
-    size_t index = 0;
-    for (int suit = 0; suit < 4; ++suit) {
-        for (int value = 2; value <= 14; ++value) {
-            deck[index++] = Card(static_cast<Suit>(suit), static_cast<Value>(value));
-        }
-    }
+namespace {
+    const uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+}
+
+Deck::Deck() : deckIndex(0), isShuffled(false), seed(random_device{}()), numShuffles(0) {
+    seed = (seed << 32) ^ random_device{}();
+    shuffleDeck();
+}
+
+void Deck::setSeed(uint64_t seed) {
+    this->seed = seed;
+    numShuffles = 0;
     shuffleDeck();
 }
 
@@ -39,10 +44,19 @@ void Deck::resetDeck() {
     shuffleDeck();
 }
 
+void Deck::fillDeck() {
+    size_t index = 0;
+    for (int suit = 0; suit < 4; ++suit) {
+        for (int value = 2; value <= 14; ++value) {
+            deck[index++] = Card(static_cast<Suit>(suit), static_cast<Value>(value));
+        }
+    }
+}
+
 void Deck::shuffleDeck() {
-    random_device rd;
-    mt19937 g(rd());
-    shuffle(deck.begin(), deck.end(), g);
+    mt19937_64 rng(seed + GOLDEN_GAMMA * numShuffles++);
+    fillDeck();
+    shuffle(deck.begin(), deck.end(), rng);
     deckIndex = 0;
     isShuffled = true;
 }
@@ -0,0 +1,250 @@
+#include "../include/Equity.h"
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    const int NUM_SUITS = 4;
+    const uint32_t RANK_MASK = 0x1FFF;
+
+    // Cards left to deal, the hands they are dealt against and the suits that are interchangeable
+    typedef struct Runouts {
+        const uint64_t* hands;
+        size_t numHands;
+        uint64_t cards[52];
+        int numCards;
+
+        // Suits grouped by what they hold, each group in increasing suit order
+        int numGroups;
+        int groupSize[NUM_SUITS];
+        int groupSuits[NUM_SUITS][NUM_SUITS];
+        bool hasSwaps;
+
+        // The suit before each in its group (-1 if first), and for each card the suit it is
+        // in and the index of the first card of the next suit
+        int previousSuit[NUM_SUITS];
+        int cardSuit[52];
+        int nextSuitStart[52];
+    } Runouts;
+
+    inline uint32_t getSuitRanks(uint64_t cards, int suit) {
+        return (cards >> (suit * NUM_VALUES)) & RANK_MASK;
+    }
+
+    // Groups the suits that hold the same ranks in every hand and on the board
+    void groupSuits(Runouts& runouts, uint64_t board, bool reduceSuits) {
+        runouts.numGroups = 0;
+        runouts.hasSwaps = false;
+        for (int suit = 0; suit < NUM_SUITS; ++suit) {
+            int group = 0;
+            for (; reduceSuits && group < runouts.numGroups; ++group) {
+                int other = runouts.groupSuits[group][0];
+                bool isSame = getSuitRanks(board, suit) == getSuitRanks(board, other);
+                for (size_t i = 0; isSame && i < runouts.numHands; ++i) {
+                    isSame = getSuitRanks(runouts.hands[i], suit) == getSuitRanks(runouts.hands[i], other);
+                }
+                if (isSame) break;
+            }
+            if (!reduceSuits || group == runouts.numGroups) {
+                group = runouts.numGroups++;
+                runouts.groupSize[group] = 0;
+            }
+            runouts.previousSuit[suit] = (runouts.groupSize[group] > 0) ? runouts.groupSuits[group][runouts.groupSize[group] - 1] : -1;
+            runouts.groupSuits[group][runouts.groupSize[group]++] = suit;
+            runouts.hasSwaps |= (runouts.groupSize[group] > 1);
+        }
+
+        for (int i = runouts.numCards - 1; i >= 0; --i) {
+            runouts.cardSuit[i] = __builtin_ctzll(runouts.cards[i]) / NUM_VALUES;
+            bool isLastOfSuit = (i == runouts.numCards - 1) || runouts.cardSuit[i + 1] != runouts.cardSuit[i];
+            runouts.nextSuitStart[i] = isLastOfSuit ? i + 1 : runouts.nextSuitStart[i + 1];
+        }
+    }
+
+    // Returns how many distinct runouts swapping interchangeable suits makes of this one,
+    // or 0 if it isn't the representative with each group in descending rank mask order.
+    // Dealing only ever reaches representatives, this is the backstop.
+    uint64_t getRunoutWeight(const Runouts& runouts, uint64_t runout) {
+        static const uint64_t FACTORIALS[] = {1, 1, 2, 6, 24};
+        uint64_t weight = 1;
+        for (int group = 0; group < runouts.numGroups; ++group) {
+            int size = runouts.groupSize[group];
+            if (size == 1) continue;
+
+            uint64_t orderings = FACTORIALS[size];
+            int runLength = 1;
+            uint32_t previous = getSuitRanks(runout, runouts.groupSuits[group][0]);
+            for (int i = 1; i < size; ++i) {
+                uint32_t ranks = getSuitRanks(runout, runouts.groupSuits[group][i]);
+                if (ranks > previous) return 0;
+                runLength = (ranks == previous) ? runLength + 1 : 1;
+                orderings /= runLength;
+                previous = ranks;
+            }
+            weight *= orderings;
+        }
+        return weight;
+    }
+
+    void scoreBoard(const Runouts& runouts, uint64_t runout, uint64_t board, EquityResult& tally) {
+        uint64_t weight = runouts.hasSwaps ? getRunoutWeight(runouts, runout) : 1;
+        if (weight == 0) return;
+
+        uint32_t ranks[MAX_EQUITY_HANDS];
+        uint32_t best = 0;
+        for (size_t i = 0; i < runouts.numHands; ++i) {
+            ranks[i] = HandRank::evaluate(runouts.hands[i] | board);
+            if (ranks[i] > best) best = ranks[i];
+        }
+
+        int numWinners = 0;
+        for (size_t i = 0; i < runouts.numHands; ++i) numWinners += (ranks[i] == best);
+
+        tally.numBoards += weight;
+        tally.numRanked++;
+        if (numWinners == 1) {
+            for (size_t i = 0; i < runouts.numHands; ++i) {
+                if (ranks[i] != best) continue;
+                tally.wins[i] += weight;
+                tally.shares[i] += weight;
+            }
+            return;
+        }
+        double share = static_cast<double>(weight) / numWinners;
+        for (size_t i = 0; i < runouts.numHands; ++i) {
+            if (ranks[i] != best) continue;
+            tally.ties[i] += weight;
+            tally.shares[i] += share;
+        }
+    }
+
+    // Checks a runout still has each suit's ranks at most those of the suit before it in
+    // its group. Cards are dealt in increasing order, so the suit before is complete and
+    // any later card in the same suit would only raise the ranks further.
+    inline bool isInOrder(const Runouts& runouts, uint64_t runout, int suit) {
+        int previous = runouts.previousSuit[suit];
+        return previous < 0 || getSuitRanks(runout, suit) <= getSuitRanks(runout, previous);
+    }
+
+    // Deals the remaining numToDeal cards in increasing card order from start
+    void dealRunouts(const Runouts& runouts, int start, int numToDeal, uint64_t runout, uint64_t board, EquityResult& tally) {
+        if (numToDeal == 0) {
+            scoreBoard(runouts, runout, board | runout, tally);
+            return;
+        }
+        for (int i = start; i <= runouts.numCards - numToDeal; ++i) {
+            uint64_t next = runout | runouts.cards[i];
+            if (!isInOrder(runouts, next, runouts.cardSuit[i])) {
+                i = runouts.nextSuitStart[i] - 1;
+                continue;
+            }
+            dealRunouts(runouts, i + 1, numToDeal - 1, next, board, tally);
+        }
+    }
+
+    // Deals the runouts whose first card falls to this worker
+    void dealWorkerRunouts(const Runouts& runouts, int numToDeal, uint64_t board,
+                           int worker, int numWorkers, EquityResult& tally) {
+        if (numToDeal == 0) {
+            if (worker == 0) scoreBoard(runouts, 0, board, tally);
+            return;
+        }
+        for (int i = worker; i <= runouts.numCards - numToDeal; i += numWorkers) {
+            if (!isInOrder(runouts, runouts.cards[i], runouts.cardSuit[i])) continue;
+            dealRunouts(runouts, i + 1, numToDeal - 1, runouts.cards[i], board, tally);
+        }
+    }
+}
+
+EquityResult::EquityResult() : numBoards(0), numRanked(0) {}
+
+EquityResult::EquityResult(size_t numHands) :
+    numBoards(0),
+    numRanked(0),
+    wins(numHands, 0),
+    ties(numHands, 0),
+    shares(numHands, 0.0)
+{}
+
+void EquityResult::merge(const EquityResult& other) {
+    numBoards += other.numBoards;
+    numRanked += other.numRanked;
+    for (size_t i = 0; i < wins.size(); ++i) {
+        wins[i] += other.wins[i];
+        ties[i] += other.ties[i];
+        shares[i] += other.shares[i];
+    }
+}
+
+double EquityResult::getWinFraction(size_t hand) const {
+    return (numBoards == 0) ? 0.0 : static_cast<double>(wins.at(hand)) / numBoards;
+}
+
+double EquityResult::getTieFraction(size_t hand) const {
+    return (numBoards == 0) ? 0.0 : static_cast<double>(ties.at(hand)) / numBoards;
+}
+
+double EquityResult::getLossFraction(size_t hand) const {
+    return (numBoards == 0) ? 0.0 : static_cast<double>(numBoards - wins.at(hand) - ties.at(hand)) / numBoards;
+}
+
+double EquityResult::getEquity(size_t hand) const {
+    return (numBoards == 0) ? 0.0 : shares.at(hand) / numBoards;
+}
+
+EquityResult Equity::computeHeadsUp(const vector<Card>& first, const vector<Card>& second,
+                                    const vector<Card>& board, int numThreads) {
+    if (first.size() != NUM_HOLE_CARDS || second.size() != NUM_HOLE_CARDS) {
+        throw runtime_error("Each hand needs exactly two hole cards");
+    }
+    if (HandRank::countCards(HandRank::getMask(board)) != static_cast<int>(board.size())) {
+        throw runtime_error("Board has a repeated card");
+    }
+    return computeExact({HandRank::getMask(first), HandRank::getMask(second)}, HandRank::getMask(board), numThreads);
+}
+
+uint64_t Equity::validate(const vector<uint64_t>& hands, uint64_t board, bool allowUnknown) {
+    if (hands.size() < 2 || hands.size() > MAX_EQUITY_HANDS) {
+        throw runtime_error("Equity needs between 2 and " + to_string(MAX_EQUITY_HANDS) + " hands");
+    }
+    int numBoardCards = HandRank::countCards(board);
+    if (numBoardCards == 1 || numBoardCards == 2 || numBoardCards > NUM_BOARD_CARDS || (board & ~FULL_DECK_MASK)) {
+        throw runtime_error("Board must have 0, 3, 4 or 5 cards");
+    }
+
+    uint64_t dealt = board;
+    for (uint64_t hand : hands) {
+        if (allowUnknown && hand == 0) continue;
+        if (HandRank::countCards(hand) != NUM_HOLE_CARDS || (hand & ~FULL_DECK_MASK)) {
+            throw runtime_error("Each hand needs exactly two hole cards");
+        }
+        if (dealt & hand) throw runtime_error("A card is dealt twice");
+        dealt |= hand;
+    }
+    return dealt;
+}
+
+EquityResult Equity::computeExact(const vector<uint64_t>& hands, uint64_t board, int numThreads, bool reduceSuits) {
+    uint64_t dealt = validate(hands, board);
+
+    Runouts runouts;
+    runouts.hands = hands.data();
+    runouts.numHands = hands.size();
+    runouts.numCards = 0;
+    for (uint64_t remaining = FULL_DECK_MASK & ~dealt; remaining != 0; remaining &= remaining - 1) {
+        runouts.cards[runouts.numCards++] = remaining & -remaining;
+    }
+    int numToDeal = NUM_BOARD_CARDS - HandRank::countCards(board);
+    groupSuits(runouts, board, reduceSuits);
+
+    int numWorkers = max(1, min(numThreads, runouts.numCards));
+    vector<EquityResult> tallies(numWorkers, EquityResult(hands.size()));
+    vector<thread> workers;
+    for (int worker = 1; worker < numWorkers; ++worker) {
+        workers.emplace_back(dealWorkerRunouts, cref(runouts), numToDeal, board, worker, numWorkers, ref(tallies[worker]));
+    }
+    dealWorkerRunouts(runouts, numToDeal, board, 0, numWorkers, tallies[0]);
+    for (thread& worker : workers) worker.join();
+
+    for (int worker = 1; worker < numWorkers; ++worker) tallies[0].merge(tallies[worker]);
+    return tallies[0];
+}
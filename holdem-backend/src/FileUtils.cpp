@@ -0,0 +1,77 @@
+#include "../include/FileUtils.h"
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+    array<uint32_t, 256> makeCrcTable() {
+        array<uint32_t, 256> table;
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            table[i] = crc;
+        }
+        return table;
+    }
+
+    bool writeAll(int fd, const uint8_t* data, size_t size) {
+        while (size > 0) {
+            ssize_t written = ::write(fd, data, size);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return false;
+            data += written;
+            size -= written;
+        }
+        return true;
+    }
+}
+
+uint32_t computeCrc32(const uint8_t* data, size_t size) {
+    static const array<uint32_t, 256> table = makeCrcTable();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+bool writeFileAtomically(const string& path, const uint8_t* data, size_t size) {
+    string tmpPath = path + ".tmp";
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+
+    bool isWritten = writeAll(fd, data, size) && fdatasync(fd) == 0;
+    ::close(fd);
+    if (!isWritten || rename(tmpPath.c_str(), path.c_str()) != 0) {
+        unlink(tmpPath.c_str());
+        return false;
+    }
+
+    // The rename itself is only durable once the directory is synced
+    size_t slash = path.find_last_of('/');
+    string directory = (slash == string::npos) ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int dirFd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) return false;
+    bool isSynced = fsync(dirFd) == 0;
+    ::close(dirFd);
+    return isSynced;
+}
+
+bool readWholeFile(const string& path, vector<uint8_t>& data) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    data.clear();
+    uint8_t chunk[4096];
+    ssize_t numRead;
+    while ((numRead = ::read(fd, chunk, sizeof(chunk))) != 0) {
+        if (numRead < 0 && errno == EINTR) continue;
+        if (numRead < 0) {
+            ::close(fd);
+            return false;
+        }
+        data.insert(data.end(), chunk, chunk + numRead);
+    }
+    ::close(fd);
+    return true;
+}
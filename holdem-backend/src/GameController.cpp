@@ -1,4 +1,7 @@
 #include "../include/GameController.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
 
 GameController::GameController(size_t smallBlind, size_t bigBlind) :
     smallBlind(smallBlind),
@@ -13,46 +16,29 @@ GameController::GameController(size_t smallBlind, size_t bigBlind) :
     clientManager(bigBlind),
     potManager(),
     handEvaluator(),
-    streetState() {}
-
-
-inline void handleBlind(TurnManager& turnManager, ActionManager& actionManager, PotManager& potManager, int blindAmount, bool isSmallBlind) {
+    streetState(),
+    curStreet(PRE_FLOP),
+    isRoundActive(false),
+    isStreetActive(false),
+    isDecisionPending(false),
+    possibleActions(),
+    tableId(0),
+    handRecord(),
+    actionLog(nullptr),
+    logSequence(0),
+    runoutEquityOptions(nullptr),
+    runoutEquities(),
+    runoutJobs(),
+    streetStrength(nullptr) {}
+
+
+inline shared_ptr<Player> handleBlind(TurnManager& turnManager, ActionManager& actionManager, PotManager& potManager, int blindAmount, bool isSmallBlind) {
     if (isSmallBlind) turnManager.setSmallBlindToAct();
     auto player = turnManager.getPlayerToAct();
     auto blindAction = std::make_shared<BlindAction>(player, blindAmount);
     actionManager.addActionToTimelineAndUpdateActionState(blindAction);
     potManager.addPlayerBet(player, blindAmount, false);
-}
-
-// While loop can be simplified to:
-// Display info
-// Ask info
-// Process info
-void GameController::startStreet(Street newStreet) {
-    if (!turnManager.isNewStreetPossible()) return; // UPDATE GAME STATE
-
-    setupStreet(newStreet); // UPDATE GAME STATE
-
-    while (!actionManager.isActionsFinished(streetState.getInitialNumPlayers())) {
-
-        // Get player to act and fetch possible actions
-        shared_ptr<Player> curPlayer = turnManager.getPlayerToAct(); // UPDATE GAME STATE
-        udpateStreetStateForCurPlayer(curPlayer);
-        vector<PossibleAction> possibleActions = actionManager.getAllowedActionTypes(streetState.getPlayerCanRaise()); // UPDATE GAME STATE
-
-        // DISPLAY GAME STATE
-        // REQUEST CLIENT INPUT
-
-        // Request client action given possible actions
-        ClientAction clientAction = clientManager.getClientAction(streetState, possibleActions);
-
-        // Process the new action object in ActionManager, potManager and turnManager
-        // Refactor: We can chuck the client Action inside processNewAction
-        shared_ptr<Action> playerAction = createAction(clientAction, streetState.getPlayerInitialChips());
-        processNewAction(curPlayer, playerAction); // UPDATE GAME STATE
-    }
-
-    cleanupStreet(); // UPDATE GAME STATE
+    return player;
 }
 
 void GameController::setupStreet(Street newStreet) {
@@ -63,8 +49,8 @@ void GameController::setupStreet(Street newStreet) {
 
     if (newStreet == PRE_FLOP) {
         dealPlayers();
-        handleBlind(turnManager, actionManager, potManager, smallBlind, true);
-        handleBlind(turnManager, actionManager, potManager, bigBlind, false);
+        recordAction(handleBlind(turnManager, actionManager, potManager, smallBlind, true), BLIND, smallBlind);
+        recordAction(handleBlind(turnManager, actionManager, potManager, bigBlind, false), BLIND, bigBlind);
     } else if (newStreet == FLOP) {
         dealBoard(3);
         turnManager.setEarlyPositionToAct();
@@ -78,6 +64,10 @@ void GameController::processNewAction(shared_ptr<Player>& player, const shared_p
     actionManager.addActionToTimelineAndUpdateActionState(playerAction);
 
     ActionType playerActionType = playerAction->getActionType();
+    recordAction(player, playerActionType, playerAction->getAmount());
+    if (actionLog != nullptr) {
+        logSequence = actionLog->appendAction(tableId, static_cast<uint32_t>(handRecord.handNumber), handRecord.actions.back());
+    }
     switch (playerActionType) {
         case BET:
         case RAISE:
@@ -115,11 +105,13 @@ void GameController::cleanupStreet() {
 
 void GameController::startRound() {
     // DISPLAY THE GAME STATE TO THE CLIENT
-    startStreet(PRE_FLOP);
-    startStreet(FLOP);
-    startStreet(TURN);
-    startStreet(RIVER);
-    evaluatePots(); // UPDATE STATE
+    beginRound(); // UPDATE STATE
+
+    while (isAwaitingAction()) {
+        // Request client action given possible actions
+        ClientAction clientAction = clientManager.getClientAction(streetState, possibleActions);
+        processClientAction(clientAction); // UPDATE STATE
+    }
     // DISPLAY STATE
     cout << "Round completed!\n" << endl;
 }
@@ -127,16 +119,344 @@ void GameController::startRound() {
 void GameController::evaluatePots() {
     potManager.displayPots();
     handEvaluator.populatePlayerHandsMap(gamePlayers.getGamePlayers(), board.getCommunityCards());
+    handEvaluator.evaluatePlayerHands();
     vector<shared_ptr<Player>> sortedPlayers = handEvaluator.getSortedPlayers();
+
+    vector<size_t> chipsBeforeAward;
+    for (const auto& player : gamePlayers.getGamePlayers()) chipsBeforeAward.push_back(player->getChips());
+    finishHandRecord();
     potManager.awardPots(sortedPlayers);
+
+    // Winners are the seats whose stacks grew with the award
+    const vector<shared_ptr<Player>>& players = gamePlayers.getGamePlayers();
+    for (size_t i = 0; i < players.size(); ++i) {
+        if (players[i]->getChips() <= chipsBeforeAward[i]) continue;
+        HandResult result;
+        result.position = static_cast<uint8_t>(players[i]->getPosition());
+        result.chipsWon = static_cast<uint32_t>(players[i]->getChips() - chipsBeforeAward[i]);
+        handRecord.results.push_back(result);
+    }
+}
+
+void GameController::startHandRecord() {
+    handRecord.clear();
+    handRecord.tableId = tableId;
+    handRecord.handNumber = static_cast<uint64_t>(roundNum);
+    handRecord.startTime = chrono::duration_cast<chrono::milliseconds>(
+        chrono::system_clock::now().time_since_epoch()).count();
+    handRecord.smallBlind = static_cast<uint32_t>(smallBlind);
+    handRecord.bigBlind = static_cast<uint32_t>(bigBlind);
+
+    for (const auto& player : gamePlayers.getGamePlayers()) {
+        HandSeat seat;
+        seat.position = static_cast<uint8_t>(player->getPosition());
+        seat.name = player->getName();
+        seat.startingChips = static_cast<uint32_t>(player->getChips());
+        handRecord.seats.push_back(seat);
+    }
+}
+
+void GameController::recordAction(const shared_ptr<Player>& player, ActionType type, size_t amount) {
+    HandAction action;
+    action.street = static_cast<uint8_t>(curStreet);
+    action.position = static_cast<uint8_t>(player->getPosition());
+    action.type = static_cast<uint8_t>(type);
+    action.amount = static_cast<uint32_t>(amount);
+    handRecord.actions.push_back(action);
+}
+
+void GameController::finishHandRecord() {
+    // Hole cards are kept until setupNewRound, so they are taken now rather than as they are dealt
+    const vector<shared_ptr<Player>>& players = gamePlayers.getGamePlayers();
+    for (size_t i = 0; i < players.size() && i < handRecord.seats.size(); ++i) {
+        const vector<Card>& hand = players[i]->getHand();
+        for (size_t c = 0; c < hand.size() && c < 2; ++c) handRecord.seats[i].holeCards[c] = WireCodec::encodeCard(hand[c]);
+    }
+
+    const vector<Card>& cards = board.getCommunityCards();
+    handRecord.numBoardCards = static_cast<uint8_t>(min<size_t>(cards.size(), 5));
+    for (int i = 0; i < handRecord.numBoardCards; ++i) handRecord.board[i] = WireCodec::encodeCard(cards[i]);
+
+    for (int i = 0; i < potManager.getNumPots(); ++i) {
+        const Pot& pot = potManager.getPot(i);
+        HandPot handPot;
+        handPot.chips = static_cast<uint32_t>(pot.getChips());
+        for (const auto& player : pot.getEligiblePlayers()) {
+            handPot.eligiblePositions |= static_cast<uint16_t>(1u << static_cast<int>(player->getPosition()));
+        }
+        handRecord.pots.push_back(handPot);
+    }
 }
 
 
+// STEP METHODS
+
+bool GameController::beginRound() {
+    if (isRoundActive) throw runtime_error("Attempting to begin a round while a round is in progress!");
+    if (gamePlayers.getNumPlayersInGame() < MIN_NUM_PLAYERS) return false;
+
+    curStreet = PRE_FLOP;
+    isRoundActive = true;
+    isStreetActive = false;
+    isDecisionPending = false;
+
+    roundNum++;
+    startHandRecord();
+
+    advanceToNextDecision();
+    return true;
+}
+
+bool GameController::processClientAction(ClientAction& clientAction) {
+    if (!isDecisionPending) return false;
+    if (!validateClientAction(clientAction)) return false;
+
+    // Process the new action object in ActionManager, potManager and turnManager
+    shared_ptr<Player> curPlayer = streetState.getCurPlayer();
+    shared_ptr<Action> playerAction = createAction(clientAction, streetState.getPlayerInitialChips());
+    isDecisionPending = false;
+    processNewAction(curPlayer, playerAction);
+
+    advanceToNextDecision();
+    return true;
+}
+
+void GameController::advanceToNextDecision() {
+    while (isRoundActive) {
+        if (!isStreetActive) {
+            // Betting action is complete for every street
+            if (curStreet == SHOWDOWN) {
+                evaluatePots();
+                isRoundActive = false;
+                return;
+            }
+
+            if (!turnManager.isNewStreetPossible()) {
+                runOutStreet(curStreet);
+                curStreet = static_cast<Street>(curStreet + 1);
+                continue;
+            }
+
+            setupStreet(curStreet);
+            isStreetActive = true;
+        }
+
+        if (actionManager.isActionsFinished(streetState.getInitialNumPlayers())) {
+            cleanupStreet();
+            isStreetActive = false;
+            curStreet = static_cast<Street>(curStreet + 1);
+            continue;
+        }
+
+        // Get player to act and fetch possible actions
+        shared_ptr<Player> curPlayer = turnManager.getPlayerToAct();
+        udpateStreetStateForCurPlayer(curPlayer);
+        possibleActions = actionManager.getAllowedActionTypes(streetState.getPlayerCanRaise());
+        isDecisionPending = true;
+        return;
+    }
+}
+
+vector<shared_ptr<Player>> GameController::getContenders() const {
+    // All in players leave the turn manager too, so folds are taken from the hand record
+    uint16_t folded = 0;
+    for (const HandAction& action : handRecord.actions) {
+        if (action.type == FOLD) folded |= static_cast<uint16_t>(1u << action.position);
+    }
+
+    vector<shared_ptr<Player>> contenders;
+    for (const auto& player : gamePlayers.getGamePlayers()) {
+        if (player->getHand().empty() || (folded & (1u << static_cast<int>(player->getPosition())))) continue;
+        contenders.push_back(player);
+    }
+    return contenders;
+}
+
+void GameController::runOutStreet(Street street) {
+    if (street == PRE_FLOP) return;
+    vector<shared_ptr<Player>> contenders = getContenders();
+    if (contenders.size() < 2) return;
+
+    if (runoutEquityOptions != nullptr) {
+        // Entries are kept until another hand is run out, so deferred ones can still be attached
+        if (!runoutEquities.empty() && runoutEquities.front().handNumber != handRecord.handNumber) {
+            runoutEquities.clear();
+            runoutJobs.clear();
+        }
+
+        RunoutJob job = RunoutEquity::createJob(contenders, board.getCommunityCards(), street, *runoutEquityOptions);
+        job.handNumber = handRecord.handNumber;
+
+        // Each hand samples its own stream
+        job.options.seed += static_cast<uint64_t>(roundNum);
+
+        // A deferred runout waits for attachRunoutEquity unless the preflop table has it
+        StreetEquity equity;
+        if (!job.options.isDeferred) {
+            equity = RunoutEquity::compute(job);
+        } else if (!RunoutEquity::lookup(job, equity)) {
+            equity.handNumber = job.handNumber;
+            equity.street = street;
+            equity.positions = job.positions;
+            equity.isPending = true;
+            runoutJobs.push_back(job);
+        }
+        if (!equity.isPending) handRecord.addRunoutEquity(equity);
+        runoutEquities.push_back(equity);
+    }
+    dealBoard(street == FLOP ? 3 : 1);
+}
+
+bool GameController::validateClientAction(ClientAction& clientAction) {
+    if (clientAction.player != streetState.getCurPlayer()) return false;
+    if (!clientManager.isValidAction(possibleActions, clientAction.type)) return false;
+
+    switch (clientAction.type) {
+        case CHECK:
+        case FOLD:
+            clientAction.amount = 0;
+            return true;
+        case CALL:
+            clientAction.amount = clientManager.getCallAmount(streetState, possibleActions);
+            return true;
+        case BET:
+        case RAISE: {
+            size_t minBet = clientManager.getMinBet(streetState, possibleActions, clientAction.type);
+            size_t maxBet = clientManager.getMaxBet(streetState);
+            return clientAction.amount >= minBet && clientAction.amount <= maxBet;
+        }
+        default:
+            return false;
+    }
+}
+
+shared_ptr<Player> GameController::addPlayerToGame(const string& name, size_t chips) {
+    if (isRoundActive) throw runtime_error("Attempting to add a player while a round is in progress!");
+
+    shared_ptr<Player> newPlayer = gamePlayers.addPlayerToGame(name, chips);
+    if (newPlayer != nullptr) turnManager.addPlayerInHand(newPlayer);
+    return newPlayer;
+}
+
+shared_ptr<Player> GameController::removePlayerFromGame(const string& name) {
+    if (isRoundActive) throw runtime_error("Attempting to remove a player while a round is in progress!");
+
+    shared_ptr<Player> oldPlayer = gamePlayers.removePlayerFromGame(name);
+    if (oldPlayer != nullptr) turnManager.removePlayerFromHand(oldPlayer);
+    return oldPlayer;
+}
+
+bool GameController::isRoundInProgress() const {
+    return isRoundActive;
+}
+
+bool GameController::isAwaitingAction() const {
+    return isDecisionPending;
+}
+
+const StreetState& GameController::getStreetState() const {
+    return streetState;
+}
+
+const vector<PossibleAction>& GameController::getPossibleActions() const {
+    return possibleActions;
+}
+
+const vector<shared_ptr<Player>>& GameController::getGamePlayers() const {
+    return gamePlayers.getGamePlayers();
+}
+
+const Board& GameController::getBoard() const {
+    return board;
+}
+
+const PotManager& GameController::getPotManager() const {
+    return potManager;
+}
+
+const HandRecord& GameController::getHandRecord() const {
+    return handRecord;
+}
+
+void GameController::setTableId(uint32_t tableId) {
+    this->tableId = tableId;
+}
+
+void GameController::setActionLog(ActionLog* log) {
+    actionLog = log;
+}
+
+uint64_t GameController::getLogSequence() const {
+    return logSequence;
+}
+
+void GameController::setRunoutEquity(const RunoutEquityOptions* options) {
+    runoutEquityOptions = options;
+}
+
+const vector<StreetEquity>& GameController::getRunoutEquities() const {
+    return runoutEquities;
+}
+
+vector<RunoutJob> GameController::takeRunoutJobs() {
+    vector<RunoutJob> jobs;
+    jobs.swap(runoutJobs);
+    return jobs;
+}
+
+bool GameController::attachRunoutEquity(const StreetEquity& equity) {
+    for (StreetEquity& entry : runoutEquities) {
+        if (entry.isPending && entry.handNumber == equity.handNumber && entry.street == equity.street) {
+            entry = equity;
+
+            // Only the hand in progress (or just completed) is still recorded here
+            if (equity.handNumber == handRecord.handNumber) handRecord.addRunoutEquity(equity);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t GameController::getNumPendingRunouts(uint64_t handNumber) const {
+    return count_if(runoutEquities.begin(), runoutEquities.end(), [handNumber](const StreetEquity& entry) {
+        return entry.isPending && entry.handNumber == handNumber;
+    });
+}
+
+void GameController::setStreetStrength(StreetStrength* strength) {
+    streetStrength = strength;
+}
+
+HandPotential GameController::getHandPotential(const Player& player) const {
+    const vector<Card>& communityCards = board.getCommunityCards();
+    if (streetStrength == nullptr || player.getHand().size() != static_cast<size_t>(NUM_HOLE_CARDS) ||
+        communityCards.size() == 1 || communityCards.size() == 2) {
+        return HandPotential();
+    }
+    return streetStrength->lookup(player.getHand(), communityCards);
+}
+
+void GameController::setDeckSeed(uint64_t seed) {
+    if (isRoundActive) throw runtime_error("Attempting to seed the deck while a round is in progress!");
+    deck.setSeed(seed);
+}
+
+size_t GameController::getSmallBlind() const {
+    return smallBlind;
+}
+
+size_t GameController::getBigBlind() const {
+    return bigBlind;
+}
+
 // GAME SPECIFIC METHODS
 
 void GameController::main() {
     int roundNum = 0;
     while (verifyGamePlayers()) {
+        // Nothing left to play a round with
+        if (clientManager.isInputExhausted()) break;
+
         cout << "Beginning round #" << roundNum++ << " of Texas Hold'Em!\n" << endl;
         startRound();
         setupNewRound();
@@ -144,47 +464,29 @@ void GameController::main() {
     cout << "Ending the application! Game Over!\n" << endl;
 }
 
+void GameController::setClientScript(istream& script) {
+    clientManager.setScript(script);
+}
+
 // PLAYER SPECIFIC METHODS
 
 void GameController::queryNewPlayer() {
-    while (true) {
-        cout << "Would you like to add a new player? (y/n): ";
-        string input;
-        cin >> input;
-
-        transform(input.begin(), input.end(), input.begin(), ::tolower);
-
-        if (input != "y") {
-            cout << "No more players will be added!" << endl;
-            break;
-        }
-
+    while (clientManager.queryYesNo("Would you like to add a new player? (y/n): ")) {
         string name = queryPlayerName();
         size_t chips = queryPlayerChips();
 
-        shared_ptr<Player> newPlayer = gamePlayers.addPlayerToGame(name, chips);
-        if (newPlayer != nullptr) turnManager.addPlayerInHand(newPlayer);
+        addPlayerToGame(name, chips);
     }
+    cout << "No more players will be added!" << endl;
 }
 
 void GameController::queryRemovePlayer() {
-    while (true) {
-        cout << "Would you like to remove an existing player? (y/n: ";
-        string input;
-        cin >> input;
-
-        transform(input.begin(), input.end(), input.begin(), ::tolower);
-
-        if (input != "y") {
-            cout << "No more players will be removed.\n" << endl;
-            break;
-        }
-
+    while (clientManager.queryYesNo("Would you like to remove an existing player? (y/n): ")) {
         string playerName = queryPlayerName();
 
-        shared_ptr<Player> oldPlayer = gamePlayers.removePlayerFromGame(playerName);
-        if (oldPlayer != nullptr) turnManager.removePlayerFromHand(oldPlayer);
+        removePlayerFromGame(playerName);
     }
+    cout << "No more players will be removed.\n" << endl;
 }
 
 void GameController::validateChipCounts() {
@@ -309,6 +611,9 @@ void GameController::setupNewRound() {
 
     // Clear the playerHands map
     handEvaluator.clearHandEvaluator();
+
+    // Clear hole cards from the previous round
+    for (const auto& player : gamePlayers.getGamePlayers()) player->resetHand();
 }
 
 bool GameController::verifyNumPlayers() {
@@ -329,52 +634,16 @@ bool GameController::verifyGamePlayers() {
 // STDOUT STUFF
 
 string GameController::queryPlayerName() {
-    string name;
-    do {
-        cout << "Enter player's name: ";
-        cin >> name;
-        transform(name.begin(), name.end(), name.begin(), ::tolower);
-        if (name.empty()) {
-            cout << "Invalid input. Please enter a valid name." << endl;
-        }
-    } while (name.empty()); // Repeat until a non-empty name is provided
-    return name;
+    return clientManager.queryPlayerName();
 }
 
 size_t GameController::queryPlayerChips() {
-    size_t chips;
-    while (true) {
-        cout << "Enter player's chips: ";
-        cin >> chips;
-        
-        // Check if the input is valid and a positive number
-        if (cin.fail() || chips <= 0) {
-            cout << "Invalid input. Please enter a valid number of chips." << endl;
-            cin.clear(); // Clear the error flag on cin
-            cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Discard invalid input
-        } else {
-            break; // Valid input received
-        }
-    }
-    return chips;
-}
-
-size_t GameController::queryChipsToAdd(size_t minChips, size_t currentChips) const {
-    size_t chipsToAdd;
-    while (true) {
-        cout << "Enter the number of chips to add (must be at least "
-             << (minChips - currentChips) << "): ";
-        cin >> chipsToAdd;
-
-        if (cin.fail() || chipsToAdd <= 0 || (currentChips + chipsToAdd) < minChips) {
-            cout << "Invalid input. Please enter a valid number of chips." << endl;
-            cin.clear(); // Clear the error flag on cin
-            cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Discard invalid input
-        } else {
-            break; // Valid input received
-        }
-    }
-    return chipsToAdd;
+    return clientManager.queryChips("Enter player's chips: ", 1);
+}
+
+size_t GameController::queryChipsToAdd(size_t minChips, size_t currentChips) {
+    size_t minToAdd = minChips - currentChips;
+    return clientManager.queryChips("Enter the number of chips to add (must be at least " + to_string(minToAdd) + "): ", minToAdd);
 }
 
 // TO DELETE LATER:
@@ -1,5 +1,6 @@
 #include "../include/GamePlayers.h"
 #include "../include/Player.h"
+#include <algorithm>
 
 using namespace std;
 
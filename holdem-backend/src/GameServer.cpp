@@ -0,0 +1,509 @@
+#include "../include/GameServer.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Client ids share the epoll data field with these two descriptors
+const uint64_t LISTEN_EVENT_ID = 0;
+const uint64_t WAKE_EVENT_ID = UINT64_MAX;
+
+const int MAX_EPOLL_EVENTS = 256;
+const size_t READ_CHUNK_SIZE = 16384;
+const size_t MAX_WRITE_BATCH = 64;
+
+// Most a connection may have buffered in either direction. Reads stop here until the frames are
+// dispatched, a client whose unsent output grows past it is not reading and is dropped.
+const size_t MAX_CONNECTION_BUFFER = 4 * (FRAME_HEADER_SIZE + MAX_FRAME_PAYLOAD);
+
+namespace {
+    size_t getPendingOutput(const Connection& connection) {
+        return connection.writeBuffer.size() - connection.writeOffset;
+    }
+}
+
+GameServer::GameServer(uint16_t port, size_t numTables, size_t numWorkers, size_t smallBlind, size_t bigBlind) :
+    listenFd(-1),
+    epollFd(-1),
+    wakeFd(-1),
+    port(0),
+    scheduler(numWorkers),
+    tables(),
+    connections(),
+    nextClientId(1),
+    spectators(),
+    outbox(),
+    spectatorNotices(),
+    isWakePending(false),
+    isRunning(false) {
+
+    for (size_t i = 0; i < numTables; ++i) {
+        auto table = make_shared<GameTable>(static_cast<uint32_t>(i), smallBlind, bigBlind, *this);
+        scheduler.addTable(table);
+        tables.push_back(table);
+    }
+    openSockets(port);
+}
+
+GameServer::~GameServer() {
+    // Tables write into the outbox, so they must stop before anything is torn down
+    scheduler.stop();
+
+    for (auto& [clientId, connection] : connections) close(connection.fd);
+    if (wakeFd >= 0) close(wakeFd);
+    if (epollFd >= 0) close(epollFd);
+    if (listenFd >= 0) close(listenFd);
+}
+
+void GameServer::setHandHistory(HandHistoryWriter* writer) {
+    for (auto& table : tables) table->setHandHistory(writer);
+}
+
+void GameServer::setStreetStrength(StreetStrength* strength) {
+    for (auto& table : tables) table->setStreetStrength(strength);
+}
+
+void GameServer::setRunoutEquity(const RunoutEquityOptions& options, RunoutEquityWorker* worker) {
+    for (auto& table : tables) table->setRunoutEquity(options, worker);
+}
+
+void GameServer::run() {
+    isRunning = true;
+    epoll_event events[MAX_EPOLL_EVENTS];
+
+    while (isRunning) {
+        int numEvents = epoll_wait(epollFd, events, MAX_EPOLL_EVENTS, -1);
+        if (numEvents < 0) {
+            if (errno == EINTR) continue;
+            throw runtime_error("epoll_wait failed!");
+        }
+
+        for (int i = 0; i < numEvents; ++i) {
+            uint64_t id = events[i].data.u64;
+
+            if (id == LISTEN_EVENT_ID) {
+                acceptConnections();
+                continue;
+            }
+            if (id == WAKE_EVENT_ID) {
+                uint64_t count;
+                ssize_t ignored = read(wakeFd, &count, sizeof(count));
+                (void)ignored;
+                isWakePending = false;
+                drainOutbox();
+                continue;
+            }
+
+            auto it = connections.find(id);
+            if (it == connections.end()) continue;
+
+            if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                closeClient(id);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                flushClient(it->second);
+
+                // Flushing may have closed the connection
+                it = connections.find(id);
+                if (it == connections.end()) continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP)) readFromClient(it->second);
+        }
+    }
+}
+
+void GameServer::stop() {
+    isRunning = false;
+    uint64_t one = 1;
+    ssize_t ignored = write(wakeFd, &one, sizeof(one));
+    (void)ignored;
+}
+
+void GameServer::sendToClient(uint64_t clientId, const uint8_t* data, size_t size) {
+    outbox.push(OutgoingFrame{clientId, vector<uint8_t>(data, data + size)});
+    wakeIoThread();
+}
+
+void GameServer::notifySpectators(uint32_t tableId) {
+    spectatorNotices.push(tableId);
+    wakeIoThread();
+}
+
+uint16_t GameServer::getPort() const {
+    return port;
+}
+
+size_t GameServer::getNumTables() const {
+    return tables.size();
+}
+
+// Helper Functions
+
+void GameServer::openSockets(uint16_t requestedPort) {
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) throw runtime_error("Failed to create the listening socket!");
+
+    int enable = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(requestedPort);
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        throw runtime_error("Failed to bind the listening socket to port " + to_string(requestedPort) + "!");
+    }
+    if (listen(listenFd, SOMAXCONN) < 0) throw runtime_error("Failed to listen on the server socket!");
+
+    socklen_t length = sizeof(address);
+    getsockname(listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+    port = ntohs(address.sin_port);
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0) throw runtime_error("Failed to create the epoll instance!");
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = LISTEN_EVENT_ID;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+
+    event.data.u64 = WAKE_EVENT_ID;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+}
+
+void GameServer::acceptConnections() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return; // EAGAIN, or out of descriptors until a client leaves
+
+        // Frames are small and latency sensitive
+        int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+        uint64_t clientId = nextClientId++;
+        Connection& connection = connections[clientId];
+        connection.fd = fd;
+        connection.clientId = clientId;
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = clientId;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+void GameServer::readFromClient(Connection& connection) {
+    uint64_t clientId = connection.clientId;
+    bool isClosed = false;
+
+    // Anything left over stays in the socket, epoll is level triggered so it is read on the next wake up
+    while (connection.readBuffer.size() < MAX_CONNECTION_BUFFER) {
+        size_t oldSize = connection.readBuffer.size();
+        size_t chunkSize = min(READ_CHUNK_SIZE, MAX_CONNECTION_BUFFER - oldSize);
+        connection.readBuffer.resize(oldSize + chunkSize);
+        ssize_t numRead = read(connection.fd, connection.readBuffer.data() + oldSize, chunkSize);
+
+        if (numRead > 0) {
+            connection.readBuffer.resize(oldSize + numRead);
+            continue;
+        }
+        connection.readBuffer.resize(oldSize);
+        if (numRead == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) isClosed = true;
+        if (numRead < 0 && errno == EINTR) continue;
+        break;
+    }
+
+    // Dispatch every complete frame
+    size_t offset = 0;
+    vector<uint8_t>& buffer = connection.readBuffer;
+    FrameHeader header;
+    while (decodeFrameHeader(buffer.data() + offset, buffer.size() - offset, header)) {
+        if (header.payloadSize > MAX_FRAME_PAYLOAD) {
+            isClosed = true;
+            break;
+        }
+        if (buffer.size() - offset < FRAME_HEADER_SIZE + header.payloadSize) break;
+
+        const uint8_t* payload = buffer.data() + offset + FRAME_HEADER_SIZE;
+        if (header.version != WIRE_PROTOCOL_VERSION) {
+            sendError(connection, 0, ERR_UNSUPPORTED_VERSION);
+        } else if (!dispatchFrame(connection, header.type, payload, header.payloadSize)) {
+            sendError(connection, 0, ERR_MALFORMED);
+        }
+        offset += FRAME_HEADER_SIZE + header.payloadSize;
+    }
+    buffer.erase(buffer.begin(), buffer.begin() + offset);
+
+    // Replies to a client that sends but never reads would otherwise pile up without limit
+    if (getPendingOutput(connection) > MAX_CONNECTION_BUFFER) isClosed = true;
+
+    if (isClosed) closeClient(clientId);
+    else if (connection.writeOffset < connection.writeBuffer.size() && !connection.isWriteRegistered) flushClient(connection);
+}
+
+bool GameServer::dispatchFrame(Connection& connection, uint8_t type, const uint8_t* payload, size_t size) {
+    WireReader reader(payload, size);
+    TableCommand command;
+    command.source = NETWORK;
+    command.clientId = connection.clientId;
+
+    uint32_t tableId = reader.getU32();
+
+    // Spectating is handled on the IO thread, the table never knows about its spectators
+    if (type == MSG_WATCH_TABLE || type == MSG_UNWATCH_TABLE) {
+        if (reader.isUnderflow()) return false;
+        if (tableId >= tables.size()) sendError(connection, tableId, ERR_NO_SUCH_TABLE);
+        else if (type == MSG_WATCH_TABLE) watchTable(connection, tableId);
+        else unwatchTable(connection, tableId);
+        return true;
+    }
+
+    switch (type) {
+        case MSG_JOIN_TABLE: {
+            command.type = JOIN_TABLE;
+            command.amount = reader.getU32();
+            uint8_t nameLength = reader.getU8();
+            const uint8_t* name = reader.getBytes(nameLength);
+            if (name == nullptr || nameLength == 0 || nameLength > MAX_PLAYER_NAME) return false;
+            command.playerName.assign(reinterpret_cast<const char*>(name), nameLength);
+            break;
+        }
+        case MSG_LEAVE_TABLE:
+            command.type = LEAVE_TABLE;
+            break;
+        case MSG_PLAYER_ACTION:
+            command.type = PLAYER_ACTION;
+            command.action = static_cast<ActionType>(reader.getU8());
+            command.amount = reader.getU32();
+            if (command.action >= INVALID_ACTION) return false;
+            break;
+        default:
+            return false;
+    }
+    if (reader.isUnderflow()) return false;
+
+    if (tableId >= tables.size()) {
+        sendError(connection, tableId, ERR_NO_SUCH_TABLE);
+        return true;
+    }
+
+    if (command.type == JOIN_TABLE &&
+        find(connection.joinedTables.begin(), connection.joinedTables.end(), tableId) == connection.joinedTables.end()) {
+        connection.joinedTables.push_back(tableId);
+    }
+    scheduler.post(*tables[tableId], std::move(command));
+    return true;
+}
+
+void GameServer::watchTable(Connection& connection, uint32_t tableId) {
+    bool isWatching = any_of(connection.subscriptions.begin(), connection.subscriptions.end(),
+        [tableId](const Subscription& subscription) { return subscription.tableId == tableId; });
+    if (isWatching) {
+        sendError(connection, tableId, ERR_ALREADY_WATCHING);
+        return;
+    }
+
+    connection.subscriptions.push_back(Subscription{tableId, BroadcastCursor()});
+    spectators[tableId].push_back(connection.clientId);
+    appendTableMessage(connection, tableId, MSG_WATCHING);
+}
+
+void GameServer::unwatchTable(Connection& connection, uint32_t tableId) {
+    auto it = find_if(connection.subscriptions.begin(), connection.subscriptions.end(),
+        [tableId](const Subscription& subscription) { return subscription.tableId == tableId; });
+    if (it == connection.subscriptions.end()) {
+        sendError(connection, tableId, ERR_NOT_WATCHING);
+        return;
+    }
+
+    connection.subscriptions.erase(it);
+    vector<uint64_t>& watchers = spectators[tableId];
+    watchers.erase(remove(watchers.begin(), watchers.end(), connection.clientId), watchers.end());
+    appendTableMessage(connection, tableId, MSG_LEFT);
+}
+
+void GameServer::flushClient(Connection& connection) {
+    while (true) {
+        iovec iov[MAX_WRITE_BATCH];
+        size_t count = 0;
+        bool isOwnData = false;
+
+        // A partly written broadcast frame is finished first so that frames never interleave
+        if (connection.broadcastOffset == 0 && connection.writeOffset < connection.writeBuffer.size()) {
+            iov[count++] = {connection.writeBuffer.data() + connection.writeOffset,
+                            connection.writeBuffer.size() - connection.writeOffset};
+            isOwnData = true;
+        } else {
+            if (connection.broadcastFrames.empty()) pullBroadcastFrames(connection);
+            for (const auto& frame : connection.broadcastFrames) {
+                if (count == MAX_WRITE_BATCH) break;
+                size_t offset = (count == 0) ? connection.broadcastOffset : 0;
+                iov[count++] = {const_cast<uint8_t*>(frame->data.data()) + offset, frame->data.size() - offset};
+            }
+        }
+        if (count == 0) break;
+
+        msghdr message{};
+        message.msg_iov = iov;
+        message.msg_iovlen = count;
+        ssize_t numWritten = sendmsg(connection.fd, &message, MSG_NOSIGNAL);
+        if (numWritten < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                updateWriteInterest(connection, true);
+                return;
+            }
+            closeClient(connection.clientId);
+            return;
+        }
+
+        if (isOwnData) {
+            connection.writeOffset += numWritten;
+            if (connection.writeOffset == connection.writeBuffer.size()) {
+                connection.writeBuffer.clear();
+                connection.writeOffset = 0;
+            }
+            continue;
+        }
+
+        // Release every broadcast frame that was written in full
+        size_t remaining = static_cast<size_t>(numWritten);
+        while (remaining > 0) {
+            size_t frameRemaining = connection.broadcastFrames.front()->data.size() - connection.broadcastOffset;
+            if (remaining < frameRemaining) {
+                connection.broadcastOffset += remaining;
+                break;
+            }
+            remaining -= frameRemaining;
+            connection.broadcastFrames.pop_front();
+            connection.broadcastOffset = 0;
+        }
+    }
+
+    updateWriteInterest(connection, false);
+}
+
+void GameServer::pullBroadcastFrames(Connection& connection) {
+    // Take frames from each subscription in turn so one busy table can't starve the others
+    bool isPulled = true;
+    while (isPulled && connection.broadcastFrames.size() < MAX_WRITE_BATCH) {
+        isPulled = false;
+        for (Subscription& subscription : connection.subscriptions) {
+            auto frame = tables[subscription.tableId]->getSpectatorRing().next(subscription.cursor);
+            if (frame == nullptr) continue;
+            connection.broadcastFrames.push_back(std::move(frame));
+            isPulled = true;
+        }
+    }
+}
+
+void GameServer::drainOutbox() {
+    // Gather every queued frame first so each connection is written once per wake up
+    vector<uint64_t> dirtyClients;
+    OutgoingFrame frame;
+
+    while (outbox.pop(frame)) {
+        auto it = connections.find(frame.clientId);
+        if (it == connections.end()) continue; // Client disconnected
+
+        Connection& connection = it->second;
+        if (getPendingOutput(connection) + frame.data.size() > MAX_CONNECTION_BUFFER) {
+            closeClient(frame.clientId);
+            continue;
+        }
+        if (connection.writeBuffer.size() == connection.writeOffset) dirtyClients.push_back(frame.clientId);
+        connection.writeBuffer.insert(connection.writeBuffer.end(), frame.data.begin(), frame.data.end());
+    }
+
+    // Spectators read straight from the table's ring. Slow ones (waiting on EPOLLOUT) catch up
+    // when their socket drains, skipping to a keyframe if the ring has moved on without them.
+    uint32_t tableId;
+    while (spectatorNotices.pop(tableId)) {
+        tables[tableId]->getSpectatorRing().clearNotifyPending();
+        auto it = spectators.find(tableId);
+        if (it == spectators.end()) continue;
+        dirtyClients.insert(dirtyClients.end(), it->second.begin(), it->second.end());
+    }
+
+    for (uint64_t clientId : dirtyClients) {
+        auto it = connections.find(clientId);
+        if (it != connections.end() && !it->second.isWriteRegistered) flushClient(it->second);
+    }
+}
+
+void GameServer::wakeIoThread() {
+    // Coalesce wake ups, the IO thread drains everything once it wakes
+    if (!isWakePending.exchange(true)) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+void GameServer::closeClient(uint64_t clientId) {
+    auto it = connections.find(clientId);
+    if (it == connections.end()) return;
+
+    Connection& connection = it->second;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, connection.fd, nullptr);
+    close(connection.fd);
+
+    for (const Subscription& subscription : connection.subscriptions) {
+        vector<uint64_t>& watchers = spectators[subscription.tableId];
+        watchers.erase(remove(watchers.begin(), watchers.end(), clientId), watchers.end());
+    }
+
+    // A disconnect is a leave from every table the client joined
+    for (uint32_t tableId : connection.joinedTables) {
+        TableCommand command;
+        command.type = LEAVE_TABLE;
+        command.source = NETWORK;
+        command.clientId = clientId;
+        scheduler.post(*tables[tableId], std::move(command));
+    }
+    connections.erase(it);
+}
+
+void GameServer::appendTableMessage(Connection& connection, uint32_t tableId, MessageType type) {
+    uint8_t buffer[FRAME_HEADER_SIZE + 4];
+    WireWriter writer(buffer, sizeof(buffer));
+    size_t frame = beginFrame(writer, type);
+    writer.putU32(tableId);
+    endFrame(writer, frame);
+
+    // Flushed by the caller once it is done with the connection
+    connection.writeBuffer.insert(connection.writeBuffer.end(), buffer, buffer + writer.getSize());
+}
+
+void GameServer::sendError(Connection& connection, uint32_t tableId, WireError error) {
+    uint8_t buffer[FRAME_HEADER_SIZE + 8];
+    WireWriter writer(buffer, sizeof(buffer));
+    size_t frame = beginFrame(writer, MSG_ERROR);
+    writer.putU32(tableId);
+    writer.putU8(error);
+    endFrame(writer, frame);
+
+    // Flushed by the caller once it is done with the connection
+    connection.writeBuffer.insert(connection.writeBuffer.end(), buffer, buffer + writer.getSize());
+}
+
+void GameServer::updateWriteInterest(Connection& connection, bool wantsWrite) {
+    if (connection.isWriteRegistered == wantsWrite) return;
+
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    if (wantsWrite) event.events |= EPOLLOUT;
+    event.data.u64 = connection.clientId;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.isWriteRegistered = wantsWrite;
+}
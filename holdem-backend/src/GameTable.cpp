@@ -0,0 +1,709 @@
+#include "../include/GameTable.h"
+#include <algorithm>
+
+GameTable::GameTable(uint32_t tableId, size_t smallBlind, size_t bigBlind, TableOutput& output) :
+    tableId(tableId),
+    game(smallBlind, bigBlind),
+    output(output),
+    clientPlayers(),
+    pendingJoins(),
+    leavingClients(),
+    isRoundPendingCleanup(false),
+    handNumber(0),
+    stateStream(tableId),
+    spectatorRing(),
+    shotClock(DEFAULT_SHOT_CLOCK),
+    timeBank(DEFAULT_TIME_BANK),
+    timeBanks(),
+    decisionId(0),
+    decisionClientId(0),
+    actionTimerId(0),
+    isOnTimeBank(false),
+    handHistory(nullptr),
+    actionLog(nullptr),
+    snapshotBuffer(),
+    snapshotSequence(0),
+    durableSequence(0),
+    noticeSequence(0),
+    heldFrames(),
+    isLogFailed(false),
+    runoutOptions(),
+    runoutWorker(nullptr),
+    runoutHandNumber(0),
+    numRunoutsSeen(0),
+    heldHandRecord(),
+    isHandRecordHeld(false),
+    winProbabilityFeed() {
+
+    game.setTableId(tableId);
+
+    // Spectators always start from a keyframe, so the ring starts with one
+    WireWriter writer(frameBuffer, sizeof(frameBuffer));
+    stateStream.encodeKeyframe(writer);
+    spectatorRing.publish(frameBuffer, writer.getSize(), true);
+    spectatorRing.clearNotifyPending();
+}
+
+GameTable::~GameTable() {
+    if (actionLog != nullptr) actionLog->cancelNotices(tableId);
+    if (runoutWorker != nullptr) runoutWorker->cancel(this);
+    logHeldHand();
+}
+
+void GameTable::handleCommand(const TableCommand& command) {
+    // Nothing is played once the log fails
+    if (isLogFailed) {
+        if (command.source == NETWORK) sendError(command.clientId, ERR_TABLE_CLOSED);
+        return;
+    }
+
+    switch (command.type) {
+        case JOIN_TABLE:
+            handleJoin(command);
+            break;
+        case LEAVE_TABLE:
+            handleLeave(command);
+            break;
+        case PLAYER_ACTION:
+            handleAction(command);
+            break;
+        case ACTION_TIMEOUT:
+            handleTimeout(command);
+            break;
+        case LOG_DURABLE:
+            handleLogDurable(command);
+            break;
+        case LOG_FAILED:
+            handleLogFailed(command);
+            break;
+        case RUNOUT_EQUITY:
+            handleRunoutEquity(command);
+            break;
+        default:
+            break;
+    }
+    submitRunouts();
+    commitLog();
+}
+
+void GameTable::setActionClock(chrono::milliseconds shotClock, chrono::milliseconds timeBank) {
+    this->shotClock = shotClock;
+    this->timeBank = timeBank;
+}
+
+void GameTable::setHandHistory(HandHistoryWriter* writer) {
+    handHistory = writer;
+}
+
+void GameTable::setActionLog(ActionLog* log) {
+    actionLog = log;
+    game.setActionLog(log);
+    snapshotBuffer.resize(MAX_TABLE_SNAPSHOT_SIZE);
+}
+
+void GameTable::setStreetStrength(StreetStrength* strength) {
+    game.setStreetStrength(strength);
+}
+
+void GameTable::setRunoutEquity(const RunoutEquityOptions& options, RunoutEquityWorker* worker) {
+    runoutOptions = options;
+    runoutOptions.isDeferred = (worker != nullptr);
+    runoutWorker = worker;
+    game.setRunoutEquity(&runoutOptions);
+}
+
+void GameTable::setWinProbabilityFeed(chrono::microseconds budget) {
+    winProbabilityFeed = make_unique<WinProbabilityFeed>(budget);
+}
+
+bool GameTable::recover(const RecoveredTable& table) {
+    // The replayed actions are in the log already
+    game.setActionLog(nullptr);
+    bool isRestored = ActionLog::restoreGame(game, table);
+    game.setActionLog(actionLog);
+    if (!isRestored) return false;
+
+    handNumber = table.handNumber;
+    isRoundPendingCleanup = !game.getHandRecord().actions.empty();
+
+    // Logged again so the segments it was recovered from can be deleted
+    logSnapshot();
+    commitLog();
+
+    publishState();
+    if (game.isAwaitingAction()) startActionClock();
+    return true;
+}
+
+uint32_t GameTable::getTableId() const {
+    return tableId;
+}
+
+size_t GameTable::getNumSeated() const {
+    return clientPlayers.size() + pendingJoins.size();
+}
+
+BroadcastRing& GameTable::getSpectatorRing() {
+    return spectatorRing;
+}
+
+const GameController& GameTable::getGame() const {
+    return game;
+}
+
+// Command Handlers
+
+void GameTable::handleJoin(const TableCommand& command) {
+    bool isPending = any_of(pendingJoins.begin(), pendingJoins.end(), [&command](const TableCommand& join) {
+        return join.clientId == command.clientId;
+    });
+    if (isPending || clientPlayers.count(command.clientId)) {
+        sendError(command.clientId, ERR_ALREADY_SEATED);
+        return;
+    }
+    if (reclaimSeat(command)) return;
+
+    bool isNameTaken = any_of(clientPlayers.begin(), clientPlayers.end(), [&command](const auto& entry) {
+        return entry.second->getName() == command.playerName;
+    }) || any_of(pendingJoins.begin(), pendingJoins.end(), [&command](const TableCommand& join) {
+        return join.playerName == command.playerName;
+    });
+    if (isNameTaken) {
+        sendError(command.clientId, ERR_NAME_TAKEN);
+        return;
+    }
+
+    if (getNumSeated() >= MAX_NUM_PLAYERS) {
+        sendError(command.clientId, ERR_TABLE_FULL);
+        return;
+    }
+
+    // Players can only be added between rounds
+    if (game.isRoundInProgress()) {
+        pendingJoins.push_back(command);
+        sendTableMessage(command.clientId, MSG_JOINED);
+        sendKeyframe(command.clientId);
+        return;
+    }
+
+    if (seatClient(command)) advanceTable();
+}
+
+void GameTable::handleLeave(const TableCommand& command) {
+    auto pendingIt = find_if(pendingJoins.begin(), pendingJoins.end(), [&command](const TableCommand& join) {
+        return join.clientId == command.clientId;
+    });
+    if (pendingIt != pendingJoins.end()) {
+        pendingJoins.erase(pendingIt);
+        sendTableMessage(command.clientId, MSG_LEFT);
+        return;
+    }
+
+    auto it = clientPlayers.find(command.clientId);
+    if (it == clientPlayers.end()) {
+        sendError(command.clientId, ERR_NOT_SEATED);
+        return;
+    }
+
+    // Mid-round, the player is folded on their turn and removed when the round completes
+    if (game.isRoundInProgress()) {
+        leavingClients.insert(command.clientId);
+        advanceTable();
+        return;
+    }
+
+    game.removePlayerFromGame(it->second->getName());
+    clientPlayers.erase(it);
+    timeBanks.erase(command.clientId);
+    sendTableMessage(command.clientId, MSG_LEFT);
+    publishState();
+}
+
+void GameTable::handleAction(const TableCommand& command) {
+    auto it = clientPlayers.find(command.clientId);
+    if (it == clientPlayers.end()) {
+        sendError(command.clientId, ERR_NOT_SEATED);
+        return;
+    }
+
+    shared_ptr<Player> player = it->second;
+    if (!game.isAwaitingAction() || game.getStreetState().getCurPlayer() != player) {
+        sendError(command.clientId, ERR_NOT_YOUR_TURN);
+        return;
+    }
+
+    // Validated against the allowed action types and applied through processNewAction
+    ClientAction clientAction = ClientAction{player, command.action, command.amount};
+    if (!game.processClientAction(clientAction)) {
+        sendError(command.clientId, ERR_INVALID_ACTION);
+        return;
+    }
+
+    stopActionClock();
+    sendActionResult(clientAction);
+    advanceTable();
+}
+
+void GameTable::handleTimeout(const TableCommand& command) {
+    // The player acted (or left) before the clock fired
+    if (command.decisionId != decisionId || !game.isAwaitingAction()) return;
+    actionTimerId = 0;
+
+    shared_ptr<Player> player = game.getStreetState().getCurPlayer();
+
+    // Out of time on the shot clock, dip into the time bank if there is any left
+    auto bankIt = timeBanks.find(decisionClientId);
+    if (!isOnTimeBank && bankIt != timeBanks.end() && bankIt->second.count() > 0) {
+        isOnTimeBank = true;
+        timeBankStart = chrono::steady_clock::now();
+
+        TableCommand timeout = command;
+        actionTimerId = postAfter(bankIt->second, timeout);
+        sendTimeBank(*player, bankIt->second);
+        return;
+    }
+
+    if (isOnTimeBank && bankIt != timeBanks.end()) bankIt->second = chrono::milliseconds(0);
+    isOnTimeBank = false;
+
+    // Check if the player can, otherwise fold
+    ActionType autoAction = FOLD;
+    for (const auto& action : game.getPossibleActions()) {
+        if (action.type == CHECK) autoAction = CHECK;
+    }
+
+    ClientAction clientAction = ClientAction{player, autoAction, 0};
+    game.processClientAction(clientAction);
+    sendActionResult(clientAction);
+    advanceTable();
+}
+
+void GameTable::handleLogDurable(const TableCommand& command) {
+    durableSequence = max(durableSequence, command.logSequence);
+    releaseFrames();
+}
+
+void GameTable::handleLogFailed(const TableCommand& command) {
+    cerr << "Action log failed before record " << command.logSequence << ", table " << tableId << " is closed" << endl;
+    isLogFailed = true;
+
+    // What the held frames report was never made durable, so it is never acknowledged
+    heldFrames.clear();
+    stopActionClock();
+    for (const auto& [clientId, player] : clientPlayers) sendError(clientId, ERR_TABLE_CLOSED);
+    for (const auto& join : pendingJoins) sendError(join.clientId, ERR_TABLE_CLOSED);
+}
+
+void GameTable::handleRunoutEquity(const TableCommand& command) {
+    // Dropped if another hand was run out in the meantime
+    if (command.runoutEquity == nullptr || !game.attachRunoutEquity(*command.runoutEquity)) return;
+    const StreetEquity& equity = *command.runoutEquity;
+    sendRunoutEquity(equity);
+
+    if (!isHandRecordHeld || heldHandRecord.handNumber != equity.handNumber) return;
+    heldHandRecord.addRunoutEquity(equity);
+    if (game.getNumPendingRunouts(equity.handNumber) == 0) logHeldHand();
+}
+
+void GameTable::startActionClock() {
+    decisionId++;
+    decisionClientId = getClientForPlayer(game.getStreetState().getCurPlayer());
+    isOnTimeBank = false;
+    if (!isRegistered() || shotClock.count() <= 0) return;
+
+    TableCommand timeout;
+    timeout.type = ACTION_TIMEOUT;
+    timeout.source = TIMER;
+    timeout.decisionId = decisionId;
+    actionTimerId = postAfter(shotClock, timeout);
+}
+
+void GameTable::stopActionClock() {
+    if (actionTimerId != 0) {
+        cancelTimer(actionTimerId);
+        actionTimerId = 0;
+    }
+
+    if (isOnTimeBank) {
+        auto bankIt = timeBanks.find(decisionClientId);
+        if (bankIt != timeBanks.end()) {
+            auto used = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - timeBankStart);
+            bankIt->second = max(chrono::milliseconds(0), bankIt->second - used);
+        }
+        isOnTimeBank = false;
+    }
+}
+
+// Helper Functions
+
+bool GameTable::seatClient(const TableCommand& command) {
+    shared_ptr<Player> player;
+    try {
+        player = game.addPlayerToGame(command.playerName, command.amount);
+    } catch (const runtime_error& e) {
+        sendError(command.clientId, ERR_TABLE_FULL);
+        return false;
+    }
+
+    clientPlayers[command.clientId] = player;
+    timeBanks[command.clientId] = timeBank;
+    sendTableMessage(command.clientId, MSG_JOINED);
+    sendKeyframe(command.clientId);
+    return true;
+}
+
+void GameTable::advanceTable() {
+    while (true) {
+        if (game.isAwaitingAction()) {
+            shared_ptr<Player> curPlayer = game.getStreetState().getCurPlayer();
+
+            // Players that left are folded on their turn
+            if (leavingClients.count(getClientForPlayer(curPlayer))) {
+                stopActionClock();
+                ClientAction fold = ClientAction{curPlayer, FOLD, 0};
+                game.processClientAction(fold);
+                sendActionResult(fold);
+                continue;
+            }
+
+            publishState();
+            sendActionRequest();
+            startActionClock();
+            return;
+        }
+
+        if (game.isRoundInProgress()) return;
+
+        // Round is complete (or was never started)
+        if (isRoundPendingCleanup) {
+            // Runout equity goes out while everyone in the hand is still seated
+            submitRunouts();
+            logHand();
+            publishState();
+
+            WireWriter writer(frameBuffer, sizeof(frameBuffer));
+            size_t frame = beginFrame(writer, MSG_ROUND_COMPLETE);
+            writer.putU32(tableId);
+            endFrame(writer, frame);
+            broadcastFrame(writer);
+        }
+
+        startNextRound();
+        if (!game.isRoundInProgress()) {
+            publishState();
+            return;
+        }
+        sendHandStarted();
+    }
+}
+
+void GameTable::startNextRound() {
+    if (isRoundPendingCleanup) {
+        game.setupNewRound();
+        isRoundPendingCleanup = false;
+    }
+
+    // Remove recovered players nobody came back for
+    vector<string> unclaimedPlayers;
+    for (const auto& player : game.getGamePlayers()) {
+        if (getClientForPlayer(player) == 0) unclaimedPlayers.push_back(player->getName());
+    }
+    for (const string& name : unclaimedPlayers) game.removePlayerFromGame(name);
+
+    // Remove players that left, and players that can no longer post the big blind
+    for (auto it = clientPlayers.begin(); it != clientPlayers.end();) {
+        bool isLeaving = leavingClients.count(it->first) > 0;
+        bool isBusted = it->second->getChips() < game.getBigBlind();
+
+        if (isLeaving || isBusted) {
+            game.removePlayerFromGame(it->second->getName());
+            sendTableMessage(it->first, MSG_LEFT);
+            timeBanks.erase(it->first);
+            it = clientPlayers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    leavingClients.clear();
+
+    // Seat players that joined during the round
+    for (const auto& join : pendingJoins) {
+        try {
+            clientPlayers[join.clientId] = game.addPlayerToGame(join.playerName, join.amount);
+            timeBanks[join.clientId] = timeBank;
+        } catch (const runtime_error& e) {
+            sendError(join.clientId, ERR_TABLE_FULL);
+        }
+    }
+    pendingJoins.clear();
+
+    if (game.beginRound()) {
+        isRoundPendingCleanup = true;
+        handNumber++;
+        logSnapshot();
+    }
+}
+
+bool GameTable::reclaimSeat(const TableCommand& command) {
+    for (const auto& player : game.getGamePlayers()) {
+        if (player->getName() != command.playerName || getClientForPlayer(player) != 0) continue;
+
+        clientPlayers[command.clientId] = player;
+        timeBanks[command.clientId] = timeBank;
+        sendTableMessage(command.clientId, MSG_JOINED);
+        sendKeyframe(command.clientId);
+        if (game.isRoundInProgress()) {
+            WireWriter writer(frameBuffer, sizeof(frameBuffer));
+            WireCodec::encodeHoleCards(writer, tableId, *player);
+            sendFrame(command.clientId, writer);
+        }
+
+        // A pending decision is requested again, now from the client, with a fresh clock
+        if (game.isAwaitingAction() && game.getStreetState().getCurPlayer() == player) {
+            stopActionClock();
+            advanceTable();
+        }
+        return true;
+    }
+    return false;
+}
+
+void GameTable::logSnapshot() {
+    if (actionLog == nullptr) return;
+    size_t size = TableSnapshot::save(game, snapshotBuffer.data(), snapshotBuffer.size());
+    if (size == 0) return;
+    uint32_t hand = static_cast<uint32_t>(game.getHandRecord().handNumber);
+    snapshotSequence = actionLog->appendSnapshot(tableId, hand, snapshotBuffer.data(), size);
+}
+
+void GameTable::commitLog() {
+    uint64_t sequence = getLastLogSequence();
+    if (actionLog == nullptr || isLogFailed || sequence <= noticeSequence) return;
+    noticeSequence = sequence;
+
+    TableCommand notice;
+    notice.source = LOG_WRITER;
+    notice.logSequence = sequence;
+    if (!isRegistered()) {
+        notice.type = actionLog->waitDurable(sequence) ? LOG_DURABLE : LOG_FAILED;
+        handleCommand(notice);
+        return;
+    }
+    actionLog->notifyDurable(tableId, sequence, [this, notice](bool isDurable) mutable {
+        notice.type = isDurable ? LOG_DURABLE : LOG_FAILED;
+        post(std::move(notice));
+    });
+}
+
+void GameTable::logHand() {
+    if (handHistory == nullptr) return;
+
+    // A hand still waiting is logged as it is, its remaining results can no longer be attached
+    logHeldHand();
+    const HandRecord& record = game.getHandRecord();
+    if (game.getNumPendingRunouts(record.handNumber) == 0) {
+        handHistory->append(record);
+        return;
+    }
+    heldHandRecord = record;
+    isHandRecordHeld = true;
+}
+
+void GameTable::logHeldHand() {
+    if (!isHandRecordHeld) return;
+    isHandRecordHeld = false;
+    if (handHistory != nullptr) handHistory->append(heldHandRecord);
+}
+
+void GameTable::submitRunouts() {
+    // Entries worked out while the command ran go out first
+    const vector<StreetEquity>& equities = game.getRunoutEquities();
+    if (!equities.empty() && equities.front().handNumber != runoutHandNumber) {
+        runoutHandNumber = equities.front().handNumber;
+        numRunoutsSeen = 0;
+    }
+    for (; numRunoutsSeen < equities.size(); ++numRunoutsSeen) {
+        if (!equities[numRunoutsSeen].isPending) sendRunoutEquity(equities[numRunoutsSeen]);
+    }
+
+    for (RunoutJob& job : game.takeRunoutJobs()) {
+        if (runoutWorker == nullptr || !isRegistered()) {
+            TableCommand command;
+            command.type = RUNOUT_EQUITY;
+            command.source = RUNOUT_WORKER;
+            command.runoutEquity = make_shared<const StreetEquity>(RunoutEquity::compute(job));
+            handleRunoutEquity(command);
+            continue;
+        }
+        runoutWorker->submit(this, std::move(job), [this](StreetEquity equity) {
+            TableCommand command;
+            command.type = RUNOUT_EQUITY;
+            command.source = RUNOUT_WORKER;
+            command.runoutEquity = make_shared<const StreetEquity>(std::move(equity));
+            post(std::move(command));
+        });
+    }
+}
+
+uint64_t GameTable::getLastLogSequence() const {
+    return max(game.getLogSequence(), snapshotSequence);
+}
+
+bool GameTable::isHoldingFrames() const {
+    return actionLog != nullptr && !isLogFailed && getLastLogSequence() > durableSequence;
+}
+
+void GameTable::holdFrame(WireWriter& writer, vector<uint64_t> clientIds, bool isSpectated, bool isKeyframe) {
+    HeldFrame frame;
+    frame.logSequence = getLastLogSequence();
+    frame.clientIds = std::move(clientIds);
+    frame.isSpectated = isSpectated;
+    frame.isKeyframe = isKeyframe;
+    frame.data.assign(frameBuffer, frameBuffer + writer.getSize());
+    heldFrames.push_back(std::move(frame));
+}
+
+void GameTable::releaseFrames() {
+    bool isPublished = false;
+    while (!heldFrames.empty() && heldFrames.front().logSequence <= durableSequence) {
+        const HeldFrame& frame = heldFrames.front();
+        for (uint64_t clientId : frame.clientIds) output.sendToClient(clientId, frame.data.data(), frame.data.size());
+        if (frame.isSpectated && spectatorRing.publish(frame.data.data(), frame.data.size(), frame.isKeyframe)) {
+            isPublished = true;
+        }
+        heldFrames.pop_front();
+    }
+    if (isPublished) output.notifySpectators(tableId);
+}
+
+uint64_t GameTable::getClientForPlayer(const shared_ptr<Player>& player) const {
+    for (const auto& [clientId, clientPlayer] : clientPlayers) {
+        if (clientPlayer == player) return clientId;
+    }
+    return 0;
+}
+
+// Frame Helpers
+
+void GameTable::sendFrame(uint64_t clientId, WireWriter& writer) {
+    if (writer.isOverflow()) return;
+    if (isHoldingFrames()) {
+        holdFrame(writer, {clientId}, false, false);
+        return;
+    }
+    output.sendToClient(clientId, frameBuffer, writer.getSize());
+}
+
+void GameTable::broadcastFrame(WireWriter& writer, bool isKeyframe) {
+    if (writer.isOverflow()) return;
+    if (isHoldingFrames()) {
+        vector<uint64_t> clientIds;
+        for (const auto& [clientId, player] : clientPlayers) clientIds.push_back(clientId);
+        for (const auto& join : pendingJoins) clientIds.push_back(join.clientId);
+        holdFrame(writer, std::move(clientIds), true, isKeyframe);
+        return;
+    }
+    for (const auto& [clientId, player] : clientPlayers) sendFrame(clientId, writer);
+    for (const auto& join : pendingJoins) sendFrame(join.clientId, writer);
+
+    // Encoded once however many spectators there are
+    if (spectatorRing.publish(frameBuffer, writer.getSize(), isKeyframe)) output.notifySpectators(tableId);
+}
+
+void GameTable::sendError(uint64_t clientId, WireError error) {
+    WireWriter writer(frameBuffer, sizeof(frameBuffer));
+    size_t frame = beginFrame(writer, MSG_ERROR);
+    writer.putU32(tableId);
+    writer.putU8(error);
+    endFrame(writer, frame);
+    sendFrame(clientId, writer);
+}
+
+void GameTable::sendTableMessage(uint64_t clientId, MessageType type) {
+    WireWriter writer(frameBuffer, sizeof(frameBuffer));
+    size_t frame = beginFrame(writer, type);
+    writer.putU32(tableId);
+    endFrame(writer, frame);
+    sendFrame(clientId, writer);
+}
+
+void GameTable::sendTimeBank(const Player& player, chrono::milliseconds remaining) {
+    WireWriter writer(frameBuffer, sizeof(frameBuffer));
+    size_t frame = beginFrame(writer, MSG_TIME_BANK);
+    writer.putU32(tableId);
+    writer.putU8(static_cast<uint8_t>(player.getPosition()));
+    writer.putU32(static_cast<uint32_t>(remaining.count()));
+    endFrame(writer, frame);
+    broadcastFrame(writer);
+}
+
+void GameTable::sendHandStarted() {
+    for (const auto& [clientId, player] : clientPlayers) {
+        WireWriter writer(frameBuffer, sizeof(frameBuffer));
+        size_t frame = beginFrame(writer, MSG_HAND_STARTED);
+        writer.putU32(tableId);
+        writer.putU8(static_cast<uint8_t>(player->getPosition()));
+        endFrame(writer, frame);
+        sendFrame(clientId, writer);
+
+        // Hole cards only go to their owner
+        WireWriter cardsWriter(frameBuffer, sizeof(frameBuffer));
+        WireCodec::encodeHoleCards(cardsWriter, tableId, *player);
+        sendFrame(clientId, cardsWriter);
+    }
+}
+
+void GameTable::sendKeyframe(uint64_t clientId) {
+    WireWriter writer(frameBuffer, sizeof(frameBuffer));
+    stateStream.encodeKeyframe(writer);
+    sendFrame(clientId, writer);
+}
+
+void GameTable::publishState() {
+    // Captured over the published state so that players keep their seats
+    TableState state = stateStream.getPublishedState();
+    state.capture(game, handNumber);
+
+    WireWriter writer(frameBuffer, sizeof(frameBuffer));
+    if (!stateStream.encodeDelta(state, writer)) return;
+    broadcastFrame(writer);
+
+    // Periodic keyframes let clients that dropped a delta resynchronise
+    WireWriter keyframeWriter(frameBuffer, sizeof(frameBuffer));
+    bool isKeyframe = stateStream.encodeKeyframeIfDue(keyframeWriter);
+    if (isKeyframe) broadcastFrame(keyframeWriter, true);
+
+    // Spectators joining at the keyframe get the probabilities again right after it
+    if (winProbabilityFeed == nullptr) return;
+    bool isChanged = winProbabilityFeed->update(game.getContenders(), game.getBoard().getCommunityCards(), handNumber);
+    if (isChanged || (isKeyframe && !winProbabilityFeed->getProbabilities().positions.empty())) publishWinProbabilities();
+}
+
+void GameTable::publishWinProbabilities() {
+    WireWriter writer(frameBuffer, sizeof(frameBuffer));
+    WireCodec::encodeWinProbabilities(writer, tableId, winProbabilityFeed->getProbabilities());
+    if (writer.isOverflow()) return;
+    if (isHoldingFrames()) {
+        holdFrame(writer, {}, true, false);
+        return;
+    }
+    if (spectatorRing.publish(frameBuffer, writer.getSize(), false)) output.notifySpectators(tableId);
+}
+
+void GameTable::sendRunoutEquity(const StreetEquity& equity) {
+    WireWriter writer(frameBuffer, sizeof(frameBuffer));
+    WireCodec::encodeRunoutEquity(writer, tableId, equity);
+    broadcastFrame(writer);
+}
+
+void GameTable::sendActionRequest() {
+    WireWriter writer(frameBuffer, sizeof(frameBuffer));
+    WireCodec::encodeActionRequest(writer, tableId, game.getStreetState(), game.getPossibleActions());
+    broadcastFrame(writer);
+}
+
+void GameTable::sendActionResult(const ClientAction& action) {
+    WireWriter writer(frameBuffer, sizeof(frameBuffer));
+    WireCodec::encodeActionResult(writer, tableId, action);
+    broadcastFrame(writer);
+}
@@ -0,0 +1,536 @@
+#include "../include/HandArchive.h"
+#include <algorithm>
+
+namespace {
+    const uint32_t NO_CARD_BITS = 63;
+    const int CARD_BITS = 6;
+    const int NIBBLE_BITS = 4;
+    const int STREET_BITS = 3;
+    const int BOARD_COUNT_BITS = 3;
+    const int EQUITY_BITS = 14;
+    const uint8_t NUM_CARDS = 52;
+    const size_t BLOCK_HEADER_SIZE = 34;
+    const size_t INDEX_ENTRY_SIZE = 16;
+
+    void appendU16(vector<uint8_t>& out, uint16_t value) {
+        for (int i = 0; i < 2; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    void appendU32(vector<uint8_t>& out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    void appendU64(vector<uint8_t>& out, uint64_t value) {
+        for (int i = 0; i < 8; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    // Amounts that divide by the small blind are coded in small blinds
+    void putAmount(BitWriter& writer, uint64_t amount, uint32_t unit) {
+        if (unit > 0 && amount % unit == 0) {
+            writer.putBits(0, 1);
+            writer.putGamma(amount / unit);
+        } else {
+            writer.putBits(1, 1);
+            writer.putGamma(amount);
+        }
+    }
+
+    uint64_t getAmount(BitReader& reader, uint32_t unit) {
+        bool isRaw = reader.getBits(1);
+        uint64_t value = reader.getGamma();
+        return isRaw ? value : value * unit;
+    }
+
+    void putCard(BitWriter& writer, uint8_t card) {
+        writer.putBits(card == NO_CARD ? NO_CARD_BITS : card, CARD_BITS);
+    }
+
+    bool getCard(BitReader& reader, uint8_t& card, bool isNoCardAllowed) {
+        uint32_t bits = reader.getBits(CARD_BITS);
+        if (bits == NO_CARD_BITS && isNoCardAllowed) {
+            card = NO_CARD;
+            return true;
+        }
+        card = static_cast<uint8_t>(bits);
+        return bits < NUM_CARDS;
+    }
+
+    // Action types ranked by how often they occur, so the common ones get the shortest codes
+    const uint8_t TYPE_BY_RANK[INVALID_ACTION] = {CALL, CHECK, FOLD, RAISE, BET, BLIND, ALL_IN_BET, ALL_IN_CALL};
+    const uint8_t RANK_BY_TYPE[INVALID_ACTION] = {1, 4, 0, 3, 2, 5, 6, 7};
+
+    bool isZeroAmountType(uint8_t type) {
+        return type == CHECK || type == FOLD;
+    }
+
+    bool isCallType(uint8_t type) {
+        return type == CALL || type == ALL_IN_CALL;
+    }
+}
+
+// Bit Writer
+
+BitWriter::BitWriter(vector<uint8_t>& out) : out(out), accumulator(0), numBits(0) {}
+
+void BitWriter::putBits(uint32_t value, int count) {
+    if (count < 32) value &= (1u << count) - 1;
+    accumulator |= static_cast<uint64_t>(value) << numBits;
+    numBits += count;
+    while (numBits >= 8) {
+        out.push_back(static_cast<uint8_t>(accumulator));
+        accumulator >>= 8;
+        numBits -= 8;
+    }
+}
+
+void BitWriter::putGamma(uint64_t value) {
+    // value + 1 has length bits: length - 1 zeros, a one, then the low length - 1 bits
+    unsigned __int128 coded = static_cast<unsigned __int128>(value) + 1;
+    int length = 0;
+    for (unsigned __int128 rest = coded; rest != 0; rest >>= 1) length++;
+
+    for (int zeros = length - 1; zeros > 0; zeros -= min(zeros, 32)) putBits(0, min(zeros, 32));
+    putBits(1, 1);
+    for (int i = 0; i < length - 1; i += 32) {
+        putBits(static_cast<uint32_t>(coded >> i), min(32, length - 1 - i));
+    }
+}
+
+void BitWriter::alignToByte() {
+    if (numBits > 0) putBits(0, 8 - numBits);
+}
+
+// Bit Reader
+
+BitReader::BitReader(const uint8_t* data, size_t size) : data(data), size(size), bitOffset(0), underflow(false) {}
+
+uint32_t BitReader::getBits(int count) {
+    if (bitOffset + count > size * 8) {
+        underflow = true;
+        bitOffset = size * 8;
+        return 0;
+    }
+
+    uint32_t value = 0;
+    int numRead = 0;
+    while (numRead < count) {
+        int shift = bitOffset & 7;
+        int take = min(8 - shift, count - numRead);
+        uint32_t bits = (data[bitOffset >> 3] >> shift) & ((1u << take) - 1);
+        value |= bits << numRead;
+        numRead += take;
+        bitOffset += take;
+    }
+    return value;
+}
+
+uint64_t BitReader::getGamma() {
+    int zeros = 0;
+    while (!underflow && getBits(1) == 0) {
+        if (++zeros > 64) {
+            underflow = true;
+            return 0;
+        }
+    }
+    if (underflow) return 0;
+
+    // The one just read is the top bit of value + 1, the low bits follow
+    unsigned __int128 coded = static_cast<unsigned __int128>(1) << zeros;
+    for (int i = 0; i < zeros; i += 32) {
+        coded |= static_cast<unsigned __int128>(getBits(min(32, zeros - i))) << i;
+    }
+
+    unsigned __int128 value = coded - 1;
+    if (value > UINT64_MAX) {
+        underflow = true;
+        return 0;
+    }
+    return static_cast<uint64_t>(value);
+}
+
+bool BitReader::isUnderflow() const {
+    return underflow;
+}
+
+size_t BitReader::getByteOffset() const {
+    return (bitOffset + 7) / 8;
+}
+
+size_t BitReader::getRemainingBits() const {
+    return size * 8 - bitOffset;
+}
+
+// Hand Archive Writer
+
+HandArchiveWriter::HandArchiveWriter(size_t handsPerBlock) :
+    handsPerBlock(max<size_t>(handsPerBlock, 1)),
+    archive(HAND_ARCHIVE_HEADER_SIZE, 0),
+    blockHands(),
+    blocks() {}
+
+void HandArchiveWriter::add(const HandRecord& hand) {
+    if (!blockHands.empty()) {
+        const HandRecord& first = blockHands.front();
+        bool isSameBlinds = hand.smallBlind == first.smallBlind && hand.bigBlind == first.bigBlind;
+        if (!isSameBlinds || blockHands.size() >= handsPerBlock) writeBlock();
+    }
+    blockHands.push_back(hand);
+}
+
+vector<uint8_t> HandArchiveWriter::finish() {
+    if (!blockHands.empty()) writeBlock();
+
+    uint64_t indexOffset = archive.size();
+    appendU32(archive, static_cast<uint32_t>(blocks.size()));
+    for (const BlockEntry& block : blocks) {
+        appendU64(archive, block.offset);
+        appendU32(archive, block.size);
+        appendU32(archive, block.numHands);
+    }
+
+    vector<uint8_t> header;
+    appendU32(header, HAND_ARCHIVE_MAGIC);
+    appendU16(header, HAND_ARCHIVE_VERSION);
+    appendU16(header, 0);
+    appendU64(header, indexOffset);
+    copy(header.begin(), header.end(), archive.begin());
+
+    vector<uint8_t> result = std::move(archive);
+    archive.assign(HAND_ARCHIVE_HEADER_SIZE, 0);
+    blocks.clear();
+    return result;
+}
+
+void HandArchiveWriter::writeBlock() {
+    const HandRecord& first = blockHands.front();
+
+    // Names in order of first appearance
+    map<string, uint32_t> names;
+    vector<const string*> nameOrder;
+    for (const HandRecord& hand : blockHands) {
+        for (const HandSeat& seat : hand.seats) {
+            auto [it, isNew] = names.emplace(seat.name.substr(0, MAX_PLAYER_NAME), names.size());
+            if (isNew) nameOrder.push_back(&it->first);
+        }
+    }
+
+    uint64_t offset = archive.size();
+    appendU32(archive, static_cast<uint32_t>(blockHands.size()));
+    appendU32(archive, first.smallBlind);
+    appendU32(archive, first.bigBlind);
+    appendU32(archive, first.tableId);
+    appendU64(archive, first.handNumber);
+    appendU64(archive, first.startTime);
+    appendU16(archive, static_cast<uint16_t>(nameOrder.size()));
+    for (const string* name : nameOrder) {
+        archive.push_back(static_cast<uint8_t>(name->size()));
+        archive.insert(archive.end(), name->begin(), name->end());
+    }
+
+    ArchiveBlockState state{first.tableId, first.handNumber, first.startTime, vector<int64_t>(names.size(), -1)};
+    BitWriter writer(archive);
+    for (const HandRecord& hand : blockHands) encodeHand(hand, names, state, writer);
+    writer.alignToByte();
+
+    blocks.push_back(BlockEntry{offset, static_cast<uint32_t>(archive.size() - offset),
+                                static_cast<uint32_t>(blockHands.size())});
+    blockHands.clear();
+}
+
+void HandArchiveWriter::encodeHand(const HandRecord& hand, const map<string, uint32_t>& names,
+                                   ArchiveBlockState& state, BitWriter& writer) {
+    uint32_t unit = hand.smallBlind;
+
+    writer.putGamma(zigzag(static_cast<int64_t>(hand.tableId) - static_cast<int64_t>(state.tableId)));
+    writer.putGamma(zigzag(static_cast<int64_t>(hand.handNumber - state.handNumber)));
+    writer.putGamma(zigzag(static_cast<int64_t>(hand.startTime - state.startTime)));
+    state.tableId = hand.tableId;
+    state.handNumber = hand.handNumber;
+    state.startTime = hand.startTime;
+
+    // A returning player's stack has only moved by what they won or lost
+    writer.putBits(static_cast<uint32_t>(hand.seats.size()), NIBBLE_BITS);
+    for (const HandSeat& seat : hand.seats) {
+        uint32_t nameIndex = names.at(seat.name.substr(0, MAX_PLAYER_NAME));
+        writer.putBits(seat.position, NIBBLE_BITS);
+        writer.putGamma(nameIndex);
+
+        int64_t& lastChips = state.chips[nameIndex];
+        if (lastChips < 0) {
+            putAmount(writer, seat.startingChips, unit);
+        } else {
+            int64_t delta = static_cast<int64_t>(seat.startingChips) - lastChips;
+            bool isUnits = unit > 0 && delta % unit == 0;
+            writer.putBits(isUnits ? 0 : 1, 1);
+            writer.putGamma(zigzag(isUnits ? delta / unit : delta));
+        }
+        lastChips = seat.startingChips;
+
+        putCard(writer, seat.holeCards[0]);
+        putCard(writer, seat.holeCards[1]);
+    }
+
+    // Streets only move forward, so a flag marks the first action of each street
+    // Action passes round the table, so positions are coded as steps from the last actor
+    writer.putGamma(hand.actions.size());
+    // Calls usually match the last bet of the street, which then costs a single bit
+    uint8_t street = PRE_FLOP;
+    uint8_t position = NUM_POSITIONS - 1;
+    uint32_t lastBet = 0;
+    for (const HandAction& action : hand.actions) {
+        if (action.street == street) {
+            writer.putBits(0, 1);
+        } else {
+            writer.putBits(1, 1);
+            writer.putBits(action.street, STREET_BITS);
+            street = action.street;
+            lastBet = 0;
+        }
+        writer.putGamma(RANK_BY_TYPE[action.type]);
+        writer.putGamma((action.position + NUM_POSITIONS - position) % NUM_POSITIONS);
+        position = action.position;
+
+        if (isZeroAmountType(action.type) || isCallType(action.type)) {
+            uint32_t expected = isCallType(action.type) ? lastBet : 0;
+            writer.putBits(action.amount != expected, 1);
+            if (action.amount == expected) continue;
+        }
+        putAmount(writer, action.amount, unit);
+        if (!isZeroAmountType(action.type) && !isCallType(action.type)) lastBet = action.amount;
+    }
+
+    writer.putBits(hand.numBoardCards, BOARD_COUNT_BITS);
+    for (int i = 0; i < hand.numBoardCards; ++i) putCard(writer, hand.board[i]);
+
+    writer.putGamma(hand.pots.size());
+    for (const HandPot& pot : hand.pots) {
+        putAmount(writer, pot.chips, unit);
+        writer.putBits(pot.eligiblePositions, NUM_POSITIONS);
+    }
+
+    writer.putBits(static_cast<uint32_t>(hand.results.size()), NIBBLE_BITS);
+    for (const HandResult& result : hand.results) {
+        writer.putBits(result.position, NIBBLE_BITS);
+        putAmount(writer, result.chipsWon, unit);
+    }
+
+    writer.putGamma(hand.runoutEquities.size());
+    for (const HandRunoutEquity& entry : hand.runoutEquities) {
+        writer.putBits(entry.street, STREET_BITS);
+        writer.putBits(entry.position, NIBBLE_BITS);
+        writer.putBits(entry.equity, EQUITY_BITS);
+    }
+}
+
+// Hand Archive Reader
+
+HandArchiveReader::HandArchiveReader(const uint8_t* data, size_t size) :
+    data(data),
+    size(size),
+    isValidArchive(false),
+    blocks(),
+    numHands(0) {
+
+    WireReader header(data, size);
+    uint32_t magic = header.getU32();
+    uint16_t version = header.getU16();
+    header.getU16();
+    uint64_t indexOffset = header.getU64();
+    if (header.isUnderflow() || magic != HAND_ARCHIVE_MAGIC || version != HAND_ARCHIVE_VERSION) return;
+    if (indexOffset < HAND_ARCHIVE_HEADER_SIZE || indexOffset > size) return;
+
+    WireReader index(data + indexOffset, size - indexOffset);
+    uint32_t numBlocks = index.getU32();
+    if (index.isUnderflow() || numBlocks > index.getRemaining() / INDEX_ENTRY_SIZE) return;
+
+    for (uint32_t i = 0; i < numBlocks; ++i) {
+        BlockEntry block;
+        block.offset = index.getU64();
+        block.size = index.getU32();
+        block.numHands = index.getU32();
+        block.firstHand = numHands;
+        if (block.offset < HAND_ARCHIVE_HEADER_SIZE || block.offset + block.size > indexOffset) return;
+        if (block.size < BLOCK_HEADER_SIZE || block.numHands > block.size * 8) return;
+        blocks.push_back(block);
+        numHands += block.numHands;
+    }
+    isValidArchive = true;
+}
+
+bool HandArchiveReader::isValid() const {
+    return isValidArchive;
+}
+
+size_t HandArchiveReader::getNumHands() const {
+    return numHands;
+}
+
+size_t HandArchiveReader::getNumBlocks() const {
+    return blocks.size();
+}
+
+bool HandArchiveReader::getHand(size_t index, HandRecord& hand) const {
+    if (index >= numHands) return false;
+
+    auto it = upper_bound(blocks.begin(), blocks.end(), index, [](size_t value, const BlockEntry& block) {
+        return value < block.firstHand;
+    });
+    const BlockEntry& block = *(it - 1);
+
+    BlockHeader header;
+    if (!readBlockHeader(block, header)) return false;
+
+    BitReader reader(data + block.offset + header.handsOffset, block.size - header.handsOffset);
+    for (size_t i = block.firstHand; i <= index; ++i) {
+        if (!decodeHand(reader, header, hand)) return false;
+    }
+    return true;
+}
+
+bool HandArchiveReader::getBlock(size_t blockIndex, vector<HandRecord>& hands) const {
+    if (blockIndex >= blocks.size()) return false;
+    const BlockEntry& block = blocks[blockIndex];
+
+    BlockHeader header;
+    if (!readBlockHeader(block, header)) return false;
+
+    BitReader reader(data + block.offset + header.handsOffset, block.size - header.handsOffset);
+    for (uint32_t i = 0; i < block.numHands; ++i) {
+        hands.emplace_back();
+        if (!decodeHand(reader, header, hands.back())) return false;
+    }
+    return true;
+}
+
+bool HandArchiveReader::readBlockHeader(const BlockEntry& block, BlockHeader& header) const {
+    WireReader reader(data + block.offset, block.size);
+
+    uint32_t blockHands = reader.getU32();
+    header.smallBlind = reader.getU32();
+    header.bigBlind = reader.getU32();
+    header.state.tableId = reader.getU32();
+    header.state.handNumber = reader.getU64();
+    header.state.startTime = reader.getU64();
+    uint16_t numNames = reader.getU16();
+    if (reader.isUnderflow() || blockHands != block.numHands) return false;
+
+    header.names.resize(numNames);
+    for (string& name : header.names) {
+        uint8_t length = reader.getU8();
+        const uint8_t* bytes = reader.getBytes(length);
+        if (bytes == nullptr) return false;
+        name.assign(reinterpret_cast<const char*>(bytes), length);
+    }
+    header.state.chips.assign(numNames, -1);
+    header.handsOffset = block.size - reader.getRemaining();
+    return true;
+}
+
+bool HandArchiveReader::decodeHand(BitReader& reader, BlockHeader& header, HandRecord& hand) {
+    ArchiveBlockState& state = header.state;
+    uint32_t unit = header.smallBlind;
+    hand.clear();
+
+    state.tableId = static_cast<uint32_t>(state.tableId + unzigzag(reader.getGamma()));
+    state.handNumber += unzigzag(reader.getGamma());
+    state.startTime += unzigzag(reader.getGamma());
+    hand.tableId = state.tableId;
+    hand.handNumber = state.handNumber;
+    hand.startTime = state.startTime;
+    hand.smallBlind = header.smallBlind;
+    hand.bigBlind = header.bigBlind;
+
+    uint32_t numSeats = reader.getBits(NIBBLE_BITS);
+    if (numSeats > NUM_POSITIONS) return false;
+    hand.seats.resize(numSeats);
+    for (HandSeat& seat : hand.seats) {
+        seat.position = static_cast<uint8_t>(reader.getBits(NIBBLE_BITS));
+        uint64_t nameIndex = reader.getGamma();
+        if (seat.position >= NUM_POSITIONS || nameIndex >= header.names.size()) return false;
+
+        int64_t& lastChips = state.chips[nameIndex];
+        if (lastChips < 0) {
+            seat.startingChips = static_cast<uint32_t>(getAmount(reader, unit));
+        } else {
+            bool isRaw = reader.getBits(1);
+            int64_t delta = unzigzag(reader.getGamma());
+            seat.startingChips = static_cast<uint32_t>(lastChips + (isRaw ? delta : delta * unit));
+        }
+        lastChips = seat.startingChips;
+
+        if (!getCard(reader, seat.holeCards[0], true) || !getCard(reader, seat.holeCards[1], true)) return false;
+        seat.name = header.names[nameIndex];
+    }
+
+    // Every action takes at least 4 bits
+    uint64_t numActions = reader.getGamma();
+    if (numActions > reader.getRemainingBits() / 4) return false;
+    hand.actions.resize(numActions);
+    uint8_t street = PRE_FLOP;
+    uint8_t position = NUM_POSITIONS - 1;
+    uint32_t lastBet = 0;
+    for (HandAction& action : hand.actions) {
+        if (reader.getBits(1)) {
+            street = static_cast<uint8_t>(reader.getBits(STREET_BITS));
+            lastBet = 0;
+        }
+        uint64_t rank = reader.getGamma();
+        uint64_t steps = reader.getGamma();
+        if (rank >= INVALID_ACTION || steps >= NUM_POSITIONS || street > SHOWDOWN) return false;
+
+        position = static_cast<uint8_t>((position + steps) % NUM_POSITIONS);
+        action.street = street;
+        action.type = TYPE_BY_RANK[rank];
+        action.position = position;
+
+        if (isZeroAmountType(action.type) || isCallType(action.type)) {
+            action.amount = isCallType(action.type) ? lastBet : 0;
+            if (reader.getBits(1) == 0) continue;
+        }
+        action.amount = static_cast<uint32_t>(getAmount(reader, unit));
+        if (!isZeroAmountType(action.type) && !isCallType(action.type)) lastBet = action.amount;
+    }
+
+    hand.numBoardCards = static_cast<uint8_t>(reader.getBits(BOARD_COUNT_BITS));
+    if (hand.numBoardCards > 5) return false;
+    for (int i = 0; i < hand.numBoardCards; ++i) {
+        if (!getCard(reader, hand.board[i], false)) return false;
+    }
+
+    uint64_t numPots = reader.getGamma();
+    if (numPots > UINT8_MAX) return false;
+    hand.pots.resize(numPots);
+    for (HandPot& pot : hand.pots) {
+        pot.chips = static_cast<uint32_t>(getAmount(reader, unit));
+        pot.eligiblePositions = static_cast<uint16_t>(reader.getBits(NUM_POSITIONS));
+    }
+
+    uint32_t numResults = reader.getBits(NIBBLE_BITS);
+    if (numResults > NUM_POSITIONS) return false;
+    hand.results.resize(numResults);
+    for (HandResult& result : hand.results) {
+        result.position = static_cast<uint8_t>(reader.getBits(NIBBLE_BITS));
+        result.chipsWon = static_cast<uint32_t>(getAmount(reader, unit));
+        if (result.position >= NUM_POSITIONS) return false;
+    }
+
+    uint64_t numRunoutEquities = reader.getGamma();
+    if (numRunoutEquities > UINT8_MAX) return false;
+    hand.runoutEquities.resize(numRunoutEquities);
+    for (HandRunoutEquity& entry : hand.runoutEquities) {
+        entry.street = static_cast<uint8_t>(reader.getBits(STREET_BITS));
+        entry.position = static_cast<uint8_t>(reader.getBits(NIBBLE_BITS));
+        entry.equity = static_cast<uint16_t>(reader.getBits(EQUITY_BITS));
+        if (entry.position >= NUM_POSITIONS || entry.equity > PROBABILITY_SCALE) return false;
+    }
+
+    return !reader.isUnderflow();
+}
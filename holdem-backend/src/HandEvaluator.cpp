@@ -12,8 +12,13 @@ vector<shared_ptr<Player>> HandEvaluator::getSortedPlayers() {
     vector<shared_ptr<Player>> sortedPlayers;
     for (const auto& entry : playerHands) sortedPlayers.push_back(entry.first);
 
+    // Equal hands are ordered by position, so the order never depends on the map's iteration order
     sort(sortedPlayers.begin(), sortedPlayers.end(), [this](const shared_ptr<Player>& a, const shared_ptr<Player>& b) {
-        return compareHands(playerHands.at(a), playerHands.at(b));
+        const PokerHand& handA = playerHands.at(a);
+        const PokerHand& handB = playerHands.at(b);
+        if (compareHands(handA, handB)) return true;
+        if (compareHands(handB, handA)) return false;
+        return a->getPosition() < b->getPosition();
     });
 
     return sortedPlayers;
@@ -0,0 +1,209 @@
+#include "../include/HandHistory.h"
+#include <algorithm>
+
+namespace {
+    const uint8_t NUM_CARDS = 52;
+
+    bool isValidCard(uint8_t card) {
+        return card < NUM_CARDS || card == NO_CARD;
+    }
+
+    bool isValidPosition(uint8_t position) {
+        return position < NUM_POSITIONS;
+    }
+}
+
+// Record Helpers
+
+bool HandSeat::operator==(const HandSeat& other) const {
+    return position == other.position && name == other.name && startingChips == other.startingChips &&
+           holeCards[0] == other.holeCards[0] && holeCards[1] == other.holeCards[1];
+}
+
+bool HandAction::operator==(const HandAction& other) const {
+    return street == other.street && position == other.position && type == other.type && amount == other.amount;
+}
+
+bool HandPot::operator==(const HandPot& other) const {
+    return chips == other.chips && eligiblePositions == other.eligiblePositions;
+}
+
+bool HandResult::operator==(const HandResult& other) const {
+    return position == other.position && chipsWon == other.chipsWon;
+}
+
+bool HandRunoutEquity::operator==(const HandRunoutEquity& other) const {
+    return street == other.street && position == other.position && equity == other.equity;
+}
+
+void HandRecord::clear() {
+    tableId = 0;
+    handNumber = 0;
+    startTime = 0;
+    smallBlind = 0;
+    bigBlind = 0;
+    seats.clear();
+    actions.clear();
+    numBoardCards = 0;
+    fill(begin(board), end(board), NO_CARD);
+    pots.clear();
+    results.clear();
+    runoutEquities.clear();
+}
+
+void HandRecord::addRunoutEquity(const StreetEquity& equity) {
+    // Deferred streets can be worked out in any order
+    auto it = upper_bound(runoutEquities.begin(), runoutEquities.end(), static_cast<uint8_t>(equity.street),
+                          [](uint8_t street, const HandRunoutEquity& entry) { return street < entry.street; });
+    for (size_t i = 0; i < equity.positions.size() && i < equity.equities.size(); ++i) {
+        HandRunoutEquity entry;
+        entry.street = static_cast<uint8_t>(equity.street);
+        entry.position = equity.positions[i];
+        entry.equity = WireCodec::encodeEquity(equity.equities[i]);
+        it = runoutEquities.insert(it, entry) + 1;
+    }
+}
+
+bool HandRecord::operator==(const HandRecord& other) const {
+    return tableId == other.tableId && handNumber == other.handNumber && startTime == other.startTime &&
+           smallBlind == other.smallBlind && bigBlind == other.bigBlind && seats == other.seats &&
+           actions == other.actions && numBoardCards == other.numBoardCards &&
+           equal(board, board + numBoardCards, other.board) && pots == other.pots && results == other.results &&
+           runoutEquities == other.runoutEquities;
+}
+
+// Codec
+
+bool HandRecordCodec::encode(const HandRecord& record, WireWriter& writer) {
+    if (record.seats.size() > NUM_POSITIONS || record.actions.size() > UINT16_MAX ||
+        record.numBoardCards > 5 || record.pots.size() > UINT8_MAX || record.results.size() > NUM_POSITIONS ||
+        record.runoutEquities.size() > UINT8_MAX) {
+        return false;
+    }
+
+    writer.putU32(record.tableId);
+    writer.putU64(record.handNumber);
+    writer.putU64(record.startTime);
+    writer.putU32(record.smallBlind);
+    writer.putU32(record.bigBlind);
+
+    writer.putU8(static_cast<uint8_t>(record.seats.size()));
+    for (const HandSeat& seat : record.seats) {
+        size_t nameLength = min(seat.name.size(), MAX_PLAYER_NAME);
+        writer.putU8(seat.position);
+        writer.putU8(static_cast<uint8_t>(nameLength));
+        writer.putBytes(seat.name.data(), nameLength);
+        writer.putU32(seat.startingChips);
+        writer.putU8(seat.holeCards[0]);
+        writer.putU8(seat.holeCards[1]);
+    }
+
+    writer.putU16(static_cast<uint16_t>(record.actions.size()));
+    for (const HandAction& action : record.actions) {
+        writer.putU8(action.street);
+        writer.putU8(action.position);
+        writer.putU8(action.type);
+        writer.putU32(action.amount);
+    }
+
+    writer.putU8(record.numBoardCards);
+    for (int i = 0; i < record.numBoardCards; ++i) writer.putU8(record.board[i]);
+
+    writer.putU8(static_cast<uint8_t>(record.pots.size()));
+    for (const HandPot& pot : record.pots) {
+        writer.putU32(pot.chips);
+        writer.putU16(pot.eligiblePositions);
+    }
+
+    writer.putU8(static_cast<uint8_t>(record.results.size()));
+    for (const HandResult& result : record.results) {
+        writer.putU8(result.position);
+        writer.putU32(result.chipsWon);
+    }
+
+    writer.putU8(static_cast<uint8_t>(record.runoutEquities.size()));
+    for (const HandRunoutEquity& entry : record.runoutEquities) {
+        writer.putU8(entry.street);
+        writer.putU8(entry.position);
+        writer.putU16(entry.equity);
+    }
+
+    return !writer.isOverflow();
+}
+
+bool HandRecordCodec::decode(const uint8_t* payload, size_t size, HandRecord& record) {
+    WireReader reader(payload, size);
+    record.clear();
+
+    record.tableId = reader.getU32();
+    record.handNumber = reader.getU64();
+    record.startTime = reader.getU64();
+    record.smallBlind = reader.getU32();
+    record.bigBlind = reader.getU32();
+
+    uint8_t numSeats = reader.getU8();
+    if (numSeats > NUM_POSITIONS) return false;
+    record.seats.resize(numSeats);
+    for (HandSeat& seat : record.seats) {
+        seat.position = reader.getU8();
+        uint8_t nameLength = reader.getU8();
+        const uint8_t* name = reader.getBytes(nameLength);
+        seat.startingChips = reader.getU32();
+        seat.holeCards[0] = reader.getU8();
+        seat.holeCards[1] = reader.getU8();
+
+        if (reader.isUnderflow() || !isValidPosition(seat.position)) return false;
+        if (!isValidCard(seat.holeCards[0]) || !isValidCard(seat.holeCards[1])) return false;
+        seat.name.assign(reinterpret_cast<const char*>(name), nameLength);
+    }
+
+    uint16_t numActions = reader.getU16();
+    if (reader.isUnderflow() || numActions > reader.getRemaining() / 7) return false;
+    record.actions.resize(numActions);
+    for (HandAction& action : record.actions) {
+        action.street = reader.getU8();
+        action.position = reader.getU8();
+        action.type = reader.getU8();
+        action.amount = reader.getU32();
+        if (!isValidPosition(action.position) || action.type >= INVALID_ACTION) return false;
+    }
+
+    record.numBoardCards = reader.getU8();
+    if (record.numBoardCards > 5) return false;
+    for (int i = 0; i < record.numBoardCards; ++i) {
+        record.board[i] = reader.getU8();
+        if (record.board[i] == NO_CARD || !isValidCard(record.board[i])) return false;
+    }
+
+    uint8_t numPots = reader.getU8();
+    if (reader.isUnderflow() || numPots > reader.getRemaining() / 6) return false;
+    record.pots.resize(numPots);
+    for (HandPot& pot : record.pots) {
+        pot.chips = reader.getU32();
+        pot.eligiblePositions = reader.getU16();
+    }
+
+    uint8_t numResults = reader.getU8();
+    if (numResults > NUM_POSITIONS) return false;
+    record.results.resize(numResults);
+    for (HandResult& result : record.results) {
+        result.position = reader.getU8();
+        result.chipsWon = reader.getU32();
+        if (!isValidPosition(result.position)) return false;
+    }
+
+    uint8_t numRunoutEquities = reader.getU8();
+    if (reader.isUnderflow() || numRunoutEquities > reader.getRemaining() / 4) return false;
+    record.runoutEquities.resize(numRunoutEquities);
+    for (HandRunoutEquity& entry : record.runoutEquities) {
+        entry.street = reader.getU8();
+        entry.position = reader.getU8();
+        entry.equity = reader.getU16();
+        if (entry.street < FLOP || entry.street > RIVER || !isValidPosition(entry.position) ||
+            entry.equity > PROBABILITY_SCALE) {
+            return false;
+        }
+    }
+
+    return !reader.isUnderflow();
+}
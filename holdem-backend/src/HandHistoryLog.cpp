@@ -0,0 +1,381 @@
+#include "../include/HandHistoryLog.h"
+#include "../include/FileUtils.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char* SEGMENT_PREFIX = "hands-";
+    const char* SEGMENT_SUFFIX = ".log";
+
+    // Parses "hands-00000012.log", returns false for any other file name
+    bool parseSegmentName(const string& name, uint32_t& index) {
+        size_t prefixLength = strlen(SEGMENT_PREFIX);
+        size_t suffixLength = strlen(SEGMENT_SUFFIX);
+        if (name.size() <= prefixLength + suffixLength) return false;
+        if (name.compare(0, prefixLength, SEGMENT_PREFIX) != 0) return false;
+        if (name.compare(name.size() - suffixLength, suffixLength, SEGMENT_SUFFIX) != 0) return false;
+
+        string digits = name.substr(prefixLength, name.size() - prefixLength - suffixLength);
+        if (digits.empty() || !all_of(digits.begin(), digits.end(), ::isdigit)) return false;
+        index = static_cast<uint32_t>(stoul(digits));
+        return true;
+    }
+
+    uint32_t readU32(const uint8_t* data) {
+        return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+}
+
+// Hand History Writer
+
+HandHistoryWriter::HandHistoryWriter(const HandHistoryOptions& options) :
+    options(options),
+    pending(),
+    isStopping(false),
+    isClosed(false),
+    isParked(false),
+    numAppended(0),
+    numWritten(0),
+    numDropped(0),
+    numSynced(0),
+    syncTarget(0),
+    numFailed(0),
+    fd(-1),
+    segmentIndex(0),
+    segmentOffset(0),
+    buffer(),
+    numBuffered(0),
+    lastSync(chrono::steady_clock::now()) {
+
+    if (mkdir(options.directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw runtime_error("Failed to create hand history directory " + options.directory + ": " + strerror(errno));
+    }
+
+    // Never reopen an old segment, its tail may be torn
+    uint32_t lastIndex = 0;
+    for (const string& path : HandHistoryReader::listSegments(options.directory)) {
+        uint32_t index;
+        if (parseSegmentName(path.substr(path.find_last_of('/') + 1), index)) lastIndex = max(lastIndex, index);
+    }
+    openSegment(lastIndex + 1);
+
+    buffer.reserve(this->options.bufferSize);
+    writerThread = thread(&HandHistoryWriter::writerLoop, this);
+}
+
+HandHistoryWriter::~HandHistoryWriter() {
+    close();
+}
+
+bool HandHistoryWriter::append(const HandRecord& record) {
+    thread_local uint8_t scratch[MAX_HAND_RECORD_SIZE];
+
+    WireWriter writer(scratch, sizeof(scratch));
+    if (!HandRecordCodec::encode(record, writer)) {
+        numDropped++;
+        return false;
+    }
+    pending.push(vector<uint8_t>(scratch, scratch + writer.getSize()));
+    numAppended++;
+
+    // Paired with the fence in writerLoop so a parked writer can't miss the record
+    atomic_thread_fence(memory_order_seq_cst);
+    if (isParked) {
+        lock_guard<mutex> lock(writerMutex);
+        writerCv.notify_one();
+    }
+    return true;
+}
+
+void HandHistoryWriter::flush() {
+    uint64_t target = numAppended;
+
+    unique_lock<mutex> lock(writerMutex);
+    syncTarget = max(syncTarget, target);
+    writerCv.notify_one();
+    flushedCv.wait(lock, [this, target]() { return numSynced >= target || isClosed; });
+}
+
+void HandHistoryWriter::close() {
+    {
+        lock_guard<mutex> lock(writerMutex);
+        if (isStopping) return;
+        isStopping = true;
+    }
+    writerCv.notify_one();
+    writerThread.join();
+
+    // Nothing appended after close() is written
+    {
+        lock_guard<mutex> lock(writerMutex);
+        isClosed = true;
+    }
+    flushedCv.notify_all();
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+}
+
+uint64_t HandHistoryWriter::getNumAppended() const {
+    return numAppended;
+}
+
+uint64_t HandHistoryWriter::getNumWritten() const {
+    return numWritten;
+}
+
+uint64_t HandHistoryWriter::getNumDropped() const {
+    return numDropped;
+}
+
+uint32_t HandHistoryWriter::getSegmentIndex() const {
+    return segmentIndex;
+}
+
+// Writer Thread
+
+void HandHistoryWriter::writerLoop() {
+    vector<uint8_t> record;
+    while (true) {
+        while (pending.pop(record)) bufferRecord(record);
+        if (numBuffered > 0) writeBuffer();
+
+        bool isSyncRequested;
+        {
+            lock_guard<mutex> lock(writerMutex);
+            isSyncRequested = syncTarget > numSynced;
+        }
+        bool isSyncDue = options.fsyncInterval.count() > 0 &&
+                         chrono::steady_clock::now() - lastSync >= options.fsyncInterval;
+        if (isSyncRequested || isSyncDue) syncSegment();
+
+        unique_lock<mutex> lock(writerMutex);
+        flushedCv.notify_all();
+        if (isStopping && pending.empty()) break;
+
+        isParked = true;
+        atomic_thread_fence(memory_order_seq_cst);
+        auto hasWork = [this]() { return isStopping || !pending.empty() || syncTarget > numSynced; };
+        if (options.fsyncInterval.count() > 0 && numSynced < numWritten) {
+            writerCv.wait_until(lock, lastSync + options.fsyncInterval, hasWork);
+        } else {
+            writerCv.wait(lock, hasWork);
+        }
+        isParked = false;
+    }
+
+    // Whatever was written is made durable on the way out
+    syncSegment();
+}
+
+void HandHistoryWriter::bufferRecord(const vector<uint8_t>& record) {
+    size_t recordSize = HAND_LOG_RECORD_HEADER_SIZE + record.size();
+
+    // Rotate before the segment outgrows its size, unless the record alone is bigger
+    size_t segmentSize = segmentOffset + buffer.size();
+    if (segmentSize + recordSize > options.segmentSize && segmentSize > HAND_LOG_HEADER_SIZE) {
+        if (numBuffered > 0) writeBuffer();
+
+        // Keep appending to the old segment if a new one can't be created
+        try {
+            openSegment(segmentIndex + 1);
+        } catch (const runtime_error& e) {
+            cerr << e.what() << endl;
+        }
+    }
+    if (buffer.size() + recordSize > options.bufferSize && numBuffered > 0) writeBuffer();
+
+    uint8_t header[HAND_LOG_RECORD_HEADER_SIZE];
+    WireWriter writer(header, sizeof(header));
+    writer.putU32(static_cast<uint32_t>(record.size()));
+    writer.putU32(computeCrc32(record.data(), record.size()));
+    buffer.insert(buffer.end(), header, header + sizeof(header));
+    buffer.insert(buffer.end(), record.begin(), record.end());
+    numBuffered++;
+}
+
+void HandHistoryWriter::writeBuffer() {
+    try {
+        writeAll(buffer.data(), buffer.size());
+        segmentOffset += buffer.size();
+        numWritten += numBuffered;
+    } catch (const runtime_error& e) {
+        cerr << e.what() << endl;
+        numDropped += numBuffered;
+        numFailed += numBuffered;
+    }
+    buffer.clear();
+    numBuffered = 0;
+}
+
+void HandHistoryWriter::syncSegment() {
+    if (fd >= 0) fdatasync(fd);
+    lastSync = chrono::steady_clock::now();
+
+    // Records lost to failed writes will never be synced, so they count towards flush targets too
+    lock_guard<mutex> lock(writerMutex);
+    numSynced = numWritten + numFailed;
+}
+
+void HandHistoryWriter::openSegment(uint32_t index) {
+    string path = options.directory + "/" + HandHistoryReader::getSegmentName(index);
+    int segmentFd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0644);
+    if (segmentFd < 0) throw runtime_error("Failed to create hand history segment " + path + ": " + strerror(errno));
+
+    if (fd >= 0) {
+        if (options.fsyncInterval.count() > 0) fdatasync(fd);
+        ::close(fd);
+    }
+    fd = segmentFd;
+    segmentIndex = index;
+
+    uint8_t header[HAND_LOG_HEADER_SIZE];
+    WireWriter writer(header, sizeof(header));
+    writer.putU32(HAND_LOG_MAGIC);
+    writer.putU16(HAND_LOG_VERSION);
+    writer.putU16(0);
+    writer.putU32(index);
+    writer.putU32(0);
+    writeAll(header, sizeof(header));
+    segmentOffset = HAND_LOG_HEADER_SIZE;
+}
+
+void HandHistoryWriter::writeAll(const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw runtime_error(string("Failed to write hand history: ") + strerror(errno));
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+// Hand Record View
+
+uint32_t HandRecordView::getTableId() const {
+    return readU32(payload + HandRecordCodec::TABLE_ID_OFFSET);
+}
+
+uint64_t HandRecordView::getHandNumber() const {
+    const uint8_t* field = payload + HandRecordCodec::HAND_NUMBER_OFFSET;
+    return readU32(field) | (static_cast<uint64_t>(readU32(field + 4)) << 32);
+}
+
+bool HandRecordView::decode(HandRecord& record) const {
+    return HandRecordCodec::decode(payload, size, record);
+}
+
+// Hand History Reader
+
+HandHistoryReader::HandHistoryReader(const string& path) :
+    fd(-1),
+    data(nullptr),
+    size(0),
+    offset(HAND_LOG_HEADER_SIZE),
+    segmentIndex(0),
+    isCorrupt(false) {
+
+    fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throw runtime_error("Failed to open hand history segment " + path + ": " + strerror(errno));
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw runtime_error("Failed to stat hand history segment " + path);
+    }
+    size = static_cast<size_t>(info.st_size);
+
+    // A segment that died before its header was written holds nothing
+    if (size < HAND_LOG_HEADER_SIZE) {
+        isCorrupt = size > 0;
+        offset = size;
+        return;
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        ::close(fd);
+        throw runtime_error("Failed to map hand history segment " + path + ": " + strerror(errno));
+    }
+    data = static_cast<const uint8_t*>(mapping);
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    WireReader reader(data, HAND_LOG_HEADER_SIZE);
+    uint32_t magic = reader.getU32();
+    uint16_t version = reader.getU16();
+    reader.getU16();
+    segmentIndex = reader.getU32();
+    if (magic != HAND_LOG_MAGIC || version != HAND_LOG_VERSION) {
+        munmap(mapping, size);
+        ::close(fd);
+        throw runtime_error("Not a hand history segment: " + path);
+    }
+}
+
+HandHistoryReader::~HandHistoryReader() {
+    if (data != nullptr) munmap(const_cast<uint8_t*>(data), size);
+    if (fd >= 0) ::close(fd);
+}
+
+bool HandHistoryReader::next(HandRecordView& view) {
+    if (isCorrupt || offset >= size) return false;
+
+    if (size - offset < HAND_LOG_RECORD_HEADER_SIZE) {
+        isCorrupt = true;
+        return false;
+    }
+    uint32_t recordSize = readU32(data + offset);
+    uint32_t crc = readU32(data + offset + 4);
+
+    const uint8_t* payload = data + offset + HAND_LOG_RECORD_HEADER_SIZE;
+    if (recordSize == 0 || recordSize > MAX_HAND_RECORD_SIZE ||
+        recordSize > size - offset - HAND_LOG_RECORD_HEADER_SIZE || computeCrc32(payload, recordSize) != crc) {
+        isCorrupt = true;
+        return false;
+    }
+
+    view.payload = payload;
+    view.size = recordSize;
+    offset += HAND_LOG_RECORD_HEADER_SIZE + recordSize;
+    return true;
+}
+
+bool HandHistoryReader::isTruncated() const {
+    return isCorrupt;
+}
+
+uint32_t HandHistoryReader::getSegmentIndex() const {
+    return segmentIndex;
+}
+
+vector<string> HandHistoryReader::listSegments(const string& directory) {
+    vector<pair<uint32_t, string>> segments;
+
+    DIR* dir = opendir(directory.c_str());
+    if (dir == nullptr) return {};
+    while (dirent* entry = readdir(dir)) {
+        uint32_t index;
+        if (parseSegmentName(entry->d_name, index)) segments.emplace_back(index, directory + "/" + entry->d_name);
+    }
+    closedir(dir);
+
+    sort(segments.begin(), segments.end());
+    vector<string> paths;
+    for (auto& segment : segments) paths.push_back(std::move(segment.second));
+    return paths;
+}
+
+string HandHistoryReader::getSegmentName(uint32_t index) {
+    char name[32];
+    snprintf(name, sizeof(name), "%s%08u%s", SEGMENT_PREFIX, index, SEGMENT_SUFFIX);
+    return name;
+}
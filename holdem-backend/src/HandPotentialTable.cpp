@@ -0,0 +1,410 @@
+#include "../include/HandPotentialTable.h"
+#include "../include/CardSubset.h"
+#include "../include/Equity.h"
+#include "../include/HandStrength.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace {
+    const string RANK_CHARS = "23456789TJQKA";
+    const string SUIT_CHARS = "hdcs";
+    const int NUM_SLOT_VALUES = 3;          // HS, PPot and NPot
+
+    // The hero's standing against an opponent
+    enum Standing { AHEAD, TIED, BEHIND, NUM_STANDINGS };
+
+    // Opponent and runout pairs by the hero's standing now, then once the board is out
+    typedef array<array<uint64_t, NUM_STANDINGS>, NUM_STANDINGS> PotentialCounts;
+
+    Standing compare(uint32_t hero, uint32_t opponent) {
+        return hero > opponent ? AHEAD : (hero == opponent ? TIED : BEHIND);
+    }
+
+    // Hole card pairs that can be dealt with a board, one slot each
+    size_t getNumSlots(int numBoardCards) {
+        return CardSubset::choose(DECK_SIZE - numBoardCards, NUM_HOLE_CARDS);
+    }
+
+    // Colex rank of the hole cards in the deck left once the board is taken out
+    size_t getSlot(uint64_t hole, uint64_t board) {
+        int low = __builtin_ctzll(hole);
+        int high = 63 - __builtin_clzll(hole);
+        low -= __builtin_popcountll(board & ((1ULL << low) - 1));
+        high -= __builtin_popcountll(board & ((1ULL << high) - 1));
+        return static_cast<size_t>(high) * (high - 1) / 2 + low;
+    }
+
+    size_t getSectionSize(int numBoardCards) {
+        int numClasses = (numBoardCards == 3) ? NUM_FLOP_CLASSES : NUM_TURN_CLASSES;
+        return numClasses * getNumSlots(numBoardCards) * NUM_SLOT_VALUES;
+    }
+
+    HandPotential fromCounts(double strength, const PotentialCounts& counts) {
+        array<double, NUM_STANDINGS> totals{};
+        for (int now = 0; now < NUM_STANDINGS; ++now) {
+            for (int end = 0; end < NUM_STANDINGS; ++end) totals[now] += counts[now][end];
+        }
+
+        HandPotential potential;
+        potential.isKnown = true;
+        potential.strength = strength;
+        // A tie now is half behind and half ahead, so it counts half towards either side
+        double behind = totals[BEHIND] + totals[TIED] / 2.0;
+        double ahead = totals[AHEAD] + totals[TIED] / 2.0;
+        if (behind > 0) {
+            potential.positive = (counts[BEHIND][AHEAD] + counts[BEHIND][TIED] / 2.0 + counts[TIED][AHEAD] / 2.0) / behind;
+        }
+        if (ahead > 0) {
+            potential.negative = (counts[AHEAD][BEHIND] + counts[TIED][BEHIND] / 2.0 + counts[AHEAD][TIED] / 2.0) / ahead;
+        }
+        potential.effective = strength * (1 - potential.negative) + (1 - strength) * potential.positive;
+        return potential;
+    }
+
+    void encodeSlot(uint16_t* slot, const HandPotential& potential) {
+        slot[0] = static_cast<uint16_t>(potential.strength * HAND_POTENTIAL_SCALE + 0.5);
+        slot[1] = static_cast<uint16_t>(potential.positive * HAND_POTENTIAL_SCALE + 0.5);
+        slot[2] = static_cast<uint16_t>(potential.negative * HAND_POTENTIAL_SCALE + 0.5);
+    }
+
+    HandPotential decodeSlot(const uint16_t* slot) {
+        HandPotential potential;
+        if (slot[0] == HAND_POTENTIAL_UNKNOWN) return potential;
+        potential.isKnown = true;
+        potential.strength = static_cast<double>(slot[0]) / HAND_POTENTIAL_SCALE;
+        potential.positive = static_cast<double>(slot[1]) / HAND_POTENTIAL_SCALE;
+        potential.negative = static_cast<double>(slot[2]) / HAND_POTENTIAL_SCALE;
+        potential.effective = potential.strength * (1 - potential.negative) + (1 - potential.strength) * potential.positive;
+        return potential;
+    }
+
+    void checkCards(uint64_t hole, uint64_t board) {
+        if (HandRank::countCards(hole) != NUM_HOLE_CARDS || (hole & ~FULL_DECK_MASK)) {
+            throw runtime_error("Hand potential needs exactly two hole cards");
+        }
+        int numBoardCards = HandRank::countCards(board);
+        if (numBoardCards < 3 || numBoardCards > 4 || (board & ~FULL_DECK_MASK)) {
+            throw runtime_error("Hand potential needs a flop or turn");
+        }
+        if (hole & board) throw runtime_error("A hole card is on the board");
+    }
+
+    // Counts of binary indexed tree, one per distinct rank at the end of a runout
+    class RankCounts {
+    private:
+        vector<uint16_t> tree;
+        int size;
+
+    public:
+        RankCounts() : tree(NUM_COMBOS + 1, 0), size(0) {}
+
+        void reset(int newSize) {
+            size = newSize;
+            fill(tree.begin(), tree.begin() + size + 1, 0);
+        }
+
+        void add(int place) {
+            for (++place; place <= size; place += place & -place) tree[place]++;
+        }
+
+        // Returns the number added at places below this one
+        int countBelow(int place) const {
+            int count = 0;
+            for (; place > 0; place -= place & -place) count += tree[place];
+            return count;
+        }
+    };
+
+    // Works out the hand potential of every hole card pair on a board at once. For each runout
+    // the combos are swept in order of their rank now, adding each one's rank at the end to a
+    // RankCounts, so every hero reads the opponents ranked below and level with it in both.
+    // The opponents sharing a card with the hero are then taken back out one by one.
+    class ClassGenerator {
+    private:
+        uint64_t board;
+        vector<int> combos;                     // Combos off the board, by rank now
+        vector<uint32_t> nowRanks;              // By combo index, as are the rest
+        vector<uint32_t> endRanks;
+        vector<bool> isDealt;                   // Combos off the runout
+        vector<int> endOrder;
+        vector<uint16_t> endPlaces;             // Distinct end ranks below the combo's
+        vector<uint16_t> numEndBelow;
+        vector<uint16_t> numEndSame;
+        vector<uint16_t> numBothBelow;          // Below now and at the end, then below now and level at the end
+        vector<uint16_t> numBelowNowSameEnd;
+        vector<PotentialCounts> counts;
+        RankCounts rankCounts;
+
+        void countRunout(uint64_t runout) {
+            uint64_t fullBoard = board | runout;
+            endOrder.clear();
+            for (int combo : combos) {
+                isDealt[combo] = !(HandRange::getComboMask(combo) & runout);
+                if (!isDealt[combo]) continue;
+                endRanks[combo] = HandRank::evaluate(HandRange::getComboMask(combo) | fullBoard);
+                endOrder.push_back(combo);
+            }
+            sort(endOrder.begin(), endOrder.end(), [&](int a, int b) { return endRanks[a] < endRanks[b]; });
+
+            int numDealt = static_cast<int>(endOrder.size());
+            int numPlaces = 0;
+            for (int first = 0; first < numDealt;) {
+                int last = first;
+                while (last < numDealt && endRanks[endOrder[last]] == endRanks[endOrder[first]]) ++last;
+                for (int i = first; i < last; ++i) {
+                    endPlaces[endOrder[i]] = static_cast<uint16_t>(numPlaces);
+                    numEndBelow[endOrder[i]] = static_cast<uint16_t>(first);
+                    numEndSame[endOrder[i]] = static_cast<uint16_t>(last - first);
+                }
+                numPlaces++;
+                first = last;
+            }
+            rankCounts.reset(numPlaces);
+
+            int numNowBelow = 0;
+            for (size_t first = 0; first < combos.size();) {
+                size_t last = first;
+                while (last < combos.size() && nowRanks[combos[last]] == nowRanks[combos[first]]) ++last;
+
+                for (size_t i = first; i < last; ++i) {
+                    int hero = combos[i];
+                    if (!isDealt[hero]) continue;
+                    numBothBelow[hero] = static_cast<uint16_t>(rankCounts.countBelow(endPlaces[hero]));
+                    numBelowNowSameEnd[hero] = static_cast<uint16_t>(rankCounts.countBelow(endPlaces[hero] + 1) - numBothBelow[hero]);
+                }
+                int numNowSame = 0;
+                for (size_t i = first; i < last; ++i) {
+                    if (!isDealt[combos[i]]) continue;
+                    rankCounts.add(endPlaces[combos[i]]);
+                    numNowSame++;
+                }
+                for (size_t i = first; i < last; ++i) {
+                    int hero = combos[i];
+                    if (!isDealt[hero]) continue;
+                    int belowNotAbove = rankCounts.countBelow(endPlaces[hero] + 1);
+                    int sameNowBelowEnd = rankCounts.countBelow(endPlaces[hero]) - numBothBelow[hero];
+                    int sameBoth = belowNotAbove - numBothBelow[hero] - numBelowNowSameEnd[hero] - sameNowBelowEnd;
+                    countHero(hero, numNowBelow, numNowSame, sameNowBelowEnd, sameBoth, numDealt, fullBoard);
+                }
+                numNowBelow += numNowSame;
+                first = last;
+            }
+        }
+
+        // Adds the opponents of a hero on one runout, by the nine standings, less those sharing a card
+        void countHero(int hero, int numNowBelow, int numNowSame, int sameNowBelowEnd, int sameBoth, int numDealt,
+                       uint64_t fullBoard) {
+            PotentialCounts& heroCounts = counts[hero];
+            int bothBelow = numBothBelow[hero];
+            int belowNowSameEnd = numBelowNowSameEnd[hero];
+            int aboveNowBelowEnd = numEndBelow[hero] - bothBelow - sameNowBelowEnd;
+            int aboveNowSameEnd = numEndSame[hero] - belowNowSameEnd - sameBoth;
+
+            heroCounts[AHEAD][AHEAD] += bothBelow;
+            heroCounts[AHEAD][TIED] += belowNowSameEnd;
+            heroCounts[AHEAD][BEHIND] += numNowBelow - bothBelow - belowNowSameEnd;
+            heroCounts[TIED][AHEAD] += sameNowBelowEnd;
+            heroCounts[TIED][TIED] += sameBoth;
+            heroCounts[TIED][BEHIND] += numNowSame - sameNowBelowEnd - sameBoth;
+            heroCounts[BEHIND][AHEAD] += aboveNowBelowEnd;
+            heroCounts[BEHIND][TIED] += aboveNowSameEnd;
+            heroCounts[BEHIND][BEHIND] += numDealt - numNowBelow - numNowSame - aboveNowBelowEnd - aboveNowSameEnd;
+
+            // The hero itself is among the opponents sharing its first card
+            uint64_t hole = HandRange::getComboMask(hero);
+            int first = __builtin_ctzll(hole);
+            uint64_t others = FULL_DECK_MASK & ~(fullBoard | (1ULL << first));
+            for (int card : {first, 63 - __builtin_clzll(hole)}) {
+                for (uint64_t rest = others; rest != 0; rest &= rest - 1) {
+                    int other = __builtin_ctzll(rest);
+                    int blocked = (card > other) ? card * (card - 1) / 2 + other : other * (other - 1) / 2 + card;
+                    heroCounts[compare(nowRanks[hero], nowRanks[blocked])][compare(endRanks[hero], endRanks[blocked])]--;
+                }
+                others &= ~hole;
+            }
+        }
+
+    public:
+        ClassGenerator() :
+            board(0),
+            nowRanks(NUM_COMBOS),
+            endRanks(NUM_COMBOS),
+            isDealt(NUM_COMBOS),
+            endPlaces(NUM_COMBOS),
+            numEndBelow(NUM_COMBOS),
+            numEndSame(NUM_COMBOS),
+            numBothBelow(NUM_COMBOS),
+            numBelowNowSameEnd(NUM_COMBOS),
+            counts(NUM_COMBOS)
+        {
+            combos.reserve(NUM_COMBOS);
+            endOrder.reserve(NUM_COMBOS);
+        }
+
+        // Fills the slots of a board's class
+        void generate(uint64_t newBoard, uint16_t* slots) {
+            board = newBoard;
+            combos.clear();
+            for (int combo = 0; combo < NUM_COMBOS; ++combo) {
+                uint64_t hole = HandRange::getComboMask(combo);
+                if (hole & board) continue;
+                combos.push_back(combo);
+                nowRanks[combo] = HandRank::evaluate(hole | board);
+                counts[combo] = PotentialCounts{};
+            }
+            sort(combos.begin(), combos.end(), [&](int a, int b) { return nowRanks[a] < nowRanks[b]; });
+
+            int numToDeal = NUM_BOARD_CARDS - HandRank::countCards(board);
+            for (uint64_t runout : CardSubsets(FULL_DECK_MASK & ~board, numToDeal)) countRunout(runout);
+
+            HandStrength strength(board);
+            for (int combo : combos) {
+                uint64_t hole = HandRange::getComboMask(combo);
+                HandPotential potential = fromCounts(strength.getStrength(hole).getStrength(), counts[combo]);
+                encodeSlot(slots + getSlot(hole, board) * NUM_SLOT_VALUES, potential);
+            }
+        }
+    };
+}
+
+HandPotential::HandPotential() : isKnown(false), strength(0), positive(0), negative(0), effective(0) {}
+
+HandPotentialOptions::HandPotentialOptions() : numThreads(1), includeTurn(false) {}
+
+HandPotentialTable::HandPotentialTable() :
+    mapping(),
+    flopEntries(nullptr),
+    turnEntries(nullptr)
+{}
+
+HandPotentialTable::~HandPotentialTable() {
+    close();
+}
+
+void HandPotentialTable::close() {
+    mapping.close();
+    flopEntries = nullptr;
+    turnEntries = nullptr;
+}
+
+bool HandPotentialTable::open(const string& path) {
+    close();
+    auto isValid = [](const MappedTableHeader& header, size_t bodySize) {
+        bool hasTurn = (header.flags & HAND_POTENTIAL_TABLE_HAS_TURN) != 0;
+        return header.sizes[0] == static_cast<uint32_t>(NUM_FLOP_CLASSES) &&
+               header.sizes[1] == static_cast<uint32_t>(hasTurn ? NUM_TURN_CLASSES : 0) &&
+               bodySize == (getSectionSize(3) + (hasTurn ? getSectionSize(4) : 0)) * sizeof(uint16_t);
+    };
+    if (!mapping.open(path, HAND_POTENTIAL_TABLE_MAGIC, HAND_POTENTIAL_TABLE_VERSION, isValid)) return false;
+
+    flopEntries = reinterpret_cast<const uint16_t*>(mapping.getBody());
+    if (mapping.getHeader().flags & HAND_POTENTIAL_TABLE_HAS_TURN) turnEntries = flopEntries + getSectionSize(3);
+    return true;
+}
+
+bool HandPotentialTable::isOpen() const {
+    return mapping.isOpen();
+}
+
+bool HandPotentialTable::hasTurn() const {
+    return turnEntries != nullptr;
+}
+
+HandPotential HandPotentialTable::lookup(uint64_t hole, uint64_t board) const {
+    if (!isOpen()) throw runtime_error("Hand potential table is not open");
+    checkCards(hole, board);
+    int numBoardCards = HandRank::countCards(board);
+    const uint16_t* entries = (numBoardCards == 3) ? flopEntries : turnEntries;
+    if (entries == nullptr) return HandPotential();
+
+    CanonicalBoard canonical = BoardClass::canonicalize(board);
+    size_t slot = canonical.index * getNumSlots(numBoardCards) + getSlot(canonical.apply(hole), canonical.cards);
+    return decodeSlot(entries + slot * NUM_SLOT_VALUES);
+}
+
+HandPotential HandPotentialTable::lookup(const vector<Card>& hole, const vector<Card>& board) const {
+    return lookup(HandRank::getMask(hole), HandRank::getMask(board));
+}
+
+HandPotential HandPotentialTable::compute(uint64_t hole, uint64_t board) {
+    checkCards(hole, board);
+    int numToDeal = NUM_BOARD_CARDS - HandRank::countCards(board);
+    uint32_t heroNow = HandRank::evaluate(hole | board);
+
+    PotentialCounts counts{};
+    double numBeaten = 0;
+    int numOpponents = 0;
+    for (uint64_t opponent : CardSubsets(FULL_DECK_MASK & ~(hole | board), NUM_HOLE_CARDS)) {
+        Standing now = compare(heroNow, HandRank::evaluate(opponent | board));
+        numBeaten += (now == AHEAD) ? 1.0 : (now == TIED ? 0.5 : 0.0);
+        numOpponents++;
+        for (uint64_t runout : CardSubsets(FULL_DECK_MASK & ~(hole | board | opponent), numToDeal)) {
+            uint64_t fullBoard = board | runout;
+            counts[now][compare(HandRank::evaluate(hole | fullBoard), HandRank::evaluate(opponent | fullBoard))]++;
+        }
+    }
+    return fromCounts(numBeaten / numOpponents, counts);
+}
+
+uint64_t HandPotentialTable::parseCards(const string& text) {
+    if (text.size() % 2 != 0) throw runtime_error("Invalid cards: " + text);
+    uint64_t cards = 0;
+    for (size_t i = 0; i < text.size(); i += 2) {
+        size_t rank = RANK_CHARS.find(static_cast<char>(toupper(text[i])));
+        size_t suit = SUIT_CHARS.find(static_cast<char>(tolower(text[i + 1])));
+        if (rank == string::npos || suit == string::npos) throw runtime_error("Invalid cards: " + text);
+        uint64_t card = 1ULL << (suit * NUM_VALUES + rank);
+        if (cards & card) throw runtime_error("Cards repeat: " + text);
+        cards |= card;
+    }
+    return cards;
+}
+
+bool HandPotentialTable::generate(const string& path, const HandPotentialOptions& options) {
+    // Classes to compute, by board size
+    array<vector<bool>, 5> isSelected;
+    isSelected[3].assign(NUM_FLOP_CLASSES, options.boards.empty());
+    isSelected[4].assign(NUM_TURN_CLASSES, options.boards.empty() && options.includeTurn);
+    for (uint64_t board : options.boards) {
+        int numBoardCards = HandRank::countCards(board);
+        if (numBoardCards < 3 || numBoardCards > 4) throw runtime_error("Hand potential needs a flop or turn");
+        if (numBoardCards == 4 && !options.includeTurn) throw runtime_error("Turn boards need the turn classes included");
+        isSelected[numBoardCards][BoardClass::canonicalize(board).index] = true;
+    }
+    vector<pair<int, uint32_t>> classes;
+    for (int numBoardCards = 3; numBoardCards <= 4; ++numBoardCards) {
+        for (uint32_t index = 0; index < isSelected[numBoardCards].size(); ++index) {
+            if (isSelected[numBoardCards][index]) classes.emplace_back(numBoardCards, index);
+        }
+    }
+
+    // Slots are filled in place, every class writing only its own
+    size_t numEntries = getSectionSize(3) + (options.includeTurn ? getSectionSize(4) : 0);
+    vector<uint8_t> file(HAND_POTENTIAL_TABLE_HEADER_SIZE + numEntries * sizeof(uint16_t), 0xFF);
+    uint16_t* flopSlots = reinterpret_cast<uint16_t*>(file.data() + HAND_POTENTIAL_TABLE_HEADER_SIZE);
+    uint16_t* turnSlots = flopSlots + getSectionSize(3);
+
+    atomic<size_t> nextClass(0);
+    auto enumerate = [&]() {
+        ClassGenerator generator;
+        for (size_t c = nextClass++; c < classes.size(); c = nextClass++) {
+            int numBoardCards = classes[c].first;
+            uint32_t index = classes[c].second;
+            uint16_t* slots = (numBoardCards == 3 ? flopSlots : turnSlots) + index * getNumSlots(numBoardCards) * NUM_SLOT_VALUES;
+            generator.generate(BoardClass::getRepresentative(numBoardCards, index), slots);
+        }
+    };
+    vector<thread> workers;
+    for (int worker = 1; worker < options.numThreads; ++worker) workers.emplace_back(enumerate);
+    enumerate();
+    for (thread& worker : workers) worker.join();
+
+    MappedTableHeader header;
+    header.magic = HAND_POTENTIAL_TABLE_MAGIC;
+    header.version = HAND_POTENTIAL_TABLE_VERSION;
+    header.flags = options.includeTurn ? HAND_POTENTIAL_TABLE_HAS_TURN : 0;
+    header.sizes = {NUM_FLOP_CLASSES, static_cast<uint32_t>(options.includeTurn ? NUM_TURN_CLASSES : 0)};
+    return MappedTable::write(path, header, file);
+}
@@ -0,0 +1,213 @@
+#include "../include/HandRange.h"
+#include "../include/CardSubset.h"
+#include <stdexcept>
+
+namespace {
+    const string RANK_CHARS = "23456789TJQKA";
+    const string SUIT_CHARS = "hdcs";
+    const int NUM_SUITS = 4;
+
+    typedef struct ComboTables {
+        array<uint64_t, NUM_COMBOS> masks;
+        array<bitset<NUM_COMBOS>, 52> withCard;
+    } ComboTables;
+
+    ComboTables buildTables() {
+        ComboTables tables;
+        for (int high = 1; high < 52; ++high) {
+            for (int low = 0; low < high; ++low) {
+                int combo = high * (high - 1) / 2 + low;
+                tables.masks[combo] = (1ULL << high) | (1ULL << low);
+                tables.withCard[high].set(combo);
+                tables.withCard[low].set(combo);
+            }
+        }
+        return tables;
+    }
+
+    const ComboTables TABLES = buildTables();
+
+    int parseRank(char c, const string& token) {
+        size_t rank = RANK_CHARS.find(toupper(c));
+        if (rank == string::npos) throw runtime_error("Invalid rank in range token: " + token);
+        return static_cast<int>(rank);
+    }
+
+    int parseSuit(char c, const string& token) {
+        size_t suit = SUIT_CHARS.find(tolower(c));
+        if (suit == string::npos) throw runtime_error("Invalid suit in range token: " + token);
+        return static_cast<int>(suit);
+    }
+
+    string trim(const string& text) {
+        size_t first = text.find_first_not_of(" \t");
+        if (first == string::npos) return "";
+        return text.substr(first, text.find_last_not_of(" \t") - first + 1);
+    }
+
+    // A hand like "AKs" or "QQ": ranks high first, suitedness 0 for either
+    typedef struct HandToken {
+        int first;
+        int second;
+        char suitedness;
+    } HandToken;
+
+    HandToken parseHand(const string& hand, const string& token) {
+        if (hand.size() < 2 || hand.size() > 3) throw runtime_error("Invalid hand in range token: " + token);
+        HandToken parsed{parseRank(hand[0], token), parseRank(hand[1], token), 0};
+        if (parsed.first < parsed.second) swap(parsed.first, parsed.second);
+        if (hand.size() == 3) {
+            parsed.suitedness = static_cast<char>(tolower(hand[2]));
+            if ((parsed.suitedness != 's' && parsed.suitedness != 'o') || parsed.first == parsed.second) {
+                throw runtime_error("Invalid suitedness in range token: " + token);
+            }
+        }
+        return parsed;
+    }
+}
+
+HandRange::HandRange() {
+    weights.fill(0);
+}
+
+HandRange HandRange::parse(const string& text) {
+    HandRange range;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find(',', start);
+        if (end == string::npos) end = text.size();
+        string token = trim(text.substr(start, end - start));
+        start = end + 1;
+        if (token.empty()) continue;
+
+        // Optional weight, e.g. "50% AQo"
+        uint8_t weight = FULL_WEIGHT;
+        size_t percent = token.find('%');
+        if (percent != string::npos) {
+            string number = token.substr(0, percent);
+            if (number.empty() || number.find_first_not_of("0123456789") != string::npos || number.size() > 3 ||
+                stoi(number) < 1 || stoi(number) > FULL_WEIGHT) {
+                throw runtime_error("Invalid weight in range token: " + token);
+            }
+            weight = static_cast<uint8_t>(stoi(number));
+            token = trim(token.substr(percent + 1));
+        }
+        range.addToken(token, weight);
+    }
+    return range;
+}
+
+HandRange HandRange::createFull() {
+    HandRange range;
+    for (int combo = 0; combo < NUM_COMBOS; ++combo) range.addCombo(combo);
+    return range;
+}
+
+void HandRange::addToken(const string& token, uint8_t weight) {
+    // A specific combo, e.g. "AhKh"
+    if (token.size() == 4 && SUIT_CHARS.find(tolower(token[1])) != string::npos &&
+        SUIT_CHARS.find(tolower(token[3])) != string::npos) {
+        int first = parseSuit(token[1], token) * NUM_VALUES + parseRank(token[0], token);
+        int second = parseSuit(token[3], token) * NUM_VALUES + parseRank(token[2], token);
+        if (first == second) throw runtime_error("Combo repeats a card: " + token);
+        addCombo(getComboIndex((1ULL << first) | (1ULL << second)), weight);
+        return;
+    }
+
+    // A span, e.g. "22-55" or "KTs-K7s"
+    size_t dash = token.find('-');
+    if (dash != string::npos) {
+        HandToken from = parseHand(token.substr(0, dash), token);
+        HandToken to = parseHand(token.substr(dash + 1), token);
+        if (from.first == from.second && to.first == to.second) {
+            for (int rank = min(from.first, to.first); rank <= max(from.first, to.first); ++rank) {
+                addHand(rank, rank, 0, weight);
+            }
+            return;
+        }
+        if (from.first != to.first || from.suitedness != to.suitedness || from.first == from.second || to.first == to.second) {
+            throw runtime_error("Span must share its top rank: " + token);
+        }
+        for (int kicker = min(from.second, to.second); kicker <= max(from.second, to.second); ++kicker) {
+            addHand(from.first, kicker, from.suitedness, weight);
+        }
+        return;
+    }
+
+    // This hand and better, e.g. "QQ+" up to aces or "A2s+" up to the kicker below the top rank
+    if (!token.empty() && token.back() == '+') {
+        HandToken hand = parseHand(token.substr(0, token.size() - 1), token);
+        if (hand.first == hand.second) {
+            for (int rank = hand.first; rank < NUM_VALUES; ++rank) addHand(rank, rank, 0, weight);
+        } else {
+            for (int kicker = hand.second; kicker < hand.first; ++kicker) addHand(hand.first, kicker, hand.suitedness, weight);
+        }
+        return;
+    }
+
+    HandToken hand = parseHand(token, token);
+    addHand(hand.first, hand.second, hand.suitedness, weight);
+}
+
+void HandRange::addHand(int first, int second, char suitedness, uint8_t weight) {
+    for (int firstSuit = 0; firstSuit < NUM_SUITS; ++firstSuit) {
+        for (int secondSuit = 0; secondSuit < NUM_SUITS; ++secondSuit) {
+            if (first == second && firstSuit >= secondSuit) continue;
+            if (suitedness == 's' && firstSuit != secondSuit) continue;
+            if (suitedness == 'o' && firstSuit == secondSuit) continue;
+            uint64_t cards = (1ULL << (firstSuit * NUM_VALUES + first)) | (1ULL << (secondSuit * NUM_VALUES + second));
+            addCombo(getComboIndex(cards), weight);
+        }
+    }
+}
+
+void HandRange::addCombo(int combo, uint8_t weight) {
+    if (combo < 0 || combo >= NUM_COMBOS || weight == 0 || weight > FULL_WEIGHT) {
+        throw runtime_error("Invalid combo or weight");
+    }
+    combos.set(combo);
+    weights[combo] = weight;
+}
+
+void HandRange::removeCards(uint64_t cards) {
+    combos = getLiveCombos(cards);
+}
+
+bitset<NUM_COMBOS> HandRange::getLiveCombos(uint64_t cards) const {
+    bitset<NUM_COMBOS> live = combos;
+    for (; cards != 0; cards &= cards - 1) live &= ~TABLES.withCard[__builtin_ctzll(cards)];
+    return live;
+}
+
+bool HandRange::contains(int combo) const {
+    return combos.test(combo);
+}
+
+uint8_t HandRange::getWeight(int combo) const {
+    return combos.test(combo) ? weights[combo] : 0;
+}
+
+const bitset<NUM_COMBOS>& HandRange::getCombos() const {
+    return combos;
+}
+
+size_t HandRange::size() const {
+    return combos.count();
+}
+
+bool HandRange::isEmpty() const {
+    return combos.none();
+}
+
+int HandRange::getComboIndex(uint64_t cards) {
+    if (HandRank::countCards(cards) != 2 || (cards & ~FULL_DECK_MASK)) throw runtime_error("A combo is two cards");
+    return static_cast<int>(CardSubset::getRank(cards));
+}
+
+uint64_t HandRange::getComboMask(int combo) {
+    return TABLES.masks.at(combo);
+}
+
+const bitset<NUM_COMBOS>& HandRange::getCombosWithCard(int card) {
+    return TABLES.withCard.at(card);
+}
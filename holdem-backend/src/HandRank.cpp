@@ -0,0 +1,134 @@
+#include "../include/HandRank.h"
+#include <array>
+
+namespace {
+    const uint32_t RANK_MASK = 0x1FFF;
+    const int NUM_RANK_MASKS = 1 << NUM_VALUES;
+
+    typedef struct RankTables {
+        // Highest rank index of the best straight in a rank mask, -1 if there is none
+        array<int8_t, NUM_RANK_MASKS> straightHigh;
+        array<uint8_t, NUM_RANK_MASKS> numRanks;
+    } RankTables;
+
+    RankTables buildTables() {
+        RankTables tables;
+        for (int mask = 0; mask < NUM_RANK_MASKS; ++mask) {
+            tables.straightHigh[mask] = -1;
+            for (int high = NUM_VALUES - 1; high >= 4; --high) {
+                uint32_t straight = 0x1Fu << (high - 4);
+                if ((mask & straight) == straight) {
+                    tables.straightHigh[mask] = static_cast<int8_t>(high);
+                    break;
+                }
+            }
+            // Five high straight (the wheel) plays the ace low
+            if (tables.straightHigh[mask] < 0 && (mask & 0x100F) == 0x100F) tables.straightHigh[mask] = 3;
+
+            int count = 0;
+            for (int bit = mask; bit != 0; bit &= bit - 1) count++;
+            tables.numRanks[mask] = static_cast<uint8_t>(count);
+        }
+        return tables;
+    }
+
+    const RankTables TABLES = buildTables();
+
+    inline uint32_t getHighestIndex(uint32_t ranks) {
+        return 31 - __builtin_clz(ranks);
+    }
+
+    // Keeps the n highest ranks of a mask by clearing the lowest ones
+    inline uint32_t keepHighest(uint32_t ranks, int n) {
+        for (int extra = TABLES.numRanks[ranks] - n; extra > 0; --extra) ranks &= ranks - 1;
+        return ranks;
+    }
+
+    inline uint32_t makeRank(HandCategory category, uint32_t payload) {
+        return (static_cast<uint32_t>(category) << HAND_RANK_CATEGORY_SHIFT) | payload;
+    }
+}
+
+uint32_t HandRank::evaluate(uint64_t cards) {
+    uint32_t hearts = cards & RANK_MASK;
+    uint32_t diamonds = (cards >> NUM_VALUES) & RANK_MASK;
+    uint32_t clubs = (cards >> (2 * NUM_VALUES)) & RANK_MASK;
+    uint32_t spades = (cards >> (3 * NUM_VALUES)) & RANK_MASK;
+
+    // A flush suit holds at least five of the (at most seven) cards, so there is only one
+    uint32_t flush = (TABLES.numRanks[hearts] >= 5) ? hearts :
+                     (TABLES.numRanks[diamonds] >= 5) ? diamonds :
+                     (TABLES.numRanks[clubs] >= 5) ? clubs :
+                     (TABLES.numRanks[spades] >= 5) ? spades : 0;
+    if (flush != 0) {
+        int high = TABLES.straightHigh[flush];
+        if (high == NUM_VALUES - 1) return makeRank(ROYAL_FLUSH, high);
+        if (high >= 0) return makeRank(STRAIGHT_FLUSH, high);
+
+        // Nothing but a straight flush beats a flush when there are seven cards or fewer
+        return makeRank(FLUSH, keepHighest(flush, 5));
+    }
+
+    uint32_t ranks = hearts | diamonds | clubs | spades;
+    int straightHigh = TABLES.straightHigh[ranks];
+    int numCards = TABLES.numRanks[hearts] + TABLES.numRanks[diamonds] + TABLES.numRanks[clubs] + TABLES.numRanks[spades];
+    int numDuplicates = numCards - TABLES.numRanks[ranks];
+
+    // Most hands have no pair or a single one, which need none of the counting below
+    if (numDuplicates == 0) {
+        if (straightHigh >= 0) return makeRank(STRAIGHT, straightHigh);
+        return makeRank(HIGH_CARD, keepHighest(ranks, 5));
+    }
+    if (numDuplicates == 1) {
+        if (straightHigh >= 0) return makeRank(STRAIGHT, straightHigh);
+
+        // The pair is the one rank held an even number of times
+        uint32_t pair = ranks ^ (hearts ^ diamonds ^ clubs ^ spades);
+        return makeRank(ONE_PAIR, (getHighestIndex(pair) << NUM_VALUES) | keepHighest(ranks & ~pair, 3));
+    }
+
+    uint32_t quads = hearts & diamonds & clubs & spades;
+    uint32_t atLeastTwo = (hearts & diamonds) | (hearts & clubs) | (hearts & spades) |
+                          (diamonds & clubs) | (diamonds & spades) | (clubs & spades);
+    uint32_t atLeastThree = (hearts & diamonds & clubs) | (hearts & diamonds & spades) |
+                            (hearts & clubs & spades) | (diamonds & clubs & spades);
+    uint32_t trips = atLeastThree & ~quads;
+    uint32_t pairs = atLeastTwo & ~atLeastThree;
+
+    if (quads != 0) {
+        uint32_t quad = getHighestIndex(quads);
+        return makeRank(FOUR_OF_A_KIND, (quad << NUM_VALUES) | keepHighest(ranks & ~(1u << quad), 1));
+    }
+
+    if (trips != 0) {
+        // A second set of trips plays as the pair
+        uint32_t trip = getHighestIndex(trips);
+        uint32_t pairRanks = (trips & ~(1u << trip)) | pairs;
+        if (pairRanks != 0) return makeRank(FULL_HOUSE, (trip << NUM_VALUES) | getHighestIndex(pairRanks));
+    }
+
+    if (straightHigh >= 0) return makeRank(STRAIGHT, straightHigh);
+
+    if (trips != 0) {
+        uint32_t trip = getHighestIndex(trips);
+        return makeRank(THREE_OF_A_KIND, (trip << NUM_VALUES) | keepHighest(ranks & ~(1u << trip), 2));
+    }
+
+    // Two or three pairs, the best two of which play
+    uint32_t twoPairs = keepHighest(pairs, 2);
+    return makeRank(TWO_PAIR, (twoPairs << NUM_VALUES) | keepHighest(ranks & ~twoPairs, 1));
+}
+
+HandCategory HandRank::getCategory(uint32_t rank) {
+    return static_cast<HandCategory>(rank >> HAND_RANK_CATEGORY_SHIFT);
+}
+
+uint64_t HandRank::getMask(const vector<Card>& cards) {
+    uint64_t mask = 0;
+    for (const Card& card : cards) mask |= card.getBitMask();
+    return mask;
+}
+
+int HandRank::countCards(uint64_t cards) {
+    return __builtin_popcountll(cards);
+}
@@ -0,0 +1,104 @@
+#include "../include/HandReplay.h"
+
+namespace {
+    const uint64_t FNV_OFFSET = 14695981039346656037ull;
+    const uint64_t FNV_PRIME = 1099511628211ull;
+
+    // The game narrates every step to stdout, which is silenced for the replay
+    class QuietConsole {
+    private:
+        ios_base::iostate state;
+    public:
+        QuietConsole() : state(cout.rdstate()) { cout.setstate(ios_base::badbit); }
+        ~QuietConsole() { cout.clear(state); }
+    };
+}
+
+ReplayResult ReplayEngine::replay(const ReplayLog& log, ReplayMode mode) {
+    QuietConsole quiet;
+    ReplayResult result;
+    result.chipDigest = FNV_OFFSET;
+
+    GameController game(log.smallBlind, log.bigBlind);
+    game.setDeckSeed(log.seed);
+    for (const auto& [name, chips] : log.players) game.addPlayerToGame(name, chips);
+
+    size_t next = 0;
+    while (next < log.actions.size() && !result.isDiverged) {
+        if (!game.beginRound()) {
+            result.isDiverged = true;
+            break;
+        }
+
+        while (game.isAwaitingAction()) {
+            if (next == log.actions.size()) {
+                result.isTruncated = true;
+                break;
+            }
+
+            const HandAction& logged = log.actions[next];
+            const StreetState& streetState = game.getStreetState();
+            shared_ptr<Player> player = streetState.getCurPlayer();
+            if (logged.position != static_cast<uint8_t>(player->getPosition()) ||
+                logged.street != static_cast<uint8_t>(streetState.getStreet())) {
+                result.isDiverged = true;
+                break;
+            }
+
+            ClientAction action = ClientAction{player, getClientActionType(logged, game.getPossibleActions()), logged.amount};
+            if (!game.processClientAction(action)) {
+                result.isDiverged = true;
+                break;
+            }
+            next++;
+        }
+        if (game.isRoundInProgress()) break;
+
+        result.numHands++;
+        result.chipDigest = updateDigest(result.chipDigest, game.getGamePlayers());
+        if (mode == REPLAY_FULL) result.hands.push_back(game.getHandRecord());
+        game.setupNewRound();
+    }
+    result.numActions = next;
+
+    for (const auto& [name, chips] : log.players) {
+        size_t finalChips = 0;
+        for (const auto& player : game.getGamePlayers()) {
+            if (player->getName() == name) finalChips = player->getChips();
+        }
+        result.finalChips.push_back(finalChips);
+    }
+    return result;
+}
+
+void ReplayEngine::appendHand(const HandRecord& hand, ReplayLog& log) {
+    for (const HandAction& action : hand.actions) {
+        if (action.type != BLIND) log.actions.push_back(action);
+    }
+}
+
+ActionType ReplayEngine::getClientActionType(const HandAction& action, const vector<PossibleAction>& possibleActions) {
+    switch (action.type) {
+        case ALL_IN_CALL:
+            return CALL;
+        case ALL_IN_BET:
+            // All in for the whole stack is a raise when facing a bet
+            for (const auto& possible : possibleActions) {
+                if (possible.type == RAISE) return RAISE;
+            }
+            return BET;
+        default:
+            return static_cast<ActionType>(action.type);
+    }
+}
+
+uint64_t ReplayEngine::updateDigest(uint64_t digest, const vector<shared_ptr<Player>>& players) {
+    for (const auto& player : players) {
+        uint64_t chips = player->getChips();
+        for (int i = 0; i < 8; ++i) {
+            digest ^= (chips >> (8 * i)) & 0xFF;
+            digest *= FNV_PRIME;
+        }
+    }
+    return digest;
+}
@@ -0,0 +1,92 @@
+#include "../include/HandStrength.h"
+#include <algorithm>
+#include <stdexcept>
+
+HandStrengthResult::HandStrengthResult() : numCombos(0), wins(0), ties(0), losses(0) {}
+
+double HandStrengthResult::getWinFraction() const {
+    return numCombos ? static_cast<double>(wins) / numCombos : 0.0;
+}
+
+double HandStrengthResult::getTieFraction() const {
+    return numCombos ? static_cast<double>(ties) / numCombos : 0.0;
+}
+
+double HandStrengthResult::getLossFraction() const {
+    return numCombos ? static_cast<double>(losses) / numCombos : 0.0;
+}
+
+double HandStrengthResult::getStrength() const {
+    return numCombos ? (wins + ties / 2.0) / numCombos : 0.0;
+}
+
+HandStrength::HandStrength(uint64_t board) :
+    board(board),
+    numCombos(0),
+    numBelow(NUM_COMBOS, 0),
+    numSame(NUM_COMBOS, 0)
+{
+    int numBoardCards = HandRank::countCards(board);
+    if (numBoardCards < 3 || numBoardCards > 5 || (board & ~FULL_DECK_MASK)) {
+        throw runtime_error("Hand strength needs a board of 3 to 5 cards");
+    }
+
+    // Combos ordered by rank, then each run of equal ranks gets the same place
+    vector<pair<uint32_t, int>> ranked;
+    ranked.reserve(NUM_COMBOS);
+    for (int combo = 0; combo < NUM_COMBOS; ++combo) {
+        uint64_t hole = HandRange::getComboMask(combo);
+        if (hole & board) continue;
+        ranked.emplace_back(HandRank::evaluate(hole | board), combo);
+    }
+    sort(ranked.begin(), ranked.end());
+    numCombos = static_cast<int>(ranked.size());
+
+    for (size_t first = 0; first < ranked.size();) {
+        size_t last = first;
+        while (last < ranked.size() && ranked[last].first == ranked[first].first) ++last;
+        for (size_t i = first; i < last; ++i) {
+            numBelow[ranked[i].second] = static_cast<uint16_t>(first);
+            numSame[ranked[i].second] = static_cast<uint16_t>(last - first);
+        }
+        first = last;
+    }
+}
+
+HandStrengthResult HandStrength::getStrength(uint64_t hole) const {
+    if (HandRank::countCards(hole) != 2 || (hole & ~FULL_DECK_MASK)) {
+        throw runtime_error("Hand strength needs exactly two hole cards");
+    }
+    if (hole & board) throw runtime_error("A hole card is on the board");
+
+    int combo = HandRange::getComboIndex(hole);
+    int below = numBelow[combo];
+    HandStrengthResult result;
+    result.wins = below;
+    result.ties = numSame[combo];
+    result.numCombos = numCombos;
+
+    // Takes out the combos holding a hole card, the pair itself among them. Indices are
+    // worked out inline (high * (high - 1) / 2 + low) as this loop is the whole query.
+    int first = __builtin_ctzll(hole);
+    uint64_t others = FULL_DECK_MASK & ~(board | (1ULL << first));
+    for (int card : {first, 63 - __builtin_clzll(hole)}) {
+        for (uint64_t rest = others; rest != 0; rest &= rest - 1) {
+            int other = __builtin_ctzll(rest);
+            int blocked = (card > other) ? card * (card - 1) / 2 + other : other * (other - 1) / 2 + card;
+            if (numBelow[blocked] < below) {
+                result.wins--;
+            } else if (numBelow[blocked] == below) {
+                result.ties--;
+            }
+            result.numCombos--;
+        }
+        others &= ~hole;
+    }
+    result.losses = result.numCombos - result.wins - result.ties;
+    return result;
+}
+
+uint64_t HandStrength::getBoard() const {
+    return board;
+}
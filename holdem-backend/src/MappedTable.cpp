@@ -0,0 +1,92 @@
+#include "../include/MappedTable.h"
+#include "../include/FileUtils.h"
+#include "../include/WireProtocol.h"
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedTable::MappedTable() : mapping(nullptr), mappingSize(0), header() {}
+
+MappedTable::~MappedTable() {
+    close();
+}
+
+void MappedTable::close() {
+    if (mapping != nullptr) munmap(const_cast<uint8_t*>(mapping), mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+    header = MappedTableHeader();
+}
+
+bool MappedTable::open(const string& path, uint32_t magic, uint16_t version,
+                       const function<bool(const MappedTableHeader&, size_t)>& isValid) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < MAPPED_TABLE_HEADER_SIZE) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    const uint8_t* data = static_cast<const uint8_t*>(mapped);
+    WireReader reader(data, MAPPED_TABLE_HEADER_SIZE);
+    MappedTableHeader read;
+    read.magic = reader.getU32();
+    read.version = reader.getU16();
+    read.flags = reader.getU16();
+    read.sizes[0] = reader.getU32();
+    read.sizes[1] = reader.getU32();
+    read.crc = reader.getU32();
+
+    size_t bodySize = size - MAPPED_TABLE_HEADER_SIZE;
+    if (read.magic != magic || read.version != version || !isValid(read, bodySize) ||
+        computeCrc32(data + MAPPED_TABLE_HEADER_SIZE, bodySize) != read.crc) {
+        munmap(mapped, size);
+        return false;
+    }
+
+    mapping = data;
+    mappingSize = size;
+    header = read;
+    return true;
+}
+
+bool MappedTable::isOpen() const {
+    return mapping != nullptr;
+}
+
+const MappedTableHeader& MappedTable::getHeader() const {
+    return header;
+}
+
+const uint8_t* MappedTable::getBody() const {
+    return mapping == nullptr ? nullptr : mapping + MAPPED_TABLE_HEADER_SIZE;
+}
+
+size_t MappedTable::getBodySize() const {
+    return mapping == nullptr ? 0 : mappingSize - MAPPED_TABLE_HEADER_SIZE;
+}
+
+bool MappedTable::write(const string& path, MappedTableHeader header, vector<uint8_t>& file) {
+    if (file.size() < MAPPED_TABLE_HEADER_SIZE) throw runtime_error("A table file needs room for its header");
+
+    header.crc = computeCrc32(file.data() + MAPPED_TABLE_HEADER_SIZE, file.size() - MAPPED_TABLE_HEADER_SIZE);
+    WireWriter writer(file.data(), MAPPED_TABLE_HEADER_SIZE);
+    writer.putU32(header.magic);
+    writer.putU16(header.version);
+    writer.putU16(header.flags);
+    writer.putU32(header.sizes[0]);
+    writer.putU32(header.sizes[1]);
+    writer.putU32(header.crc);
+    memset(file.data() + writer.getSize(), 0, MAPPED_TABLE_HEADER_SIZE - writer.getSize());
+    return writeFileAtomically(path, file.data(), file.size());
+}
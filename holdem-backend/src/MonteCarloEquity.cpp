@@ -0,0 +1,243 @@
+#include "../include/MonteCarloEquity.h"
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+using Clock = chrono::steady_clock;
+
+namespace {
+    // Spaces out the seeds of the worker streams
+    const uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+
+    // Range combos dealt in a row that clash before a worker gives up on the ranges
+    const int MAX_CLASHING_DEALS = 100000;
+
+    typedef struct SharedRun {
+        const vector<HandSource>& sources;
+        uint64_t board;
+        uint64_t dealt;                 // Known hands and the board
+        const MonteCarloOptions& options;
+        Clock::time_point start;
+
+        atomic<uint64_t> numReserved;   // Samples handed out to workers so far
+        atomic<bool> isDone;
+        atomic<bool> hasClashingRanges;
+        mutex totalLock;
+        MonteCarloResult total;
+    } SharedRun;
+
+    // Checks the stopping rules against the samples folded in so far
+    bool isFinished(const SharedRun& run) {
+        const MonteCarloOptions& options = run.options;
+        if (run.total.tally.numBoards >= options.maxSamples) return true;
+        if (options.timeBudget.count() > 0 && Clock::now() - run.start >= options.timeBudget) return true;
+        return options.targetError > 0 && run.total.tally.numBoards >= MONTE_CARLO_BATCH_SIZE &&
+               run.total.getMaxStandardError() <= options.targetError;
+    }
+
+    inline uint64_t getUniform(mt19937_64& rng, uint64_t bound) {
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(rng()) * bound) >> 64);
+    }
+
+    // Draws a combo for every range hand, redrawing all of them while any clash.
+    // Returns false if they keep clashing.
+    bool drawRangeCombos(const SharedRun& run, mt19937_64& rng, uint64_t* holes, uint64_t& used) {
+        for (int attempt = 0; attempt < MAX_CLASHING_DEALS; ++attempt) {
+            uint64_t drawn = run.dealt;
+            bool isClash = false;
+            for (size_t h = 0; h < run.sources.size() && !isClash; ++h) {
+                const HandSource& source = run.sources[h];
+                if (source.combos.empty()) continue;
+                uint32_t pick = static_cast<uint32_t>(getUniform(rng, source.cumulativeWeights.back()));
+                size_t combo = upper_bound(source.cumulativeWeights.begin(), source.cumulativeWeights.end(), pick) -
+                               source.cumulativeWeights.begin();
+                holes[h] = source.combos[combo];
+                isClash = (drawn & holes[h]) != 0;
+                drawn |= holes[h];
+            }
+            if (!isClash) {
+                used = drawn;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void runWorker(SharedRun& run, int stream) {
+        size_t numHands = run.sources.size();
+        mt19937_64 rng(run.options.seed + GOLDEN_GAMMA * (stream + 1));
+
+        bool hasRanges = false;
+        for (const HandSource& source : run.sources) hasRanges |= !source.combos.empty();
+
+        uint64_t cards[52];
+        int numCards = 0;
+        for (uint64_t remaining = FULL_DECK_MASK & ~run.dealt; remaining != 0; remaining &= remaining - 1) {
+            cards[numCards++] = remaining & -remaining;
+        }
+        int numBoardToDeal = NUM_BOARD_CARDS - HandRank::countCards(run.board);
+
+        uint64_t holes[MONTE_CARLO_BATCH_SIZE][MAX_EQUITY_HANDS];
+        uint64_t boards[MONTE_CARLO_BATCH_SIZE];
+        uint32_t ranks[MONTE_CARLO_BATCH_SIZE][MAX_EQUITY_HANDS];
+        MonteCarloResult batch(numHands);
+
+        while (!run.isDone) {
+            uint64_t first = run.numReserved.fetch_add(MONTE_CARLO_BATCH_SIZE);
+            if (first >= run.options.maxSamples) break;
+            int batchSize = static_cast<int>(min<uint64_t>(MONTE_CARLO_BATCH_SIZE, run.options.maxSamples - first));
+
+            // Deal every runout in the batch: range combos first, then the board and unknown
+            // hands with a partial shuffle of the remaining cards, passing over range cards
+            for (int s = 0; s < batchSize; ++s) {
+                uint64_t used = run.dealt;
+                if (hasRanges && !drawRangeCombos(run, rng, holes[s], used)) {
+                    run.hasClashingRanges = true;
+                    run.isDone = true;
+                    return;
+                }
+
+                int numDrawn = 0;
+                auto draw = [&]() {
+                    uint64_t card;
+                    do {
+                        int pick = numDrawn + static_cast<int>(getUniform(rng, numCards - numDrawn));
+                        swap(cards[numDrawn], cards[pick]);
+                        card = cards[numDrawn++];
+                    } while (card & used);
+                    return card;
+                };
+                boards[s] = run.board;
+                for (int i = 0; i < numBoardToDeal; ++i) boards[s] |= draw();
+                for (size_t h = 0; h < numHands; ++h) {
+                    const HandSource& source = run.sources[h];
+                    if (source.known != 0) holes[s][h] = source.known;
+                    else if (source.combos.empty()) holes[s][h] = draw() | draw();
+                }
+            }
+
+            for (int s = 0; s < batchSize; ++s) {
+                for (size_t h = 0; h < numHands; ++h) ranks[s][h] = HandRank::evaluate(holes[s][h] | boards[s]);
+            }
+            batch = MonteCarloResult(numHands);
+            for (int s = 0; s < batchSize; ++s) {
+                uint32_t best = 0;
+                int numWinners = 0;
+                for (size_t h = 0; h < numHands; ++h) best = max(best, ranks[s][h]);
+                for (size_t h = 0; h < numHands; ++h) numWinners += (ranks[s][h] == best);
+
+                double share = 1.0 / numWinners;
+                for (size_t h = 0; h < numHands; ++h) {
+                    if (ranks[s][h] != best) continue;
+                    if (numWinners == 1) batch.tally.wins[h]++;
+                    else batch.tally.ties[h]++;
+                    batch.tally.shares[h] += share;
+                    batch.squaredShares[h] += share * share;
+                }
+            }
+            batch.tally.numBoards = batchSize;
+            batch.tally.numRanked = batchSize;
+
+            lock_guard<mutex> lock(run.totalLock);
+            run.total.merge(batch);
+            if (isFinished(run)) run.isDone = true;
+        }
+    }
+}
+
+MonteCarloOptions::MonteCarloOptions() :
+    numThreads(1),
+    seed(0),
+    targetError(0.0),
+    timeBudget(0),
+    maxSamples(10000000)
+{}
+
+MonteCarloResult::MonteCarloResult() : elapsed(0) {}
+
+MonteCarloResult::MonteCarloResult(size_t numHands) :
+    tally(numHands),
+    squaredShares(numHands, 0.0),
+    elapsed(0)
+{}
+
+void MonteCarloResult::merge(const MonteCarloResult& other) {
+    tally.merge(other.tally);
+    for (size_t i = 0; i < squaredShares.size(); ++i) squaredShares[i] += other.squaredShares[i];
+}
+
+double MonteCarloResult::getStandardError(size_t hand) const {
+    double n = static_cast<double>(tally.numBoards);
+    if (n < 2) return 1.0;
+    double mean = tally.shares.at(hand) / n;
+    double variance = max(0.0, (squaredShares.at(hand) / n - mean * mean) * n / (n - 1));
+    return sqrt(variance / n);
+}
+
+double MonteCarloResult::getMaxStandardError() const {
+    double maxError = 0.0;
+    for (size_t i = 0; i < squaredShares.size(); ++i) maxError = max(maxError, getStandardError(i));
+    return maxError;
+}
+
+MonteCarloResult MonteCarloEquity::compute(const vector<shared_ptr<Player>>& players, const vector<Card>& board,
+                                           const MonteCarloOptions& options) {
+    vector<uint64_t> hands;
+    for (const auto& player : players) {
+        const vector<Card>& hand = player->getHand();
+        if (!hand.empty() && hand.size() != NUM_HOLE_CARDS) {
+            throw runtime_error("Player " + player->getName() + " must have two hole cards or none");
+        }
+        hands.push_back(HandRank::getMask(hand));
+    }
+    uint64_t boardMask = HandRank::getMask(board);
+    if (HandRank::countCards(boardMask) != static_cast<int>(board.size())) {
+        throw runtime_error("Board has a repeated card");
+    }
+    return compute(hands, boardMask, options);
+}
+
+MonteCarloResult MonteCarloEquity::compute(const vector<uint64_t>& hands, uint64_t board,
+                                           const MonteCarloOptions& options) {
+    uint64_t dealt = Equity::validate(hands, board, true);
+    vector<HandSource> sources(hands.size());
+    for (size_t i = 0; i < hands.size(); ++i) sources[i].known = hands[i];
+    return sample(sources, board, dealt, options);
+}
+
+MonteCarloResult MonteCarloEquity::compute(const vector<HandRange>& ranges, uint64_t board,
+                                           const MonteCarloOptions& options) {
+    Equity::validate(vector<uint64_t>(ranges.size(), 0), board, true);
+    vector<HandSource> sources(ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        bitset<NUM_COMBOS> live = ranges[i].getLiveCombos(board);
+        if (live.none()) throw runtime_error("Range " + to_string(i) + " has no combo left on this board");
+
+        uint32_t totalWeight = 0;
+        for (size_t combo = live._Find_first(); combo < NUM_COMBOS; combo = live._Find_next(combo)) {
+            totalWeight += ranges[i].getWeight(static_cast<int>(combo));
+            sources[i].known = 0;
+            sources[i].combos.push_back(HandRange::getComboMask(static_cast<int>(combo)));
+            sources[i].cumulativeWeights.push_back(totalWeight);
+        }
+    }
+    return sample(sources, board, board, options);
+}
+
+MonteCarloResult MonteCarloEquity::sample(const vector<HandSource>& sources, uint64_t board, uint64_t dealt,
+                                          const MonteCarloOptions& options) {
+    if (options.numThreads < 1) throw runtime_error("Monte Carlo equity needs at least one thread");
+
+    SharedRun run{sources, board, dealt, options, Clock::now(), {0}, {false}, {false}, {}, MonteCarloResult(sources.size())};
+    vector<thread> workers;
+    for (int stream = 1; stream < options.numThreads; ++stream) workers.emplace_back(runWorker, ref(run), stream);
+    runWorker(run, 0);
+    for (thread& worker : workers) worker.join();
+    if (run.hasClashingRanges) throw runtime_error("Ranges have no combos that can be dealt together");
+
+    run.total.elapsed = chrono::duration_cast<chrono::microseconds>(Clock::now() - run.start);
+    return run.total;
+}
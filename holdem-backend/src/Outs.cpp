@@ -0,0 +1,49 @@
+#include "../include/Outs.h"
+
+OutsResult::OutsResult() : numHands(0), remaining(0), leaders(0), outs() {}
+
+bool OutsResult::isLeading(int hand) const {
+    return (leaders >> hand) & 1;
+}
+
+int OutsResult::getNumOuts(int hand) const {
+    return HandRank::countCards(outs[hand]);
+}
+
+namespace {
+    // Hands ranked first or level first with a board, by bit
+    uint16_t findLeaders(const vector<uint64_t>& hands, uint64_t board) {
+        uint32_t best = 0;
+        uint16_t leaders = 0;
+        for (size_t hand = 0; hand < hands.size(); ++hand) {
+            uint32_t rank = HandRank::evaluate(hands[hand] | board);
+            if (rank > best) {
+                best = rank;
+                leaders = 0;
+            }
+            if (rank == best) leaders |= static_cast<uint16_t>(1u << hand);
+        }
+        return leaders;
+    }
+}
+
+OutsResult Outs::compute(const vector<uint64_t>& hands, uint64_t board, uint64_t dead) {
+    uint64_t dealt = Equity::validate(hands, board);
+    int numBoardCards = HandRank::countCards(board);
+    if (numBoardCards < 3 || numBoardCards >= NUM_BOARD_CARDS) throw runtime_error("Outs need a flop or turn");
+    if (dead & ~FULL_DECK_MASK) throw runtime_error("Dead cards hold an invalid card");
+
+    OutsResult result;
+    result.numHands = static_cast<int>(hands.size());
+    result.remaining = FULL_DECK_MASK & ~(dealt | dead);
+    result.leaders = findLeaders(hands, board);
+
+    for (uint64_t cards = result.remaining; cards != 0; cards &= cards - 1) {
+        uint64_t card = cards & -cards;
+        uint16_t trailersLeading = findLeaders(hands, board | card) & ~result.leaders;
+        for (; trailersLeading != 0; trailersLeading &= trailersLeading - 1) {
+            result.outs[__builtin_ctz(trailersLeading)] |= card;
+        }
+    }
+    return result;
+}
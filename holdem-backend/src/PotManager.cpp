@@ -1,6 +1,7 @@
 #include "../include/PotManager.h"
 #include <limits>
 #include <iostream>
+#include <algorithm>
 
 // Helper Functions
 
@@ -0,0 +1,247 @@
+#include "../include/PreflopEquityTable.h"
+#include "../include/Equity.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+    const string RANK_CHARS = "23456789TJQKA";
+    const int NUM_SUITS = 4;
+    const int NUM_SUIT_PERMUTATIONS = 24;
+    const size_t NUM_STARTING_HAND_ENTRIES = NUM_STARTING_HANDS * NUM_STARTING_HANDS;
+    const size_t NUM_COMBO_ENTRIES = static_cast<size_t>(NUM_COMBOS) * NUM_COMBOS;
+
+    // Each combo's index once its suits are permuted, for every permutation
+    typedef array<array<uint16_t, NUM_COMBOS>, NUM_SUIT_PERMUTATIONS> PermutedCombos;
+
+    PermutedCombos buildPermutedCombos() {
+        PermutedCombos permuted;
+        array<int, NUM_SUITS> suits = {0, 1, 2, 3};
+        int p = 0;
+        do {
+            for (int combo = 0; combo < NUM_COMBOS; ++combo) {
+                uint64_t cards = HandRange::getComboMask(combo);
+                uint64_t moved = 0;
+                for (int suit = 0; suit < NUM_SUITS; ++suit) {
+                    moved |= ((cards >> (suit * NUM_VALUES)) & 0x1FFF) << (suits[suit] * NUM_VALUES);
+                }
+                permuted[p][combo] = static_cast<uint16_t>(HandRange::getComboIndex(moved));
+            }
+            p++;
+        } while (next_permutation(suits.begin(), suits.end()));
+        return permuted;
+    }
+
+    // Smallest first * NUM_COMBOS + second over every suit permutation and both seat orders,
+    // flipped when that smallest has the seats swapped
+    uint32_t getCanonicalMatchup(const PermutedCombos& permuted, int first, int second, bool& isFlipped) {
+        uint32_t best = UINT32_MAX;
+        for (int p = 0; p < NUM_SUIT_PERMUTATIONS; ++p) {
+            uint32_t a = permuted[p][first];
+            uint32_t b = permuted[p][second];
+            uint32_t asDealt = a * NUM_COMBOS + b;
+            uint32_t swapped = b * NUM_COMBOS + a;
+            if (asDealt < best) {
+                best = asDealt;
+                isFlipped = false;
+            }
+            if (swapped < best) {
+                best = swapped;
+                isFlipped = true;
+            }
+        }
+        return best;
+    }
+}
+
+PreflopTableOptions::PreflopTableOptions() : numThreads(1), includeCombos(false) {}
+
+PreflopEquityTable::PreflopEquityTable() :
+    mapping(),
+    startingHandEquities(nullptr),
+    comboEquities(nullptr)
+{}
+
+PreflopEquityTable::~PreflopEquityTable() {
+    close();
+}
+
+void PreflopEquityTable::close() {
+    mapping.close();
+    startingHandEquities = nullptr;
+    comboEquities = nullptr;
+    startingHandStrengths.clear();
+}
+
+bool PreflopEquityTable::open(const string& path) {
+    close();
+    auto isValid = [](const MappedTableHeader& header, size_t bodySize) {
+        bool hasCombos = (header.flags & PREFLOP_TABLE_HAS_COMBOS) != 0;
+        return header.sizes[0] == static_cast<uint32_t>(NUM_STARTING_HANDS) &&
+               header.sizes[1] == static_cast<uint32_t>(hasCombos ? NUM_COMBOS : 0) &&
+               bodySize == (NUM_STARTING_HAND_ENTRIES + (hasCombos ? NUM_COMBO_ENTRIES : 0)) * sizeof(float);
+    };
+    if (!mapping.open(path, PREFLOP_TABLE_MAGIC, PREFLOP_TABLE_VERSION, isValid)) return false;
+
+    startingHandEquities = reinterpret_cast<const float*>(mapping.getBody());
+    if (mapping.getHeader().flags & PREFLOP_TABLE_HAS_COMBOS) {
+        comboEquities = startingHandEquities + NUM_STARTING_HAND_ENTRIES;
+    }
+    computeStrengths();
+    return true;
+}
+
+void PreflopEquityTable::computeStrengths() {
+    // Every combo of a starting hand faces the same matchups up to suits, so one per hand is enough
+    startingHandStrengths.assign(NUM_STARTING_HANDS, NAN);
+    vector<bool> isDone(NUM_STARTING_HANDS, false);
+    for (int combo = 0; combo < NUM_COMBOS; ++combo) {
+        int startingHand = getStartingHand(combo);
+        if (isDone[startingHand]) continue;
+        isDone[startingHand] = true;
+
+        double total = 0;
+        int numOpponents = 0;
+        for (int opponent = 0; opponent < NUM_COMBOS; ++opponent) {
+            if (HandRange::getComboMask(combo) & HandRange::getComboMask(opponent)) continue;
+            total += getEquity(combo, opponent);
+            numOpponents++;
+        }
+        startingHandStrengths[startingHand] = static_cast<float>(total / numOpponents);
+    }
+}
+
+bool PreflopEquityTable::isOpen() const {
+    return mapping.isOpen();
+}
+
+bool PreflopEquityTable::hasCombos() const {
+    return comboEquities != nullptr;
+}
+
+float PreflopEquityTable::getEquity(int firstCombo, int secondCombo) const {
+    if (!isOpen()) throw runtime_error("Preflop equity table is not open");
+    if (comboEquities != nullptr) return comboEquities[static_cast<size_t>(firstCombo) * NUM_COMBOS + secondCombo];
+    return getStartingHandEquity(getStartingHand(firstCombo), getStartingHand(secondCombo));
+}
+
+float PreflopEquityTable::getStartingHandEquity(int first, int second) const {
+    if (!isOpen()) throw runtime_error("Preflop equity table is not open");
+    return startingHandEquities[first * NUM_STARTING_HANDS + second];
+}
+
+float PreflopEquityTable::getStartingHandStrength(int startingHand) const {
+    if (!isOpen()) throw runtime_error("Preflop equity table is not open");
+    return startingHandStrengths[startingHand];
+}
+
+int PreflopEquityTable::getStartingHand(int combo) {
+    uint64_t cards = HandRange::getComboMask(combo);
+    int low = __builtin_ctzll(cards);
+    int high = 63 - __builtin_clzll(cards);
+    int lowRank = low % NUM_VALUES;
+    int highRank = high % NUM_VALUES;
+    if (lowRank > highRank) swap(lowRank, highRank);
+
+    bool isSuited = (low / NUM_VALUES) == (high / NUM_VALUES);
+    return isSuited ? highRank * NUM_VALUES + lowRank : lowRank * NUM_VALUES + highRank;
+}
+
+string PreflopEquityTable::getStartingHandName(int startingHand) {
+    int row = startingHand / NUM_VALUES;
+    int column = startingHand % NUM_VALUES;
+    string name = {RANK_CHARS[max(row, column)], RANK_CHARS[min(row, column)]};
+    if (row > column) name += 's';
+    if (row < column) name += 'o';
+    return name;
+}
+
+int PreflopEquityTable::parseStartingHand(const string& name) {
+    if (name.size() < 2 || name.size() > 3 || name.find_first_of("+-,%") != string::npos) {
+        throw runtime_error("Not a starting hand: " + name);
+    }
+    HandRange range = HandRange::parse(name);
+    const bitset<NUM_COMBOS>& combos = range.getCombos();
+    int startingHand = getStartingHand(static_cast<int>(combos._Find_first()));
+    for (size_t combo = combos._Find_first(); combo < NUM_COMBOS; combo = combos._Find_next(combo)) {
+        if (getStartingHand(static_cast<int>(combo)) != startingHand) throw runtime_error("Not a starting hand: " + name);
+    }
+    return startingHand;
+}
+
+bool PreflopEquityTable::generate(const string& path, const PreflopTableOptions& options) {
+    vector<bool> isSelected(NUM_STARTING_HANDS, options.startingHands.empty());
+    for (int startingHand : options.startingHands) isSelected.at(startingHand) = true;
+    vector<int> combos;
+    for (int combo = 0; combo < NUM_COMBOS; ++combo) {
+        if (isSelected[getStartingHand(combo)]) combos.push_back(combo);
+    }
+
+    // Every distinct matchup once, up to suits and seat order
+    const PermutedCombos permuted = buildPermutedCombos();
+    unordered_map<uint32_t, uint32_t> matchupIndex;
+    vector<uint32_t> matchups;
+    for (size_t i = 0; i < combos.size(); ++i) {
+        for (size_t j = i + 1; j < combos.size(); ++j) {
+            if (HandRange::getComboMask(combos[i]) & HandRange::getComboMask(combos[j])) continue;
+            bool isFlipped;
+            uint32_t matchup = getCanonicalMatchup(permuted, combos[i], combos[j], isFlipped);
+            if (matchupIndex.emplace(matchup, matchups.size()).second) matchups.push_back(matchup);
+        }
+    }
+
+    vector<float> equities(matchups.size());
+    atomic<size_t> nextMatchup(0);
+    auto enumerate = [&]() {
+        for (size_t m = nextMatchup++; m < matchups.size(); m = nextMatchup++) {
+            uint64_t first = HandRange::getComboMask(matchups[m] / NUM_COMBOS);
+            uint64_t second = HandRange::getComboMask(matchups[m] % NUM_COMBOS);
+            equities[m] = static_cast<float>(Equity::computeExact({first, second}, 0).getEquity(0));
+        }
+    };
+    vector<thread> workers;
+    for (int worker = 1; worker < options.numThreads; ++worker) workers.emplace_back(enumerate);
+    enumerate();
+    for (thread& worker : workers) worker.join();
+
+    size_t numEntries = NUM_STARTING_HAND_ENTRIES + (options.includeCombos ? NUM_COMBO_ENTRIES : 0);
+    vector<float> table(numEntries, NAN);
+    float* comboTable = options.includeCombos ? table.data() + NUM_STARTING_HAND_ENTRIES : nullptr;
+    vector<double> sums(NUM_STARTING_HAND_ENTRIES, 0.0);
+    vector<uint32_t> counts(NUM_STARTING_HAND_ENTRIES, 0);
+    for (size_t i = 0; i < combos.size(); ++i) {
+        for (size_t j = i + 1; j < combos.size(); ++j) {
+            if (HandRange::getComboMask(combos[i]) & HandRange::getComboMask(combos[j])) continue;
+            bool isFlipped;
+            uint32_t matchup = getCanonicalMatchup(permuted, combos[i], combos[j], isFlipped);
+            float equity = equities[matchupIndex.at(matchup)];
+            if (isFlipped) equity = 1.0f - equity;
+
+            if (comboTable != nullptr) {
+                comboTable[static_cast<size_t>(combos[i]) * NUM_COMBOS + combos[j]] = equity;
+                comboTable[static_cast<size_t>(combos[j]) * NUM_COMBOS + combos[i]] = 1.0f - equity;
+            }
+            int first = getStartingHand(combos[i]);
+            int second = getStartingHand(combos[j]);
+            sums[first * NUM_STARTING_HANDS + second] += equity;
+            counts[first * NUM_STARTING_HANDS + second]++;
+            sums[second * NUM_STARTING_HANDS + first] += 1.0 - equity;
+            counts[second * NUM_STARTING_HANDS + first]++;
+        }
+    }
+    for (size_t entry = 0; entry < NUM_STARTING_HAND_ENTRIES; ++entry) {
+        if (counts[entry] > 0) table[entry] = static_cast<float>(sums[entry] / counts[entry]);
+    }
+
+    vector<uint8_t> file(PREFLOP_TABLE_HEADER_SIZE + numEntries * sizeof(float));
+    memcpy(file.data() + PREFLOP_TABLE_HEADER_SIZE, table.data(), numEntries * sizeof(float));
+    MappedTableHeader header;
+    header.magic = PREFLOP_TABLE_MAGIC;
+    header.version = PREFLOP_TABLE_VERSION;
+    header.flags = options.includeCombos ? PREFLOP_TABLE_HAS_COMBOS : 0;
+    header.sizes = {NUM_STARTING_HANDS, static_cast<uint32_t>(options.includeCombos ? NUM_COMBOS : 0)};
+    return MappedTable::write(path, header, file);
+}
@@ -0,0 +1,178 @@
+#include "../include/RangeEquity.h"
+#include <stdexcept>
+#include <thread>
+
+using Clock = chrono::steady_clock;
+
+namespace {
+    typedef struct LiveCombo {
+        uint64_t cards;
+        uint64_t weight;
+    } LiveCombo;
+
+    // Live combos of both ranges and the cards left to deal
+    typedef struct RangeRunouts {
+        vector<LiveCombo> first;
+        vector<LiveCombo> second;
+        uint64_t board;
+        uint64_t cards[52];
+        int numCards;
+    } RangeRunouts;
+
+    // Weighted counts of one worker's runouts, from the first range's point of view
+    typedef struct RangeTally {
+        uint64_t numRunouts = 0;
+        uint64_t wins = 0;
+        uint64_t losses = 0;
+        uint64_t ties = 0;
+        vector<uint32_t> firstRanks;
+        vector<uint32_t> secondRanks;
+    } RangeTally;
+
+    vector<LiveCombo> getLiveCombos(const HandRange& range, uint64_t board) {
+        vector<LiveCombo> live;
+        bitset<NUM_COMBOS> combos = range.getLiveCombos(board);
+        for (size_t combo = combos._Find_first(); combo < NUM_COMBOS; combo = combos._Find_next(combo)) {
+            live.push_back({HandRange::getComboMask(static_cast<int>(combo)), range.getWeight(static_cast<int>(combo))});
+        }
+        return live;
+    }
+
+    // Ranks every combo not blocked by the runout once (0 marks a blocked one), then scores each pair
+    void scoreRunout(const RangeRunouts& runouts, uint64_t runout, RangeTally& tally) {
+        uint64_t board = runouts.board | runout;
+        for (size_t i = 0; i < runouts.first.size(); ++i) {
+            uint64_t cards = runouts.first[i].cards;
+            tally.firstRanks[i] = (cards & runout) ? 0 : HandRank::evaluate(cards | board);
+        }
+        for (size_t j = 0; j < runouts.second.size(); ++j) {
+            uint64_t cards = runouts.second[j].cards;
+            tally.secondRanks[j] = (cards & runout) ? 0 : HandRank::evaluate(cards | board);
+        }
+
+        tally.numRunouts++;
+        for (size_t i = 0; i < runouts.first.size(); ++i) {
+            uint32_t firstRank = tally.firstRanks[i];
+            if (firstRank == 0) continue;
+            uint64_t firstCards = runouts.first[i].cards;
+            uint64_t wins = 0, losses = 0, ties = 0;
+            for (size_t j = 0; j < runouts.second.size(); ++j) {
+                uint32_t secondRank = tally.secondRanks[j];
+                if (secondRank == 0 || (firstCards & runouts.second[j].cards)) continue;
+                uint64_t weight = runouts.second[j].weight;
+                if (firstRank > secondRank) wins += weight;
+                else if (firstRank < secondRank) losses += weight;
+                else ties += weight;
+            }
+            uint64_t weight = runouts.first[i].weight;
+            tally.wins += wins * weight;
+            tally.losses += losses * weight;
+            tally.ties += ties * weight;
+        }
+    }
+
+    void dealRunouts(const RangeRunouts& runouts, int start, int numToDeal, uint64_t runout, RangeTally& tally) {
+        if (numToDeal == 0) {
+            scoreRunout(runouts, runout, tally);
+            return;
+        }
+        for (int i = start; i <= runouts.numCards - numToDeal; ++i) {
+            dealRunouts(runouts, i + 1, numToDeal - 1, runout | runouts.cards[i], tally);
+        }
+    }
+
+    // Deals the runouts whose first card falls to this worker
+    void dealWorkerRunouts(const RangeRunouts& runouts, int numToDeal, int worker, int numWorkers, RangeTally& tally) {
+        tally.firstRanks.resize(runouts.first.size());
+        tally.secondRanks.resize(runouts.second.size());
+        if (numToDeal == 0) {
+            if (worker == 0) scoreRunout(runouts, 0, tally);
+            return;
+        }
+        for (int i = worker; i <= runouts.numCards - numToDeal; i += numWorkers) {
+            dealRunouts(runouts, i + 1, numToDeal - 1, runouts.cards[i], tally);
+        }
+    }
+
+    uint64_t countRunouts(int numCards, int numToDeal) {
+        uint64_t count = 1;
+        for (int i = 0; i < numToDeal; ++i) count = count * (numCards - i) / (i + 1);
+        return count;
+    }
+}
+
+RangeEquityOptions::RangeEquityOptions() : maxExactWork(50000000) {
+    sampling.targetError = 0.001;
+}
+
+RangeEquityResult::RangeEquityResult() : isExact(false), elapsed(0) {}
+
+RangeEquityResult RangeEquity::compute(const vector<HandRange>& ranges, const vector<Card>& board,
+                                       const RangeEquityOptions& options) {
+    uint64_t boardMask = HandRank::getMask(board);
+    if (HandRank::countCards(boardMask) != static_cast<int>(board.size())) {
+        throw runtime_error("Board has a repeated card");
+    }
+    return compute(ranges, boardMask, options);
+}
+
+RangeEquityResult RangeEquity::compute(const vector<HandRange>& ranges, uint64_t board,
+                                       const RangeEquityOptions& options) {
+    Clock::time_point start = Clock::now();
+    RangeEquityResult result;
+    if (ranges.size() == 2 && estimateExactWork(ranges[0], ranges[1], board) <= options.maxExactWork) {
+        result.tally = computeExact(ranges[0], ranges[1], board, options.sampling.numThreads);
+        result.standardErrors.assign(2, 0.0);
+        result.isExact = true;
+    } else {
+        MonteCarloResult sampled = MonteCarloEquity::compute(ranges, board, options.sampling);
+        result.tally = sampled.tally;
+        for (size_t i = 0; i < ranges.size(); ++i) result.standardErrors.push_back(sampled.getStandardError(i));
+    }
+    result.elapsed = chrono::duration_cast<chrono::microseconds>(Clock::now() - start);
+    return result;
+}
+
+EquityResult RangeEquity::computeExact(const HandRange& first, const HandRange& second, uint64_t board, int numThreads) {
+    Equity::validate({0, 0}, board, true);
+
+    RangeRunouts runouts;
+    runouts.first = getLiveCombos(first, board);
+    runouts.second = getLiveCombos(second, board);
+    runouts.board = board;
+    if (runouts.first.empty() || runouts.second.empty()) throw runtime_error("A range has no combo left on this board");
+    runouts.numCards = 0;
+    for (uint64_t remaining = FULL_DECK_MASK & ~board; remaining != 0; remaining &= remaining - 1) {
+        runouts.cards[runouts.numCards++] = remaining & -remaining;
+    }
+    int numToDeal = NUM_BOARD_CARDS - HandRank::countCards(board);
+
+    int numWorkers = max(1, min(numThreads, runouts.numCards));
+    vector<RangeTally> tallies(numWorkers);
+    vector<thread> workers;
+    for (int worker = 1; worker < numWorkers; ++worker) {
+        workers.emplace_back(dealWorkerRunouts, cref(runouts), numToDeal, worker, numWorkers, ref(tallies[worker]));
+    }
+    dealWorkerRunouts(runouts, numToDeal, 0, numWorkers, tallies[0]);
+    for (thread& worker : workers) worker.join();
+
+    EquityResult result(2);
+    for (const RangeTally& tally : tallies) {
+        result.numRanked += tally.numRunouts;
+        result.numBoards += tally.wins + tally.losses + tally.ties;
+        result.wins[0] += tally.wins;
+        result.wins[1] += tally.losses;
+        result.ties[0] += tally.ties;
+        result.ties[1] += tally.ties;
+    }
+    if (result.numBoards == 0) throw runtime_error("Ranges have no combos that can be dealt together");
+    result.shares[0] = result.wins[0] + result.ties[0] / 2.0;
+    result.shares[1] = result.wins[1] + result.ties[1] / 2.0;
+    return result;
+}
+
+uint64_t RangeEquity::estimateExactWork(const HandRange& first, const HandRange& second, uint64_t board) {
+    int numBoardCards = HandRank::countCards(board);
+    uint64_t numRunouts = countRunouts(52 - numBoardCards, NUM_BOARD_CARDS - numBoardCards);
+    return numRunouts * first.getLiveCombos(board).count() * second.getLiveCombos(board).count();
+}
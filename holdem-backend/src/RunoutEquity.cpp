@@ -0,0 +1,147 @@
+#include "../include/RunoutEquity.h"
+#include "../include/CardSubset.h"
+#include <algorithm>
+#include <cmath>
+
+using Clock = chrono::steady_clock;
+
+RunoutEquityOptions::RunoutEquityOptions() :
+    budget(DEFAULT_RUNOUT_EQUITY_BUDGET),
+    seed(0),
+    preflopTable(nullptr),
+    isDeferred(false)
+{}
+
+StreetEquity::StreetEquity() : handNumber(0), street(PRE_FLOP), isExact(false), isPending(false), elapsed(0) {}
+
+RunoutJob::RunoutJob() : handNumber(0), street(PRE_FLOP), board(0) {}
+
+StreetEquity RunoutEquity::compute(const vector<shared_ptr<Player>>& contenders, const vector<Card>& board, Street street,
+                                   const RunoutEquityOptions& options) {
+    return compute(createJob(contenders, board, street, options));
+}
+
+RunoutJob RunoutEquity::createJob(const vector<shared_ptr<Player>>& contenders, const vector<Card>& board, Street street,
+                                  const RunoutEquityOptions& options) {
+    RunoutJob job;
+    job.street = street;
+    for (const auto& player : contenders) {
+        job.positions.push_back(static_cast<uint8_t>(player->getPosition()));
+        job.hands.push_back(HandRank::getMask(player->getHand()));
+    }
+    job.board = HandRank::getMask(board);
+    job.options = options;
+    return job;
+}
+
+StreetEquity RunoutEquity::compute(const RunoutJob& job) {
+    StreetEquity equity;
+    if (lookup(job, equity)) return equity;
+
+    Clock::time_point start = Clock::now();
+    equity.handNumber = job.handNumber;
+    equity.street = job.street;
+    equity.positions = job.positions;
+    uint64_t dealt = Equity::validate(job.hands, job.board);
+
+    int numRemaining = DECK_SIZE - HandRank::countCards(dealt);
+    int numToDeal = NUM_BOARD_CARDS - HandRank::countCards(job.board);
+    uint64_t work = CardSubset::choose(numRemaining, numToDeal) * job.hands.size();
+    equity.isExact = work <= MAX_EXACT_RUNOUT_WORK;
+    if (equity.isExact) {
+        equity.tally = Equity::computeExact(job.hands, job.board);
+    } else {
+        MonteCarloOptions sampling;
+        sampling.seed = job.options.seed;
+        sampling.timeBudget = max(job.options.budget - chrono::duration_cast<chrono::microseconds>(Clock::now() - start),
+                                  chrono::microseconds(1));
+        equity.tally = MonteCarloEquity::compute(job.hands, job.board, sampling).tally;
+    }
+    for (size_t hand = 0; hand < job.hands.size(); ++hand) equity.equities.push_back(equity.tally.getEquity(hand));
+
+    equity.elapsed = chrono::duration_cast<chrono::microseconds>(Clock::now() - start);
+    return equity;
+}
+
+bool RunoutEquity::lookup(const RunoutJob& job, StreetEquity& equity) {
+    const PreflopEquityTable* table = job.options.preflopTable;
+    if (table == nullptr || !table->isOpen() || job.board != 0 || job.hands.size() != 2) return false;
+
+    Clock::time_point start = Clock::now();
+    Equity::validate(job.hands, job.board);
+    float first = table->getEquity(HandRange::getComboIndex(job.hands[0]), HandRange::getComboIndex(job.hands[1]));
+    if (isnan(first)) return false;
+
+    equity = StreetEquity();
+    equity.handNumber = job.handNumber;
+    equity.street = job.street;
+    equity.positions = job.positions;
+    equity.equities = {first, 1.0 - first};
+
+    // The starting hand matrix averages over suits, only the combo matrix is exact
+    equity.isExact = table->hasCombos();
+    equity.elapsed = chrono::duration_cast<chrono::microseconds>(Clock::now() - start);
+    return true;
+}
+
+// Runout Equity Worker
+
+RunoutEquityWorker::RunoutEquityWorker(size_t numThreads) :
+    isStopping(false),
+    runningOwners(max<size_t>(numThreads, 1), nullptr) {
+
+    for (size_t i = 0; i < runningOwners.size(); ++i) threads.emplace_back(&RunoutEquityWorker::workerLoop, this, i);
+}
+
+RunoutEquityWorker::~RunoutEquityWorker() {
+    stop();
+}
+
+void RunoutEquityWorker::submit(const void* owner, RunoutJob job, function<void(StreetEquity)> done) {
+    {
+        lock_guard<mutex> lock(jobsMutex);
+        if (isStopping) return;
+        jobs.push_back(QueuedJob{owner, std::move(job), std::move(done)});
+    }
+    jobsCv.notify_one();
+}
+
+void RunoutEquityWorker::cancel(const void* owner) {
+    lock_guard<mutex> lock(jobsMutex);
+    jobs.erase(remove_if(jobs.begin(), jobs.end(), [owner](const QueuedJob& queued) { return queued.owner == owner; }),
+               jobs.end());
+    for (const void*& running : runningOwners) {
+        if (running == owner) running = nullptr;
+    }
+}
+
+void RunoutEquityWorker::stop() {
+    {
+        lock_guard<mutex> lock(jobsMutex);
+        if (isStopping) return;
+        isStopping = true;
+        jobs.clear();
+    }
+    jobsCv.notify_all();
+    for (thread& worker : threads) worker.join();
+}
+
+void RunoutEquityWorker::workerLoop(size_t threadIndex) {
+    unique_lock<mutex> lock(jobsMutex);
+    while (true) {
+        jobsCv.wait(lock, [this]() { return isStopping || !jobs.empty(); });
+        if (isStopping) return;
+
+        QueuedJob queued = std::move(jobs.front());
+        jobs.pop_front();
+        runningOwners[threadIndex] = queued.owner;
+        lock.unlock();
+
+        StreetEquity equity = RunoutEquity::compute(queued.job);
+
+        // Run under the lock, so an owner that cancelled never sees a result afterwards
+        lock.lock();
+        if (runningOwners[threadIndex] == queued.owner) queued.done(std::move(equity));
+        runningOwners[threadIndex] = nullptr;
+    }
+}
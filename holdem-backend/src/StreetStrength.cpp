@@ -0,0 +1,52 @@
+#include "../include/StreetStrength.h"
+#include "../include/Equity.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // A complete state: its strength is all there is
+    HandPotential fromStrength(double strength) {
+        HandPotential potential;
+        potential.isKnown = !isnan(strength);
+        if (!potential.isKnown) return potential;
+        potential.strength = strength;
+        potential.effective = strength;
+        return potential;
+    }
+}
+
+StreetStrength::StreetStrength(const PreflopEquityTable& preflopTable, const HandPotentialTable& potentialTable,
+                               size_t riverCacheSize) :
+    preflopTable(preflopTable),
+    potentialTable(potentialTable),
+    riverStrengths([](const CanonicalBoard& board) { return HandStrength(board.cards); }, max<size_t>(riverCacheSize, 1))
+{}
+
+HandPotential StreetStrength::lookup(uint64_t hole, uint64_t board) {
+    if (HandRank::countCards(hole) != NUM_HOLE_CARDS || (hole & ~FULL_DECK_MASK)) {
+        throw runtime_error("Each hand needs exactly two hole cards");
+    }
+    int numBoardCards = HandRank::countCards(board);
+    if (numBoardCards == 1 || numBoardCards == 2 || numBoardCards > NUM_BOARD_CARDS || (board & ~FULL_DECK_MASK)) {
+        throw runtime_error("Board must have 0, 3, 4 or 5 cards");
+    }
+    if (hole & board) throw runtime_error("A card is dealt twice");
+
+    switch (numBoardCards) {
+        case 0:
+            if (!preflopTable.isOpen()) return HandPotential();
+            return fromStrength(preflopTable.getStartingHandStrength(
+                PreflopEquityTable::getStartingHand(HandRange::getComboIndex(hole))));
+        case NUM_BOARD_CARDS: {
+            CanonicalBoard canonical = BoardClass::canonicalize(board);
+            return fromStrength(riverStrengths.get(canonical)->getStrength(canonical.apply(hole)).getStrength());
+        }
+        default:
+            if (!potentialTable.isOpen()) return HandPotential();
+            return potentialTable.lookup(hole, board);
+    }
+}
+
+HandPotential StreetStrength::lookup(const vector<Card>& hole, const vector<Card>& board) {
+    return lookup(HandRank::getMask(hole), HandRank::getMask(board));
+}
@@ -0,0 +1,246 @@
+#include "../include/TableScheduler.h"
+#include <iostream>
+#include <stdexcept>
+
+// Table Actor
+
+TableActor::TableActor() : inbox(), numPending(0), scheduler(nullptr), timerShard(0) {}
+
+void TableActor::post(TableCommand command) {
+    if (scheduler == nullptr) {
+        throw runtime_error("Attempting to post a command to a table without a scheduler!");
+    }
+    scheduler->post(*this, std::move(command));
+}
+
+uint64_t TableActor::postAfter(chrono::milliseconds delay, TableCommand command) {
+    if (scheduler == nullptr) {
+        throw runtime_error("Attempting to start a timer for a table without a scheduler!");
+    }
+    return scheduler->postAfter(*this, delay, std::move(command));
+}
+
+void TableActor::cancelTimer(uint64_t timerId) {
+    if (scheduler != nullptr) scheduler->cancelTimer(*this, timerId);
+}
+
+bool TableActor::isRegistered() const {
+    return scheduler != nullptr;
+}
+
+// Table Scheduler
+
+TableScheduler::TableScheduler(size_t numWorkers, size_t batchSize) :
+    nextTimerId(1),
+    numArmedTimers(0),
+    numActiveTables(0),
+    isStopping(false),
+    batchSize(batchSize == 0 ? 1 : batchSize) {
+
+    if (numWorkers == 0) numWorkers = 1;
+    for (size_t i = 0; i < numWorkers; ++i) {
+        workerTimers.push_back(make_unique<WorkerTimers>());
+        workerTimers.back()->epoch = chrono::steady_clock::now();
+    }
+    for (size_t i = 0; i < numWorkers; ++i) {
+        workers.emplace_back(&TableScheduler::workerLoop, this, i);
+    }
+}
+
+TableScheduler::~TableScheduler() {
+    stop();
+}
+
+void TableScheduler::addTable(const shared_ptr<TableActor>& table) {
+    if (table->scheduler != nullptr) {
+        throw runtime_error("Table is already registered with a scheduler!");
+    }
+    table->scheduler = this;
+
+    lock_guard<mutex> lock(runQueueMutex);
+    table->timerShard = tables.size() % workerTimers.size();
+    tables.push_back(table);
+}
+
+void TableScheduler::post(TableActor& table, TableCommand command) {
+    table.inbox.push(std::move(command));
+
+    // Only the producer that finds the table idle schedules it.
+    // Every other producer knows a worker will see its command.
+    if (table.numPending.fetch_add(1) == 0) enqueueTable(&table);
+}
+
+uint64_t TableScheduler::postAfter(TableActor& table, chrono::milliseconds delay, TableCommand command) {
+    TimerRequest request;
+    request.requestId = nextTimerId++;
+    // The wheel's current tick may be up to a tick old, the extra tick keeps timers from firing early
+    request.delayTicks = (delay.count() + TIMER_TICK.count() - 1) / TIMER_TICK.count() + 1;
+    request.table = &table;
+    request.command = std::move(command);
+
+    uint64_t requestId = request.requestId;
+    requestTimer(table, std::move(request));
+    return requestId;
+}
+
+void TableScheduler::cancelTimer(TableActor& table, uint64_t timerId) {
+    TimerRequest request;
+    request.requestId = timerId;
+    request.isCancel = true;
+    requestTimer(table, std::move(request));
+}
+
+size_t TableScheduler::getNumTimers() const {
+    return numArmedTimers;
+}
+
+void TableScheduler::waitUntilIdle() {
+    unique_lock<mutex> lock(runQueueMutex);
+    idleCv.wait(lock, [this]() { return numActiveTables == 0; });
+}
+
+void TableScheduler::stop() {
+    {
+        lock_guard<mutex> lock(runQueueMutex);
+        if (isStopping) return;
+        isStopping = true;
+    }
+    runQueueCv.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+size_t TableScheduler::getNumWorkers() const {
+    return workers.size();
+}
+
+size_t TableScheduler::getNumTables() const {
+    return tables.size();
+}
+
+// Helper Functions
+
+void TableScheduler::enqueueTable(TableActor* table) {
+    {
+        lock_guard<mutex> lock(runQueueMutex);
+        runQueue.push_back(table);
+        numActiveTables++;
+    }
+    runQueueCv.notify_one();
+}
+
+void TableScheduler::finishTable() {
+    bool isIdle;
+    {
+        lock_guard<mutex> lock(runQueueMutex);
+        numActiveTables--;
+        isIdle = (numActiveTables == 0);
+    }
+    if (isIdle) idleCv.notify_all();
+}
+
+void TableScheduler::workerLoop(size_t workerIndex) {
+    WorkerTimers& timers = *workerTimers[workerIndex];
+
+    while (true) {
+        runTimers(timers);
+
+        TableActor* table;
+        {
+            unique_lock<mutex> lock(runQueueMutex);
+            auto hasWork = [this, &timers]() { return isStopping || !runQueue.empty() || !timers.requests.empty(); };
+
+            if (timers.wheel.size() == 0) {
+                // No deadline to keep, sleep until there is work or a timer request.
+                // Paired with the fence in requestTimer so a request can't slip past the check.
+                timers.isParked = true;
+                atomic_thread_fence(memory_order_seq_cst);
+                runQueueCv.wait(lock, hasWork);
+                timers.isParked = false;
+            } else {
+                uint64_t nextTick = timers.wheel.getCurrentTick() + 1;
+                runQueueCv.wait_until(lock, timers.epoch + nextTick * TIMER_TICK, hasWork);
+            }
+
+            // Outstanding work is drained before a stopping worker exits
+            if (runQueue.empty()) {
+                if (isStopping) return;
+                continue;
+            }
+
+            table = runQueue.front();
+            runQueue.pop_front();
+        }
+        runTable(table);
+    }
+}
+
+void TableScheduler::runTimers(WorkerTimers& timers) {
+    // Catch the wheel up with the clock first, so new timers are measured from now
+    uint64_t nowTick = (chrono::steady_clock::now() - timers.epoch) / TIMER_TICK;
+    if (nowTick > timers.wheel.getCurrentTick()) {
+        vector<uint64_t> expired;
+        timers.wheel.advance(nowTick - timers.wheel.getCurrentTick(), expired);
+        for (uint64_t requestId : expired) {
+            auto it = timers.armedTimers.find(requestId);
+            if (it == timers.armedTimers.end()) continue;
+
+            post(*it->second.table, std::move(it->second.command));
+            timers.armedTimers.erase(it);
+            numArmedTimers--;
+        }
+    }
+
+    TimerRequest request;
+    while (timers.requests.pop(request)) {
+        if (request.isCancel) {
+            auto it = timers.armedTimers.find(request.requestId);
+            if (it == timers.armedTimers.end()) continue; // Already fired
+
+            timers.wheel.cancel(it->second.timerId);
+            timers.armedTimers.erase(it);
+            numArmedTimers--;
+            continue;
+        }
+
+        TimerId timerId = timers.wheel.schedule(request.delayTicks, request.requestId);
+        timers.armedTimers[request.requestId] = ArmedTimer{timerId, request.table, std::move(request.command)};
+        numArmedTimers++;
+    }
+}
+
+void TableScheduler::requestTimer(TableActor& table, TimerRequest request) {
+    WorkerTimers& timers = *workerTimers[table.timerShard];
+    timers.requests.push(std::move(request));
+
+    // A worker with a timer already armed wakes every tick and will see the request,
+    // a parked one has to be woken
+    atomic_thread_fence(memory_order_seq_cst);
+    if (timers.isParked) {
+        { lock_guard<mutex> lock(runQueueMutex); }
+        runQueueCv.notify_all();
+    }
+}
+
+void TableScheduler::runTable(TableActor* table) {
+    TableCommand command;
+    size_t numHandled = 0;
+
+    while (numHandled < batchSize && table->inbox.pop(command)) {
+        try {
+            table->handleCommand(command);
+        } catch (const exception& e) {
+            // A bad command must not take the worker (and every other table) down with it
+            cerr << "Error: Table failed to handle a command: " << e.what() << endl;
+        }
+        numHandled++;
+    }
+
+    // The inbox must not be touched once the count can reach zero, as a producer may then
+    // schedule the table on another worker. Commands still pending (posted after the last
+    // pop, or pushed but not linked yet) keep the table scheduled, so it goes back in the queue.
+    if (table->numPending.fetch_sub(numHandled) != numHandled) enqueueTable(table);
+    finishTable();
+}
@@ -0,0 +1,406 @@
+#include "../include/TableSnapshot.h"
+#include "../include/FileUtils.h"
+#include <algorithm>
+
+namespace {
+    const uint8_t NO_PLAYER = 0xFF;
+    const uint8_t NUM_CARDS = 52;
+    const size_t SNAPSHOT_HEADER_SIZE = 5;
+    const size_t SNAPSHOT_CRC_SIZE = 4;
+
+    // Controller flags
+    const uint8_t SNAPSHOT_ROUND_ACTIVE = 0x01;
+    const uint8_t SNAPSHOT_STREET_ACTIVE = 0x02;
+    const uint8_t SNAPSHOT_DECISION_PENDING = 0x04;
+    const uint8_t SNAPSHOT_DECK_SHUFFLED = 0x08;
+
+    // Street state flags
+    const uint8_t SNAPSHOT_BIG_BLIND_PRE_FLOP = 0x01;
+    const uint8_t SNAPSHOT_CAN_RAISE = 0x02;
+
+    shared_ptr<Action> createAction(ActionType type, const shared_ptr<Player>& player, size_t amount) {
+        switch (type) {
+            case CHECK: return make_shared<CheckAction>(player);
+            case BET: return make_shared<BetAction>(player, amount);
+            case CALL: return make_shared<CallAction>(player, amount);
+            case RAISE: return make_shared<RaiseAction>(player, amount);
+            case FOLD: return make_shared<FoldAction>(player);
+            case BLIND: return make_shared<BlindAction>(player, amount);
+            case ALL_IN_BET: return make_shared<AllInBetAction>(player, amount);
+            case ALL_IN_CALL: return make_shared<AllInCallAction>(player, amount);
+            default: return nullptr;
+        }
+    }
+
+    void saveCards(WireWriter& writer, const vector<Card>& cards) {
+        writer.putU8(static_cast<uint8_t>(cards.size()));
+        for (const Card& card : cards) writer.putU8(WireCodec::encodeCard(card));
+    }
+}
+
+// Save
+
+size_t TableSnapshot::save(const GameController& game, uint8_t* buffer, size_t capacity) {
+    const vector<shared_ptr<Player>>& players = game.gamePlayers.getGamePlayers();
+    if (players.size() > MAX_NUM_PLAYERS || game.actionManager.actionTimeline.size() > UINT16_MAX) return 0;
+    for (const auto& player : players) {
+        // Names are read from the client without a limit, refuse rather than truncate
+        if (player->getName().size() > UINT8_MAX) return 0;
+    }
+
+    WireWriter writer(buffer, capacity);
+    writer.putU32(TABLE_SNAPSHOT_MAGIC);
+    writer.putU8(TABLE_SNAPSHOT_VERSION);
+
+    saveController(writer, game);
+    savePlayers(writer, players);
+    saveDeck(writer, game.deck);
+    saveCards(writer, game.board.communityCards);
+    saveTurnManager(writer, game.turnManager, players);
+    saveActionManager(writer, game.actionManager, players);
+    savePotManager(writer, game.potManager, players);
+    saveStreetState(writer, game.streetState, players);
+
+    size_t recordSize = writer.getSize();
+    writer.putU16(0);
+    if (!HandRecordCodec::encode(game.handRecord, writer)) return 0;
+    writer.patchU16(recordSize, static_cast<uint16_t>(writer.getSize() - recordSize - 2));
+
+    if (writer.isOverflow()) return 0;
+    writer.putU32(computeCrc32(buffer, writer.getSize()));
+    return writer.isOverflow() ? 0 : writer.getSize();
+}
+
+void TableSnapshot::savePlayerIndex(WireWriter& writer, const vector<shared_ptr<Player>>& players,
+                                    const shared_ptr<Player>& player) {
+    for (size_t i = 0; i < players.size(); ++i) {
+        if (players[i] == player) {
+            writer.putU8(static_cast<uint8_t>(i));
+            return;
+        }
+    }
+    writer.putU8(NO_PLAYER);
+}
+
+void TableSnapshot::saveController(WireWriter& writer, const GameController& game) {
+    writer.putU64(game.smallBlind);
+    writer.putU64(game.bigBlind);
+    writer.putU32(game.tableId);
+    writer.putU32(static_cast<uint32_t>(game.roundNum));
+    writer.putU8(static_cast<uint8_t>(game.curStreet));
+
+    uint8_t flags = 0;
+    if (game.isRoundActive) flags |= SNAPSHOT_ROUND_ACTIVE;
+    if (game.isStreetActive) flags |= SNAPSHOT_STREET_ACTIVE;
+    if (game.isDecisionPending) flags |= SNAPSHOT_DECISION_PENDING;
+    writer.putU8(flags);
+
+    writer.putU8(static_cast<uint8_t>(game.possibleActions.size()));
+    for (const PossibleAction& action : game.possibleActions) {
+        writer.putU8(static_cast<uint8_t>(action.type));
+        writer.putU64(action.amount);
+    }
+}
+
+void TableSnapshot::savePlayers(WireWriter& writer, const vector<shared_ptr<Player>>& players) {
+    writer.putU8(static_cast<uint8_t>(players.size()));
+    for (const auto& player : players) {
+        string name = player->getName();
+        writer.putU8(static_cast<uint8_t>(name.size()));
+        writer.putBytes(name.data(), name.size());
+        writer.putU8(static_cast<uint8_t>(player->getPosition()));
+        writer.putU64(player->getChips());
+        saveCards(writer, player->getHand());
+    }
+}
+
+void TableSnapshot::saveDeck(WireWriter& writer, const Deck& deck) {
+    writer.putU64(deck.seed);
+    writer.putU64(deck.numShuffles);
+    writer.putU8(static_cast<uint8_t>(deck.deckIndex));
+    writer.putU8(deck.isShuffled ? SNAPSHOT_DECK_SHUFFLED : 0);
+    for (const Card& card : deck.deck) writer.putU8(WireCodec::encodeCard(card));
+}
+
+void TableSnapshot::saveTurnManager(WireWriter& writer, const TurnManager& turnManager,
+                                    const vector<shared_ptr<Player>>& players) {
+    writer.putU8(static_cast<uint8_t>(turnManager.playersInHand.size()));
+    for (const auto& player : turnManager.playersInHand) savePlayerIndex(writer, players, player);
+    writer.putU8(static_cast<uint8_t>(turnManager.playersNotInHand.size()));
+    for (const auto& player : turnManager.playersNotInHand) savePlayerIndex(writer, players, player);
+    savePlayerIndex(writer, players, turnManager.playerWithButton);
+    savePlayerIndex(writer, players, turnManager.playerToAct);
+    writer.putU64(turnManager.bigStackChipCount);
+}
+
+void TableSnapshot::saveActionManager(WireWriter& writer, const ActionManager& actionManager,
+                                      const vector<shared_ptr<Player>>& players) {
+    writer.putU16(static_cast<uint16_t>(actionManager.actionTimeline.size()));
+    for (const auto& action : actionManager.actionTimeline) {
+        savePlayerIndex(writer, players, action->getPlayer());
+        writer.putU8(static_cast<uint8_t>(action->getActionType()));
+        writer.putU64(action->getAmount());
+    }
+
+    const ActionState& state = actionManager.actionState;
+    for (int count : {state.numCalls, state.numChecks, state.numFolded, state.numAllInBet,
+                      state.numAllInCall, state.numSittingOut}) {
+        writer.putU32(static_cast<uint32_t>(count));
+    }
+    writer.putU8(state.limpAround);
+    writer.putU64(actionManager.activeBet);
+}
+
+void TableSnapshot::savePotManager(WireWriter& writer, const PotManager& potManager,
+                                   const vector<shared_ptr<Player>>& players) {
+    writer.putU8(static_cast<uint8_t>(potManager.pots.size()));
+    for (const Pot& pot : potManager.pots) {
+        writer.putU64(pot.chips);
+        // Like the bets, eligible players come from the address ordered map, so they are written in player order
+        uint8_t eligible[MAX_NUM_PLAYERS];
+        uint8_t numEligible = 0;
+        for (size_t i = 0; i < players.size(); ++i) {
+            if (find(pot.eligiblePlayers.begin(), pot.eligiblePlayers.end(), players[i]) != pot.eligiblePlayers.end()) {
+                eligible[numEligible++] = static_cast<uint8_t>(i);
+            }
+        }
+        writer.putU8(numEligible);
+        writer.putBytes(eligible, numEligible);
+    }
+
+    // The map is ordered by address, so bets are written in player order to keep snapshots stable
+    uint8_t numBets = 0;
+    for (const auto& player : players) numBets += potManager.playerBets.count(player);
+    writer.putU8(numBets);
+    for (size_t i = 0; i < players.size(); ++i) {
+        auto bet = potManager.playerBets.find(players[i]);
+        if (bet == potManager.playerBets.end()) continue;
+        writer.putU8(static_cast<uint8_t>(i));
+        writer.putU64(bet->second.betSize);
+        writer.putU8(bet->second.isAllIn);
+    }
+    writer.putU64(potManager.deadChips);
+}
+
+void TableSnapshot::saveStreetState(WireWriter& writer, const StreetState& streetState,
+                                    const vector<shared_ptr<Player>>& players) {
+    writer.putU8(static_cast<uint8_t>(streetState.street));
+    writer.putU8(static_cast<uint8_t>(streetState.initialNumPlayersInHand));
+    savePlayerIndex(writer, players, streetState.curPlayer);
+
+    uint8_t flags = 0;
+    if (streetState.isBigBlindPreFlop) flags |= SNAPSHOT_BIG_BLIND_PRE_FLOP;
+    if (streetState.playerCanRaise) flags |= SNAPSHOT_CAN_RAISE;
+    writer.putU8(flags);
+
+    writer.putU64(streetState.activeBet);
+    writer.putU64(streetState.playerInitialChips);
+    writer.putU64(streetState.bigStackAmongOthers);
+}
+
+// Restore
+
+bool TableSnapshot::restore(GameController& game, const uint8_t* data, size_t size) {
+    if (size < SNAPSHOT_HEADER_SIZE + SNAPSHOT_CRC_SIZE) return false;
+    size_t bodySize = size - SNAPSHOT_CRC_SIZE;
+    WireReader crcReader(data + bodySize, SNAPSHOT_CRC_SIZE);
+    if (crcReader.getU32() != computeCrc32(data, bodySize)) return false;
+
+    WireReader reader(data, bodySize);
+    if (reader.getU32() != TABLE_SNAPSHOT_MAGIC || reader.getU8() != TABLE_SNAPSHOT_VERSION) return false;
+
+    if (!restoreController(reader, game)) return false;
+    if (!restorePlayers(reader, game.gamePlayers)) return false;
+    const vector<shared_ptr<Player>>& players = game.gamePlayers.gamePlayers;
+
+    if (!restoreDeck(reader, game.deck)) return false;
+    uint8_t numBoardCards = reader.getU8();
+    if (numBoardCards > 5) return false;
+    game.board.communityCards.clear();
+    for (uint8_t i = 0; i < numBoardCards; ++i) {
+        Card card;
+        if (!restoreCard(reader, card)) return false;
+        game.board.communityCards.push_back(card);
+    }
+
+    if (!restoreTurnManager(reader, game.turnManager, players)) return false;
+    if (!restoreActionManager(reader, game.actionManager, players)) return false;
+    if (!restorePotManager(reader, game.potManager, players)) return false;
+    if (!restoreStreetState(reader, game.streetState, players)) return false;
+
+    uint16_t recordSize = reader.getU16();
+    const uint8_t* record = reader.getBytes(recordSize);
+    if (record == nullptr || reader.getRemaining() != 0) return false;
+    if (!HandRecordCodec::decode(record, recordSize, game.handRecord)) return false;
+
+    // Hands are evaluated from the players' cards when the pots are awarded
+    game.handEvaluator.clearHandEvaluator();
+    return !reader.isUnderflow();
+}
+
+bool TableSnapshot::restorePlayerIndex(WireReader& reader, const vector<shared_ptr<Player>>& players,
+                                       shared_ptr<Player>& player) {
+    uint8_t index = reader.getU8();
+    if (index == NO_PLAYER) {
+        player = nullptr;
+        return !reader.isUnderflow();
+    }
+    if (index >= players.size()) return false;
+    player = players[index];
+    return true;
+}
+
+bool TableSnapshot::restoreCard(WireReader& reader, Card& card) {
+    uint8_t index = reader.getU8();
+    if (index >= NUM_CARDS) return false;
+    card = WireCodec::decodeCard(index);
+    return true;
+}
+
+bool TableSnapshot::restoreController(WireReader& reader, GameController& game) {
+    if (reader.getU64() != game.smallBlind || reader.getU64() != game.bigBlind) return false;
+    game.tableId = reader.getU32();
+    game.roundNum = static_cast<int>(reader.getU32());
+
+    uint8_t street = reader.getU8();
+    if (street > SHOWDOWN) return false;
+    game.curStreet = static_cast<Street>(street);
+
+    uint8_t flags = reader.getU8();
+    game.isRoundActive = flags & SNAPSHOT_ROUND_ACTIVE;
+    game.isStreetActive = flags & SNAPSHOT_STREET_ACTIVE;
+    game.isDecisionPending = flags & SNAPSHOT_DECISION_PENDING;
+
+    uint8_t numActions = reader.getU8();
+    game.possibleActions.clear();
+    for (uint8_t i = 0; i < numActions; ++i) {
+        uint8_t type = reader.getU8();
+        if (type >= INVALID_ACTION) return false;
+        game.possibleActions.push_back(PossibleAction{static_cast<ActionType>(type), reader.getU64()});
+    }
+    return !reader.isUnderflow();
+}
+
+bool TableSnapshot::restorePlayers(WireReader& reader, GamePlayers& gamePlayers) {
+    uint8_t numPlayers = reader.getU8();
+    if (numPlayers > MAX_NUM_PLAYERS) return false;
+
+    gamePlayers.gamePlayers.clear();
+    for (uint8_t i = 0; i < numPlayers; ++i) {
+        uint8_t nameSize = reader.getU8();
+        const uint8_t* name = reader.getBytes(nameSize);
+        uint8_t position = reader.getU8();
+        size_t chips = reader.getU64();
+        uint8_t numCards = reader.getU8();
+        if (name == nullptr || position >= NUM_POSITIONS || numCards > 2) return false;
+
+        auto player = make_shared<Player>(string(reinterpret_cast<const char*>(name), nameSize),
+                                          static_cast<Position>(position), chips);
+        for (uint8_t j = 0; j < numCards; ++j) {
+            Card card;
+            if (!restoreCard(reader, card)) return false;
+            player->addHoleCard(card);
+        }
+        gamePlayers.gamePlayers.push_back(player);
+    }
+    return !reader.isUnderflow();
+}
+
+bool TableSnapshot::restoreDeck(WireReader& reader, Deck& deck) {
+    deck.seed = reader.getU64();
+    deck.numShuffles = reader.getU64();
+    deck.deckIndex = reader.getU8();
+    deck.isShuffled = reader.getU8() & SNAPSHOT_DECK_SHUFFLED;
+    if (deck.deckIndex > DECK_SIZE) return false;
+    for (Card& card : deck.deck) {
+        if (!restoreCard(reader, card)) return false;
+    }
+    return true;
+}
+
+bool TableSnapshot::restoreTurnManager(WireReader& reader, TurnManager& turnManager,
+                                       const vector<shared_ptr<Player>>& players) {
+    for (vector<shared_ptr<Player>>* list : {&turnManager.playersInHand, &turnManager.playersNotInHand}) {
+        uint8_t numPlayers = reader.getU8();
+        if (numPlayers > players.size()) return false;
+        list->assign(numPlayers, nullptr);
+        for (auto& player : *list) {
+            if (!restorePlayerIndex(reader, players, player) || player == nullptr) return false;
+        }
+    }
+    if (!restorePlayerIndex(reader, players, turnManager.playerWithButton)) return false;
+    if (!restorePlayerIndex(reader, players, turnManager.playerToAct)) return false;
+    turnManager.bigStackChipCount = reader.getU64();
+    return !reader.isUnderflow();
+}
+
+bool TableSnapshot::restoreActionManager(WireReader& reader, ActionManager& actionManager,
+                                         const vector<shared_ptr<Player>>& players) {
+    uint16_t numActions = reader.getU16();
+    actionManager.actionTimeline.clear();
+    actionManager.actionTimeline.reserve(numActions);
+    for (uint16_t i = 0; i < numActions; ++i) {
+        shared_ptr<Player> player;
+        if (!restorePlayerIndex(reader, players, player) || player == nullptr) return false;
+        uint8_t type = reader.getU8();
+        shared_ptr<Action> action = createAction(static_cast<ActionType>(type), player, reader.getU64());
+        if (action == nullptr) return false;
+        actionManager.actionTimeline.push_back(action);
+    }
+
+    ActionState& state = actionManager.actionState;
+    for (int* count : {&state.numCalls, &state.numChecks, &state.numFolded, &state.numAllInBet,
+                       &state.numAllInCall, &state.numSittingOut}) {
+        *count = static_cast<int>(reader.getU32());
+    }
+    state.limpAround = reader.getU8();
+    actionManager.activeBet = reader.getU64();
+    return !reader.isUnderflow();
+}
+
+bool TableSnapshot::restorePotManager(WireReader& reader, PotManager& potManager,
+                                      const vector<shared_ptr<Player>>& players) {
+    uint8_t numPots = reader.getU8();
+    potManager.pots.assign(numPots, Pot());
+    for (Pot& pot : potManager.pots) {
+        pot.chips = reader.getU64();
+        uint8_t numEligible = reader.getU8();
+        if (numEligible > players.size()) return false;
+        pot.eligiblePlayers.assign(numEligible, nullptr);
+        for (auto& player : pot.eligiblePlayers) {
+            if (!restorePlayerIndex(reader, players, player) || player == nullptr) return false;
+        }
+    }
+
+    uint8_t numBets = reader.getU8();
+    if (numBets > players.size()) return false;
+    potManager.playerBets.clear();
+    for (uint8_t i = 0; i < numBets; ++i) {
+        shared_ptr<Player> player;
+        if (!restorePlayerIndex(reader, players, player) || player == nullptr) return false;
+        size_t betSize = reader.getU64();
+        bool isAllIn = reader.getU8();
+        potManager.playerBets[player] = BetInfo{betSize, isAllIn};
+    }
+    potManager.deadChips = reader.getU64();
+    return !reader.isUnderflow();
+}
+
+bool TableSnapshot::restoreStreetState(WireReader& reader, StreetState& streetState,
+                                       const vector<shared_ptr<Player>>& players) {
+    uint8_t street = reader.getU8();
+    if (street > SHOWDOWN) return false;
+    streetState.street = static_cast<Street>(street);
+    streetState.initialNumPlayersInHand = reader.getU8();
+    if (!restorePlayerIndex(reader, players, streetState.curPlayer)) return false;
+
+    uint8_t flags = reader.getU8();
+    streetState.isBigBlindPreFlop = flags & SNAPSHOT_BIG_BLIND_PRE_FLOP;
+    streetState.playerCanRaise = flags & SNAPSHOT_CAN_RAISE;
+    streetState.playerAction = nullptr;
+
+    streetState.activeBet = reader.getU64();
+    streetState.playerInitialChips = reader.getU64();
+    streetState.bigStackAmongOthers = reader.getU64();
+    return !reader.isUnderflow();
+}
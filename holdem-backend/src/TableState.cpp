@@ -0,0 +1,357 @@
+#include "../include/TableState.h"
+#include <algorithm>
+
+namespace {
+    void putSeat(WireWriter& writer, uint8_t index, const SeatState& seat) {
+        writer.putU8(index);
+        writer.putU8(seat.position);
+        writer.putU32(seat.chips);
+        writer.putU8(seat.nameLength);
+        writer.putBytes(seat.name.data(), seat.nameLength);
+    }
+
+    bool getSeat(WireReader& reader, SeatState& seat) {
+        seat.isOccupied = true;
+        seat.position = reader.getU8();
+        seat.chips = reader.getU32();
+        seat.nameLength = reader.getU8();
+        const uint8_t* name = reader.getBytes(seat.nameLength);
+        if (name == nullptr || seat.nameLength > MAX_PLAYER_NAME) return false;
+        memcpy(seat.name.data(), name, seat.nameLength);
+        return true;
+    }
+}
+
+bool SeatState::operator==(const SeatState& other) const {
+    return isOccupied == other.isOccupied && position == other.position && chips == other.chips &&
+           getName() == other.getName();
+}
+
+// TableState
+
+void TableState::capture(const GameController& game, uint32_t hand) {
+    handNumber = hand;
+
+    bool isAwaiting = game.isAwaitingAction();
+    street = isAwaiting ? static_cast<uint8_t>(game.getStreetState().getStreet()) : NO_STREET;
+    toAct = isAwaiting ? static_cast<uint8_t>(game.getStreetState().getCurPlayer()->getPosition()) : NO_POSITION;
+
+    // Players who were already seated stay put, so a new hand only moves positions
+    const vector<shared_ptr<Player>>& players = game.getGamePlayers();
+    array<bool, NUM_POSITIONS> isTaken{};
+    vector<int> playerSeats(players.size(), -1);
+    for (size_t i = 0; i < players.size(); ++i) {
+        const string& name = players[i]->getName();
+        string_view seatedName(name.data(), min(name.size(), MAX_PLAYER_NAME));
+        for (int index = 0; index < NUM_POSITIONS; ++index) {
+            if (isTaken[index] || !seats[index].isOccupied || seats[index].getName() != seatedName) continue;
+            isTaken[index] = true;
+            playerSeats[i] = index;
+            break;
+        }
+    }
+    for (size_t i = 0; i < players.size(); ++i) {
+        if (playerSeats[i] >= 0) continue;
+        int index = static_cast<int>(find(isTaken.begin(), isTaken.end(), false) - isTaken.begin());
+        if (index == NUM_POSITIONS) break;
+        isTaken[index] = true;
+        playerSeats[i] = index;
+    }
+
+    for (size_t i = 0; i < players.size(); ++i) {
+        if (playerSeats[i] < 0) continue;
+        SeatState& seat = seats[playerSeats[i]];
+        const string& name = players[i]->getName();
+        seat.isOccupied = true;
+        seat.position = static_cast<uint8_t>(players[i]->getPosition());
+        seat.chips = static_cast<uint32_t>(players[i]->getChips());
+        seat.nameLength = static_cast<uint8_t>(min(name.size(), MAX_PLAYER_NAME));
+        memcpy(seat.name.data(), name.data(), seat.nameLength);
+    }
+    for (int index = 0; index < NUM_POSITIONS; ++index) {
+        if (!isTaken[index]) seats[index] = SeatState();
+    }
+
+    const vector<Card>& cards = game.getBoard().getCommunityCards();
+    numBoardCards = static_cast<uint8_t>(min(cards.size(), board.size()));
+    for (uint8_t i = 0; i < numBoardCards; ++i) board[i] = WireCodec::encodeCard(cards[i]);
+
+    const PotManager& potManager = game.getPotManager();
+    numPots = static_cast<uint8_t>(min(static_cast<size_t>(potManager.getNumPots()), pots.size()));
+    for (uint8_t i = 0; i < numPots; ++i) {
+        const Pot& pot = potManager.getPot(i);
+        pots[i].chips = static_cast<uint32_t>(pot.getChips());
+        pots[i].eligiblePositions = 0;
+        for (const auto& player : pot.getEligiblePlayers()) {
+            pots[i].eligiblePositions |= static_cast<uint16_t>(1u << static_cast<int>(player->getPosition()));
+        }
+    }
+}
+
+const SeatState* TableState::findSeat(uint8_t position) const {
+    for (const SeatState& seat : seats) {
+        if (seat.isOccupied && seat.position == position) return &seat;
+    }
+    return nullptr;
+}
+
+bool TableState::decodeKeyframe(const uint8_t* payload, size_t size) {
+    WireReader reader(payload, size);
+    TableState decoded;
+    reader.getU32();
+    decoded.sequence = reader.getU32();
+    decoded.handNumber = reader.getU32();
+    decoded.street = reader.getU8();
+    decoded.toAct = reader.getU8();
+
+    uint8_t numSeats = reader.getU8();
+    if (numSeats > decoded.seats.size()) return false;
+    for (uint8_t i = 0; i < numSeats; ++i) {
+        uint8_t index = reader.getU8();
+        if (index >= decoded.seats.size() || !getSeat(reader, decoded.seats[index])) return false;
+    }
+
+    decoded.numBoardCards = reader.getU8();
+    if (decoded.numBoardCards > decoded.board.size()) return false;
+    for (uint8_t i = 0; i < decoded.numBoardCards; ++i) decoded.board[i] = reader.getU8();
+
+    decoded.numPots = reader.getU8();
+    if (decoded.numPots > decoded.pots.size()) return false;
+    for (uint8_t i = 0; i < decoded.numPots; ++i) {
+        decoded.pots[i].chips = reader.getU32();
+        decoded.pots[i].eligiblePositions = reader.getU16();
+    }
+
+    if (reader.isUnderflow()) return false;
+    *this = decoded;
+    return true;
+}
+
+bool TableState::applyDelta(const uint8_t* payload, size_t size) {
+    WireReader reader(payload, size);
+    reader.getU32();
+    uint32_t deltaSequence = reader.getU32();
+    if (reader.isUnderflow() || deltaSequence != sequence + 1) return false;
+
+    // Changes are applied to a copy so a malformed delta leaves this state untouched
+    TableState updated = *this;
+    uint16_t numChanges = reader.getU16();
+    for (uint16_t i = 0; i < numChanges && !reader.isUnderflow(); ++i) {
+        switch (reader.getU8()) {
+            case CHANGE_HAND:
+                updated.handNumber = reader.getU32();
+                break;
+            case CHANGE_STREET:
+                updated.street = reader.getU8();
+                break;
+            case CHANGE_TO_ACT:
+                updated.toAct = reader.getU8();
+                break;
+            case CHANGE_SEAT: {
+                uint8_t index = reader.getU8();
+                if (index >= updated.seats.size()) return false;
+                updated.seats[index] = SeatState();
+                if (!getSeat(reader, updated.seats[index])) return false;
+                break;
+            }
+            case CHANGE_SEAT_EMPTY: {
+                uint8_t index = reader.getU8();
+                if (index >= updated.seats.size()) return false;
+                updated.seats[index] = SeatState();
+                break;
+            }
+            case CHANGE_STACK: {
+                uint8_t index = reader.getU8();
+                if (index >= updated.seats.size()) return false;
+                updated.seats[index].chips = reader.getU32();
+                break;
+            }
+            case CHANGE_POSITION: {
+                uint8_t index = reader.getU8();
+                if (index >= updated.seats.size()) return false;
+                updated.seats[index].position = reader.getU8();
+                break;
+            }
+            case CHANGE_BOARD: {
+                uint8_t numKept = reader.getU8();
+                uint8_t numNew = reader.getU8();
+                if (numKept > updated.numBoardCards || numKept + numNew > updated.board.size()) return false;
+                for (uint8_t j = 0; j < numNew; ++j) updated.board[numKept + j] = reader.getU8();
+                updated.numBoardCards = numKept + numNew;
+                break;
+            }
+            case CHANGE_POT: {
+                uint8_t index = reader.getU8();
+                if (index >= updated.pots.size()) return false;
+                updated.pots[index].chips = reader.getU32();
+                updated.pots[index].eligiblePositions = reader.getU16();
+                break;
+            }
+            case CHANGE_NUM_POTS:
+                updated.numPots = reader.getU8();
+                if (updated.numPots > updated.pots.size()) return false;
+                break;
+            default:
+                return false;
+        }
+    }
+
+    if (reader.isUnderflow()) return false;
+    updated.sequence = deltaSequence;
+    *this = updated;
+    return true;
+}
+
+bool TableState::isSameState(const TableState& other) const {
+    if (handNumber != other.handNumber || street != other.street || toAct != other.toAct) return false;
+    if (seats != other.seats || numBoardCards != other.numBoardCards || numPots != other.numPots) return false;
+    if (!equal(board.begin(), board.begin() + numBoardCards, other.board.begin())) return false;
+
+    return equal(pots.begin(), pots.begin() + numPots, other.pots.begin(), [](const WirePot& a, const WirePot& b) {
+        return a.chips == b.chips && a.eligiblePositions == b.eligiblePositions;
+    });
+}
+
+// TableStateStream
+
+TableStateStream::TableStateStream(uint32_t tableId, size_t keyframeInterval) :
+    tableId(tableId),
+    keyframeInterval(keyframeInterval),
+    numDeltasSinceKeyframe(0),
+    published() {}
+
+bool TableStateStream::encodeDelta(const TableState& state, WireWriter& writer) {
+    if (state.isSameState(published)) return false;
+
+    size_t frame = beginFrame(writer, MSG_STATE_DELTA);
+    writer.putU32(tableId);
+    writer.putU32(published.sequence + 1);
+    size_t countOffset = writer.getSize();
+    writer.putU16(0);
+    uint16_t numChanges = 0;
+
+    if (state.handNumber != published.handNumber) {
+        writer.putU8(CHANGE_HAND);
+        writer.putU32(state.handNumber);
+        numChanges++;
+    }
+    if (state.street != published.street) {
+        writer.putU8(CHANGE_STREET);
+        writer.putU8(state.street);
+        numChanges++;
+    }
+    if (state.toAct != published.toAct) {
+        writer.putU8(CHANGE_TO_ACT);
+        writer.putU8(state.toAct);
+        numChanges++;
+    }
+
+    for (uint8_t index = 0; index < state.seats.size(); ++index) {
+        const SeatState& seat = state.seats[index];
+        const SeatState& previous = published.seats[index];
+        if (seat == previous) continue;
+
+        if (!seat.isOccupied) {
+            writer.putU8(CHANGE_SEAT_EMPTY);
+            writer.putU8(index);
+            numChanges++;
+        } else if (!previous.isOccupied || seat.getName() != previous.getName()) {
+            writer.putU8(CHANGE_SEAT);
+            putSeat(writer, index, seat);
+            numChanges++;
+        } else {
+            if (seat.chips != previous.chips) {
+                writer.putU8(CHANGE_STACK);
+                writer.putU8(index);
+                writer.putU32(seat.chips);
+                numChanges++;
+            }
+            if (seat.position != previous.position) {
+                writer.putU8(CHANGE_POSITION);
+                writer.putU8(index);
+                writer.putU8(seat.position);
+                numChanges++;
+            }
+        }
+    }
+
+    // Cards are only ever appended within a hand, so send the common prefix length and the new cards
+    uint8_t numKept = 0;
+    while (numKept < min(state.numBoardCards, published.numBoardCards) &&
+           state.board[numKept] == published.board[numKept]) {
+        numKept++;
+    }
+    if (numKept != state.numBoardCards || numKept != published.numBoardCards) {
+        writer.putU8(CHANGE_BOARD);
+        writer.putU8(numKept);
+        writer.putU8(state.numBoardCards - numKept);
+        for (uint8_t i = numKept; i < state.numBoardCards; ++i) writer.putU8(state.board[i]);
+        numChanges++;
+    }
+
+    for (uint8_t i = 0; i < state.numPots; ++i) {
+        const WirePot& pot = state.pots[i];
+        const WirePot& previous = published.pots[i];
+        bool isChanged = i >= published.numPots || pot.chips != previous.chips ||
+                         pot.eligiblePositions != previous.eligiblePositions;
+        if (!isChanged) continue;
+
+        writer.putU8(CHANGE_POT);
+        writer.putU8(i);
+        writer.putU32(pot.chips);
+        writer.putU16(pot.eligiblePositions);
+        numChanges++;
+    }
+    if (state.numPots != published.numPots) {
+        writer.putU8(CHANGE_NUM_POTS);
+        writer.putU8(state.numPots);
+        numChanges++;
+    }
+
+    writer.patchU16(countOffset, numChanges);
+    endFrame(writer, frame);
+
+    uint32_t sequence = published.sequence + 1;
+    published = state;
+    published.sequence = sequence;
+    numDeltasSinceKeyframe++;
+    return true;
+}
+
+void TableStateStream::encodeKeyframe(WireWriter& writer) const {
+    uint8_t numSeats = static_cast<uint8_t>(count_if(published.seats.begin(), published.seats.end(),
+        [](const SeatState& seat) { return seat.isOccupied; }));
+
+    size_t frame = beginFrame(writer, MSG_STATE_KEYFRAME);
+    writer.putU32(tableId);
+    writer.putU32(published.sequence);
+    writer.putU32(published.handNumber);
+    writer.putU8(published.street);
+    writer.putU8(published.toAct);
+
+    writer.putU8(numSeats);
+    for (uint8_t index = 0; index < published.seats.size(); ++index) {
+        if (published.seats[index].isOccupied) putSeat(writer, index, published.seats[index]);
+    }
+
+    writer.putU8(published.numBoardCards);
+    for (uint8_t i = 0; i < published.numBoardCards; ++i) writer.putU8(published.board[i]);
+
+    writer.putU8(published.numPots);
+    for (uint8_t i = 0; i < published.numPots; ++i) {
+        writer.putU32(published.pots[i].chips);
+        writer.putU16(published.pots[i].eligiblePositions);
+    }
+    endFrame(writer, frame);
+}
+
+bool TableStateStream::encodeKeyframeIfDue(WireWriter& writer) {
+    if (numDeltasSinceKeyframe < keyframeInterval) return false;
+    encodeKeyframe(writer);
+    numDeltasSinceKeyframe = 0;
+    return true;
+}
+
+const TableState& TableStateStream::getPublishedState() const {
+    return published;
+}
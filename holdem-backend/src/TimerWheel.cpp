@@ -0,0 +1,132 @@
+#include "../include/TimerWheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel() :
+    nodes(),
+    freeList(NIL),
+    currentTick(0),
+    numTimers(0) {
+    slots.fill(NIL);
+}
+
+TimerId TimerWheel::schedule(uint64_t delayTicks, uint64_t data) {
+    uint32_t index;
+    if (freeList != NIL) {
+        index = freeList;
+        freeList = nodes[index].next;
+    } else {
+        index = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+    }
+
+    TimerNode& node = nodes[index];
+    node.expiryTick = currentTick + clamp<uint64_t>(delayTicks, 1, MAX_TIMER_DELAY);
+    node.data = data;
+    link(index);
+    numTimers++;
+
+    return (static_cast<uint64_t>(node.generation) << 32) | (index + 1);
+}
+
+bool TimerWheel::cancel(TimerId timerId) {
+    if (timerId == INVALID_TIMER) return false;
+
+    uint32_t index = static_cast<uint32_t>(timerId & UINT32_MAX) - 1;
+    uint32_t generation = static_cast<uint32_t>(timerId >> 32);
+    if (index >= nodes.size()) return false;
+
+    TimerNode& node = nodes[index];
+    if (node.generation != generation || node.slot == NIL) return false;
+
+    unlink(index);
+    release(index);
+    return true;
+}
+
+void TimerWheel::advance(uint64_t numTicks, vector<uint64_t>& expired) {
+    // Nothing can fire, so skip straight ahead
+    if (numTimers == 0) {
+        currentTick += numTicks;
+        return;
+    }
+
+    for (uint64_t i = 0; i < numTicks; ++i) {
+        currentTick++;
+
+        // Turning over a level pulls the next slot of the level above down, highest level first
+        // so that timers can fall more than one level in a single tick
+        int topLevel = 0;
+        while (topLevel + 1 < TIMER_WHEEL_LEVELS &&
+               (currentTick & ((1ull << (TIMER_WHEEL_SLOT_BITS * (topLevel + 1))) - 1)) == 0) {
+            topLevel++;
+        }
+        for (int level = topLevel; level >= 1; --level) cascade(level);
+
+        uint32_t& head = slots[currentTick & (TIMER_WHEEL_SLOTS - 1)];
+        while (head != NIL) {
+            uint32_t index = head;
+            expired.push_back(nodes[index].data);
+            unlink(index);
+            release(index);
+        }
+
+        if (numTimers == 0) {
+            currentTick += numTicks - i - 1;
+            return;
+        }
+    }
+}
+
+size_t TimerWheel::size() const {
+    return numTimers;
+}
+
+uint64_t TimerWheel::getCurrentTick() const {
+    return currentTick;
+}
+
+// Helper Functions
+
+void TimerWheel::link(uint32_t index) {
+    TimerNode& node = nodes[index];
+
+    // The level is set by the highest bit in which expiry and now differ
+    uint64_t difference = node.expiryTick ^ currentTick;
+    int level = 0;
+    while (level + 1 < TIMER_WHEEL_LEVELS && (difference >> (TIMER_WHEEL_SLOT_BITS * (level + 1))) != 0) level++;
+
+    uint32_t slotInLevel = (node.expiryTick >> (TIMER_WHEEL_SLOT_BITS * level)) & (TIMER_WHEEL_SLOTS - 1);
+    node.slot = level * TIMER_WHEEL_SLOTS + slotInLevel;
+    node.prev = NIL;
+    node.next = slots[node.slot];
+    if (node.next != NIL) nodes[node.next].prev = index;
+    slots[node.slot] = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    TimerNode& node = nodes[index];
+    if (node.prev != NIL) nodes[node.prev].next = node.next;
+    else slots[node.slot] = node.next;
+    if (node.next != NIL) nodes[node.next].prev = node.prev;
+    node.slot = NIL;
+}
+
+void TimerWheel::release(uint32_t index) {
+    TimerNode& node = nodes[index];
+    node.generation++;
+    node.next = freeList;
+    freeList = index;
+    numTimers--;
+}
+
+void TimerWheel::cascade(int level) {
+    uint32_t slotInLevel = (currentTick >> (TIMER_WHEEL_SLOT_BITS * level)) & (TIMER_WHEEL_SLOTS - 1);
+    uint32_t index = slots[level * TIMER_WHEEL_SLOTS + slotInLevel];
+    slots[level * TIMER_WHEEL_SLOTS + slotInLevel] = NIL;
+
+    while (index != NIL) {
+        uint32_t next = nodes[index].next;
+        link(index);
+        index = next;
+    }
+}
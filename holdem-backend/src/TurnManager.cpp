@@ -167,6 +167,11 @@ void TurnManager::sortPlayersInHand() {
 }
 
 void TurnManager::setBlindsAndButton() {
+    if (playersInHand.empty()) {
+        playerWithButton = nullptr;
+        return;
+    }
+
     if (playersInHand.size() >= 2) {
         playersInHand[0]->setPosition(Position::SMALL_BLIND);
         playersInHand[1]->setPosition(Position::BIG_BLIND);
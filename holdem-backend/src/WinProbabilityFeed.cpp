@@ -0,0 +1,154 @@
+#include "../include/WinProbabilityFeed.h"
+
+using Clock = chrono::steady_clock;
+
+namespace {
+    // Coprime with NUM_COMBOS, so stepping by it visits every pair once in a spread out order
+    const int PAIR_STRIDE = 1009;
+}
+
+WinProbabilities::WinProbabilities() : handNumber(0), numBoardCards(0), isExact(true) {}
+
+WinProbabilityFeed::WinProbabilityFeed(chrono::microseconds budget) :
+    budget(budget),
+    handNumber(0),
+    flop(0),
+    positions(),
+    hands(),
+    numHands(0),
+    pairRanks(NUM_COMBOS),
+    isPairRanked(NUM_COMBOS, false),
+    current()
+{}
+
+void WinProbabilityFeed::reset(const vector<shared_ptr<Player>>& players, uint64_t newFlop, uint32_t newHandNumber) {
+    if (players.size() > MAX_EQUITY_HANDS) throw runtime_error("Too many players for win probabilities");
+    handNumber = newHandNumber;
+    flop = newFlop;
+    numHands = 0;
+    for (const auto& player : players) {
+        positions[numHands] = static_cast<uint8_t>(player->getPosition());
+        hands[numHands++] = HandRank::getMask(player->getHand());
+    }
+    fill(isPairRanked.begin(), isPairRanked.end(), false);
+}
+
+void WinProbabilityFeed::rankPair(int pair) {
+    uint64_t board = flop | HandRange::getComboMask(pair);
+    for (int hand = 0; hand < numHands; ++hand) pairRanks[pair][hand] = HandRank::evaluate(hands[hand] | board);
+    isPairRanked[pair] = true;
+}
+
+void WinProbabilityFeed::scorePair(int pair, uint16_t liveHands, WinProbabilities& result) const {
+    uint32_t best = 0;
+    int numWinners = 0;
+    for (int hand = 0; hand < numHands; ++hand) {
+        if (!(liveHands & (1u << hand))) continue;
+        uint32_t rank = pairRanks[pair][hand];
+        if (rank > best) {
+            best = rank;
+            numWinners = 0;
+        }
+        numWinners += (rank == best);
+    }
+
+    EquityResult& tally = result.tally;
+    tally.numBoards++;
+    tally.numRanked++;
+    size_t index = 0;
+    for (int hand = 0; hand < numHands; ++hand) {
+        if (!(liveHands & (1u << hand))) continue;
+        if (pairRanks[pair][hand] == best) {
+            (numWinners == 1 ? tally.wins : tally.ties)[index]++;
+            tally.shares[index] += 1.0 / numWinners;
+        }
+        index++;
+    }
+}
+
+bool WinProbabilityFeed::update(const vector<shared_ptr<Player>>& players, const vector<Card>& board, uint32_t hand) {
+    if (board.size() < 3 || players.size() < 2) {
+        bool isChanged = !current.positions.empty() || current.handNumber != hand;
+        current = WinProbabilities();
+        current.handNumber = hand;
+        current.numBoardCards = static_cast<int>(board.size());
+        return isChanged;
+    }
+
+    uint64_t flopCards = HandRank::getMask(vector<Card>(board.begin(), board.begin() + 3));
+    if (hand != handNumber || flopCards != flop || numHands == 0) reset(players, flopCards, hand);
+
+    // Players still in, as the seats they were ranked in
+    uint16_t liveHands = 0;
+    vector<uint64_t> liveMasks;
+    WinProbabilities result;
+    result.handNumber = hand;
+    result.numBoardCards = static_cast<int>(board.size());
+    for (int seat = 0; seat < numHands; ++seat) {
+        for (const auto& player : players) {
+            if (static_cast<uint8_t>(player->getPosition()) != positions[seat]) continue;
+            liveHands |= static_cast<uint16_t>(1u << seat);
+            liveMasks.push_back(hands[seat]);
+            result.positions.push_back(positions[seat]);
+        }
+    }
+    if (result.numBoardCards == current.numBoardCards && result.positions == current.positions &&
+        hand == current.handNumber) {
+        return false;
+    }
+    result.tally = EquityResult(result.positions.size());
+
+    uint64_t dead = flop;
+    for (int seat = 0; seat < numHands; ++seat) dead |= hands[seat];
+    uint64_t later = HandRank::getMask(board) & ~flop;
+
+    if (later == 0) {
+        Clock::time_point deadline = Clock::now() + budget;
+        int numRankedSinceCheck = 0;
+        bool isOverBudget = false;
+        for (int step = 0; step < NUM_COMBOS; ++step) {
+            int pair = static_cast<int>((static_cast<int64_t>(step) * PAIR_STRIDE) % NUM_COMBOS);
+            if (HandRange::getComboMask(pair) & dead) continue;
+            if (!isPairRanked[pair]) {
+                if (isOverBudget) {
+                    result.isExact = false;
+                    continue;
+                }
+                rankPair(pair);
+                if (++numRankedSinceCheck == WIN_PROBABILITY_CHECK_INTERVAL) {
+                    numRankedSinceCheck = 0;
+                    isOverBudget = Clock::now() >= deadline;
+                }
+            }
+            scorePair(pair, liveHands, result);
+        }
+    } else if (HandRank::countCards(later) == 1) {
+        // Every river with the turn card
+        for (uint64_t river = FULL_DECK_MASK & ~(dead | later); river != 0; river &= river - 1) {
+            int pair = HandRange::getComboIndex(later | (river & -river));
+            if (!isPairRanked[pair]) rankPair(pair);
+            scorePair(pair, liveHands, result);
+        }
+    } else {
+        int pair = HandRange::getComboIndex(later);
+        if (!isPairRanked[pair]) rankPair(pair);
+        scorePair(pair, liveHands, result);
+    }
+
+    // Folded hands are shown on these tables, so they are known not to come
+    if (result.numBoardCards < NUM_BOARD_CARDS && liveMasks.size() >= 2) {
+        uint64_t folded = 0;
+        for (int seat = 0; seat < numHands; ++seat) {
+            if (!(liveHands & (1u << seat))) folded |= hands[seat];
+        }
+        OutsResult outs = Outs::compute(liveMasks, HandRank::getMask(board), folded);
+        result.outs.assign(outs.outs, outs.outs + outs.numHands);
+    }
+
+    current = move(result);
+    return true;
+}
+
+const WinProbabilities& WinProbabilityFeed::getProbabilities() const {
+    return current;
+}
@@ -0,0 +1,279 @@
+#include "../include/WireCodec.h"
+#include <algorithm>
+
+namespace {
+    const uint8_t NUM_CARDS = 52;
+
+    bool isValidCard(uint8_t card) {
+        return card < NUM_CARDS;
+    }
+
+    bool isValidPosition(uint8_t position) {
+        return position < NUM_POSITIONS;
+    }
+}
+
+uint8_t WireCodec::encodeCard(const Card& card) {
+    return static_cast<uint8_t>(static_cast<int>(card.getSuit()) * NUM_VALUES + static_cast<int>(card.getValue()) - 2);
+}
+
+Card WireCodec::decodeCard(uint8_t card) {
+    return Card(static_cast<Suit>(card / NUM_VALUES), static_cast<Value>(card % NUM_VALUES + 2));
+}
+
+// Encoders
+
+void WireCodec::encodeSeats(WireWriter& writer, uint32_t tableId, const vector<shared_ptr<Player>>& players) {
+    size_t frame = beginFrame(writer, MSG_SEATS);
+    writer.putU32(tableId);
+    writer.putU8(static_cast<uint8_t>(players.size()));
+    for (const auto& player : players) {
+        const string& name = player->getName();
+        size_t nameLength = min(name.size(), MAX_PLAYER_NAME);
+        writer.putU8(static_cast<uint8_t>(player->getPosition()));
+        writer.putU32(static_cast<uint32_t>(player->getChips()));
+        writer.putU8(static_cast<uint8_t>(nameLength));
+        writer.putBytes(name.data(), nameLength);
+    }
+    endFrame(writer, frame);
+}
+
+void WireCodec::encodeHoleCards(WireWriter& writer, uint32_t tableId, const Player& player) {
+    const vector<Card>& hand = player.getHand();
+
+    size_t frame = beginFrame(writer, MSG_HOLE_CARDS);
+    writer.putU32(tableId);
+    writer.putU8(static_cast<uint8_t>(player.getPosition()));
+    writer.putU8(static_cast<uint8_t>(hand.size()));
+    for (const Card& card : hand) writer.putU8(encodeCard(card));
+    endFrame(writer, frame);
+}
+
+void WireCodec::encodeBoard(WireWriter& writer, uint32_t tableId, const Board& board) {
+    const vector<Card>& cards = board.getCommunityCards();
+
+    size_t frame = beginFrame(writer, MSG_BOARD);
+    writer.putU32(tableId);
+    writer.putU8(static_cast<uint8_t>(cards.size()));
+    for (const Card& card : cards) writer.putU8(encodeCard(card));
+    endFrame(writer, frame);
+}
+
+void WireCodec::encodePots(WireWriter& writer, uint32_t tableId, const PotManager& potManager) {
+    size_t frame = beginFrame(writer, MSG_POTS);
+    writer.putU32(tableId);
+    writer.putU8(static_cast<uint8_t>(potManager.getNumPots()));
+    for (int i = 0; i < potManager.getNumPots(); ++i) {
+        const Pot& pot = potManager.getPot(i);
+        uint16_t eligiblePositions = 0;
+        for (const auto& player : pot.getEligiblePlayers()) {
+            eligiblePositions |= static_cast<uint16_t>(1u << static_cast<int>(player->getPosition()));
+        }
+        writer.putU32(static_cast<uint32_t>(pot.getChips()));
+        writer.putU16(eligiblePositions);
+    }
+    endFrame(writer, frame);
+}
+
+void WireCodec::encodeActionRequest(WireWriter& writer, uint32_t tableId, const StreetState& streetState,
+                                    const vector<PossibleAction>& possibleActions) {
+    uint8_t flags = 0;
+    if (streetState.getPlayerCanRaise()) flags |= REQUEST_CAN_RAISE;
+    if (streetState.isPlayerBigBlindPreFlop()) flags |= REQUEST_BIG_BLIND_PRE_FLOP;
+
+    size_t frame = beginFrame(writer, MSG_ACTION_REQUEST);
+    writer.putU32(tableId);
+    writer.putU8(static_cast<uint8_t>(streetState.getStreet()));
+    writer.putU8(static_cast<uint8_t>(streetState.getCurPlayer()->getPosition()));
+    writer.putU8(flags);
+    writer.putU32(static_cast<uint32_t>(streetState.getActiveBet()));
+    writer.putU32(static_cast<uint32_t>(streetState.getPlayerInitialChips()));
+    writer.putU32(static_cast<uint32_t>(streetState.getBigStackAmongOthers()));
+    writer.putU8(static_cast<uint8_t>(possibleActions.size()));
+    for (const auto& action : possibleActions) {
+        writer.putU8(static_cast<uint8_t>(action.type));
+        writer.putU32(static_cast<uint32_t>(action.amount));
+    }
+    endFrame(writer, frame);
+}
+
+void WireCodec::encodeActionResult(WireWriter& writer, uint32_t tableId, const ClientAction& action) {
+    size_t frame = beginFrame(writer, MSG_ACTION_RESULT);
+    writer.putU32(tableId);
+    writer.putU8(static_cast<uint8_t>(action.player->getPosition()));
+    writer.putU8(static_cast<uint8_t>(action.type));
+    writer.putU32(static_cast<uint32_t>(action.amount));
+    writer.putU32(static_cast<uint32_t>(action.player->getChips()));
+    endFrame(writer, frame);
+}
+
+void WireCodec::encodeWinProbabilities(WireWriter& writer, uint32_t tableId, const WinProbabilities& probabilities) {
+    const EquityResult& tally = probabilities.tally;
+    size_t frame = beginFrame(writer, MSG_WIN_PROBABILITIES);
+    writer.putU32(tableId);
+    writer.putU32(probabilities.handNumber);
+    writer.putU8(static_cast<uint8_t>(probabilities.numBoardCards));
+    writer.putU8(probabilities.isExact ? 1 : 0);
+    writer.putU8(static_cast<uint8_t>(probabilities.positions.size()));
+    for (size_t i = 0; i < probabilities.positions.size(); ++i) {
+        // Rounded together so a player's win and tie never add up to more than certain
+        uint16_t win = static_cast<uint16_t>(tally.getWinFraction(i) * PROBABILITY_SCALE + 0.5);
+        uint16_t winOrTie = static_cast<uint16_t>((tally.getWinFraction(i) + tally.getTieFraction(i)) * PROBABILITY_SCALE + 0.5);
+        writer.putU8(probabilities.positions[i]);
+        writer.putU16(win);
+        writer.putU16(static_cast<uint16_t>(winOrTie - win));
+        writer.putU64(i < probabilities.outs.size() ? probabilities.outs[i] : 0);
+    }
+    endFrame(writer, frame);
+}
+
+void WireCodec::encodeRunoutEquity(WireWriter& writer, uint32_t tableId, const StreetEquity& equity) {
+    size_t frame = beginFrame(writer, MSG_RUNOUT_EQUITY);
+    writer.putU32(tableId);
+    writer.putU32(static_cast<uint32_t>(equity.handNumber));
+    writer.putU8(static_cast<uint8_t>(equity.street));
+    writer.putU8(equity.isExact ? 1 : 0);
+    writer.putU8(static_cast<uint8_t>(equity.positions.size()));
+    for (size_t i = 0; i < equity.positions.size(); ++i) {
+        writer.putU8(equity.positions[i]);
+        writer.putU16(encodeEquity(i < equity.equities.size() ? equity.equities[i] : 0.0));
+    }
+    endFrame(writer, frame);
+}
+
+uint16_t WireCodec::encodeEquity(double equity) {
+    return static_cast<uint16_t>(min(max(equity, 0.0), 1.0) * PROBABILITY_SCALE + 0.5);
+}
+
+// Decoders
+
+bool WireCodec::decodeSeats(const uint8_t* payload, size_t size, SeatsMessage& message) {
+    WireReader reader(payload, size);
+    message.tableId = reader.getU32();
+    message.numSeats = reader.getU8();
+    if (message.numSeats > message.seats.size()) return false;
+
+    for (uint8_t i = 0; i < message.numSeats; ++i) {
+        WireSeat& seat = message.seats[i];
+        seat.position = reader.getU8();
+        seat.chips = reader.getU32();
+        uint8_t nameLength = reader.getU8();
+        const uint8_t* name = reader.getBytes(nameLength);
+        if (name == nullptr || !isValidPosition(seat.position)) return false;
+        seat.name = string_view(reinterpret_cast<const char*>(name), nameLength);
+    }
+    return !reader.isUnderflow();
+}
+
+bool WireCodec::decodeHoleCards(const uint8_t* payload, size_t size, HoleCardsMessage& message) {
+    WireReader reader(payload, size);
+    message.tableId = reader.getU32();
+    message.position = reader.getU8();
+    message.numCards = reader.getU8();
+    if (message.numCards > message.cards.size() || !isValidPosition(message.position)) return false;
+
+    for (uint8_t i = 0; i < message.numCards; ++i) {
+        message.cards[i] = reader.getU8();
+        if (!isValidCard(message.cards[i])) return false;
+    }
+    return !reader.isUnderflow();
+}
+
+bool WireCodec::decodeBoard(const uint8_t* payload, size_t size, BoardMessage& message) {
+    WireReader reader(payload, size);
+    message.tableId = reader.getU32();
+    message.numCards = reader.getU8();
+    if (message.numCards > message.cards.size()) return false;
+
+    for (uint8_t i = 0; i < message.numCards; ++i) {
+        message.cards[i] = reader.getU8();
+        if (!isValidCard(message.cards[i])) return false;
+    }
+    return !reader.isUnderflow();
+}
+
+bool WireCodec::decodePots(const uint8_t* payload, size_t size, PotsMessage& message) {
+    WireReader reader(payload, size);
+    message.tableId = reader.getU32();
+    message.numPots = reader.getU8();
+    if (message.numPots > message.pots.size()) return false;
+
+    for (uint8_t i = 0; i < message.numPots; ++i) {
+        message.pots[i].chips = reader.getU32();
+        message.pots[i].eligiblePositions = reader.getU16();
+    }
+    return !reader.isUnderflow();
+}
+
+bool WireCodec::decodeActionRequest(const uint8_t* payload, size_t size, ActionRequestMessage& message) {
+    WireReader reader(payload, size);
+    message.tableId = reader.getU32();
+    message.street = reader.getU8();
+    message.position = reader.getU8();
+    message.flags = reader.getU8();
+    message.activeBet = reader.getU32();
+    message.playerInitialChips = reader.getU32();
+    message.bigStackAmongOthers = reader.getU32();
+    message.numActions = reader.getU8();
+    if (message.numActions > message.actions.size() || !isValidPosition(message.position)) return false;
+    if (message.street > SHOWDOWN) return false;
+
+    for (uint8_t i = 0; i < message.numActions; ++i) {
+        message.actions[i].type = reader.getU8();
+        message.actions[i].amount = reader.getU32();
+        if (message.actions[i].type >= INVALID_ACTION) return false;
+    }
+    return !reader.isUnderflow();
+}
+
+bool WireCodec::decodeActionResult(const uint8_t* payload, size_t size, ActionResultMessage& message) {
+    WireReader reader(payload, size);
+    message.tableId = reader.getU32();
+    message.position = reader.getU8();
+    message.type = reader.getU8();
+    message.amount = reader.getU32();
+    message.chips = reader.getU32();
+    if (!isValidPosition(message.position) || message.type >= INVALID_ACTION) return false;
+    return !reader.isUnderflow();
+}
+
+bool WireCodec::decodeWinProbabilities(const uint8_t* payload, size_t size, WinProbabilitiesMessage& message) {
+    WireReader reader(payload, size);
+    message.tableId = reader.getU32();
+    message.handNumber = reader.getU32();
+    message.numBoardCards = reader.getU8();
+    message.isExact = reader.getU8() != 0;
+    message.numPlayers = reader.getU8();
+    if (message.numBoardCards > 5 || message.numPlayers > message.players.size()) return false;
+
+    for (uint8_t i = 0; i < message.numPlayers; ++i) {
+        WireWinProbability& player = message.players[i];
+        player.position = reader.getU8();
+        player.win = reader.getU16();
+        player.tie = reader.getU16();
+        player.outs = reader.getU64();
+        if (!isValidPosition(player.position) || player.win + player.tie > PROBABILITY_SCALE ||
+            (player.outs & ~FULL_DECK_MASK)) {
+            return false;
+        }
+    }
+    return !reader.isUnderflow();
+}
+
+bool WireCodec::decodeRunoutEquity(const uint8_t* payload, size_t size, RunoutEquityMessage& message) {
+    WireReader reader(payload, size);
+    message.tableId = reader.getU32();
+    message.handNumber = reader.getU32();
+    message.street = reader.getU8();
+    message.isExact = reader.getU8() != 0;
+    message.numPlayers = reader.getU8();
+    if (message.street < FLOP || message.street > RIVER || message.numPlayers > message.players.size()) return false;
+
+    for (uint8_t i = 0; i < message.numPlayers; ++i) {
+        WireRunoutEquity& player = message.players[i];
+        player.position = reader.getU8();
+        player.equity = reader.getU16();
+        if (!isValidPosition(player.position) || player.equity > PROBABILITY_SCALE) return false;
+    }
+    return !reader.isUnderflow();
+}
@@ -0,0 +1,415 @@
+#include <gtest/gtest.h>
+#include "../include/ActionLog.h"
+#include "../include/GameTable.h"
+#include <dirent.h>
+#include <fstream>
+#include <sys/stat.h>
+
+class NullOutput : public TableOutput {
+public:
+    void sendToClient(uint64_t clientId, const uint8_t* data, size_t size) override {}
+};
+
+// Keeps every frame a table sends with the client it went to
+class RecordingOutput : public TableOutput {
+public:
+    mutex framesMutex;
+    vector<pair<uint64_t, vector<uint8_t>>> frames;
+
+    void sendToClient(uint64_t clientId, const uint8_t* data, size_t size) override {
+        lock_guard<mutex> lock(framesMutex);
+        frames.emplace_back(clientId, vector<uint8_t>(data, data + size));
+    }
+
+    // Returns the frames of a type sent to a client, errors only when they carry error
+    size_t count(uint64_t clientId, MessageType type, uint8_t error = 0) {
+        lock_guard<mutex> lock(framesMutex);
+        size_t count = 0;
+        for (const auto& [id, frame] : frames) {
+            FrameHeader header;
+            if (id != clientId || !decodeFrameHeader(frame.data(), frame.size(), header) || header.type != type) continue;
+            count += (error == 0 || frame[FRAME_HEADER_SIZE + 4] == error);
+        }
+        return count;
+    }
+};
+
+class ActionLogTest : public ::testing::Test {
+protected:
+    string directory;
+
+    void SetUp() override {
+        // The game narrates every step to stdout
+        cout.setstate(ios_base::badbit);
+
+        char path[] = "/tmp/actionlogXXXXXX";
+        ASSERT_NE(mkdtemp(path), nullptr);
+        directory = path;
+    }
+
+    void TearDown() override {
+        for (const string& segment : listSegments()) unlink(segment.c_str());
+        rmdir(directory.c_str());
+        cout.clear();
+    }
+
+    vector<string> listSegments() const {
+        vector<string> segments;
+        DIR* dir = opendir(directory.c_str());
+        if (dir == nullptr) return segments;
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') segments.push_back(directory + "/" + entry->d_name);
+        }
+        closedir(dir);
+        sort(segments.begin(), segments.end());
+        return segments;
+    }
+
+    ActionLogOptions createOptions() const {
+        ActionLogOptions options;
+        options.directory = directory;
+        return options;
+    }
+
+    // Plays the pending decision: a raise every fifth step, otherwise a call or check
+    static void playDecision(GameController& game, size_t step) {
+        shared_ptr<Player> player = game.getStreetState().getCurPlayer();
+        ClientAction action = ClientAction{player, CHECK, 0};
+        for (const auto& possible : game.getPossibleActions()) {
+            if (possible.type == CALL) action.type = CALL;
+        }
+        ClientAction raise = ClientAction{player, RAISE, 0};
+        for (const auto& possible : game.getPossibleActions()) raise.amount = possible.amount * 3;
+        if (step % 5 == 4 && game.processClientAction(raise)) return;
+        ASSERT_TRUE(game.processClientAction(action));
+    }
+
+    static unique_ptr<GameController> createGame() {
+        auto game = make_unique<GameController>(5, 10);
+        game->setTableId(4);
+        game->setDeckSeed(99);
+        game->addPlayerToGame("alice", 1000);
+        game->addPlayerToGame("bob", 1000);
+        game->addPlayerToGame("carol", 1000);
+        return game;
+    }
+
+    static vector<uint8_t> save(const GameController& game) {
+        vector<uint8_t> buffer(MAX_TABLE_SNAPSHOT_SIZE);
+        buffer.resize(TableSnapshot::save(game, buffer.data(), buffer.size()));
+        return buffer;
+    }
+
+    // Starts a hand and logs the snapshot the way a table does
+    static void beginLoggedRound(GameController& game, ActionLog& log) {
+        ASSERT_TRUE(game.beginRound());
+        vector<uint8_t> snapshot = save(game);
+        uint32_t hand = static_cast<uint32_t>(game.getHandRecord().handNumber);
+        ASSERT_TRUE(log.waitDurable(log.appendSnapshot(game.getHandRecord().tableId, hand, snapshot.data(), snapshot.size())));
+    }
+
+    static TableCommand createJoin(uint64_t clientId, const string& name) {
+        TableCommand command;
+        command.type = JOIN_TABLE;
+        command.clientId = clientId;
+        command.amount = 1000;
+        command.playerName = name;
+        return command;
+    }
+
+    static void join(GameTable& table, uint64_t clientId, const string& name) {
+        table.handleCommand(createJoin(clientId, name));
+    }
+};
+
+TEST_F(ActionLogTest, RecoversFromSnapshotAndLogTail) {
+    unique_ptr<GameController> original = createGame();
+    {
+        ActionLog log(createOptions());
+        original->setActionLog(&log);
+
+        size_t step = 0;
+        for (int hand = 0; hand < 3; ++hand) {
+            beginLoggedRound(*original, log);
+            while (original->isAwaitingAction()) playDecision(*original, step++);
+            original->setupNewRound();
+        }
+
+        // Crash part way through the fourth hand, once the last action is durable
+        beginLoggedRound(*original, log);
+        for (int i = 0; i < 4 && original->isAwaitingAction(); ++i) playDecision(*original, step++);
+        ASSERT_TRUE(log.waitDurable(original->getLogSequence()));
+        original->setActionLog(nullptr);
+    }
+
+    ActionLog log(createOptions());
+    ASSERT_EQ(log.getRecoveredTables().size(), 1);
+    const RecoveredTable& table = log.getRecoveredTables().at(4);
+    ASSERT_EQ(table.handNumber, 4);
+    ASSERT_EQ(table.actions.size(), 4);
+
+    GameController restored(5, 10);
+    ASSERT_TRUE(ActionLog::restoreGame(restored, table));
+    ASSERT_EQ(save(restored), save(*original));
+
+    // Both play on to the same results
+    for (size_t step = 100; step < 160; ++step) {
+        for (GameController* game : {original.get(), &restored}) {
+            if (!game->isRoundInProgress()) {
+                game->setupNewRound();
+                ASSERT_TRUE(game->beginRound());
+            }
+            playDecision(*game, step);
+        }
+    }
+    for (size_t i = 0; i < original->getGamePlayers().size(); ++i) {
+        ASSERT_EQ(restored.getGamePlayers()[i]->getChips(), original->getGamePlayers()[i]->getChips());
+    }
+}
+
+TEST_F(ActionLogTest, TornTailIsDropped) {
+    unique_ptr<GameController> original = createGame();
+    {
+        ActionLog log(createOptions());
+        original->setActionLog(&log);
+        beginLoggedRound(*original, log);
+        for (size_t step = 0; step < 3; ++step) playDecision(*original, step);
+        log.close();
+        original->setActionLog(nullptr);
+    }
+
+    // The last action was half written when the process died
+    string segment = listSegments().back();
+    struct stat info;
+    ASSERT_EQ(stat(segment.c_str(), &info), 0);
+    ASSERT_EQ(truncate(segment.c_str(), info.st_size - 3), 0);
+
+    ActionLog log(createOptions());
+    const RecoveredTable& table = log.getRecoveredTables().at(4);
+    ASSERT_EQ(table.actions.size(), 2);
+
+    GameController restored(5, 10);
+    ASSERT_TRUE(ActionLog::restoreGame(restored, table));
+    ASSERT_TRUE(restored.isAwaitingAction());
+    ASSERT_EQ(restored.getHandRecord().actions.size(), original->getHandRecord().actions.size() - 1);
+
+    // An action that does not apply to the snapshot is refused
+    RecoveredTable wrongPlayer = table;
+    wrongPlayer.actions[0].position = (wrongPlayer.actions[0].position + 1) % 3;
+    GameController diverged(5, 10);
+    ASSERT_FALSE(ActionLog::restoreGame(diverged, wrongPlayer));
+}
+
+TEST_F(ActionLogTest, SegmentsAfterATornTailAreRecovered) {
+    unique_ptr<GameController> original = createGame();
+    {
+        ActionLog log(createOptions());
+        original->setActionLog(&log);
+        beginLoggedRound(*original, log);
+        for (size_t step = 0; step < 3; ++step) playDecision(*original, step);
+        log.close();
+        original->setActionLog(nullptr);
+    }
+    string segment = listSegments().back();
+    struct stat info;
+    ASSERT_EQ(stat(segment.c_str(), &info), 0);
+    ASSERT_EQ(truncate(segment.c_str(), info.st_size - 3), 0);
+
+    // The restart plays on into the next segment
+    {
+        ActionLog log(createOptions());
+        GameController restored(5, 10);
+        ASSERT_TRUE(ActionLog::restoreGame(restored, log.getRecoveredTables().at(4)));
+        restored.setTableId(4);
+        restored.setActionLog(&log);
+        size_t step = 10;
+        while (restored.isAwaitingAction()) playDecision(restored, step++);
+        restored.setupNewRound();
+        beginLoggedRound(restored, log);
+        playDecision(restored, step);
+        ASSERT_TRUE(log.waitDurable(restored.getLogSequence()));
+        log.close();
+        restored.setActionLog(nullptr);
+    }
+    ASSERT_GT(listSegments().size(), 1u);
+
+    ActionLog log(createOptions());
+    const RecoveredTable& table = log.getRecoveredTables().at(4);
+    ASSERT_EQ(table.handNumber, 2);
+    ASSERT_EQ(table.actions.size(), 1);
+}
+
+TEST_F(ActionLogTest, GroupCommitSharesFsyncs) {
+    ActionLogOptions options = createOptions();
+    options.commitDelay = chrono::microseconds(500);
+    ActionLog log(options);
+
+    // Every table waits for each of its actions to be durable before the next
+    const int numTables = 8;
+    const int actionsPerTable = 50;
+    vector<thread> tables;
+    atomic<int> numFailed(0);
+    for (int t = 0; t < numTables; ++t) {
+        tables.emplace_back([&log, &numFailed, t]() {
+            HandAction action;
+            action.type = CALL;
+            for (int i = 0; i < actionsPerTable; ++i) {
+                action.amount = i;
+                if (!log.waitDurable(log.appendAction(t, 1, action))) numFailed++;
+            }
+        });
+    }
+    for (thread& table : tables) table.join();
+
+    ASSERT_EQ(numFailed, 0);
+    ASSERT_EQ(log.getNumAppended(), numTables * actionsPerTable);
+    ASSERT_LT(log.getNumSyncs(), log.getNumAppended() / 2);
+}
+
+TEST_F(ActionLogTest, SegmentsAreDeletedOnceEveryTableMovesOn) {
+    ActionLogOptions options = createOptions();
+    options.segmentSize = 4096;
+    vector<uint8_t> snapshot(1000, 7);
+    HandAction action;
+    action.type = CHECK;
+    {
+        ActionLog log(options);
+        for (uint32_t hand = 1; hand <= 40; ++hand) {
+            log.waitDurable(log.appendSnapshot(1, hand, snapshot.data(), snapshot.size()));
+            log.waitDurable(log.appendAction(1, hand, action));
+
+            // Table 2 only snapshots once, and pins the segment it is in
+            if (hand == 1) log.waitDurable(log.appendSnapshot(2, hand, snapshot.data(), snapshot.size()));
+        }
+        ASSERT_GT(log.getSegmentIndex(), 5);
+        ASSERT_EQ(listSegments().size(), log.getSegmentIndex());
+
+        log.forgetTable(2);
+        for (uint32_t hand = 41; hand <= 50; ++hand) {
+            log.waitDurable(log.appendSnapshot(1, hand, snapshot.data(), snapshot.size()));
+        }
+        ASSERT_LE(listSegments().size(), 2);
+    }
+
+    // Only table 1 is left, at its last hand
+    ActionLog log(options);
+    ASSERT_EQ(log.getRecoveredTables().size(), 1);
+    ASSERT_EQ(log.getRecoveredTables().at(1).handNumber, 50);
+    ASSERT_EQ(log.getRecoveredTables().at(1).snapshot, snapshot);
+}
+
+TEST_F(ActionLogTest, TableIsRebuiltAfterRestart) {
+    NullOutput output;
+    vector<uint8_t> beforeCrash;
+    {
+        ActionLog log(createOptions());
+        GameTable table(6, 5, 10, output);
+        table.setActionLog(&log);
+        join(table, 1, "alice");
+        join(table, 2, "bob");
+
+        // Every decision is called or checked until the second hand is under way
+        const GameController& game = table.getGame();
+        while (game.getHandRecord().handNumber < 2 || game.getHandRecord().actions.size() < 4) {
+            TableCommand command;
+            command.clientId = (game.getStreetState().getCurPlayer()->getName() == "alice") ? 1 : 2;
+            command.action = CHECK;
+            for (const auto& possible : game.getPossibleActions()) {
+                if (possible.type == CALL) command.action = CALL;
+            }
+            table.handleCommand(command);
+        }
+        beforeCrash = save(game);
+    }
+
+    ActionLog log(createOptions());
+    GameTable table(6, 5, 10, output);
+    table.setActionLog(&log);
+    ASSERT_TRUE(table.recover(log.getRecoveredTables().at(6)));
+    ASSERT_EQ(save(table.getGame()), beforeCrash);
+    ASSERT_EQ(table.getNumSeated(), 0);
+
+    // Players take their seats back by name and the hand goes on
+    join(table, 11, "bob");
+    join(table, 12, "alice");
+    ASSERT_EQ(table.getNumSeated(), 2);
+    ASSERT_EQ(table.getGame().getGamePlayers().size(), 2);
+
+    const GameController& game = table.getGame();
+    TableCommand command;
+    command.clientId = (game.getStreetState().getCurPlayer()->getName() == "alice") ? 12 : 11;
+    command.action = CHECK;
+    for (const auto& possible : game.getPossibleActions()) {
+        if (possible.type == CALL) command.action = CALL;
+    }
+    size_t numActions = game.getHandRecord().actions.size();
+    table.handleCommand(command);
+    ASSERT_EQ(game.getHandRecord().actions.size(), numActions + 1);
+}
+
+TEST_F(ActionLogTest, FramesWaitForTheLogWithoutHoldingTheWorker) {
+    ActionLogOptions options = createOptions();
+    options.commitDelay = chrono::milliseconds(1000);
+    ActionLog log(options);
+    RecordingOutput output;
+    TableScheduler scheduler(1);
+    auto table = make_shared<GameTable>(6, 5, 10, output);
+    table->setActionClock(chrono::milliseconds(0), chrono::milliseconds(0));
+    table->setActionLog(&log);
+    scheduler.addTable(table);
+
+    // Bob's seat begins a hand, whose snapshot the writer sits on for a second
+    table->post(createJoin(1, "alice"));
+    table->post(createJoin(2, "bob"));
+    scheduler.waitUntilIdle();
+    ASSERT_TRUE(table->getGame().isRoundInProgress());
+    ASSERT_EQ(output.count(2, MSG_JOINED), 1);
+    ASSERT_EQ(output.count(1, MSG_HAND_STARTED), 0);
+    ASSERT_EQ(output.count(2, MSG_HAND_STARTED), 0);
+
+    // Everything is sent in order once the writer posts that the snapshot is durable
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+    while (output.count(2, MSG_HAND_STARTED) == 0 && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    scheduler.waitUntilIdle();
+    ASSERT_EQ(output.count(1, MSG_HAND_STARTED), 1);
+    ASSERT_EQ(output.count(2, MSG_HAND_STARTED), 1);
+    ASSERT_EQ(output.count(2, MSG_ACTION_REQUEST), 1);
+    scheduler.stop();
+}
+
+TEST_F(ActionLogTest, FailedLogClosesTheTable) {
+    ActionLogOptions options = createOptions();
+    options.segmentSize = 1;
+    ActionLog log(options);
+
+    // Every batch after the first rotates, into a segment that can't be created
+    ofstream(directory + "/" + ActionLog::getSegmentName(log.getSegmentIndex() + 1)) << "taken";
+
+    RecordingOutput output;
+    GameTable table(6, 5, 10, output);
+    table.setActionLog(&log);
+    join(table, 1, "alice");
+    join(table, 2, "bob");
+    ASSERT_EQ(output.count(2, MSG_HAND_STARTED), 1);
+
+    const GameController& game = table.getGame();
+    TableCommand command;
+    command.clientId = (game.getStreetState().getCurPlayer()->getName() == "alice") ? 1 : 2;
+    command.action = CALL;
+    table.handleCommand(command);
+
+    // The call was never durable, so it is never acknowledged
+    for (uint64_t clientId : {1, 2}) {
+        ASSERT_EQ(output.count(clientId, MSG_ACTION_RESULT), 0);
+        ASSERT_EQ(output.count(clientId, MSG_ERROR, ERR_TABLE_CLOSED), 1);
+    }
+
+    command.clientId = 3 - command.clientId;
+    table.handleCommand(command);
+    join(table, 3, "carol");
+    ASSERT_EQ(output.count(command.clientId, MSG_ERROR, ERR_TABLE_CLOSED), 2);
+    ASSERT_EQ(output.count(3, MSG_ERROR, ERR_TABLE_CLOSED), 1);
+    ASSERT_EQ(table.getNumSeated(), 2);
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include "../include/BoardClass.h"
+#include "../include/Board.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <set>
+#include <thread>
+
+class BoardClassTest : public ::testing::Test {
+protected:
+    mt19937_64 rng;
+
+    BoardClassTest() : rng(43) {}
+
+    uint64_t dealCards(int numCards, uint64_t dead = 0) {
+        uint64_t cards = 0;
+        while (HandRank::countCards(cards) < numCards) {
+            uint64_t card = 1ULL << (rng() % 52);
+            if (!(card & dead)) cards |= card;
+        }
+        return cards;
+    }
+
+    static uint64_t permuteSuits(uint64_t cards, const array<int, 4>& suits) {
+        uint64_t permuted = 0;
+        for (int suit = 0; suit < 4; ++suit) {
+            permuted |= ((cards >> (suit * NUM_VALUES)) & 0x1FFF) << (suits[suit] * NUM_VALUES);
+        }
+        return permuted;
+    }
+};
+
+TEST_F(BoardClassTest, CountsClassesOfEachStreet) {
+    ASSERT_EQ(BoardClass::getNumClasses(3), NUM_FLOP_CLASSES);
+    ASSERT_EQ(BoardClass::getNumClasses(4), NUM_TURN_CLASSES);
+    ASSERT_EQ(BoardClass::getNumClasses(5), NUM_RIVER_CLASSES);
+
+    // Every flop lands on a representative of its own class
+    vector<int> boardsPerClass(NUM_FLOP_CLASSES, 0);
+    for (int a = 0; a < 52; ++a) {
+        for (int b = a + 1; b < 52; ++b) {
+            for (int c = b + 1; c < 52; ++c) {
+                uint64_t flop = (1ULL << a) | (1ULL << b) | (1ULL << c);
+                CanonicalBoard canonical = BoardClass::canonicalize(flop);
+                ASSERT_EQ(canonical.cards, BoardClass::getRepresentative(3, canonical.index));
+                ASSERT_EQ(canonical.apply(flop), canonical.cards);
+                ASSERT_EQ(canonical.revert(canonical.cards), flop);
+                boardsPerClass[canonical.index]++;
+            }
+        }
+    }
+    ASSERT_EQ(*min_element(boardsPerClass.begin(), boardsPerClass.end()), 4);
+    ASSERT_EQ(accumulate(boardsPerClass.begin(), boardsPerClass.end(), 0), 22100);
+
+    ASSERT_THROW(BoardClass::getNumClasses(2), runtime_error);
+    ASSERT_THROW(BoardClass::canonicalize(dealCards(6)), runtime_error);
+    ASSERT_THROW(BoardClass::canonicalize(1ULL << 52 | dealCards(3)), runtime_error);
+}
+
+TEST_F(BoardClassTest, SuitPermutationsShareAClass) {
+    array<int, 4> suits = {0, 1, 2, 3};
+    for (int trial = 0; trial < 200; ++trial) {
+        int numCards = 3 + trial % 3;
+        uint64_t board = dealCards(numCards);
+        uint64_t hole = dealCards(2, board);
+        CanonicalBoard canonical = BoardClass::canonicalize(board);
+        ASSERT_EQ(canonical.numCards, numCards);
+
+        shuffle(suits.begin(), suits.end(), rng);
+        uint64_t permutedBoard = permuteSuits(board, suits);
+        uint64_t permutedHole = permuteSuits(hole, suits);
+        CanonicalBoard permuted = BoardClass::canonicalize(permutedBoard);
+        ASSERT_EQ(permuted.index, canonical.index);
+        ASSERT_EQ(permuted.cards, canonical.cards);
+
+        // Hole cards renamed with the board rank the same against the representative
+        ASSERT_EQ(HandRank::evaluate(canonical.apply(hole) | canonical.cards), HandRank::evaluate(hole | board));
+        ASSERT_EQ(HandRank::evaluate(permuted.apply(permutedHole) | permuted.cards), HandRank::evaluate(hole | board));
+    }
+
+    // Straight from the table's board
+    Board board;
+    board.addCommunityCard(Card(Suit::SPADES, Value::ACE));
+    board.addCommunityCard(Card(Suit::DIAMONDS, Value::SEVEN));
+    board.addCommunityCard(Card(Suit::SPADES, Value::TWO));
+    CanonicalBoard canonical = BoardClass::canonicalize(board.getCommunityCards());
+    uint64_t expected = Card(Suit::HEARTS, Value::ACE).getBitMask() | Card(Suit::HEARTS, Value::TWO).getBitMask() |
+                        Card(Suit::DIAMONDS, Value::SEVEN).getBitMask();
+    ASSERT_EQ(canonical.cards, expected);
+    ASSERT_EQ(canonical.suitMap[static_cast<int>(Suit::SPADES)], static_cast<int>(Suit::HEARTS));
+}
+
+TEST_F(BoardClassTest, CacheComputesEachClassOnce) {
+    atomic<int> numCalls(0);
+    BoardClassCache<uint32_t> cache([&numCalls](const CanonicalBoard& board) {
+        numCalls++;
+        return HandRank::evaluate(board.cards);
+    });
+
+    array<int, 4> suits = {0, 1, 2, 3};
+    vector<uint64_t> flops;
+    for (int i = 0; i < 20; ++i) flops.push_back(dealCards(3));
+    for (int permutation = 0; permutation < 24; ++permutation) {
+        for (uint64_t flop : flops) {
+            uint64_t board = permuteSuits(flop, suits);
+            ASSERT_EQ(*cache.get(BoardClass::canonicalize(board)), HandRank::evaluate(board));
+        }
+        next_permutation(suits.begin(), suits.end());
+    }
+
+    set<uint32_t> classes;
+    for (uint64_t flop : flops) classes.insert(BoardClass::canonicalize(flop).index);
+    ASSERT_EQ(cache.size(), classes.size());
+    ASSERT_EQ(numCalls.load(), static_cast<int>(classes.size()));
+
+    // Shared across threads, still one result per class
+    vector<thread> threads;
+    vector<uint64_t> rivers;
+    for (int i = 0; i < 50; ++i) rivers.push_back(dealCards(5));
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, &rivers]() {
+            for (uint64_t river : rivers) cache.get(BoardClass::canonicalize(river));
+        });
+    }
+    for (thread& worker : threads) worker.join();
+    for (uint64_t river : rivers) classes.insert(NUM_FLOP_CLASSES + BoardClass::canonicalize(river).index);
+    ASSERT_EQ(cache.size(), classes.size());
+}
+
+TEST_F(BoardClassTest, BoundedCacheDropsTheLeastRecentlyUsed) {
+    int numCalls = 0;
+    BoardClassCache<uint32_t> cache([&numCalls](const CanonicalBoard& board) {
+        numCalls++;
+        return HandRank::evaluate(board.cards);
+    }, 2);
+
+    vector<CanonicalBoard> rivers;
+    while (rivers.size() < 3) {
+        CanonicalBoard river = BoardClass::canonicalize(dealCards(5));
+        bool isNew = true;
+        for (const CanonicalBoard& other : rivers) isNew &= (other.index != river.index);
+        if (isNew) rivers.push_back(river);
+    }
+
+    shared_ptr<const uint32_t> first = cache.get(rivers[0]);
+    cache.get(rivers[1]);
+    cache.get(rivers[0]);
+    ASSERT_EQ(numCalls, 2);
+
+    // The second class was used least recently, so the third takes its place
+    cache.get(rivers[2]);
+    ASSERT_EQ(cache.size(), 2u);
+    cache.get(rivers[0]);
+    ASSERT_EQ(numCalls, 3);
+    cache.get(rivers[1]);
+    ASSERT_EQ(numCalls, 4);
+    ASSERT_EQ(cache.size(), 2u);
+
+    // Results handed out stay valid once dropped
+    cache.get(rivers[2]);
+    ASSERT_EQ(*first, HandRank::evaluate(rivers[0].cards));
+}
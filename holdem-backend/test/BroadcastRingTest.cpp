@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "../include/BroadcastRing.h"
+#include <thread>
+
+static void publishByte(BroadcastRing& ring, uint8_t value, bool isKeyframe = false) {
+    ring.publish(&value, 1, isKeyframe);
+}
+
+TEST(BroadcastRingTest, SubscribersStartAtLatestKeyframe) {
+    BroadcastRing ring(8);
+    BroadcastCursor early;
+
+    // Nothing to start from until a keyframe is published
+    publishByte(ring, 0);
+    ASSERT_EQ(ring.next(early), nullptr);
+
+    publishByte(ring, 1, true);
+    publishByte(ring, 2);
+    publishByte(ring, 3, true);
+    publishByte(ring, 4);
+
+    BroadcastCursor late;
+    auto frame = ring.next(late);
+    ASSERT_NE(frame, nullptr);
+    ASSERT_TRUE(frame->isKeyframe);
+    ASSERT_EQ(frame->data[0], 3);
+    ASSERT_EQ(ring.next(late)->data[0], 4);
+    ASSERT_EQ(ring.next(late), nullptr);
+
+    publishByte(ring, 5);
+    ASSERT_EQ(ring.next(late)->data[0], 5);
+    ASSERT_EQ(late.numSkips, 0);
+}
+
+TEST(BroadcastRingTest, FramesAreSharedNotCopied) {
+    BroadcastRing ring(4);
+    publishByte(ring, 7, true);
+
+    BroadcastCursor a, b;
+    auto frameA = ring.next(a);
+    auto frameB = ring.next(b);
+    ASSERT_EQ(frameA, frameB);
+
+    // A frame held by a slow writer outlives being overwritten in the ring
+    for (uint8_t i = 0; i < 8; ++i) publishByte(ring, i, i == 7);
+    ASSERT_EQ(frameA.use_count(), 2);
+    ASSERT_EQ(frameA->data[0], 7);
+}
+
+TEST(BroadcastRingTest, SlowSubscriberSkipsToKeyframe) {
+    BroadcastRing ring(8);
+    publishByte(ring, 0, true);
+
+    BroadcastCursor fast, slow;
+    ASSERT_NE(ring.next(fast), nullptr);
+    ASSERT_NE(ring.next(slow), nullptr);
+
+    // The table keeps publishing regardless of the slow subscriber, with a keyframe every 4 frames
+    for (uint8_t i = 1; i <= 20; ++i) {
+        publishByte(ring, i, i % 4 == 0);
+        ASSERT_EQ(ring.next(fast)->data[0], i);
+    }
+
+    // Frame 1 is long gone, so the slow subscriber resumes from keyframe 20
+    auto frame = ring.next(slow);
+    ASSERT_NE(frame, nullptr);
+    ASSERT_TRUE(frame->isKeyframe);
+    ASSERT_EQ(frame->data[0], 20);
+    ASSERT_EQ(slow.numSkips, 1);
+    ASSERT_EQ(ring.next(slow), nullptr);
+    ASSERT_EQ(fast.numSkips, 0);
+}
+
+TEST(BroadcastRingTest, WaitsForKeyframeWhoseDeltasAreRetained) {
+    BroadcastRing ring(4);
+    publishByte(ring, 0, true);
+    for (uint8_t i = 1; i <= 6; ++i) publishByte(ring, i);
+
+    // The keyframe's successors have been overwritten, so it's useless to a new subscriber
+    BroadcastCursor cursor;
+    ASSERT_EQ(ring.next(cursor), nullptr);
+
+    publishByte(ring, 7, true);
+    ASSERT_EQ(ring.next(cursor)->data[0], 7);
+}
+
+TEST(BroadcastRingTest, ConcurrentPublishAndRead) {
+    BroadcastRing ring(64);
+    const int numFrames = 20000;
+    const int keyframeInterval = 16;
+
+    thread producer([&ring]() {
+        for (int i = 0; i < numFrames; ++i) {
+            uint8_t data[4];
+            memcpy(data, &i, sizeof(i));
+            ring.publish(data, sizeof(data), i % keyframeInterval == 0);
+        }
+    });
+
+    // Frames arrive in order, with gaps only where the reader was skipped to a keyframe
+    BroadcastCursor cursor;
+    int lastValue = -1;
+    while (lastValue < numFrames - 1) {
+        auto frame = ring.next(cursor);
+        if (frame == nullptr) {
+            this_thread::yield();
+            continue;
+        }
+        int value;
+        memcpy(&value, frame->data.data(), sizeof(value));
+        ASSERT_GT(value, lastValue);
+        if (value != lastValue + 1) ASSERT_TRUE(frame->isKeyframe);
+        lastValue = value;
+    }
+    producer.join();
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "../include/CardSubset.h"
+#include "../include/HandRange.h"
+#include <random>
+
+// Ranks are usable at compile time, e.g. to size or index static tables
+static_assert(CardSubset::choose(52, 2) == 1326);
+static_assert(CardSubset::choose(52, 7) == 133784560);
+static_assert(CardSubset::getRank((1ULL << 51) | (1ULL << 50) | (1ULL << 49)) == CardSubset::choose(52, 3) - 1);
+static_assert(CardSubset::getMask(CardSubset::getRank(0b1011001), 4) == 0b1011001);
+
+TEST(CardSubsetTest, RanksAreDenseAndInvertible) {
+    // Every two and three card subset, in colex order from the iterator
+    for (int numCards : {0, 1, 2, 3}) {
+        uint64_t expected = 0;
+        for (uint64_t cards : CardSubsets(FULL_DECK_MASK, numCards)) {
+            ASSERT_EQ(HandRank::countCards(cards), numCards);
+            ASSERT_EQ(CardSubset::getRank(cards), expected);
+            ASSERT_EQ(CardSubset::getMask(expected, numCards), cards);
+            expected++;
+        }
+        ASSERT_EQ(expected, CardSubset::choose(52, numCards));
+    }
+
+    // Two card ranks are the HandRange combo indices
+    for (int combo = 0; combo < NUM_COMBOS; ++combo) {
+        ASSERT_EQ(CardSubset::getRank(HandRange::getComboMask(combo)), static_cast<uint64_t>(combo));
+    }
+
+    // Five and seven cards, spread over the whole rank space and at both ends
+    mt19937_64 rng(44);
+    for (int numCards : {5, 7}) {
+        uint64_t numSubsets = CardSubset::choose(52, numCards);
+        ASSERT_EQ(CardSubset::getMask(0, numCards), (1ULL << numCards) - 1);
+        ASSERT_EQ(CardSubset::getMask(numSubsets - 1, numCards), FULL_DECK_MASK & ~((1ULL << (52 - numCards)) - 1));
+        for (int trial = 0; trial < 10000; ++trial) {
+            uint64_t rank = rng() % numSubsets;
+            uint64_t cards = CardSubset::getMask(rank, numCards);
+            ASSERT_EQ(HandRank::countCards(cards), numCards);
+            ASSERT_EQ(cards & ~FULL_DECK_MASK, 0u);
+            ASSERT_EQ(CardSubset::getRank(cards), rank);
+        }
+    }
+
+    ASSERT_THROW(CardSubset::getMask(CardSubset::choose(52, 5), 5), runtime_error);
+    ASSERT_THROW(CardSubset::getMask(0, 8), runtime_error);
+    ASSERT_THROW(CardSubset::getRank(0xFF), runtime_error);
+    ASSERT_THROW(CardSubset::getRank(1ULL << 52), runtime_error);
+}
+
+TEST(CardSubsetTest, EnumeratesTheRemainingDeck) {
+    mt19937_64 rng(45);
+    for (int trial = 0; trial < 20; ++trial) {
+        uint64_t dealt = 0;
+        while (HandRank::countCards(dealt) < 5) dealt |= 1ULL << (rng() % 52);
+
+        for (int numCards = 1; numCards <= 3; ++numCards) {
+            CardSubsets runouts(FULL_DECK_MASK & ~dealt, numCards);
+            uint64_t count = 0;
+            uint64_t previous = 0;
+            for (uint64_t runout : runouts) {
+                ASSERT_EQ(HandRank::countCards(runout), numCards);
+                ASSERT_EQ(runout & dealt, 0u);
+                if (count > 0) ASSERT_GT(CardSubset::getRank(runout), CardSubset::getRank(previous));
+                previous = runout;
+                count++;
+            }
+            ASSERT_EQ(count, CardSubset::choose(47, numCards));
+            ASSERT_EQ(count, runouts.size());
+        }
+    }
+
+    // Too few cards to choose from gives nothing, choosing none gives the empty subset
+    uint64_t count = 0;
+    for (uint64_t cards : CardSubsets(0b111, 4)) count += cards + 1;
+    ASSERT_EQ(count, 0u);
+    for (uint64_t cards : CardSubsets(0b111, 0)) count += cards + 1;
+    ASSERT_EQ(count, 1u);
+    for (uint64_t cards : CardSubsets(0b101, 2)) ASSERT_EQ(cards, 0b101u);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "../include/GameController.h"
+#include <sstream>
+
+class ClientScriptTest : public ::testing::Test {
+protected:
+    ostringstream output;
+    streambuf* consoleBuffer;
+
+    // Captures the narration to check that no prompts are written
+    void SetUp() override {
+        consoleBuffer = cout.rdbuf(output.rdbuf());
+    }
+
+    void TearDown() override {
+        cout.rdbuf(consoleBuffer);
+    }
+
+    static size_t getTotalChips(const GameController& game) {
+        size_t total = 0;
+        for (const auto& player : game.getGamePlayers()) total += player->getChips();
+        return total;
+    }
+
+    static size_t getChips(const GameController& game, const string& name) {
+        for (const auto& player : game.getGamePlayers()) {
+            if (player->getName() == name) return player->getChips();
+        }
+        return 0;
+    }
+};
+
+TEST_F(ClientScriptTest, PlaysScriptedGameWithoutPrompts) {
+    // Heads up: the small blind completes and both check down, then the big blind folds to a raise
+    istringstream script(
+        "y Alice 100   # names are lower cased\n"
+        "y bob 100\n"
+        "n n\n"
+        "call check\n"
+        "check check\n"
+        "check check\n"
+        "check check\n"
+        "n n\n"
+        "raise 6 fold\n");
+
+    GameController game(2, 3);
+    game.setClientScript(script);
+    game.main();
+
+    ASSERT_EQ(game.getGamePlayers().size(), 2);
+    ASSERT_EQ(getTotalChips(game), 200);
+    ASSERT_EQ(game.getHandRecord().handNumber, 2);
+    ASSERT_EQ(game.getHandRecord().actions.back().type, FOLD);
+
+    string narration = output.str();
+    ASSERT_NE(narration.find("Game Over"), string::npos);
+    ASSERT_EQ(narration.find("Please enter"), string::npos);
+    ASSERT_EQ(narration.find("Would you like"), string::npos);
+    ASSERT_EQ(narration.find("Enter player"), string::npos);
+}
+
+TEST_F(ClientScriptTest, ScriptCoversPlayerSetupQueries) {
+    // Carol is removed before the first round. Alice's raise is capped at bob's stack, so
+    // no amount is read. Bob folds his big blind, leaving him short, and tops up.
+    istringstream script(
+        "y alice 50 y bob 4 y carol 100 n\n"
+        "y carol n\n"
+        "raise fold\n"
+        "n n 10\n");
+
+    GameController game(2, 3);
+    game.setClientScript(script);
+    game.main();
+
+    ASSERT_EQ(game.getGamePlayers().size(), 2);
+    ASSERT_EQ(getChips(game, "alice"), 53);
+    ASSERT_EQ(getChips(game, "bob"), 11);
+    ASSERT_EQ(game.getHandRecord().handNumber, 1);
+}
+
+TEST_F(ClientScriptTest, InvalidScriptedInputThrows) {
+    GameController game(2, 3);
+    istringstream badAction("y alice 100 y bob 100 n n dance");
+    game.setClientScript(badAction);
+    ASSERT_THROW(game.main(), runtime_error);
+
+    GameController other(2, 3);
+    istringstream badBet("y alice 100 y bob 100 n n raise 1");
+    other.setClientScript(badBet);
+    ASSERT_THROW(other.main(), runtime_error);
+
+    GameController third(2, 3);
+    istringstream endsMidHand("y alice 100 y bob 100 n n call");
+    third.setClientScript(endsMidHand);
+    ASSERT_THROW(third.main(), runtime_error);
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include "../include/Equity.h"
+#include <random>
+
+class EquityTest : public ::testing::Test {
+protected:
+    shared_ptr<Player> player1;
+    shared_ptr<Player> player2;
+
+    EquityTest() {
+        player1 = make_shared<Player>("P1", Position::SMALL_BLIND, 1000);
+        player2 = make_shared<Player>("P2", Position::BIG_BLIND, 1000);
+    }
+
+    // Counts wins, ties and losses for the first player with the reference HandEvaluator,
+    // dealing the runout cards in increasing bit order from start
+    void enumerateReference(const vector<Card>& board, uint64_t dealt, int start, int numToDeal, array<uint64_t, 3>& counts) {
+        if (numToDeal == 0) {
+            int order = compareReference(evaluateBestFive(player1, board), evaluateBestFive(player2, board));
+            counts[(order > 0) ? 0 : (order == 0) ? 1 : 2]++;
+            return;
+        }
+        for (int bit = start; bit < 52; ++bit) {
+            if (dealt & (1ULL << bit)) continue;
+            vector<Card> next = board;
+            next.emplace_back(static_cast<Suit>(bit / NUM_VALUES), static_cast<Value>(bit % NUM_VALUES + 2));
+            enumerateReference(next, dealt | (1ULL << bit), bit + 1, numToDeal - 1, counts);
+        }
+    }
+
+    // Best reference hand among every five card subset of a player's cards and the board,
+    // since HandEvaluator picks the wrong two pairs when seven cards hold three
+    static PokerHand evaluateBestFive(shared_ptr<Player> player, const vector<Card>& board) {
+        PokerHand best;
+        for (int skipped = 0; skipped < (1 << MAX_HAND_SIZE); ++skipped) {
+            if (__builtin_popcount(skipped) != MAX_HAND_SIZE - MIN_HAND_SIZE) continue;
+            vector<Card> five;
+            for (int i = 0; i < MAX_HAND_SIZE; ++i) {
+                if (skipped & (1 << i)) continue;
+                five.push_back((i < NUM_HOLE_CARDS) ? player->getHand()[i] : board[i - NUM_HOLE_CARDS]);
+            }
+
+            HandEvaluator evaluator;
+            shared_ptr<Player> scratch = make_shared<Player>("scratch", Position::DEALER, 0);
+            evaluator.populatePlayerHandsMap({scratch}, five);
+            evaluator.evaluatePlayerHands();
+            const PokerHand& hand = evaluator.getPlayerHandsMap().at(scratch);
+            if (best.category == NONE || compareReference(hand, best) > 0) best = hand;
+        }
+        return best;
+    }
+
+    static int compareReference(const PokerHand& a, const PokerHand& b) {
+        if (a.category != b.category) return (a.category < b.category) ? -1 : 1;
+        for (size_t i = 0; i < a.bestFiveCards.size(); ++i) {
+            Value valueA = a.bestFiveCards[i].getValue();
+            Value valueB = b.bestFiveCards[i].getValue();
+            if (valueA != valueB) return (valueA < valueB) ? -1 : 1;
+        }
+        return 0;
+    }
+};
+
+TEST_F(EquityTest, FlopMatchesReferenceEnumeration) {
+    vector<Card> first = {Card(Suit::HEARTS, Value::ACE), Card(Suit::HEARTS, Value::FIVE)};
+    vector<Card> second = {Card(Suit::CLUBS, Value::NINE), Card(Suit::SPADES, Value::NINE)};
+    vector<Card> board = {Card(Suit::HEARTS, Value::TWO), Card(Suit::DIAMONDS, Value::THREE), Card(Suit::HEARTS, Value::NINE)};
+    for (const Card& card : first) player1->addHoleCard(card);
+    for (const Card& card : second) player2->addHoleCard(card);
+
+    // Flop and turn boards, the turn one leaving a chopped river possible
+    for (size_t boardSize : {3, 4}) {
+        vector<Card> known(board.begin(), board.begin() + 3);
+        if (boardSize == 4) known.push_back(Card(Suit::CLUBS, Value::FOUR));
+
+        EquityResult result = Equity::computeHeadsUp(first, second, known);
+        uint64_t dealt = HandRank::getMask(first) | HandRank::getMask(second) | HandRank::getMask(known);
+        array<uint64_t, 3> counts = {0, 0, 0};
+        enumerateReference(known, dealt, 0, NUM_BOARD_CARDS - static_cast<int>(boardSize), counts);
+
+        ASSERT_EQ(result.numBoards, counts[0] + counts[1] + counts[2]);
+        ASSERT_EQ(result.wins[0], counts[0]);
+        ASSERT_EQ(result.ties[0], counts[1]);
+        ASSERT_EQ(result.wins[1], counts[2]);
+        ASSERT_EQ(result.ties[1], counts[1]);
+    }
+}
+
+TEST_F(EquityTest, PreflopEnumeratesEveryBoard) {
+    vector<Card> aces = {Card(Suit::HEARTS, Value::ACE), Card(Suit::SPADES, Value::ACE)};
+    vector<Card> kings = {Card(Suit::CLUBS, Value::KING), Card(Suit::DIAMONDS, Value::KING)};
+    EquityResult result = Equity::computeHeadsUp(aces, kings, {});
+
+    // C(48, 5) boards, aces hold about 82%
+    ASSERT_EQ(result.numBoards, 1712304);
+    ASSERT_NEAR(result.getEquity(0), 0.82, 0.01);
+    ASSERT_NEAR(result.getWinFraction(0) + result.getTieFraction(0) + result.getLossFraction(0), 1.0, 1e-12);
+    ASSERT_NEAR(result.getEquity(0) + result.getEquity(1), 1.0, 1e-12);
+    ASSERT_EQ(result.wins[1], result.numBoards - result.wins[0] - result.ties[0]);
+
+    // Threads split the boards without changing the tally
+    EquityResult threaded = Equity::computeHeadsUp(aces, kings, {}, 4);
+    ASSERT_EQ(threaded.numBoards, result.numBoards);
+    ASSERT_EQ(threaded.wins, result.wins);
+    ASSERT_EQ(threaded.ties, result.ties);
+}
+
+TEST_F(EquityTest, RiverIsASingleBoard) {
+    vector<Card> first = {Card(Suit::HEARTS, Value::ACE), Card(Suit::HEARTS, Value::KING)};
+    vector<Card> second = {Card(Suit::CLUBS, Value::ACE), Card(Suit::CLUBS, Value::KING)};
+    vector<Card> board = {Card(Suit::SPADES, Value::TWO), Card(Suit::SPADES, Value::SEVEN), Card(Suit::DIAMONDS, Value::NINE),
+                          Card(Suit::DIAMONDS, Value::JACK), Card(Suit::SPADES, Value::FOUR)};
+    EquityResult result = Equity::computeHeadsUp(first, second, board, 3);
+    ASSERT_EQ(result.numBoards, 1);
+    ASSERT_EQ(result.ties[0], 1);
+    ASSERT_DOUBLE_EQ(result.getEquity(0), 0.5);
+}
+
+TEST_F(EquityTest, InvalidInputThrows) {
+    vector<Card> first = {Card(Suit::HEARTS, Value::ACE), Card(Suit::HEARTS, Value::KING)};
+    vector<Card> second = {Card(Suit::CLUBS, Value::ACE), Card(Suit::CLUBS, Value::KING)};
+    vector<Card> shared = {Card(Suit::HEARTS, Value::ACE), Card(Suit::CLUBS, Value::QUEEN)};
+
+    ASSERT_THROW(Equity::computeHeadsUp(first, shared, {}), runtime_error);
+    ASSERT_THROW(Equity::computeHeadsUp(first, {second[0]}, {}), runtime_error);
+    ASSERT_THROW(Equity::computeHeadsUp(first, second, {Card(Suit::SPADES, Value::TWO)}), runtime_error);
+    ASSERT_THROW(Equity::computeHeadsUp(first, second, {Card(Suit::SPADES, Value::TWO), Card(Suit::SPADES, Value::TWO),
+                                                        Card(Suit::SPADES, Value::THREE)}), runtime_error);
+}
+
+TEST_F(EquityTest, SuitReductionMatchesBruteForce) {
+    mt19937_64 rng(5);
+    vector<uint64_t> deck;
+    for (int bit = 0; bit < 52; ++bit) deck.push_back(1ULL << bit);
+
+    // Random spots with 2 to 6 hands, where suits are rarely interchangeable
+    for (int spot = 0; spot < 40; ++spot) {
+        shuffle(deck.begin(), deck.end(), rng);
+        size_t numHands = 2 + spot % 5;
+        vector<uint64_t> hands;
+        for (size_t i = 0; i < numHands; ++i) hands.push_back(deck[2 * i] | deck[2 * i + 1]);
+        uint64_t board = 0;
+        for (int i = 0; i < 3 + spot % 2; ++i) board |= deck[2 * numHands + i];
+
+        EquityResult reduced = Equity::computeExact(hands, board, 2);
+        EquityResult bruteForce = Equity::computeExact(hands, board, 1, false);
+        ASSERT_EQ(reduced.numBoards, bruteForce.numBoards);
+        ASSERT_EQ(reduced.wins, bruteForce.wins);
+        ASSERT_EQ(reduced.ties, bruteForce.ties);
+    }
+
+    // Suits nobody holds, or that hold the same ranks, swap freely
+    auto card = [](Suit suit, Value value) { return Card(suit, value).getBitMask(); };
+    vector<vector<uint64_t>> symmetricSpots = {
+        {card(Suit::HEARTS, Value::ACE) | card(Suit::HEARTS, Value::KING),
+         card(Suit::HEARTS, Value::QUEEN) | card(Suit::HEARTS, Value::JACK)},
+        {card(Suit::HEARTS, Value::ACE) | card(Suit::SPADES, Value::ACE),
+         card(Suit::CLUBS, Value::KING) | card(Suit::DIAMONDS, Value::KING)},
+        {card(Suit::CLUBS, Value::ACE) | card(Suit::CLUBS, Value::KING),
+         card(Suit::CLUBS, Value::SEVEN) | card(Suit::CLUBS, Value::SIX),
+         card(Suit::CLUBS, Value::TWO) | card(Suit::CLUBS, Value::THREE)}};
+    for (const vector<uint64_t>& hands : symmetricSpots) {
+        EquityResult reduced = Equity::computeExact(hands, 0, 3);
+        EquityResult bruteForce = Equity::computeExact(hands, 0, 1, false);
+        ASSERT_EQ(reduced.numBoards, bruteForce.numBoards);
+        ASSERT_EQ(reduced.wins, bruteForce.wins);
+        ASSERT_EQ(reduced.ties, bruteForce.ties);
+        for (size_t i = 0; i < hands.size(); ++i) ASSERT_NEAR(reduced.getEquity(i), bruteForce.getEquity(i), 1e-12);
+        ASSERT_LT(reduced.numRanked * 3, bruteForce.numRanked);
+    }
+}
@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+#include "../include/FileUtils.h"
+#include <cstring>
+#include <filesystem>
+
+TEST(FileUtilsTest, Crc32MatchesTheStandardCheckValue) {
+    const char* check = "123456789";
+    ASSERT_EQ(computeCrc32(reinterpret_cast<const uint8_t*>(check), strlen(check)), 0xCBF43926u);
+    ASSERT_EQ(computeCrc32(nullptr, 0), 0u);
+}
+
+TEST(FileUtilsTest, FileIsReplacedWhole) {
+    string directory = testing::TempDir() + "file_utils_test";
+    filesystem::remove_all(directory);
+    filesystem::create_directories(directory);
+    string path = directory + "/data.bin";
+
+    vector<uint8_t> first(10000, 0xAB);
+    vector<uint8_t> second = {1, 2, 3};
+    ASSERT_TRUE(writeFileAtomically(path, first.data(), first.size()));
+    ASSERT_TRUE(writeFileAtomically(path, second.data(), second.size()));
+    ASSERT_FALSE(filesystem::exists(path + ".tmp"));
+
+    vector<uint8_t> read;
+    ASSERT_TRUE(readWholeFile(path, read));
+    ASSERT_EQ(read, second);
+
+    ASSERT_FALSE(readWholeFile(directory + "/missing.bin", read));
+    ASSERT_FALSE(writeFileAtomically(directory + "/missing/data.bin", second.data(), second.size()));
+    filesystem::remove_all(directory);
+}
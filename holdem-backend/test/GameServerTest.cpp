@@ -0,0 +1,379 @@
+#include <gtest/gtest.h>
+#include "../include/GameServer.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef struct Frame {
+    uint8_t type = 0;
+    vector<uint8_t> payload;
+} Frame;
+
+// Blocking loopback client speaking the wire protocol
+class TestClient {
+private:
+    int fd;
+    uint8_t buffer[FRAME_HEADER_SIZE + MAX_FRAME_PAYLOAD];
+
+    bool sendAll(const uint8_t* data, size_t size) {
+        while (size > 0) {
+            ssize_t numWritten = send(fd, data, size, MSG_NOSIGNAL);
+            if (numWritten <= 0) return false;
+            data += numWritten;
+            size -= numWritten;
+        }
+        return true;
+    }
+
+    bool readAll(uint8_t* data, size_t size) {
+        while (size > 0) {
+            ssize_t numRead = recv(fd, data, size, 0);
+            if (numRead <= 0) return false;
+            data += numRead;
+            size -= numRead;
+        }
+        return true;
+    }
+
+public:
+    int position = -1;
+
+    // Table state rebuilt from keyframes and deltas
+    TableState tableState;
+    bool isStateInSync = true;
+
+    explicit TestClient(uint16_t port) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        timeval timeout{5, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            throw runtime_error("Test client failed to connect!");
+        }
+    }
+
+    ~TestClient() { disconnect(); }
+
+    void disconnect() {
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+
+    void join(uint32_t tableId, const string& name, uint32_t chips) {
+        WireWriter writer(buffer, sizeof(buffer));
+        size_t frame = beginFrame(writer, MSG_JOIN_TABLE);
+        writer.putU32(tableId);
+        writer.putU32(chips);
+        writer.putU8(static_cast<uint8_t>(name.size()));
+        writer.putBytes(name.data(), name.size());
+        endFrame(writer, frame);
+        sendAll(buffer, writer.getSize());
+    }
+
+    void watch(uint32_t tableId, MessageType type = MSG_WATCH_TABLE) {
+        WireWriter writer(buffer, sizeof(buffer));
+        size_t frame = beginFrame(writer, type);
+        writer.putU32(tableId);
+        endFrame(writer, frame);
+        sendAll(buffer, writer.getSize());
+    }
+
+    void leave(uint32_t tableId) {
+        WireWriter writer(buffer, sizeof(buffer));
+        size_t frame = beginFrame(writer, MSG_LEAVE_TABLE);
+        writer.putU32(tableId);
+        endFrame(writer, frame);
+        sendAll(buffer, writer.getSize());
+    }
+
+    void act(uint32_t tableId, ActionType type, uint32_t amount) {
+        WireWriter writer(buffer, sizeof(buffer));
+        size_t frame = beginFrame(writer, MSG_PLAYER_ACTION);
+        writer.putU32(tableId);
+        writer.putU8(type);
+        writer.putU32(amount);
+        endFrame(writer, frame);
+        sendAll(buffer, writer.getSize());
+    }
+
+    // Returns false once the server has closed the connection
+    bool sendRaw(const vector<uint8_t>& bytes) {
+        return sendAll(bytes.data(), bytes.size());
+    }
+
+    bool readFrame(Frame& frame) {
+        uint8_t bytes[FRAME_HEADER_SIZE];
+        FrameHeader header;
+        if (!readAll(bytes, FRAME_HEADER_SIZE)) return false;
+        decodeFrameHeader(bytes, FRAME_HEADER_SIZE, header);
+        frame.type = header.type;
+        frame.payload.resize(header.payloadSize);
+        return readAll(frame.payload.data(), header.payloadSize);
+    }
+
+    // Reads until a frame of one of the given types, remembering our position on the way
+    bool readUntil(Frame& frame, const vector<uint8_t>& types) {
+        while (readFrame(frame)) {
+            if (frame.type == MSG_HAND_STARTED) position = frame.payload[4];
+            if (frame.type == MSG_STATE_KEYFRAME) {
+                isStateInSync = tableState.decodeKeyframe(frame.payload.data(), frame.payload.size());
+            }
+            if (frame.type == MSG_STATE_DELTA && isStateInSync) {
+                isStateInSync = tableState.applyDelta(frame.payload.data(), frame.payload.size());
+            }
+            if (find(types.begin(), types.end(), frame.type) != types.end()) return true;
+        }
+        return false;
+    }
+};
+
+class GameServerTest : public ::testing::Test {
+protected:
+    unique_ptr<GameServer> server;
+    thread serverThread;
+
+    void SetUp() override {
+        // Table workers narrate the game to stdout
+        cout.setstate(ios_base::badbit);
+
+        server = make_unique<GameServer>(0, 64, 4, 1, 2);
+        serverThread = thread([this]() { server->run(); });
+    }
+
+    void TearDown() override {
+        server->stop();
+        serverThread.join();
+        server.reset();
+        cout.clear();
+    }
+
+    // Plays a passive round (call or check) between two seated clients.
+    // Returns false if the clients fall out of sync.
+    static bool playPassiveRound(TestClient& clientA, TestClient& clientB, uint32_t tableId) {
+        const vector<uint8_t> types = {MSG_ACTION_REQUEST, MSG_ROUND_COMPLETE};
+
+        while (true) {
+            Frame frameA, frameB;
+            if (!clientA.readUntil(frameA, types) || !clientB.readUntil(frameB, types)) return false;
+            if (frameA.type != frameB.type || frameA.payload != frameB.payload) return false;
+            if (frameA.type == MSG_ROUND_COMPLETE) return true;
+
+            ActionRequestMessage request;
+            if (!WireCodec::decodeActionRequest(frameA.payload.data(), frameA.payload.size(), request)) return false;
+            TestClient& actor = (request.position == clientA.position) ? clientA : clientB;
+
+            ActionType choice = CHECK;
+            for (uint8_t i = 0; i < request.numActions; ++i) {
+                if (request.actions[i].type == CALL) choice = CALL;
+            }
+            actor.act(tableId, choice, 0);
+        }
+    }
+};
+
+TEST_F(GameServerTest, JoinAndPlayHeadsUpRound) {
+    TestClient clientA(server->getPort());
+    TestClient clientB(server->getPort());
+
+    Frame frame;
+    clientA.join(0, "alice", 100);
+    ASSERT_TRUE(clientA.readUntil(frame, {MSG_JOINED, MSG_ERROR}));
+    ASSERT_EQ(frame.type, MSG_JOINED);
+
+    clientB.join(0, "bob", 100);
+    ASSERT_TRUE(clientB.readUntil(frame, {MSG_JOINED, MSG_ERROR}));
+    ASSERT_EQ(frame.type, MSG_JOINED);
+
+    // Two seated players start a hand straight away
+    ASSERT_TRUE(playPassiveRound(clientA, clientB, 0));
+    ASSERT_NE(clientA.position, clientB.position);
+
+    // The next hand begins automatically
+    ASSERT_TRUE(playPassiveRound(clientA, clientB, 0));
+
+    // Both clients rebuilt the same table state from the delta stream
+    ASSERT_TRUE(clientA.isStateInSync);
+    ASSERT_TRUE(clientB.isStateInSync);
+    ASSERT_TRUE(clientA.tableState.isSameState(clientB.tableState));
+    ASSERT_EQ(clientA.tableState.handNumber, 2);
+    const SeatState* seatA = clientA.tableState.findSeat(clientA.position);
+    const SeatState* seatB = clientA.tableState.findSeat(clientB.position);
+    ASSERT_NE(seatA, nullptr);
+    ASSERT_NE(seatB, nullptr);
+    ASSERT_EQ(seatA->getName(), "alice");
+    ASSERT_EQ(seatB->getName(), "bob");
+    ASSERT_EQ(seatA->chips + seatB->chips, 200);
+}
+
+TEST_F(GameServerTest, RejectsInvalidCommands) {
+    TestClient clientA(server->getPort());
+    TestClient clientB(server->getPort());
+    Frame frame;
+
+    clientA.act(0, CHECK, 0);
+    ASSERT_TRUE(clientA.readUntil(frame, {MSG_ERROR}));
+    ASSERT_EQ(frame.payload[4], ERR_NOT_SEATED);
+
+    clientA.join(1000, "alice", 100);
+    ASSERT_TRUE(clientA.readUntil(frame, {MSG_ERROR}));
+    ASSERT_EQ(frame.payload[4], ERR_NO_SUCH_TABLE);
+
+    clientA.sendRaw({1, 0, WIRE_PROTOCOL_VERSION, 0x7F, 0});
+    ASSERT_TRUE(clientA.readUntil(frame, {MSG_ERROR}));
+    ASSERT_EQ(frame.payload[4], ERR_MALFORMED);
+
+    clientA.sendRaw({4, 0, WIRE_PROTOCOL_VERSION + 1, MSG_LEAVE_TABLE, 0, 0, 0, 0});
+    ASSERT_TRUE(clientA.readUntil(frame, {MSG_ERROR}));
+    ASSERT_EQ(frame.payload[4], ERR_UNSUPPORTED_VERSION);
+
+    clientA.join(3, "alice", 100);
+    ASSERT_TRUE(clientA.readUntil(frame, {MSG_JOINED}));
+    clientA.join(3, "alice", 100);
+    ASSERT_TRUE(clientA.readUntil(frame, {MSG_ERROR}));
+    ASSERT_EQ(frame.payload[4], ERR_ALREADY_SEATED);
+
+    clientB.join(3, "alice", 100);
+    ASSERT_TRUE(clientB.readUntil(frame, {MSG_ERROR}));
+    ASSERT_EQ(frame.payload[4], ERR_NAME_TAKEN);
+
+    clientB.join(3, "bob", 100);
+    ASSERT_TRUE(clientB.readUntil(frame, {MSG_ACTION_REQUEST}));
+    ASSERT_TRUE(clientA.readUntil(frame, {MSG_ACTION_REQUEST}));
+
+    // Whoever is not to act tries to act
+    TestClient& waiting = (frame.payload[5] == clientA.position) ? clientB : clientA;
+    TestClient& acting = (frame.payload[5] == clientA.position) ? clientA : clientB;
+    waiting.act(3, CALL, 0);
+    ASSERT_TRUE(waiting.readUntil(frame, {MSG_ERROR}));
+    ASSERT_EQ(frame.payload[4], ERR_NOT_YOUR_TURN);
+
+    // A bet below the big blind is not allowed, facing the big blind a bet is not offered at all
+    acting.act(3, BET, 1);
+    ASSERT_TRUE(acting.readUntil(frame, {MSG_ERROR}));
+    ASSERT_EQ(frame.payload[4], ERR_INVALID_ACTION);
+}
+
+TEST_F(GameServerTest, DropsAClientThatNeverReads) {
+    TestClient flooder(server->getPort());
+    TestClient other(server->getPort());
+
+    // Every malformed frame earns an error the client never reads
+    vector<uint8_t> frames;
+    for (int i = 0; i < 16384; ++i) frames.insert(frames.end(), {1, 0, WIRE_PROTOCOL_VERSION, 0x7F, 0});
+
+    bool isDropped = false;
+    for (int i = 0; i < 2048 && !isDropped; ++i) isDropped = !flooder.sendRaw(frames);
+    ASSERT_TRUE(isDropped);
+
+    // The server carries on serving everyone else
+    Frame frame;
+    other.join(0, "alice", 100);
+    ASSERT_TRUE(other.readUntil(frame, {MSG_JOINED}));
+}
+
+TEST_F(GameServerTest, SeatsAFullTable) {
+    vector<unique_ptr<TestClient>> clients;
+    Frame frame;
+    for (int seat = 0; seat < MAX_NUM_PLAYERS; ++seat) {
+        clients.push_back(make_unique<TestClient>(server->getPort()));
+        clients.back()->join(4, "player" + to_string(seat), 1000);
+        ASSERT_TRUE(clients.back()->readUntil(frame, {MSG_JOINED, MSG_ERROR}));
+        ASSERT_EQ(frame.type, MSG_JOINED);
+    }
+
+    TestClient extra(server->getPort());
+    extra.join(4, "extra", 1000);
+    ASSERT_TRUE(extra.readUntil(frame, {MSG_JOINED, MSG_ERROR}));
+    ASSERT_EQ(frame.type, MSG_ERROR);
+    ASSERT_EQ(frame.payload[4], ERR_TABLE_FULL);
+}
+
+TEST_F(GameServerTest, DisconnectFoldsOnTurn) {
+    TestClient clientA(server->getPort());
+    auto clientB = make_unique<TestClient>(server->getPort());
+    Frame frame;
+
+    clientA.join(2, "alice", 100);
+    clientB->join(2, "bob", 100);
+    ASSERT_TRUE(clientA.readUntil(frame, {MSG_ACTION_REQUEST}));
+    ASSERT_TRUE(clientB->readUntil(frame, {MSG_ACTION_REQUEST}));
+    int bobPosition = clientB->position;
+
+    // If it is alice's turn she calls, so that it becomes bob's turn
+    if (frame.payload[5] != bobPosition) {
+        clientA.act(2, CALL, 0);
+        ASSERT_TRUE(clientA.readUntil(frame, {MSG_ACTION_REQUEST}));
+    }
+
+    clientB->disconnect();
+    ASSERT_TRUE(clientA.readUntil(frame, {MSG_ACTION_RESULT}));
+    ASSERT_EQ(frame.payload[4], bobPosition);
+    ASSERT_EQ(frame.payload[5], FOLD);
+    ASSERT_TRUE(clientA.readUntil(frame, {MSG_ROUND_COMPLETE}));
+}
+
+TEST_F(GameServerTest, ManyTablesConcurrently) {
+    const uint32_t numTables = 32;
+    vector<unique_ptr<TestClient>> clients;
+
+    for (uint32_t table = 0; table < numTables; ++table) {
+        for (int seat = 0; seat < 2; ++seat) {
+            clients.push_back(make_unique<TestClient>(server->getPort()));
+            clients.back()->join(table, "player" + to_string(seat), 1000);
+        }
+    }
+
+    vector<thread> players;
+    atomic<int> numRoundsPlayed(0);
+    for (uint32_t table = 0; table < numTables; ++table) {
+        players.emplace_back([&clients, &numRoundsPlayed, table]() {
+            if (playPassiveRound(*clients[2 * table], *clients[2 * table + 1], table)) numRoundsPlayed++;
+        });
+    }
+    for (auto& player : players) player.join();
+
+    ASSERT_EQ(numRoundsPlayed, numTables);
+}
+
+TEST_F(GameServerTest, SpectatorsFollowTheTable) {
+    TestClient clientA(server->getPort());
+    TestClient clientB(server->getPort());
+    Frame frame;
+
+    // Spectators can watch before anyone sits down
+    vector<unique_ptr<TestClient>> spectators;
+    for (int i = 0; i < 8; ++i) {
+        spectators.push_back(make_unique<TestClient>(server->getPort()));
+        spectators.back()->watch(5);
+        ASSERT_TRUE(spectators.back()->readUntil(frame, {MSG_WATCHING}));
+    }
+    spectators[0]->watch(5);
+    ASSERT_TRUE(spectators[0]->readUntil(frame, {MSG_ERROR}));
+    ASSERT_EQ(frame.payload[4], ERR_ALREADY_WATCHING);
+
+    clientA.join(5, "alice", 100);
+    clientB.join(5, "bob", 100);
+    ASSERT_TRUE(playPassiveRound(clientA, clientB, 5));
+
+    // Every spectator saw the same actions and rebuilt the same state as the players
+    for (auto& spectator : spectators) {
+        ASSERT_TRUE(spectator->readUntil(frame, {MSG_ROUND_COMPLETE}));
+        ASSERT_TRUE(spectator->isStateInSync);
+        ASSERT_EQ(spectator->tableState.sequence, clientA.tableState.sequence);
+        ASSERT_TRUE(spectator->tableState.isSameState(clientA.tableState));
+    }
+
+    spectators[0]->watch(5, MSG_UNWATCH_TABLE);
+    ASSERT_TRUE(spectators[0]->readUntil(frame, {MSG_LEFT}));
+    spectators[0]->watch(5, MSG_UNWATCH_TABLE);
+    ASSERT_TRUE(spectators[0]->readUntil(frame, {MSG_ERROR}));
+    ASSERT_EQ(frame.payload[4], ERR_NOT_WATCHING);
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include "../include/HandArchive.h"
+#include "../include/GameController.h"
+
+class HandArchiveTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // The game narrates every step to stdout
+        cout.setstate(ios_base::badbit);
+    }
+
+    void TearDown() override {
+        cout.clear();
+    }
+
+    // Plays a mix of bets, raises, folds and calls so records cover every action type.
+    // Players only fold facing a bet.
+    static void playDecision(GameController& game, size_t step) {
+        shared_ptr<Player> player = game.getStreetState().getCurPlayer();
+        ClientAction fallback = ClientAction{player, CHECK, 0};
+        for (const auto& possible : game.getPossibleActions()) {
+            if (possible.type == CALL) fallback.type = CALL;
+        }
+
+        for (const auto& possible : game.getPossibleActions()) {
+            bool isAggressive = (possible.type == BET || possible.type == RAISE) && step % 7 == 3;
+            bool isFold = possible.type == FOLD && fallback.type == CALL && step % 11 == 5;
+            if (!isAggressive && !isFold) continue;
+
+            ClientAction action = ClientAction{player, possible.type, max<size_t>(possible.amount * 2, 4)};
+            if (game.processClientAction(action)) return;
+        }
+        ASSERT_TRUE(game.processClientAction(fallback));
+    }
+
+    // Plays hands at each pair of blinds in turn, stamping table ids and start times
+    static vector<HandRecord> playHands(const vector<pair<size_t, size_t>>& blinds, int handsPerBlinds) {
+        vector<HandRecord> hands;
+        size_t step = 0;
+        for (const auto& [smallBlind, bigBlind] : blinds) {
+            GameController game(smallBlind, bigBlind);
+            game.setTableId(static_cast<uint32_t>(smallBlind));
+            const char* names[] = {"alice", "bob", "charlie", "dave", "erin", "frank"};
+            for (const char* name : names) game.addPlayerToGame(name, 100000);
+
+            for (int i = 0; i < handsPerBlinds; ++i) {
+                EXPECT_TRUE(game.beginRound());
+                while (game.isAwaitingAction()) playDecision(game, step++);
+                hands.push_back(game.getHandRecord());
+                hands.back().startTime = 1700000000000 + hands.size() * 45000;
+                game.setupNewRound();
+            }
+        }
+        return hands;
+    }
+
+    static size_t getLogSize(const vector<HandRecord>& hands) {
+        uint8_t buffer[MAX_HAND_RECORD_SIZE];
+        size_t size = 0;
+        for (const HandRecord& hand : hands) {
+            WireWriter writer(buffer, sizeof(buffer));
+            EXPECT_TRUE(HandRecordCodec::encode(hand, writer));
+            size += writer.getSize();
+        }
+        return size;
+    }
+};
+
+TEST_F(HandArchiveTest, BitCodesRoundTrip) {
+    vector<uint64_t> values = {0, 1, 2, 3, 7, 8, 255, 256, 65535, UINT32_MAX, 1ull << 32,
+                               1ull << 40, UINT64_MAX - 1, UINT64_MAX};
+    vector<uint8_t> bytes;
+    BitWriter writer(bytes);
+    for (uint64_t value : values) {
+        writer.putBits(static_cast<uint32_t>(value) & 0x1F, 5);
+        writer.putGamma(value);
+    }
+    writer.putBits(0xDEADBEEF, 32);
+    writer.alignToByte();
+
+    BitReader reader(bytes.data(), bytes.size());
+    for (uint64_t value : values) {
+        ASSERT_EQ(reader.getBits(5), value & 0x1F);
+        ASSERT_EQ(reader.getGamma(), value);
+    }
+    ASSERT_EQ(reader.getBits(32), 0xDEADBEEF);
+    ASSERT_FALSE(reader.isUnderflow());
+    ASSERT_EQ(reader.getByteOffset(), bytes.size());
+
+    // Small values stay small
+    vector<uint8_t> small;
+    BitWriter smallWriter(small);
+    smallWriter.putGamma(0);
+    smallWriter.putGamma(2);
+    smallWriter.alignToByte();
+    ASSERT_EQ(small.size(), 1);
+
+    BitReader empty(bytes.data(), 0);
+    ASSERT_EQ(empty.getGamma(), 0);
+    ASSERT_TRUE(empty.isUnderflow());
+}
+
+TEST_F(HandArchiveTest, RoundTripAcrossBlocks) {
+    vector<HandRecord> hands = playHands({{1, 2}, {5, 10}, {25, 50}}, 40);
+
+    // Some hands were run out all in
+    StreetEquity equity;
+    equity.positions = {1, 4};
+    equity.equities = {0.8123, 0.1877};
+    for (size_t i = 0; i < hands.size(); i += 13) {
+        for (Street street : {FLOP, TURN, RIVER}) {
+            equity.street = street;
+            hands[i].addRunoutEquity(equity);
+        }
+    }
+
+    HandArchiveWriter writer(16);
+    for (const HandRecord& hand : hands) writer.add(hand);
+    vector<uint8_t> archive = writer.finish();
+
+    // New blinds always start a new block: 40 hands is 16 + 16 + 8 per level
+    HandArchiveReader reader(archive.data(), archive.size());
+    ASSERT_TRUE(reader.isValid());
+    ASSERT_EQ(reader.getNumHands(), hands.size());
+    ASSERT_EQ(reader.getNumBlocks(), 9);
+
+    vector<HandRecord> decoded;
+    for (size_t i = 0; i < reader.getNumBlocks(); ++i) ASSERT_TRUE(reader.getBlock(i, decoded));
+    ASSERT_EQ(decoded, hands);
+
+    // The writer is reset by finish
+    writer.add(hands[0]);
+    vector<uint8_t> single = writer.finish();
+    HandArchiveReader singleReader(single.data(), single.size());
+    ASSERT_EQ(singleReader.getNumHands(), 1);
+}
+
+TEST_F(HandArchiveTest, RandomAccessDecodesOneHand) {
+    vector<HandRecord> hands = playHands({{1, 2}, {50, 100}}, 150);
+
+    HandArchiveWriter writer;
+    for (const HandRecord& hand : hands) writer.add(hand);
+    vector<uint8_t> archive = writer.finish();
+    HandArchiveReader reader(archive.data(), archive.size());
+    ASSERT_EQ(reader.getNumBlocks(), 2);
+
+    HandRecord hand;
+    for (size_t i = hands.size(); i-- > 0;) {
+        ASSERT_TRUE(reader.getHand(i, hand));
+        ASSERT_EQ(hand, hands[i]);
+    }
+    ASSERT_FALSE(reader.getHand(hands.size(), hand));
+}
+
+TEST_F(HandArchiveTest, SmallerThanHandHistoryLog) {
+    vector<HandRecord> hands = playHands({{5, 10}}, 256);
+
+    HandArchiveWriter writer;
+    for (const HandRecord& hand : hands) writer.add(hand);
+    vector<uint8_t> archive = writer.finish();
+
+    size_t logSize = getLogSize(hands);
+    ASSERT_LT(archive.size() * 4, logSize);
+}
+
+TEST_F(HandArchiveTest, MalformedArchivesAreRejected) {
+    vector<HandRecord> hands = playHands({{1, 2}}, 20);
+    HandArchiveWriter writer(8);
+    for (const HandRecord& hand : hands) writer.add(hand);
+    vector<uint8_t> archive = writer.finish();
+
+    // Any truncation loses the index
+    for (size_t size = 0; size < archive.size(); ++size) {
+        HandArchiveReader reader(archive.data(), size);
+        ASSERT_FALSE(reader.isValid());
+    }
+
+    vector<uint8_t> badMagic = archive;
+    badMagic[0] ^= 1;
+    ASSERT_FALSE(HandArchiveReader(badMagic.data(), badMagic.size()).isValid());
+
+    // Corrupt hands never decode out of bounds
+    for (size_t offset = HAND_ARCHIVE_HEADER_SIZE; offset < archive.size(); ++offset) {
+        vector<uint8_t> corrupt = archive;
+        corrupt[offset] ^= 0xA5;
+        HandArchiveReader reader(corrupt.data(), corrupt.size());
+        vector<HandRecord> decoded;
+        for (size_t i = 0; i < reader.getNumBlocks(); ++i) reader.getBlock(i, decoded);
+    }
+}
@@ -565,7 +565,7 @@ TEST_F(HandEvalTest, ThreeOfAKindTie) {
     // DEAL CARDS
     vector<pair<Suit, Value>> SixTripsQueenKicker = {
         {Suit::CLUBS, Value::THREE},
-        {Suit::SPADES, Value::THREE},
+        {Suit::SPADES, Value::FOUR},
         {Suit::HEARTS, Value::SIX},
         {Suit::DIAMONDS, Value::SIX},
         {Suit::CLUBS, Value::TWO},
@@ -577,7 +577,7 @@ TEST_F(HandEvalTest, ThreeOfAKindTie) {
 
     vector<pair<Suit, Value>> SixTripsKingKicker = {
         {Suit::CLUBS, Value::THREE},
-        {Suit::SPADES, Value::THREE},
+        {Suit::SPADES, Value::FOUR},
         {Suit::HEARTS, Value::SIX},
         {Suit::DIAMONDS, Value::SIX},
         {Suit::CLUBS, Value::TWO},
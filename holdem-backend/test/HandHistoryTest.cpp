@@ -0,0 +1,376 @@
+#include <gtest/gtest.h>
+#include "../include/GameTable.h"
+#include "../include/HandHistoryLog.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+class NullOutput : public TableOutput {
+public:
+    void sendToClient(uint64_t clientId, const uint8_t* data, size_t size) override {}
+};
+
+// Keeps every frame a table sends with the client it went to
+class RecordingOutput : public TableOutput {
+public:
+    vector<pair<uint64_t, vector<uint8_t>>> frames;
+
+    void sendToClient(uint64_t clientId, const uint8_t* data, size_t size) override {
+        frames.emplace_back(clientId, vector<uint8_t>(data, data + size));
+    }
+};
+
+class HandHistoryTest : public ::testing::Test {
+protected:
+    string directory;
+
+    void SetUp() override {
+        // The game narrates every step to stdout
+        cout.setstate(ios_base::badbit);
+
+        char path[] = "/tmp/handhistoryXXXXXX";
+        ASSERT_NE(mkdtemp(path), nullptr);
+        directory = path;
+    }
+
+    void TearDown() override {
+        for (const string& segment : HandHistoryReader::listSegments(directory)) unlink(segment.c_str());
+        rmdir(directory.c_str());
+        cout.clear();
+    }
+
+    // Plays the pending decision with a call (or check)
+    static void callOrCheck(GameController& game) {
+        ActionType choice = CHECK;
+        for (const auto& action : game.getPossibleActions()) {
+            if (action.type == CALL) choice = CALL;
+        }
+        ClientAction action = ClientAction{game.getStreetState().getCurPlayer(), choice, 0};
+        ASSERT_TRUE(game.processClientAction(action));
+    }
+
+    // Plays a hand to the end and returns its record
+    static HandRecord playHand(GameController& game) {
+        EXPECT_TRUE(game.beginRound());
+        while (game.isAwaitingAction()) callOrCheck(game);
+        HandRecord record = game.getHandRecord();
+        game.setupNewRound();
+        return record;
+    }
+
+    // Reads every record in the directory, oldest first
+    vector<HandRecord> readAll(bool& isTruncated) {
+        vector<HandRecord> records;
+        isTruncated = false;
+        for (const string& path : HandHistoryReader::listSegments(directory)) {
+            HandHistoryReader reader(path);
+            HandRecordView view;
+            while (reader.next(view)) {
+                records.emplace_back();
+                EXPECT_TRUE(view.decode(records.back()));
+                EXPECT_EQ(view.getTableId(), records.back().tableId);
+                EXPECT_EQ(view.getHandNumber(), records.back().handNumber);
+            }
+            isTruncated |= reader.isTruncated();
+        }
+        return records;
+    }
+};
+
+TEST_F(HandHistoryTest, RecordsCompletedHand) {
+    GameController game(1, 2);
+    game.setTableId(7);
+    game.addPlayerToGame("alice", 100);
+    game.addPlayerToGame("bob", 200);
+    game.addPlayerToGame("carol", 300);
+
+    HandRecord record = playHand(game);
+    ASSERT_EQ(record.tableId, 7);
+    ASSERT_EQ(record.handNumber, 1);
+    ASSERT_EQ(record.bigBlind, 2);
+    ASSERT_EQ(record.seats.size(), 3);
+    ASSERT_EQ(record.numBoardCards, 5);
+
+    uint32_t startingChips = 0;
+    for (const HandSeat& seat : record.seats) {
+        startingChips += seat.startingChips;
+        ASSERT_NE(seat.holeCards[0], NO_CARD);
+        ASSERT_NE(seat.holeCards[1], NO_CARD);
+    }
+    ASSERT_EQ(startingChips, 600);
+
+    // Blinds open the timeline, then everyone calls or checks down
+    ASSERT_GE(record.actions.size(), 2 + 3 + 3 * 3);
+    ASSERT_EQ(record.actions[0].type, BLIND);
+    ASSERT_EQ(record.actions[0].amount, 1);
+    ASSERT_EQ(record.actions[1].type, BLIND);
+    ASSERT_EQ(record.actions[1].amount, 2);
+    ASSERT_EQ(record.actions.back().street, RIVER);
+
+    // Everything in the pots went to the winners
+    uint32_t potChips = 0, chipsWon = 0;
+    for (const HandPot& pot : record.pots) potChips += pot.chips;
+    for (const HandResult& result : record.results) chipsWon += result.chipsWon;
+    ASSERT_EQ(potChips, 6);
+    ASSERT_EQ(chipsWon, potChips);
+
+    // The next hand starts a fresh record
+    HandRecord next = playHand(game);
+    ASSERT_EQ(next.handNumber, 2);
+    ASSERT_EQ(next.actions[0].type, BLIND);
+}
+
+TEST_F(HandHistoryTest, CodecRoundTrip) {
+    GameController game(5, 10);
+    game.addPlayerToGame("alice", 1000);
+    game.addPlayerToGame("bob", 1000);
+    HandRecord record = playHand(game);
+
+    // Streets are kept in order whichever is worked out first
+    StreetEquity equity;
+    equity.positions = {0, 1};
+    for (Street street : {RIVER, FLOP}) {
+        equity.street = street;
+        equity.equities = {street == FLOP ? 0.4 : 0.0, street == FLOP ? 0.6 : 1.0};
+        record.addRunoutEquity(equity);
+    }
+    ASSERT_EQ(record.runoutEquities.size(), 4);
+    ASSERT_EQ(record.runoutEquities[1].street, FLOP);
+    ASSERT_EQ(record.runoutEquities[1].equity, 6000);
+    ASSERT_EQ(record.runoutEquities[2].street, RIVER);
+
+    uint8_t buffer[MAX_HAND_RECORD_SIZE];
+    WireWriter writer(buffer, sizeof(buffer));
+    ASSERT_TRUE(HandRecordCodec::encode(record, writer));
+
+    HandRecord decoded;
+    ASSERT_TRUE(HandRecordCodec::decode(buffer, writer.getSize(), decoded));
+    ASSERT_EQ(decoded, record);
+
+    // Every truncation is rejected
+    for (size_t size = 0; size < writer.getSize(); ++size) {
+        ASSERT_FALSE(HandRecordCodec::decode(buffer, size, decoded));
+    }
+}
+
+TEST_F(HandHistoryTest, WriterRotatesSegmentsAcrossTables) {
+    const int numTables = 4;
+    const int handsPerTable = 500;
+
+    // A template hand, stamped with each table and hand number
+    GameController game(1, 2);
+    game.addPlayerToGame("alice", 100);
+    game.addPlayerToGame("bob", 100);
+    game.addPlayerToGame("carol", 100);
+    HandRecord hand = playHand(game);
+
+    HandHistoryOptions options;
+    options.directory = directory;
+    options.segmentSize = 16 * 1024;
+    options.bufferSize = 4 * 1024;
+    {
+        HandHistoryWriter writer(options);
+        vector<thread> tables;
+        for (int t = 0; t < numTables; ++t) {
+            tables.emplace_back([&writer, &hand, t]() {
+                HandRecord record = hand;
+                record.tableId = t;
+                for (int i = 1; i <= handsPerTable; ++i) {
+                    record.handNumber = i;
+                    ASSERT_TRUE(writer.append(record));
+                }
+            });
+        }
+        for (auto& table : tables) table.join();
+        writer.close();
+        ASSERT_EQ(writer.getNumWritten(), numTables * handsPerTable);
+        ASSERT_GT(writer.getSegmentIndex(), 1);
+    }
+
+    // Each table's hands come back complete and in order
+    bool isTruncated;
+    vector<HandRecord> records = readAll(isTruncated);
+    ASSERT_FALSE(isTruncated);
+    ASSERT_EQ(records.size(), numTables * handsPerTable);
+
+    vector<uint64_t> lastHand(numTables, 0);
+    for (const HandRecord& record : records) {
+        ASSERT_EQ(record.handNumber, lastHand[record.tableId] + 1);
+        lastHand[record.tableId] = record.handNumber;
+
+        HandRecord expected = hand;
+        expected.tableId = record.tableId;
+        expected.handNumber = record.handNumber;
+        ASSERT_EQ(record, expected);
+    }
+
+    // A new writer never appends to an existing segment
+    size_t numSegments = HandHistoryReader::listSegments(directory).size();
+    HandHistoryWriter reopened(options);
+    ASSERT_EQ(reopened.getSegmentIndex(), numSegments + 1);
+}
+
+TEST_F(HandHistoryTest, FlushedRecordsAreReadableWhileWriting) {
+    GameController game(1, 2);
+    game.addPlayerToGame("alice", 100);
+    game.addPlayerToGame("bob", 100);
+
+    HandHistoryOptions options;
+    options.directory = directory;
+    options.fsyncInterval = chrono::milliseconds(5);
+    HandHistoryWriter writer(options);
+
+    vector<HandRecord> hands;
+    for (int i = 0; i < 3; ++i) {
+        hands.push_back(playHand(game));
+        writer.append(hands.back());
+    }
+    writer.flush();
+
+    bool isTruncated;
+    vector<HandRecord> records = readAll(isTruncated);
+    ASSERT_EQ(records, hands);
+    ASSERT_FALSE(isTruncated);
+}
+
+TEST_F(HandHistoryTest, TornTailIsIgnored) {
+    GameController game(1, 2);
+    game.addPlayerToGame("alice", 100);
+    game.addPlayerToGame("bob", 100);
+
+    HandHistoryOptions options;
+    options.directory = directory;
+    {
+        HandHistoryWriter writer(options);
+        for (int i = 0; i < 10; ++i) writer.append(playHand(game));
+    }
+
+    // Simulate a crash halfway through writing a record
+    string segment = HandHistoryReader::listSegments(directory).back();
+    int fd = open(segment.c_str(), O_WRONLY | O_APPEND);
+    ASSERT_GE(fd, 0);
+    uint8_t torn[] = {200, 0, 0, 0, 1, 2, 3, 4, 5, 6};
+    ASSERT_EQ(write(fd, torn, sizeof(torn)), sizeof(torn));
+    close(fd);
+
+    bool isTruncated;
+    vector<HandRecord> records = readAll(isTruncated);
+    ASSERT_EQ(records.size(), 10);
+    ASSERT_TRUE(isTruncated);
+}
+
+TEST_F(HandHistoryTest, TableLogsEveryHand) {
+    HandHistoryOptions options;
+    options.directory = directory;
+    HandHistoryWriter writer(options);
+
+    NullOutput output;
+    GameTable table(3, 1, 2, output);
+    table.setHandHistory(&writer);
+
+    for (uint64_t clientId = 1; clientId <= 2; ++clientId) {
+        TableCommand join;
+        join.type = JOIN_TABLE;
+        join.clientId = clientId;
+        join.amount = 1000;
+        join.playerName = "player" + to_string(clientId);
+        table.handleCommand(join);
+    }
+
+    // Whoever is to act folds, until five hands are complete
+    const GameController& game = table.getGame();
+    while (game.getHandRecord().handNumber <= 5) {
+        TableCommand fold;
+        fold.clientId = (game.getStreetState().getCurPlayer()->getName() == "player1") ? 1 : 2;
+        fold.action = FOLD;
+        table.handleCommand(fold);
+    }
+    writer.flush();
+
+    bool isTruncated;
+    vector<HandRecord> records = readAll(isTruncated);
+    ASSERT_EQ(records.size(), 5);
+    for (size_t i = 0; i < records.size(); ++i) {
+        ASSERT_EQ(records[i].tableId, 3);
+        ASSERT_EQ(records[i].handNumber, i + 1);
+        ASSERT_EQ(records[i].actions.back().type, FOLD);
+
+        uint32_t potChips = 0, chipsWon = 0;
+        for (const HandPot& pot : records[i].pots) potChips += pot.chips;
+        for (const HandResult& result : records[i].results) chipsWon += result.chipsWon;
+        ASSERT_EQ(chipsWon, potChips);
+    }
+}
+
+TEST_F(HandHistoryTest, TableBroadcastsAndLogsRunoutEquity) {
+    HandHistoryOptions options;
+    options.directory = directory;
+    HandHistoryWriter writer(options);
+
+    // Without a preflop table every street is worked out by the worker
+    RunoutEquityOptions runoutOptions;
+    RunoutEquityWorker worker;
+    RecordingOutput output;
+    TableScheduler scheduler(1);
+    auto table = make_shared<GameTable>(3, 1, 2, output);
+    table->setActionClock(chrono::milliseconds(0), chrono::milliseconds(0));
+    table->setHandHistory(&writer);
+    table->setRunoutEquity(runoutOptions, &worker);
+    scheduler.addTable(table);
+
+    for (uint64_t clientId = 1; clientId <= 2; ++clientId) {
+        TableCommand join;
+        join.type = JOIN_TABLE;
+        join.clientId = clientId;
+        join.amount = 1000;
+        join.playerName = "player" + to_string(clientId);
+        table->post(join);
+    }
+    scheduler.waitUntilIdle();
+
+    // Both players are all in before the flop
+    const GameController& game = table->getGame();
+    while (game.getHandRecord().handNumber == 1 && game.isAwaitingAction()) {
+        TableCommand shove;
+        shove.clientId = (game.getStreetState().getCurPlayer()->getName() == "player1") ? 1 : 2;
+        shove.action = CALL;
+        for (const auto& possible : game.getPossibleActions()) {
+            if (possible.type == BET || possible.type == RAISE) {
+                shove.action = possible.type;
+                shove.amount = game.getStreetState().getPlayerInitialChips();
+            }
+        }
+        table->post(shove);
+        scheduler.waitUntilIdle();
+    }
+
+    // The hand is logged once the worker's results are attached
+    vector<HandRecord> records;
+    for (int attempt = 0; attempt < 1000 && records.empty(); ++attempt) {
+        this_thread::sleep_for(chrono::milliseconds(5));
+        scheduler.waitUntilIdle();
+        writer.flush();
+        bool isTruncated;
+        records = readAll(isTruncated);
+    }
+    ASSERT_EQ(records.size(), 1);
+    ASSERT_EQ(records[0].runoutEquities.size(), 6);
+    for (size_t i = 0; i < records[0].runoutEquities.size(); ++i) {
+        ASSERT_EQ(records[0].runoutEquities[i].street, FLOP + i / 2);
+    }
+
+    // Each street goes to whoever is still seated, a busted player having left
+    set<int> streets;
+    for (const auto& [clientId, frame] : output.frames) {
+        FrameHeader header;
+        ASSERT_TRUE(decodeFrameHeader(frame.data(), frame.size(), header));
+        if (header.type != MSG_RUNOUT_EQUITY) continue;
+        RunoutEquityMessage message;
+        ASSERT_TRUE(WireCodec::decodeRunoutEquity(frame.data() + FRAME_HEADER_SIZE, header.payloadSize, message));
+        ASSERT_EQ(message.handNumber, 1u);
+        ASSERT_EQ(message.numPlayers, 2);
+        ASSERT_NEAR(message.players[0].equity + message.players[1].equity, PROBABILITY_SCALE, 1);
+        streets.insert(message.street);
+    }
+    ASSERT_EQ(streets, (set<int>{FLOP, TURN, RIVER}));
+    scheduler.stop();
+}
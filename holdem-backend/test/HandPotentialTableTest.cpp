@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "../include/HandPotentialTable.h"
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+class HandPotentialTableTest : public ::testing::Test {
+protected:
+    string directory;
+
+    HandPotentialTableTest() {
+        directory = testing::TempDir() + "hand_potential_table_test";
+        filesystem::remove_all(directory);
+        filesystem::create_directories(directory);
+    }
+
+    ~HandPotentialTableTest() {
+        filesystem::remove_all(directory);
+    }
+
+    static uint64_t permuteSuits(uint64_t cards, const array<int, 4>& suits) {
+        uint64_t permuted = 0;
+        for (int suit = 0; suit < 4; ++suit) {
+            permuted |= ((cards >> (suit * NUM_VALUES)) & 0x1FFF) << (suits[suit] * NUM_VALUES);
+        }
+        return permuted;
+    }
+};
+
+TEST_F(HandPotentialTableTest, EntriesMatchDirectEnumeration) {
+    string path = directory + "/potential.bin";
+    HandPotentialOptions options;
+    options.numThreads = 2;
+    options.includeTurn = true;
+    options.boards = {HandPotentialTable::parseCards("Th4hKs"), HandPotentialTable::parseCards("2c7d9hJs")};
+    ASSERT_TRUE(HandPotentialTable::generate(path, options));
+
+    HandPotentialTable table;
+    ASSERT_TRUE(table.open(path));
+    ASSERT_TRUE(table.hasTurn());
+
+    // A few pairs on each board, and on a board of the same class with its suits swapped
+    mt19937_64 rng(49);
+    array<int, 4> suits = {2, 0, 3, 1};
+    for (uint64_t board : options.boards) {
+        for (int query = 0; query < 4; ++query) {
+            uint64_t hole = 0;
+            while (HandRank::countCards(hole) < 2) {
+                uint64_t card = 1ULL << (rng() % 52);
+                if (!(card & board)) hole |= card;
+            }
+            HandPotential expected = HandPotentialTable::compute(hole, board);
+            for (bool isSwapped : {false, true}) {
+                HandPotential potential = isSwapped ? table.lookup(permuteSuits(hole, suits), permuteSuits(board, suits))
+                                                    : table.lookup(hole, board);
+                ASSERT_TRUE(potential.isKnown);
+                ASSERT_NEAR(potential.strength, expected.strength, 1e-4);
+                ASSERT_NEAR(potential.positive, expected.positive, 1e-4);
+                ASSERT_NEAR(potential.negative, expected.negative, 1e-4);
+                ASSERT_NEAR(potential.effective, expected.effective, 1e-4);
+            }
+        }
+    }
+
+    // A flush draw often gets better, and classes not generated aren't known
+    uint64_t flop = options.boards[0];
+    HandPotential draw = table.lookup(HandPotentialTable::parseCards("2h3h"), flop);
+    ASSERT_GT(draw.positive, 0.2);
+    ASSERT_GT(draw.effective, draw.strength);
+
+    ASSERT_FALSE(table.lookup(HandPotentialTable::parseCards("AcAd"), HandPotentialTable::parseCards("2s3s4s")).isKnown);
+    ASSERT_FALSE(table.lookup(HandPotentialTable::parseCards("JhQh"), flop | HandPotentialTable::parseCards("Ah")).isKnown);
+    ASSERT_THROW(table.lookup(HandPotentialTable::parseCards("ThAd"), flop), runtime_error);
+    ASSERT_THROW(table.lookup(HandPotentialTable::parseCards("AcAd"), 0), runtime_error);
+}
+
+TEST_F(HandPotentialTableTest, MatchesCountedTwoCardLookahead) {
+    // QcJd on Th 9s 2c, counted over all 1081 opponents and 990 turn and river pairs apart
+    // from the engine. Opponent and runout pairs by standing now (rows) and at the end:
+    //   ahead  312492  5272   62396
+    //   tied        0  8820      90
+    //   behind 311965  2005  367150
+    // PPot = (311965 + 2005 / 2 + 0 / 2) / (681120 + 8910 / 2)
+    // NPot = (62396 + 90 / 2 + 5272 / 2) / (380160 + 8910 / 2)
+    uint64_t hole = HandPotentialTable::parseCards("QcJd");
+    uint64_t flop = HandPotentialTable::parseCards("Th9s2c");
+    const double strength = 0.359389;
+    const double positive = 312967.5 / 685575.0;
+    const double negative = 65077.0 / 384615.0;
+
+    HandPotential direct = HandPotentialTable::compute(hole, flop);
+    ASSERT_NEAR(direct.strength, strength, 1e-6);
+    ASSERT_NEAR(direct.positive, positive, 1e-9);
+    ASSERT_NEAR(direct.negative, negative, 1e-9);
+    ASSERT_NEAR(direct.effective, strength * (1 - negative) + (1 - strength) * positive, 1e-6);
+
+    string path = directory + "/potential.bin";
+    HandPotentialOptions options;
+    options.boards = {flop};
+    ASSERT_TRUE(HandPotentialTable::generate(path, options));
+    HandPotentialTable table;
+    ASSERT_TRUE(table.open(path));
+    HandPotential stored = table.lookup(hole, flop);
+    ASSERT_NEAR(stored.positive, positive, 1e-4);
+    ASSERT_NEAR(stored.negative, negative, 1e-4);
+    ASSERT_NEAR(stored.effective, 0.591022, 1e-4);
+}
+
+TEST_F(HandPotentialTableTest, RejectsOtherFiles) {
+    string path = directory + "/potential.bin";
+    HandPotentialOptions options;
+    options.boards = {HandPotentialTable::parseCards("AsAhAd")};
+    ASSERT_TRUE(HandPotentialTable::generate(path, options));
+
+    HandPotentialTable table;
+    ASSERT_TRUE(table.open(path));
+    ASSERT_FALSE(table.hasTurn());
+    ASSERT_FALSE(table.lookup(HandPotentialTable::parseCards("2c2d"), HandPotentialTable::parseCards("AsAhAd2s")).isKnown);
+
+    // Quads stay ahead of everything but a straight flush
+    HandPotential quads = table.lookup(HandPotentialTable::parseCards("AcKd"), HandPotentialTable::parseCards("AsAhAd"));
+    ASSERT_TRUE(quads.isKnown);
+    ASSERT_EQ(quads.positive, 0.0);
+    ASSERT_LT(quads.negative, 0.01);
+
+    {
+        fstream file(path, ios::in | ios::out | ios::binary);
+        file.seekp(HAND_POTENTIAL_TABLE_HEADER_SIZE + 1000);
+        file.put('\x01');
+    }
+    ASSERT_FALSE(table.open(path));
+    ASSERT_FALSE(table.isOpen());
+    ASSERT_FALSE(table.open(directory + "/missing.bin"));
+    ASSERT_THROW(table.lookup(HandPotentialTable::parseCards("AcKd"), HandPotentialTable::parseCards("AsAhAd")), runtime_error);
+
+    ASSERT_THROW(HandPotentialTable::parseCards("A"), runtime_error);
+    ASSERT_THROW(HandPotentialTable::parseCards("AhAh"), runtime_error);
+    options.boards = {HandPotentialTable::parseCards("AsAhAd2s")};
+    ASSERT_THROW(HandPotentialTable::generate(path, options), runtime_error);
+}
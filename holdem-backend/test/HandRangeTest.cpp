@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include "../include/HandRange.h"
+
+class HandRangeTest : public ::testing::Test {
+protected:
+    static int comboOf(Suit firstSuit, Value firstValue, Suit secondSuit, Value secondValue) {
+        return HandRange::getComboIndex(Card(firstSuit, firstValue).getBitMask() | Card(secondSuit, secondValue).getBitMask());
+    }
+};
+
+TEST_F(HandRangeTest, ParsesTokens) {
+    ASSERT_EQ(HandRange::parse("QQ+").size(), 18);
+    ASSERT_EQ(HandRange::parse("AKs").size(), 4);
+    ASSERT_EQ(HandRange::parse("AKo").size(), 12);
+    ASSERT_EQ(HandRange::parse("KA").size(), 16);
+    ASSERT_EQ(HandRange::parse("A2s+").size(), 48);
+    ASSERT_EQ(HandRange::parse("KT+").size(), 48);
+    ASSERT_EQ(HandRange::parse("KTs-K7s").size(), 16);
+    ASSERT_EQ(HandRange::parse("22-44").size(), 18);
+    ASSERT_EQ(HandRange::parse("44-22").size(), 18);
+    ASSERT_EQ(HandRange::parse("").size(), 0);
+
+    HandRange combo = HandRange::parse("AhKh");
+    ASSERT_EQ(combo.size(), 1);
+    ASSERT_TRUE(combo.contains(comboOf(Suit::HEARTS, Value::ACE, Suit::HEARTS, Value::KING)));
+
+    // Later tokens set the weight of combos they repeat
+    HandRange range = HandRange::parse("QQ+, AKs, 50% AQo,  AQ , 25%KK");
+    ASSERT_EQ(range.size(), 18 + 4 + 16);
+    ASSERT_EQ(range.getWeight(comboOf(Suit::HEARTS, Value::ACE, Suit::SPADES, Value::QUEEN)), FULL_WEIGHT);
+    ASSERT_EQ(range.getWeight(comboOf(Suit::HEARTS, Value::KING, Suit::SPADES, Value::KING)), 25);
+    ASSERT_EQ(range.getWeight(comboOf(Suit::CLUBS, Value::ACE, Suit::CLUBS, Value::KING)), FULL_WEIGHT);
+    ASSERT_EQ(range.getWeight(comboOf(Suit::CLUBS, Value::ACE, Suit::HEARTS, Value::KING)), 0);
+
+    HandRange weighted = HandRange::parse("50% AQo");
+    ASSERT_EQ(weighted.getWeight(comboOf(Suit::HEARTS, Value::ACE, Suit::SPADES, Value::QUEEN)), 50);
+}
+
+TEST_F(HandRangeTest, MalformedTokensThrow) {
+    for (const string& text : {"AKx", "A", "QQs", "AK-QJ", "AKs-QJs", "150% AA", "% AA", "AhAh", "ZZ", "AK,, 2%"}) {
+        ASSERT_THROW(HandRange::parse(text), runtime_error) << text;
+    }
+}
+
+TEST_F(HandRangeTest, CombosIndexInColexOrder) {
+    uint64_t previous = 0;
+    for (int combo = 0; combo < NUM_COMBOS; ++combo) {
+        uint64_t cards = HandRange::getComboMask(combo);
+        ASSERT_EQ(HandRank::countCards(cards), 2);
+        ASSERT_EQ(HandRange::getComboIndex(cards), combo);
+
+        // Colex order compares the highest card first, which is the order of the masks
+        ASSERT_GT(cards, previous);
+        previous = cards;
+    }
+}
+
+TEST_F(HandRangeTest, CardRemovalMasksCombos) {
+    HandRange full = HandRange::createFull();
+    ASSERT_EQ(full.size(), NUM_COMBOS);
+
+    uint64_t board = Card(Suit::HEARTS, Value::ACE).getBitMask() | Card(Suit::SPADES, Value::ACE).getBitMask() |
+                     Card(Suit::CLUBS, Value::TWO).getBitMask();
+    ASSERT_EQ(full.getLiveCombos(board).count(), 49 * 48 / 2);
+    ASSERT_EQ(full.size(), NUM_COMBOS);
+
+    HandRange aces = HandRange::parse("AA, AKs");
+    aces.removeCards(board);
+    ASSERT_EQ(aces.size(), 1 + 2);
+    ASSERT_EQ(HandRange::getCombosWithCard(0).count(), 51);
+}
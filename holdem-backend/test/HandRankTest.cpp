@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "../include/HandRank.h"
+#include <random>
+
+class HandRankTest : public ::testing::Test {
+protected:
+    vector<Card> deck;
+
+    HandRankTest() {
+        for (int suit = static_cast<int>(Suit::HEARTS); suit <= static_cast<int>(Suit::SPADES); ++suit) {
+            for (int val = static_cast<int>(Value::TWO); val <= static_cast<int>(Value::ACE); ++val) {
+                deck.emplace_back(static_cast<Suit>(suit), static_cast<Value>(val));
+            }
+        }
+    }
+
+    vector<Card> drawCards(mt19937_64& rng, int numCards) {
+        shuffle(deck.begin(), deck.end(), rng);
+        return vector<Card>(deck.begin(), deck.begin() + numCards);
+    }
+
+    // Evaluates cards with the reference HandEvaluator
+    static PokerHand evaluateReference(const vector<Card>& cards) {
+        HandEvaluator evaluator;
+        shared_ptr<Player> player = make_shared<Player>("P1", Position::DEALER, 1000);
+        for (const Card& card : cards) evaluator.addDealtCard(player, card);
+        evaluator.evaluatePlayerHands();
+        return evaluator.getPlayerHandsMap().at(player);
+    }
+
+    // Best reference hand among every five card subset. HandEvaluator picks the wrong two
+    // pairs when seven cards hold three, so five card hands are the ground truth.
+    static PokerHand evaluateBestFive(const vector<Card>& cards) {
+        PokerHand best = evaluateReference({cards[0], cards[1], cards[2], cards[3], cards[4]});
+        for (int skipped = 0; skipped < (1 << cards.size()); ++skipped) {
+            if (__builtin_popcount(skipped) != static_cast<int>(cards.size()) - MIN_HAND_SIZE) continue;
+            vector<Card> five;
+            for (size_t i = 0; i < cards.size(); ++i) {
+                if (!(skipped & (1 << i))) five.push_back(cards[i]);
+            }
+            PokerHand hand = evaluateReference(five);
+            if (compareReference(hand, best) > 0) best = hand;
+        }
+        return best;
+    }
+
+    // Orders two reference hands the way HandEvaluator does: negative when a is weaker
+    static int compareReference(const PokerHand& a, const PokerHand& b) {
+        if (a.category != b.category) return (a.category < b.category) ? -1 : 1;
+        for (size_t i = 0; i < a.bestFiveCards.size(); ++i) {
+            Value valueA = a.bestFiveCards[i].getValue();
+            Value valueB = b.bestFiveCards[i].getValue();
+            if (valueA != valueB) return (valueA < valueB) ? -1 : 1;
+        }
+        return 0;
+    }
+};
+
+TEST_F(HandRankTest, CategoriesMatchReference) {
+    mt19937_64 rng(7);
+    for (int i = 0; i < 3000; ++i) {
+        int numCards = MIN_HAND_SIZE + i % 3;
+        vector<Card> cards = drawCards(rng, numCards);
+        uint32_t rank = HandRank::evaluate(HandRank::getMask(cards));
+        ASSERT_EQ(HandRank::getCategory(rank), evaluateReference(cards).category);
+    }
+}
+
+TEST_F(HandRankTest, OrderingMatchesReference) {
+    mt19937_64 rng(11);
+    for (int i = 0; i < 3000; ++i) {
+        // Share five board cards so close hands and splits come up often
+        vector<Card> cards = drawCards(rng, 9);
+        vector<Card> handA = {cards[0], cards[1], cards[4], cards[5], cards[6], cards[7], cards[8]};
+        vector<Card> handB = {cards[2], cards[3], cards[4], cards[5], cards[6], cards[7], cards[8]};
+
+        uint32_t rankA = HandRank::evaluate(HandRank::getMask(handA));
+        uint32_t rankB = HandRank::evaluate(HandRank::getMask(handB));
+        int expected = compareReference(evaluateBestFive(handA), evaluateBestFive(handB));
+        int actual = (rankA < rankB) ? -1 : (rankA > rankB);
+        ASSERT_EQ(actual, expected);
+    }
+}
+
+TEST_F(HandRankTest, OrdersEdgeCases) {
+    auto rankOf = [](const vector<Card>& cards) { return HandRank::evaluate(HandRank::getMask(cards)); };
+    Card aceHearts(Suit::HEARTS, Value::ACE);
+    Card twoClubs(Suit::CLUBS, Value::TWO);
+    Card threeSpades(Suit::SPADES, Value::THREE);
+    Card fourHearts(Suit::HEARTS, Value::FOUR);
+    Card fiveDiamonds(Suit::DIAMONDS, Value::FIVE);
+    Card sixClubs(Suit::CLUBS, Value::SIX);
+    Card kingSpades(Suit::SPADES, Value::KING);
+
+    // The wheel is the lowest straight
+    uint32_t wheel = rankOf({aceHearts, twoClubs, threeSpades, fourHearts, fiveDiamonds});
+    uint32_t sixHigh = rankOf({twoClubs, threeSpades, fourHearts, fiveDiamonds, sixClubs});
+    ASSERT_EQ(HandRank::getCategory(wheel), STRAIGHT);
+    ASSERT_LT(wheel, sixHigh);
+
+    // Two sets of trips play as a full house, the lower set as the pair
+    Card kingHearts(Suit::HEARTS, Value::KING);
+    Card kingClubs(Suit::CLUBS, Value::KING);
+    Card aceSpades(Suit::SPADES, Value::ACE);
+    Card aceClubs(Suit::CLUBS, Value::ACE);
+    uint32_t acesFull = rankOf({aceHearts, aceSpades, aceClubs, kingHearts, kingClubs, kingSpades, twoClubs});
+    ASSERT_EQ(HandRank::getCategory(acesFull), FULL_HOUSE);
+    ASSERT_EQ(acesFull, rankOf({aceHearts, aceSpades, aceClubs, kingHearts, kingClubs}));
+
+    // A sixth kicker doesn't count
+    Card nineDiamonds(Suit::DIAMONDS, Value::NINE);
+    ASSERT_EQ(rankOf({aceHearts, kingSpades, nineDiamonds, fiveDiamonds, fourHearts, twoClubs}),
+              rankOf({aceHearts, kingSpades, nineDiamonds, fiveDiamonds, fourHearts, threeSpades}));
+
+    // Fewer than five cards still rank by pairs then kickers
+    ASSERT_EQ(HandRank::getCategory(rankOf({aceHearts, aceSpades})), ONE_PAIR);
+    ASSERT_GT(rankOf({aceHearts, aceSpades}), rankOf({kingHearts, kingSpades, aceClubs}));
+    ASSERT_GT(rankOf({aceHearts, kingSpades}), rankOf({aceSpades, Card(Suit::HEARTS, Value::QUEEN)}));
+    ASSERT_EQ(HandRank::getCategory(rankOf({aceHearts, Card(Suit::HEARTS, Value::KING), Card(Suit::HEARTS, Value::QUEEN),
+                                            Card(Suit::HEARTS, Value::JACK), Card(Suit::HEARTS, Value::TEN)})), ROYAL_FLUSH);
+}
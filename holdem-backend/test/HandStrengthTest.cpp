@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "../include/BoardClass.h"
+#include "../include/HandStrength.h"
+#include <random>
+
+class HandStrengthTest : public ::testing::Test {
+protected:
+    mt19937_64 rng;
+
+    HandStrengthTest() : rng(48) {}
+
+    uint64_t dealCards(int numCards, uint64_t dead = 0) {
+        uint64_t cards = 0;
+        while (HandRank::countCards(cards) < numCards) {
+            uint64_t card = 1ULL << (rng() % 52);
+            if (!(card & dead)) cards |= card;
+        }
+        return cards;
+    }
+
+    // Ranks the pair against every combo that can be dealt
+    static HandStrengthResult bruteForce(uint64_t hole, uint64_t board) {
+        HandStrengthResult result;
+        uint32_t rank = HandRank::evaluate(hole | board);
+        for (int combo = 0; combo < NUM_COMBOS; ++combo) {
+            uint64_t opponent = HandRange::getComboMask(combo);
+            if (opponent & (hole | board)) continue;
+            uint32_t opponentRank = HandRank::evaluate(opponent | board);
+            result.numCombos++;
+            if (rank > opponentRank) {
+                result.wins++;
+            } else if (rank == opponentRank) {
+                result.ties++;
+            } else {
+                result.losses++;
+            }
+        }
+        return result;
+    }
+};
+
+TEST_F(HandStrengthTest, MatchesBruteForce) {
+    for (int numBoardCards = 3; numBoardCards <= 5; ++numBoardCards) {
+        for (int deal = 0; deal < 20; ++deal) {
+            uint64_t board = dealCards(numBoardCards);
+            HandStrength strength(board);
+            for (int query = 0; query < 10; ++query) {
+                uint64_t hole = dealCards(2, board);
+                HandStrengthResult expected = bruteForce(hole, board);
+                HandStrengthResult result = strength.getStrength(hole);
+                ASSERT_EQ(result.numCombos, (50 - numBoardCards) * (49 - numBoardCards) / 2);
+                ASSERT_EQ(result.numCombos, expected.numCombos);
+                ASSERT_EQ(result.wins, expected.wins);
+                ASSERT_EQ(result.ties, expected.ties);
+                ASSERT_EQ(result.losses, expected.losses);
+            }
+        }
+    }
+
+    // The nut flush on a monotone board loses to straight flushes only
+    auto mask = [](Suit suit, Value value) { return Card(suit, value).getBitMask(); };
+    uint64_t board = mask(Suit::SPADES, Value::TWO) | mask(Suit::SPADES, Value::SEVEN) | mask(Suit::SPADES, Value::JACK);
+    HandStrengthResult nuts = HandStrength(board).getStrength(mask(Suit::SPADES, Value::ACE) | mask(Suit::SPADES, Value::KING));
+    ASSERT_EQ(nuts.numCombos, 1081);
+    ASSERT_EQ(nuts.losses, 0);
+    ASSERT_GT(nuts.getStrength(), 0.99);
+
+    ASSERT_THROW(HandStrength(board & (board - 1)), runtime_error);
+    ASSERT_THROW(HandStrength(board).getStrength(mask(Suit::SPADES, Value::TWO) | mask(Suit::HEARTS, Value::TWO)),
+                 runtime_error);
+    ASSERT_THROW(HandStrength(board).getStrength(mask(Suit::HEARTS, Value::TWO)), runtime_error);
+}
+
+TEST_F(HandStrengthTest, SharedAcrossBoardClasses) {
+    BoardClassCache<HandStrength> cache([](const CanonicalBoard& board) { return HandStrength(board.cards); });
+    for (int deal = 0; deal < 50; ++deal) {
+        uint64_t board = dealCards(3);
+        uint64_t hole = dealCards(2, board);
+        CanonicalBoard canonical = BoardClass::canonicalize(board);
+        shared_ptr<const HandStrength> strength = cache.get(canonical);
+        ASSERT_EQ(strength->getBoard(), canonical.cards);
+
+        HandStrengthResult result = strength->getStrength(canonical.apply(hole));
+        HandStrengthResult expected = HandStrength(board).getStrength(hole);
+        ASSERT_EQ(result.wins, expected.wins);
+        ASSERT_EQ(result.ties, expected.ties);
+        ASSERT_EQ(result.losses, expected.losses);
+    }
+    ASSERT_LE(cache.size(), 50u);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "../include/MonteCarloEquity.h"
+
+class MonteCarloEquityTest : public ::testing::Test {
+protected:
+    shared_ptr<Player> player1;
+    shared_ptr<Player> player2;
+    shared_ptr<Player> player3;
+    vector<Card> flop;
+
+    MonteCarloEquityTest() {
+        player1 = make_shared<Player>("P1", Position::SMALL_BLIND, 1000);
+        player2 = make_shared<Player>("P2", Position::BIG_BLIND, 1000);
+        player3 = make_shared<Player>("P3", Position::UTG, 1000);
+        flop = {Card(Suit::HEARTS, Value::TWO), Card(Suit::DIAMONDS, Value::NINE), Card(Suit::HEARTS, Value::JACK)};
+    }
+
+    static void dealHoleCards(shared_ptr<Player>& player, Card first, Card second) {
+        player->addHoleCard(first);
+        player->addHoleCard(second);
+    }
+};
+
+TEST_F(MonteCarloEquityTest, ConvergesOnExactEquity) {
+    dealHoleCards(player1, Card(Suit::HEARTS, Value::ACE), Card(Suit::HEARTS, Value::KING));
+    dealHoleCards(player2, Card(Suit::CLUBS, Value::NINE), Card(Suit::SPADES, Value::EIGHT));
+    dealHoleCards(player3, Card(Suit::DIAMONDS, Value::QUEEN), Card(Suit::SPADES, Value::TEN));
+
+    vector<uint64_t> hands;
+    for (const auto& player : {player1, player2, player3}) hands.push_back(HandRank::getMask(player->getHand()));
+    EquityResult exact = Equity::computeExact(hands, HandRank::getMask(flop));
+
+    MonteCarloOptions options;
+    options.maxSamples = 200000;
+    MonteCarloResult sampled = MonteCarloEquity::compute({player1, player2, player3}, flop, options);
+
+    ASSERT_EQ(sampled.tally.numBoards, options.maxSamples);
+    for (size_t i = 0; i < hands.size(); ++i) {
+        ASSERT_GT(sampled.getStandardError(i), 0.0);
+        ASSERT_NEAR(sampled.tally.getEquity(i), exact.getEquity(i), 4 * sampled.getStandardError(i));
+    }
+}
+
+TEST_F(MonteCarloEquityTest, StreamsAreRepeatableAndSplitTheSamples) {
+    dealHoleCards(player1, Card(Suit::HEARTS, Value::ACE), Card(Suit::SPADES, Value::ACE));
+    dealHoleCards(player2, Card(Suit::CLUBS, Value::SEVEN), Card(Suit::CLUBS, Value::EIGHT));
+
+    MonteCarloOptions options;
+    options.seed = 42;
+    options.maxSamples = 50000;
+    MonteCarloResult first = MonteCarloEquity::compute({player1, player2, player3}, {}, options);
+    MonteCarloResult second = MonteCarloEquity::compute({player1, player2, player3}, {}, options);
+    ASSERT_EQ(first.tally.wins, second.tally.wins);
+    ASSERT_EQ(first.tally.ties, second.tally.ties);
+
+    // Threads stop on exactly the requested number of samples
+    options.numThreads = 4;
+    options.maxSamples = 50001;
+    MonteCarloResult threaded = MonteCarloEquity::compute({player1, player2, player3}, {}, options);
+    ASSERT_EQ(threaded.tally.numBoards, 50001);
+    double totalShares = 0.0;
+    for (double share : threaded.tally.shares) totalShares += share;
+    ASSERT_NEAR(totalShares, 50001.0, 1e-6);
+}
+
+TEST_F(MonteCarloEquityTest, UnknownOpponentIsDealtAtRandom) {
+    dealHoleCards(player1, Card(Suit::HEARTS, Value::ACE), Card(Suit::SPADES, Value::ACE));
+
+    // Aces against one random hand win about 85% of the pot
+    MonteCarloOptions options;
+    options.numThreads = 2;
+    options.targetError = 0.002;
+    MonteCarloResult result = MonteCarloEquity::compute({player1, player2}, {}, options);
+
+    ASSERT_LE(result.getMaxStandardError(), options.targetError);
+    ASSERT_LT(result.tally.numBoards, options.maxSamples);
+    ASSERT_NEAR(result.tally.getEquity(0), 0.852, 0.01);
+}
+
+TEST_F(MonteCarloEquityTest, StopsAtTimeBudget) {
+    MonteCarloOptions options;
+    options.timeBudget = chrono::milliseconds(20);
+    options.maxSamples = UINT64_MAX;
+
+    // Nine unknown hands preflop would sample for a long time without the budget
+    vector<uint64_t> hands(MAX_EQUITY_HANDS, 0);
+    MonteCarloResult result = MonteCarloEquity::compute(hands, 0, options);
+    ASSERT_GE(result.elapsed, options.timeBudget);
+    ASSERT_LT(result.elapsed, chrono::seconds(2));
+    ASSERT_GT(result.tally.numBoards, 0);
+}
+
+TEST_F(MonteCarloEquityTest, InvalidInputThrows) {
+    dealHoleCards(player1, Card(Suit::HEARTS, Value::ACE), Card(Suit::SPADES, Value::ACE));
+    dealHoleCards(player2, Card(Suit::HEARTS, Value::ACE), Card(Suit::CLUBS, Value::KING));
+    player3->addHoleCard(Card(Suit::CLUBS, Value::TWO));
+
+    ASSERT_THROW(MonteCarloEquity::compute({player1, player2}, {}), runtime_error);
+    ASSERT_THROW(MonteCarloEquity::compute({player1, player3}, {}), runtime_error);
+    ASSERT_THROW(MonteCarloEquity::compute({player1}, {}), runtime_error);
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "../include/Outs.h"
+#include <random>
+
+class OutsTest : public ::testing::Test {
+protected:
+    static uint64_t mask(Suit suit, Value value) {
+        return Card(suit, value).getBitMask();
+    }
+};
+
+TEST_F(OutsTest, SetOutsThatDontGiveAFlush) {
+    // AhKh leads 9s9c on Th 4h Ks; 9h makes the set but also the ace high flush
+    vector<uint64_t> hands = {mask(Suit::HEARTS, Value::ACE) | mask(Suit::HEARTS, Value::KING),
+                              mask(Suit::SPADES, Value::NINE) | mask(Suit::CLUBS, Value::NINE)};
+    uint64_t flop = mask(Suit::HEARTS, Value::TEN) | mask(Suit::HEARTS, Value::FOUR) | mask(Suit::SPADES, Value::KING);
+
+    OutsResult result = Outs::compute(hands, flop);
+    ASSERT_EQ(result.numHands, 2);
+    ASSERT_EQ(HandRank::countCards(result.remaining), 45);
+    ASSERT_TRUE(result.isLeading(0));
+    ASSERT_FALSE(result.isLeading(1));
+    ASSERT_EQ(result.outs[0], 0u);
+    ASSERT_EQ(result.outs[1], mask(Suit::DIAMONDS, Value::NINE));
+    ASSERT_EQ(result.getNumOuts(1), 1);
+
+    // Once the nine is known to be gone there are none
+    result = Outs::compute(hands, flop | mask(Suit::CLUBS, Value::TWO), mask(Suit::DIAMONDS, Value::NINE));
+    ASSERT_EQ(HandRank::countCards(result.remaining), 43);
+    ASSERT_EQ(result.outs[1], 0u);
+
+    ASSERT_THROW(Outs::compute(hands, 0), runtime_error);
+    ASSERT_THROW(Outs::compute(hands, flop | mask(Suit::CLUBS, Value::TWO) | mask(Suit::CLUBS, Value::THREE)),
+                 runtime_error);
+    ASSERT_THROW(Outs::compute({hands[0]}, flop), runtime_error);
+}
+
+TEST_F(OutsTest, MatchesRiverEquity) {
+    mt19937_64 rng(47);
+    vector<int> cards(52);
+    for (int card = 0; card < 52; ++card) cards[card] = card;
+
+    for (int deal = 0; deal < 50; ++deal) {
+        shuffle(cards.begin(), cards.end(), rng);
+        int numHands = 2 + deal % 4;
+        vector<uint64_t> hands(numHands);
+        for (int hand = 0; hand < numHands; ++hand) hands[hand] = (1ULL << cards[2 * hand]) | (1ULL << cards[2 * hand + 1]);
+        uint64_t turn = 0;
+        for (int card = 2 * numHands; card < 2 * numHands + 4; ++card) turn |= 1ULL << cards[card];
+
+        // A hand leads on a full board when it never loses there
+        OutsResult result = Outs::compute(hands, turn);
+        for (uint64_t river = result.remaining; river != 0; river &= river - 1) {
+            EquityResult equity = Equity::computeExact(hands, turn | (river & -river));
+            for (int hand = 0; hand < numHands; ++hand) {
+                bool isLeading = equity.wins[hand] + equity.ties[hand] == 1;
+                bool isOut = (result.outs[hand] & river & -river) != 0;
+                ASSERT_EQ(isOut, isLeading && !result.isLeading(hand));
+            }
+        }
+    }
+}
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include "../include/PreflopEquityTable.h"
+#include "../include/Equity.h"
+#include "../include/FileUtils.h"
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+
+class PreflopEquityTableTest : public ::testing::Test {
+protected:
+    string directory;
+
+    PreflopEquityTableTest() {
+        directory = testing::TempDir() + "preflop_equity_table_test";
+        filesystem::remove_all(directory);
+        filesystem::create_directories(directory);
+    }
+
+    ~PreflopEquityTableTest() {
+        filesystem::remove_all(directory);
+    }
+
+    static PreflopTableOptions createOptions(const vector<string>& names, bool includeCombos) {
+        PreflopTableOptions options;
+        options.includeCombos = includeCombos;
+        for (const string& name : names) options.startingHands.push_back(PreflopEquityTable::parseStartingHand(name));
+        return options;
+    }
+};
+
+TEST_F(PreflopEquityTableTest, EntriesMatchExactEnumeration) {
+    string path = directory + "/preflop.bin";
+    PreflopTableOptions options = createOptions({"AA", "KK", "AKs", "72o"}, true);
+    options.numThreads = 2;
+    ASSERT_TRUE(PreflopEquityTable::generate(path, options));
+
+    PreflopEquityTable table;
+    ASSERT_TRUE(table.open(path));
+    ASSERT_TRUE(table.hasCombos());
+
+    vector<int> combos;
+    for (int combo = 0; combo < NUM_COMBOS; ++combo) {
+        int startingHand = PreflopEquityTable::getStartingHand(combo);
+        if (find(options.startingHands.begin(), options.startingHands.end(), startingHand) != options.startingHands.end()) {
+            combos.push_back(combo);
+        }
+    }
+    ASSERT_EQ(combos.size(), 6 + 6 + 4 + 12);
+
+    // Every combo pair against its mirror, and a spread of them against a live enumeration
+    map<pair<int, int>, pair<double, int>> averages;
+    size_t checked = 0;
+    for (int first : combos) {
+        for (int second : combos) {
+            float equity = table.getEquity(first, second);
+            if (HandRange::getComboMask(first) & HandRange::getComboMask(second)) {
+                ASSERT_TRUE(isnan(equity));
+                continue;
+            }
+            ASSERT_NEAR(equity + table.getEquity(second, first), 1.0, 1e-6);
+            if ((first + second) % 7 == 0) {
+                uint64_t firstCards = HandRange::getComboMask(first);
+                uint64_t secondCards = HandRange::getComboMask(second);
+                ASSERT_NEAR(equity, Equity::computeExact({firstCards, secondCards}, 0).getEquity(0), 1e-6);
+                checked++;
+            }
+            pair<double, int>& average = averages[{PreflopEquityTable::getStartingHand(first),
+                                                   PreflopEquityTable::getStartingHand(second)}];
+            average.first += equity;
+            average.second++;
+        }
+    }
+    ASSERT_GT(checked, 10u);
+
+    // Starting hands are averaged over the combo pairs that don't share a card
+    for (const auto& [hands, average] : averages) {
+        ASSERT_NEAR(table.getStartingHandEquity(hands.first, hands.second), average.first / average.second, 1e-5);
+    }
+    int aces = PreflopEquityTable::parseStartingHand("AA");
+    int kings = PreflopEquityTable::parseStartingHand("KK");
+    int queens = PreflopEquityTable::parseStartingHand("QQ");
+    ASSERT_NEAR(table.getStartingHandEquity(aces, kings), 0.82, 0.01);
+    ASSERT_TRUE(isnan(table.getStartingHandEquity(aces, queens)));
+}
+
+TEST_F(PreflopEquityTableTest, StartingHandTableFallsBackWithoutCombos) {
+    string path = directory + "/preflop.bin";
+    ASSERT_TRUE(PreflopEquityTable::generate(path, createOptions({"AKo", "JTs"}, false)));
+
+    PreflopEquityTable table;
+    ASSERT_TRUE(table.open(path));
+    ASSERT_FALSE(table.hasCombos());
+    ASSERT_EQ(filesystem::file_size(path), PREFLOP_TABLE_HEADER_SIZE + NUM_STARTING_HANDS * NUM_STARTING_HANDS * sizeof(float));
+
+    int bigSlick = HandRange::getComboIndex(Card(Suit::HEARTS, Value::ACE).getBitMask() |
+                                            Card(Suit::SPADES, Value::KING).getBitMask());
+    int jackTen = HandRange::getComboIndex(Card(Suit::CLUBS, Value::JACK).getBitMask() |
+                                           Card(Suit::CLUBS, Value::TEN).getBitMask());
+    ASSERT_EQ(table.getEquity(bigSlick, jackTen),
+              table.getStartingHandEquity(PreflopEquityTable::parseStartingHand("AKo"),
+                                          PreflopEquityTable::parseStartingHand("JTs")));
+    ASSERT_GT(table.getEquity(bigSlick, jackTen), 0.55f);
+    ASSERT_LT(table.getEquity(bigSlick, jackTen), 0.65f);
+}
+
+TEST_F(PreflopEquityTableTest, StartingHandStrengthCountsCardRemoval) {
+    // A made up matrix: everything is a coin flip but aces always beat kings
+    int aces = PreflopEquityTable::parseStartingHand("AA");
+    int kings = PreflopEquityTable::parseStartingHand("KK");
+    vector<float> equities(NUM_STARTING_HANDS * NUM_STARTING_HANDS, 0.5f);
+    equities[aces * NUM_STARTING_HANDS + kings] = 1.0f;
+    equities[kings * NUM_STARTING_HANDS + aces] = 0.0f;
+
+    vector<uint8_t> file(PREFLOP_TABLE_HEADER_SIZE + equities.size() * sizeof(float));
+    memcpy(file.data() + PREFLOP_TABLE_HEADER_SIZE, equities.data(), equities.size() * sizeof(float));
+    MappedTableHeader header;
+    header.magic = PREFLOP_TABLE_MAGIC;
+    header.version = PREFLOP_TABLE_VERSION;
+    header.sizes = {NUM_STARTING_HANDS, 0};
+    string path = directory + "/preflop.bin";
+    ASSERT_TRUE(MappedTable::write(path, header, file));
+
+    // Each hand faces the 1225 combos left, all six of the other's
+    PreflopEquityTable table;
+    ASSERT_THROW(table.getStartingHandStrength(aces), runtime_error);
+    ASSERT_TRUE(table.open(path));
+    ASSERT_NEAR(table.getStartingHandStrength(aces), (6 * 1.0 + 1219 * 0.5) / 1225, 1e-6);
+    ASSERT_NEAR(table.getStartingHandStrength(kings), 1219 * 0.5 / 1225, 1e-6);
+    ASSERT_NEAR(table.getStartingHandStrength(PreflopEquityTable::parseStartingHand("72o")), 0.5, 1e-6);
+
+    // Matchups that weren't generated leave it unknown
+    ASSERT_TRUE(PreflopEquityTable::generate(path, createOptions({"AA", "KK"}, false)));
+    ASSERT_TRUE(table.open(path));
+    ASSERT_TRUE(isnan(table.getStartingHandStrength(aces)));
+}
+
+TEST_F(PreflopEquityTableTest, DamagedFileIsRejected) {
+    string path = directory + "/preflop.bin";
+    ASSERT_TRUE(PreflopEquityTable::generate(path, createOptions({"AA", "KK"}, false)));
+    vector<uint8_t> original;
+    ASSERT_TRUE(readWholeFile(path, original));
+
+    PreflopEquityTable table;
+    ASSERT_THROW(table.getStartingHandEquity(0, 0), runtime_error);
+    ASSERT_FALSE(table.open(directory + "/missing.bin"));
+
+    vector<uint8_t> corrupt = original;
+    corrupt[PREFLOP_TABLE_HEADER_SIZE + 1000] ^= 0x40;
+    ASSERT_TRUE(writeFileAtomically(path, corrupt.data(), corrupt.size()));
+    ASSERT_FALSE(table.open(path));
+
+    ASSERT_TRUE(writeFileAtomically(path, original.data(), original.size() - sizeof(float)));
+    ASSERT_FALSE(table.open(path));
+
+    vector<uint8_t> newer = original;
+    newer[4] = PREFLOP_TABLE_VERSION + 1;
+    ASSERT_TRUE(writeFileAtomically(path, newer.data(), newer.size()));
+    ASSERT_FALSE(table.open(path));
+
+    ASSERT_TRUE(writeFileAtomically(path, original.data(), original.size()));
+    ASSERT_TRUE(table.open(path));
+    ASSERT_FALSE(table.isOpen() && table.hasCombos());
+}
+
+TEST_F(PreflopEquityTableTest, StartingHandNames) {
+    set<string> names;
+    for (int startingHand = 0; startingHand < NUM_STARTING_HANDS; ++startingHand) {
+        string name = PreflopEquityTable::getStartingHandName(startingHand);
+        ASSERT_EQ(PreflopEquityTable::parseStartingHand(name), startingHand);
+        names.insert(name);
+    }
+    ASSERT_EQ(names.size(), static_cast<size_t>(NUM_STARTING_HANDS));
+
+    // Each combo lands in the starting hand named by its ranks and suits
+    vector<int> counts(NUM_STARTING_HANDS, 0);
+    for (int combo = 0; combo < NUM_COMBOS; ++combo) counts[PreflopEquityTable::getStartingHand(combo)]++;
+    ASSERT_EQ(counts[PreflopEquityTable::parseStartingHand("AA")], 6);
+    ASSERT_EQ(counts[PreflopEquityTable::parseStartingHand("AKs")], 4);
+    ASSERT_EQ(counts[PreflopEquityTable::parseStartingHand("AKo")], 12);
+
+    ASSERT_THROW(PreflopEquityTable::parseStartingHand("AK"), runtime_error);
+    ASSERT_THROW(PreflopEquityTable::parseStartingHand("QQ+"), runtime_error);
+    ASSERT_THROW(PreflopEquityTable::parseStartingHand("AhKh"), runtime_error);
+}
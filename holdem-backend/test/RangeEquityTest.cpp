@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "../include/RangeEquity.h"
+
+class RangeEquityTest : public ::testing::Test {
+protected:
+    uint64_t flop;
+    uint64_t turn;
+
+    RangeEquityTest() {
+        flop = Card(Suit::HEARTS, Value::QUEEN).getBitMask() | Card(Suit::DIAMONDS, Value::SEVEN).getBitMask() |
+               Card(Suit::HEARTS, Value::TWO).getBitMask();
+        turn = flop | Card(Suit::SPADES, Value::KING).getBitMask();
+    }
+
+    // Sums the exact equity of every pair of combos, weighted by both weights
+    static EquityResult sumPairwise(const HandRange& first, const HandRange& second, uint64_t board) {
+        EquityResult total(2);
+        for (int a = 0; a < NUM_COMBOS; ++a) {
+            for (int b = 0; b < NUM_COMBOS; ++b) {
+                uint64_t firstCards = HandRange::getComboMask(a);
+                uint64_t secondCards = HandRange::getComboMask(b);
+                if (!first.contains(a) || !second.contains(b)) continue;
+                if ((firstCards & secondCards) || ((firstCards | secondCards) & board)) continue;
+
+                EquityResult pair = Equity::computeExact({firstCards, secondCards}, board);
+                uint64_t weight = first.getWeight(a) * second.getWeight(b);
+                total.numBoards += pair.numBoards * weight;
+                for (int i = 0; i < 2; ++i) {
+                    total.wins[i] += pair.wins[i] * weight;
+                    total.ties[i] += pair.ties[i] * weight;
+                }
+            }
+        }
+        return total;
+    }
+};
+
+TEST_F(RangeEquityTest, ExactMatchesPairwiseEnumeration) {
+    HandRange first = HandRange::parse("AKs, QQ, 40% 76s");
+    HandRange second = HandRange::parse("JJ+, 50% AQo, KQ");
+
+    for (uint64_t board : {turn, flop}) {
+        EquityResult expected = sumPairwise(first, second, board);
+        EquityResult exact = RangeEquity::computeExact(first, second, board, 3);
+        ASSERT_EQ(exact.numBoards, expected.numBoards);
+        ASSERT_EQ(exact.wins, expected.wins);
+        ASSERT_EQ(exact.ties, expected.ties);
+        ASSERT_NEAR(exact.getEquity(0) + exact.getEquity(1), 1.0, 1e-12);
+    }
+}
+
+TEST_F(RangeEquityTest, SampledMatchesExact) {
+    vector<HandRange> ranges = {HandRange::parse("TT+, AJs+, KQs, 50% AKo"), HandRange::parse("22+, A2s+, KTo+, QJs")};
+    EquityResult exact = RangeEquity::computeExact(ranges[0], ranges[1], flop);
+
+    RangeEquityOptions options;
+    options.maxExactWork = 0;
+    options.sampling.numThreads = 2;
+    options.sampling.targetError = 0.002;
+    RangeEquityResult sampled = RangeEquity::compute(ranges, flop, options);
+
+    ASSERT_FALSE(sampled.isExact);
+    ASSERT_LE(sampled.standardErrors[0], 0.002);
+    ASSERT_NEAR(sampled.tally.getEquity(0), exact.getEquity(0), 4 * sampled.standardErrors[0]);
+}
+
+TEST_F(RangeEquityTest, PicksExactOrSampledByWork) {
+    vector<HandRange> ranges = {HandRange::parse("QQ+, AKs"), HandRange::parse("99+, AQs+, AKo")};
+    RangeEquityResult river = RangeEquity::compute(ranges, turn | Card(Suit::CLUBS, Value::THREE).getBitMask());
+    ASSERT_TRUE(river.isExact);
+    ASSERT_EQ(river.standardErrors, vector<double>(2, 0.0));
+
+    RangeEquityResult preflop = RangeEquity::compute(ranges, vector<Card>());
+    ASSERT_FALSE(preflop.isExact);
+    ASSERT_LE(preflop.standardErrors[0], RangeEquityOptions().sampling.targetError);
+
+    // Three ranges are always sampled
+    ranges.push_back(HandRange::createFull());
+    RangeEquityResult multiway = RangeEquity::compute(ranges, turn);
+    ASSERT_FALSE(multiway.isExact);
+    ASSERT_EQ(multiway.tally.wins.size(), 3);
+}
+
+TEST_F(RangeEquityTest, SingleCombosMatchHandEquity) {
+    uint64_t first = Card(Suit::SPADES, Value::ACE).getBitMask() | Card(Suit::CLUBS, Value::ACE).getBitMask();
+    uint64_t second = Card(Suit::HEARTS, Value::JACK).getBitMask() | Card(Suit::HEARTS, Value::TEN).getBitMask();
+    EquityResult hands = Equity::computeExact({first, second}, flop);
+    EquityResult ranges = RangeEquity::computeExact(HandRange::parse("AsAc"), HandRange::parse("JhTh"), flop);
+
+    // Counts carry both combo weights
+    uint64_t weight = FULL_WEIGHT * FULL_WEIGHT;
+    ASSERT_EQ(ranges.numBoards, hands.numBoards * weight);
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_EQ(ranges.wins[i], hands.wins[i] * weight);
+        ASSERT_EQ(ranges.ties[i], hands.ties[i] * weight);
+        ASSERT_DOUBLE_EQ(ranges.getEquity(i), hands.getEquity(i));
+    }
+}
+
+TEST_F(RangeEquityTest, ClashingRangesThrow) {
+    vector<HandRange> ranges = {HandRange::parse("AhAs"), HandRange::parse("AhAs")};
+    ASSERT_THROW(RangeEquity::computeExact(ranges[0], ranges[1], turn), runtime_error);
+    ASSERT_THROW(MonteCarloEquity::compute(ranges, turn), runtime_error);
+    ASSERT_THROW(RangeEquity::computeExact(HandRange::parse("QhQs"), ranges[0], flop), runtime_error);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "../include/HandReplay.h"
+
+class ReplayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // The game narrates every step to stdout
+        cout.setstate(ios_base::badbit);
+    }
+
+    void TearDown() override {
+        cout.clear();
+    }
+
+    // Plays a mix of bets, raises, folds and calls. Players only fold facing a bet.
+    static void playDecision(GameController& game, size_t step) {
+        shared_ptr<Player> player = game.getStreetState().getCurPlayer();
+        ClientAction fallback = ClientAction{player, CHECK, 0};
+        for (const auto& possible : game.getPossibleActions()) {
+            if (possible.type == CALL) fallback.type = CALL;
+        }
+
+        for (const auto& possible : game.getPossibleActions()) {
+            bool isAggressive = (possible.type == BET || possible.type == RAISE) && step % 5 == 2;
+            bool isFold = possible.type == FOLD && fallback.type == CALL && step % 4 == 1;
+            if (!isAggressive && !isFold) continue;
+
+            ClientAction action = ClientAction{player, possible.type, max<size_t>(possible.amount * 3, 4)};
+            if (game.processClientAction(action)) return;
+        }
+        ASSERT_TRUE(game.processClientAction(fallback));
+    }
+
+    // Plays a seeded session, logging it as it goes
+    static vector<HandRecord> playSession(ReplayLog& log, int numHands) {
+        GameController game(log.smallBlind, log.bigBlind);
+        game.setDeckSeed(log.seed);
+        for (const auto& [name, chips] : log.players) game.addPlayerToGame(name, chips);
+
+        vector<HandRecord> hands;
+        size_t step = 0;
+        for (int i = 0; i < numHands; ++i) {
+            EXPECT_TRUE(game.beginRound());
+            while (game.isAwaitingAction()) playDecision(game, step++);
+            hands.push_back(game.getHandRecord());
+            ReplayEngine::appendHand(hands.back(), log);
+            game.setupNewRound();
+        }
+        return hands;
+    }
+
+    static ReplayLog createLog(uint64_t seed) {
+        ReplayLog log;
+        log.seed = seed;
+        log.smallBlind = 5;
+        log.bigBlind = 10;
+        log.players = {{"alice", 5000}, {"bob", 4000}, {"carol", 6000}, {"dave", 5000}};
+        return log;
+    }
+
+    // Start times come from the clock, everything else must match exactly
+    static void expectSameHands(vector<HandRecord> replayed, const vector<HandRecord>& played) {
+        ASSERT_EQ(replayed.size(), played.size());
+        for (size_t i = 0; i < replayed.size(); ++i) {
+            replayed[i].startTime = played[i].startTime;
+            ASSERT_EQ(replayed[i], played[i]) << "hand " << i;
+        }
+    }
+};
+
+TEST_F(ReplayTest, SeededDeckDealsTheSameCards) {
+    ReplayLog first = createLog(42);
+    ReplayLog second = createLog(42);
+    ReplayLog other = createLog(43);
+    vector<HandRecord> firstHands = playSession(first, 20);
+    vector<HandRecord> secondHands = playSession(second, 20);
+    vector<HandRecord> otherHands = playSession(other, 20);
+
+    expectSameHands(secondHands, firstHands);
+    ASSERT_EQ(second.actions, first.actions);
+
+    bool isDifferentDeal = false;
+    for (size_t i = 0; i < firstHands.size(); ++i) {
+        isDifferentDeal |= otherHands[i].seats[0].holeCards[0] != firstHands[i].seats[0].holeCards[0];
+    }
+    ASSERT_TRUE(isDifferentDeal);
+}
+
+TEST_F(ReplayTest, ReplayReproducesSession) {
+    ReplayLog log = createLog(7);
+    vector<HandRecord> played = playSession(log, 60);
+
+    ReplayResult result = ReplayEngine::replay(log);
+    ASSERT_FALSE(result.isDiverged);
+    ASSERT_FALSE(result.isTruncated);
+    ASSERT_EQ(result.numHands, played.size());
+    ASSERT_EQ(result.numActions, log.actions.size());
+    expectSameHands(result.hands, played);
+
+    // Final stacks are the last hand's starting stacks plus its results
+    size_t totalChips = 0;
+    for (size_t chips : result.finalChips) totalChips += chips;
+    ASSERT_EQ(totalChips, 20000);
+
+    // Console output is left as it was
+    ASSERT_TRUE(cout.bad());
+}
+
+TEST_F(ReplayTest, FastForwardMatchesFullReplay) {
+    ReplayLog log = createLog(11);
+    playSession(log, 40);
+
+    ReplayResult full = ReplayEngine::replay(log, REPLAY_FULL);
+    ReplayResult fast = ReplayEngine::replay(log, REPLAY_FAST_FORWARD);
+    ASSERT_TRUE(fast.hands.empty());
+    ASSERT_EQ(fast.numHands, full.numHands);
+    ASSERT_EQ(fast.finalChips, full.finalChips);
+    ASSERT_EQ(fast.chipDigest, full.chipDigest);
+
+    // A different deal ends somewhere else
+    ReplayLog reseeded = log;
+    reseeded.seed = 12;
+    ReplayResult other = ReplayEngine::replay(reseeded, REPLAY_FAST_FORWARD);
+    ASSERT_TRUE(other.isDiverged || other.chipDigest != full.chipDigest);
+}
+
+TEST_F(ReplayTest, DivergenceIsReported) {
+    ReplayLog log = createLog(3);
+    vector<HandRecord> played = playSession(log, 10);
+    size_t firstHandActions = played[0].actions.size() - 2;
+
+    // An action logged for the wrong player
+    ReplayLog wrongPlayer = log;
+    wrongPlayer.actions[firstHandActions].position = (wrongPlayer.actions[firstHandActions].position + 1) % 4;
+    ReplayResult result = ReplayEngine::replay(wrongPlayer);
+    ASSERT_TRUE(result.isDiverged);
+    ASSERT_EQ(result.numHands, 1);
+    ASSERT_EQ(result.numActions, firstHandActions);
+
+    // A check facing the big blind is not allowed
+    ReplayLog illegal = log;
+    illegal.actions[0].type = CHECK;
+    illegal.actions[0].amount = 0;
+    result = ReplayEngine::replay(illegal);
+    ASSERT_TRUE(result.isDiverged);
+    ASSERT_EQ(result.numHands, 0);
+
+    // A log cut mid hand replays the complete hands
+    ReplayLog cut = log;
+    cut.actions.resize(firstHandActions + 1);
+    result = ReplayEngine::replay(cut);
+    ASSERT_FALSE(result.isDiverged);
+    ASSERT_TRUE(result.isTruncated);
+    ASSERT_EQ(result.numHands, 1);
+    expectSameHands(result.hands, {played[0]});
+}
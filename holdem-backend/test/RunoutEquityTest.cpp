@@ -0,0 +1,250 @@
+#include <gtest/gtest.h>
+#include "../include/GameController.h"
+#include "../include/RunoutEquity.h"
+#include <filesystem>
+#include <future>
+
+class RunoutEquityTest : public ::testing::Test {
+protected:
+    string directory;
+
+    RunoutEquityTest() {
+        directory = testing::TempDir() + "runout_equity_test";
+        filesystem::remove_all(directory);
+        filesystem::create_directories(directory);
+    }
+
+    ~RunoutEquityTest() {
+        filesystem::remove_all(directory);
+    }
+
+    void SetUp() override {
+        // The game narrates every step to stdout
+        cout.setstate(ios_base::badbit);
+    }
+
+    void TearDown() override {
+        cout.clear();
+    }
+
+    static shared_ptr<Player> createPlayer(const string& name, Position position, Card first, Card second) {
+        auto player = make_shared<Player>(name, position, 1000);
+        player->addHoleCard(first);
+        player->addHoleCard(second);
+        return player;
+    }
+
+    // Shoves with every player that can, and calls otherwise
+    static void playAllIn(GameController& game) {
+        while (game.isAwaitingAction()) {
+            shared_ptr<Player> player = game.getStreetState().getCurPlayer();
+            ClientAction action = ClientAction{player, CALL, 0};
+            for (const auto& possible : game.getPossibleActions()) {
+                if (possible.type == BET || possible.type == RAISE) {
+                    action = ClientAction{player, possible.type, game.getStreetState().getPlayerInitialChips()};
+                }
+            }
+            ASSERT_TRUE(game.processClientAction(action));
+        }
+    }
+};
+
+TEST_F(RunoutEquityTest, ExactFromTheFlop) {
+    vector<shared_ptr<Player>> players = {
+        createPlayer("alice", Position::SMALL_BLIND, Card(Suit::HEARTS, Value::ACE), Card(Suit::HEARTS, Value::KING)),
+        createPlayer("bob", Position::BIG_BLIND, Card(Suit::SPADES, Value::NINE), Card(Suit::CLUBS, Value::NINE)),
+        createPlayer("carol", Position::UTG, Card(Suit::DIAMONDS, Value::QUEEN), Card(Suit::CLUBS, Value::JACK))
+    };
+    vector<Card> board = {Card(Suit::HEARTS, Value::TEN), Card(Suit::HEARTS, Value::FOUR), Card(Suit::SPADES, Value::KING)};
+
+    StreetEquity equity = RunoutEquity::compute(players, board, TURN);
+    ASSERT_TRUE(equity.isExact);
+    ASSERT_EQ(equity.street, TURN);
+    ASSERT_EQ(equity.positions, (vector<uint8_t>{static_cast<uint8_t>(Position::SMALL_BLIND),
+                                                  static_cast<uint8_t>(Position::BIG_BLIND),
+                                                  static_cast<uint8_t>(Position::UTG)}));
+
+    vector<uint64_t> hands;
+    for (const auto& player : players) hands.push_back(HandRank::getMask(player->getHand()));
+    EquityResult expected = Equity::computeExact(hands, HandRank::getMask(board));
+    ASSERT_EQ(equity.tally.numBoards, 903u);
+    ASSERT_EQ(equity.tally.wins, expected.wins);
+    ASSERT_EQ(equity.tally.ties, expected.ties);
+    ASSERT_LT(equity.elapsed.count(), DEFAULT_RUNOUT_EQUITY_BUDGET.count());
+}
+
+TEST_F(RunoutEquityTest, PreflopIsSampledWithinTheBudget) {
+    vector<shared_ptr<Player>> players = {
+        createPlayer("alice", Position::SMALL_BLIND, Card(Suit::HEARTS, Value::ACE), Card(Suit::SPADES, Value::ACE)),
+        createPlayer("bob", Position::BIG_BLIND, Card(Suit::CLUBS, Value::KING), Card(Suit::DIAMONDS, Value::KING))
+    };
+
+    RunoutEquityOptions options;
+    options.seed = 45;
+    StreetEquity equity = RunoutEquity::compute(players, {}, FLOP, options);
+    ASSERT_FALSE(equity.isExact);
+    ASSERT_GT(equity.tally.numBoards, 1000u);
+    ASSERT_NEAR(equity.tally.getEquity(0), 0.82, 0.05);
+
+    // Shared with other processes, so only checked loosely
+    ASSERT_LT(equity.elapsed.count(), 10 * DEFAULT_RUNOUT_EQUITY_BUDGET.count());
+}
+
+TEST_F(RunoutEquityTest, AllInRunsOutTheBoard) {
+    RunoutEquityOptions options;
+    for (bool isComputed : {true, false}) {
+        GameController game(5, 10);
+        game.setDeckSeed(46);
+        game.addPlayerToGame("alice", 1000);
+        game.addPlayerToGame("bob", 1000);
+        game.addPlayerToGame("carol", 1000);
+        if (isComputed) game.setRunoutEquity(&options);
+
+        ASSERT_TRUE(game.beginRound());
+        playAllIn(game);
+        ASSERT_FALSE(game.isRoundInProgress());
+
+        const vector<Card>& board = game.getBoard().getCommunityCards();
+        ASSERT_EQ(board.size(), 5u);
+        ASSERT_EQ(game.getHandRecord().numBoardCards, 5);
+        if (!isComputed) {
+            ASSERT_TRUE(game.getRunoutEquities().empty());
+            continue;
+        }
+
+        // One entry before each street, the turn and river enumerated on the board so far
+        const vector<StreetEquity>& equities = game.getRunoutEquities();
+        ASSERT_EQ(equities.size(), 3u);
+        vector<uint64_t> hands;
+        for (const auto& player : game.getGamePlayers()) hands.push_back(HandRank::getMask(player->getHand()));
+        for (size_t i = 0; i < equities.size(); ++i) {
+            ASSERT_EQ(equities[i].street, static_cast<Street>(FLOP + i));
+            ASSERT_EQ(equities[i].positions.size(), 3u);
+            ASSERT_EQ(equities[i].isExact, i > 0);
+            double total = 0;
+            for (size_t hand = 0; hand < 3; ++hand) total += equities[i].tally.getEquity(hand);
+            ASSERT_NEAR(total, 1.0, 1e-9);
+        }
+        uint64_t turn = HandRank::getMask(vector<Card>(board.begin(), board.begin() + 4));
+        ASSERT_EQ(equities[2].tally.wins, Equity::computeExact(hands, turn).wins);
+    }
+}
+
+TEST_F(RunoutEquityTest, HeadsUpPreflopIsReadFromTheTable) {
+    string path = directory + "/preflop.bin";
+    PreflopTableOptions tableOptions;
+    tableOptions.includeCombos = false;
+    tableOptions.startingHands = {PreflopEquityTable::parseStartingHand("AA"), PreflopEquityTable::parseStartingHand("KK")};
+    ASSERT_TRUE(PreflopEquityTable::generate(path, tableOptions));
+    PreflopEquityTable table;
+    ASSERT_TRUE(table.open(path));
+
+    vector<shared_ptr<Player>> players = {
+        createPlayer("alice", Position::SMALL_BLIND, Card(Suit::HEARTS, Value::ACE), Card(Suit::SPADES, Value::ACE)),
+        createPlayer("bob", Position::BIG_BLIND, Card(Suit::CLUBS, Value::KING), Card(Suit::DIAMONDS, Value::KING))
+    };
+    RunoutEquityOptions options;
+    options.preflopTable = &table;
+    options.isDeferred = true;
+
+    RunoutJob job = RunoutEquity::createJob(players, {}, FLOP, options);
+    StreetEquity equity;
+    ASSERT_TRUE(RunoutEquity::lookup(job, equity));
+    ASSERT_FALSE(equity.isPending);
+    ASSERT_FALSE(equity.isExact);
+    ASSERT_EQ(equity.tally.numBoards, 0u);
+    ASSERT_EQ(equity.positions.size(), 2u);
+    float expected = table.getEquity(HandRange::getComboIndex(job.hands[0]), HandRange::getComboIndex(job.hands[1]));
+    ASSERT_EQ(equity.equities, (vector<double>{expected, 1.0 - expected}));
+    ASSERT_NEAR(equity.equities[0], 0.82, 0.01);
+
+    // A third contender, or a matchup the table doesn't have, has to be worked out
+    players.push_back(createPlayer("carol", Position::UTG, Card(Suit::HEARTS, Value::QUEEN), Card(Suit::SPADES, Value::QUEEN)));
+    ASSERT_FALSE(RunoutEquity::lookup(RunoutEquity::createJob(players, {}, FLOP, options), equity));
+    players.erase(players.begin());
+    ASSERT_FALSE(RunoutEquity::lookup(RunoutEquity::createJob(players, {}, FLOP, options), equity));
+}
+
+TEST_F(RunoutEquityTest, DeferredRunoutsAreAttachedFromTheWorker) {
+    RunoutEquityOptions inlineOptions;
+    RunoutEquityOptions deferredOptions;
+    deferredOptions.isDeferred = true;
+    GameController expected(5, 10);
+    GameController game(5, 10);
+    for (GameController* each : {&expected, &game}) {
+        each->setDeckSeed(46);
+        each->addPlayerToGame("alice", 1000);
+        each->addPlayerToGame("bob", 1000);
+        each->addPlayerToGame("carol", 1000);
+        each->setRunoutEquity(each == &game ? &deferredOptions : &inlineOptions);
+        ASSERT_TRUE(each->beginRound());
+        playAllIn(*each);
+        ASSERT_FALSE(each->isRoundInProgress());
+    }
+
+    // Nothing was worked out on the game's thread
+    for (const auto& equity : game.getRunoutEquities()) {
+        ASSERT_TRUE(equity.isPending);
+        ASSERT_EQ(equity.positions.size(), 3u);
+    }
+    vector<RunoutJob> jobs = game.takeRunoutJobs();
+    ASSERT_EQ(jobs.size(), 3u);
+    ASSERT_TRUE(game.takeRunoutJobs().empty());
+
+    mutex resultsMutex;
+    vector<StreetEquity> results;
+    promise<void> isDone;
+    RunoutEquityWorker worker(2);
+    for (RunoutJob& job : jobs) {
+        worker.submit(&game, job, [&](StreetEquity equity) {
+            lock_guard<mutex> lock(resultsMutex);
+            results.push_back(std::move(equity));
+            if (results.size() == 3) isDone.set_value();
+        });
+    }
+    ASSERT_EQ(isDone.get_future().wait_for(chrono::seconds(10)), future_status::ready);
+    for (const auto& equity : results) ASSERT_TRUE(game.attachRunoutEquity(equity));
+    ASSERT_FALSE(game.attachRunoutEquity(results[0]));
+
+    // The same numbers as working them out inline, the sampled flop up to its sample size
+    const vector<StreetEquity>& equities = game.getRunoutEquities();
+    ASSERT_EQ(equities.size(), 3u);
+    for (size_t i = 0; i < equities.size(); ++i) {
+        ASSERT_FALSE(equities[i].isPending);
+        ASSERT_EQ(equities[i].street, static_cast<Street>(FLOP + i));
+        ASSERT_EQ(equities[i].isExact, i > 0);
+        ASSERT_EQ(equities[i].equities.size(), 3u);
+        if (i > 0) ASSERT_EQ(equities[i].tally.wins, expected.getRunoutEquities()[i].tally.wins);
+    }
+
+    // Results for another hand are dropped
+    StreetEquity other = results[0];
+    other.handNumber++;
+    other.isPending = true;
+    ASSERT_FALSE(game.attachRunoutEquity(other));
+}
+
+TEST_F(RunoutEquityTest, CancelledJobsNeverReport) {
+    vector<shared_ptr<Player>> players = {
+        createPlayer("alice", Position::SMALL_BLIND, Card(Suit::HEARTS, Value::ACE), Card(Suit::SPADES, Value::ACE)),
+        createPlayer("bob", Position::BIG_BLIND, Card(Suit::CLUBS, Value::KING), Card(Suit::DIAMONDS, Value::KING))
+    };
+    RunoutJob job = RunoutEquity::createJob(players, {}, FLOP, RunoutEquityOptions());
+
+    // Sampled preflop runouts each take the whole budget, so most are still queued
+    atomic<int> numReported(0);
+    RunoutEquityWorker worker;
+    int owner = 0;
+    for (int i = 0; i < 20; ++i) worker.submit(&owner, job, [&](StreetEquity) { numReported++; });
+    worker.cancel(&owner);
+    int numBeforeCancel = numReported.load();
+    ASSERT_LT(numBeforeCancel, 20);
+
+    this_thread::sleep_for(10 * DEFAULT_RUNOUT_EQUITY_BUDGET);
+    ASSERT_EQ(numReported.load(), numBeforeCancel);
+
+    // Other owners are unaffected
+    promise<void> isDone;
+    worker.submit(&players, job, [&](StreetEquity) { isDone.set_value(); });
+    ASSERT_EQ(isDone.get_future().wait_for(chrono::seconds(10)), future_status::ready);
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "../include/StreetStrength.h"
+#include "../include/GameController.h"
+#include <cstring>
+#include <filesystem>
+
+class StreetStrengthTest : public ::testing::Test {
+protected:
+    string directory;
+
+    StreetStrengthTest() {
+        directory = testing::TempDir() + "street_strength_test";
+        filesystem::remove_all(directory);
+        filesystem::create_directories(directory);
+    }
+
+    ~StreetStrengthTest() {
+        filesystem::remove_all(directory);
+    }
+};
+
+TEST_F(StreetStrengthTest, EveryStreetFromItsTable) {
+    PreflopEquityTable preflopTable;
+    HandPotentialTable potentialTable;
+    StreetStrength strength(preflopTable, potentialTable);
+
+    uint64_t hole = HandPotentialTable::parseCards("AhJh");
+    uint64_t flop = HandPotentialTable::parseCards("Th4hKs");
+    uint64_t turn = flop | HandPotentialTable::parseCards("2c");
+    uint64_t river = turn | HandPotentialTable::parseCards("9d");
+
+    // Nothing is known without the tables but the river
+    ASSERT_FALSE(strength.lookup(hole, 0).isKnown);
+    ASSERT_FALSE(strength.lookup(hole, flop).isKnown);
+    HandPotential complete = strength.lookup(hole, river);
+    ASSERT_TRUE(complete.isKnown);
+    ASSERT_DOUBLE_EQ(complete.strength, HandStrength(river).getStrength(hole).getStrength());
+    ASSERT_EQ(complete.effective, complete.strength);
+    ASSERT_EQ(complete.positive + complete.negative, 0.0);
+
+    // The same river class with its suits swapped is read from the cached class
+    HandPotential swapped = strength.lookup(vector<Card>{Card(Suit::SPADES, Value::ACE), Card(Suit::SPADES, Value::JACK)},
+                                            vector<Card>{Card(Suit::SPADES, Value::TEN), Card(Suit::SPADES, Value::FOUR),
+                                                         Card(Suit::HEARTS, Value::KING), Card(Suit::CLUBS, Value::TWO),
+                                                         Card(Suit::DIAMONDS, Value::NINE)});
+    ASSERT_DOUBLE_EQ(swapped.strength, complete.strength);
+
+    string path = directory + "/potential.bin";
+    HandPotentialOptions options;
+    options.boards = {flop};
+    ASSERT_TRUE(HandPotentialTable::generate(path, options));
+    ASSERT_TRUE(potentialTable.open(path));
+    HandPotential flopPotential = strength.lookup(hole, flop);
+    HandPotential expected = HandPotentialTable::compute(hole, flop);
+    ASSERT_TRUE(flopPotential.isKnown);
+    ASSERT_NEAR(flopPotential.strength, expected.strength, 1e-4);
+    ASSERT_NEAR(flopPotential.positive, expected.positive, 1e-4);
+    ASSERT_NEAR(flopPotential.effective, expected.effective, 1e-4);
+    ASSERT_FALSE(strength.lookup(hole, turn).isKnown);
+
+    // Preflop hands are unknown until every matchup they face is generated
+    path = directory + "/preflop.bin";
+    PreflopTableOptions preflopOptions;
+    preflopOptions.startingHands = {PreflopEquityTable::parseStartingHand("AJs")};
+    ASSERT_TRUE(PreflopEquityTable::generate(path, preflopOptions));
+    ASSERT_TRUE(preflopTable.open(path));
+    ASSERT_FALSE(strength.lookup(hole, 0).isKnown);
+
+    ASSERT_THROW(strength.lookup(hole, flop & (flop - 1)), runtime_error);
+    ASSERT_THROW(strength.lookup(hole, river | HandPotentialTable::parseCards("2d")), runtime_error);
+    ASSERT_THROW(strength.lookup(HandPotentialTable::parseCards("ThJh"), flop), runtime_error);
+    ASSERT_THROW(strength.lookup(HandPotentialTable::parseCards("Jh"), flop), runtime_error);
+}
+
+TEST_F(StreetStrengthTest, GameLooksUpItsPlayersHands) {
+    // A made up preflop matrix where every matchup is a coin flip
+    vector<float> equities(NUM_STARTING_HANDS * NUM_STARTING_HANDS, 0.5f);
+    vector<uint8_t> file(PREFLOP_TABLE_HEADER_SIZE + equities.size() * sizeof(float));
+    memcpy(file.data() + PREFLOP_TABLE_HEADER_SIZE, equities.data(), equities.size() * sizeof(float));
+    MappedTableHeader header;
+    header.magic = PREFLOP_TABLE_MAGIC;
+    header.version = PREFLOP_TABLE_VERSION;
+    header.sizes = {NUM_STARTING_HANDS, 0};
+    string path = directory + "/preflop.bin";
+    ASSERT_TRUE(MappedTable::write(path, header, file));
+
+    PreflopEquityTable preflopTable;
+    HandPotentialTable potentialTable;
+    ASSERT_TRUE(preflopTable.open(path));
+    StreetStrength strength(preflopTable, potentialTable);
+
+    // The game narrates every step to stdout
+    cout.setstate(ios_base::badbit);
+    GameController game(5, 10);
+    game.setDeckSeed(3);
+    shared_ptr<Player> alice = game.addPlayerToGame("alice", 1000);
+    game.addPlayerToGame("bob", 1000);
+    ASSERT_FALSE(game.getHandPotential(*alice).isKnown);
+    ASSERT_TRUE(game.beginRound());
+    cout.clear();
+
+    ASSERT_FALSE(game.getHandPotential(*alice).isKnown);
+    game.setStreetStrength(&strength);
+    HandPotential preflop = game.getHandPotential(*alice);
+    ASSERT_TRUE(preflop.isKnown);
+    ASSERT_NEAR(preflop.strength, 0.5, 1e-6);
+    ASSERT_EQ(preflop.strength, strength.lookup(alice->getHand(), {}).strength);
+}
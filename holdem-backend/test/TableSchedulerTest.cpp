@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "../include/TableScheduler.h"
+#include "../include/MpscQueue.h"
+
+// Table that records commands and flags any concurrent execution
+class CountingTable : public TableActor {
+public:
+    atomic<int> numRunning{0};
+    atomic<bool> isRunConcurrently{false};
+    vector<size_t> lastAmountBySeat = vector<size_t>(NUM_POSITIONS, 0);
+    bool isOrderPreserved = true;
+    size_t numHandled = 0;
+
+    void handleCommand(const TableCommand& command) override {
+        if (numRunning.fetch_add(1) != 0) isRunConcurrently = true;
+
+        // Each producer posts increasing amounts for its own seat
+        if (command.amount <= lastAmountBySeat[command.seat]) isOrderPreserved = false;
+        lastAmountBySeat[command.seat] = command.amount;
+        numHandled++;
+
+        numRunning.fetch_sub(1);
+    }
+};
+
+TEST(MpscQueueTest, SingleThreadFifo) {
+    MpscQueue<int> queue;
+    ASSERT_TRUE(queue.empty());
+
+    for (int i = 0; i < 10; ++i) queue.push(i);
+    ASSERT_FALSE(queue.empty());
+
+    int value;
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(queue.pop(value));
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_FALSE(queue.pop(value));
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(MpscQueueTest, MultipleProducers) {
+    MpscQueue<int> queue;
+    const int numProducers = 4;
+    const int numPerProducer = 10000;
+
+    vector<thread> producers;
+    for (int p = 0; p < numProducers; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < numPerProducer; ++i) queue.push(p * numPerProducer + i);
+        });
+    }
+
+    // Consume concurrently with the producers
+    vector<int> lastSeen(numProducers, -1);
+    int numPopped = 0;
+    int value;
+    while (numPopped < numProducers * numPerProducer) {
+        if (!queue.pop(value)) continue;
+        int producer = value / numPerProducer;
+        ASSERT_GT(value, lastSeen[producer]);
+        lastSeen[producer] = value;
+        numPopped++;
+    }
+
+    for (auto& producer : producers) producer.join();
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(TableSchedulerTest, HandlesEveryPostedCommand) {
+    TableScheduler scheduler(4);
+    auto table = make_shared<CountingTable>();
+    scheduler.addTable(table);
+
+    for (size_t i = 1; i <= 1000; ++i) {
+        table->post({PLAYER_ACTION, NETWORK, 0, CALL, i});
+    }
+    scheduler.waitUntilIdle();
+
+    ASSERT_EQ(table->numHandled, 1000);
+    ASSERT_TRUE(table->isOrderPreserved);
+}
+
+TEST(TableSchedulerTest, TablesAreSingleThreadedUnderContention) {
+    const int numTables = 16;
+    const int numProducers = NUM_POSITIONS;
+    const size_t numPerProducer = 2000;
+
+    TableScheduler scheduler(4, 8);
+    vector<shared_ptr<CountingTable>> tables;
+    for (int i = 0; i < numTables; ++i) {
+        tables.push_back(make_shared<CountingTable>());
+        scheduler.addTable(tables.back());
+    }
+
+    // One producer per seat, e.g. network threads, timers and bots
+    vector<thread> producers;
+    for (int seat = 0; seat < numProducers; ++seat) {
+        producers.emplace_back([&tables, &scheduler, seat]() {
+            CommandSource source = static_cast<CommandSource>(seat % 3);
+            for (size_t i = 1; i <= numPerProducer; ++i) {
+                for (auto& table : tables) scheduler.post(*table, {PLAYER_ACTION, source, seat, CHECK, i});
+            }
+        });
+    }
+    for (auto& producer : producers) producer.join();
+    scheduler.waitUntilIdle();
+
+    for (auto& table : tables) {
+        ASSERT_EQ(table->numHandled, numProducers * numPerProducer);
+        ASSERT_FALSE(table->isRunConcurrently);
+        ASSERT_TRUE(table->isOrderPreserved);
+    }
+}
+
+TEST(TableSchedulerTest, PostingToUnregisteredTableThrows) {
+    CountingTable table;
+    ASSERT_THROW(table.post({}), runtime_error);
+}
+
+TEST(TableSchedulerTest, StopDrainsOutstandingCommands) {
+    auto table = make_shared<CountingTable>();
+    {
+        TableScheduler scheduler(2);
+        scheduler.addTable(table);
+        for (size_t i = 1; i <= 500; ++i) table->post({PLAYER_ACTION, BOT, 1, FOLD, i});
+        scheduler.stop();
+    }
+    ASSERT_EQ(table->numHandled, 500);
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "../include/TableSnapshot.h"
+#include "../include/FileUtils.h"
+#include <filesystem>
+
+class TableSnapshotTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // The game narrates every step to stdout
+        cout.setstate(ios_base::badbit);
+    }
+
+    void TearDown() override {
+        cout.clear();
+    }
+
+    static unique_ptr<GameController> createGame(uint64_t seed) {
+        auto game = make_unique<GameController>(5, 10);
+        game->setTableId(9);
+        game->setDeckSeed(seed);
+        game->addPlayerToGame("alice", 1000);
+        game->addPlayerToGame("bob", 800);
+        game->addPlayerToGame("carol", 1200);
+        game->addPlayerToGame("dave", 300);
+        return game;
+    }
+
+    // Plays a mix of bets, raises, folds and calls. Players only fold facing a bet.
+    static void playDecision(GameController& game, size_t step) {
+        shared_ptr<Player> player = game.getStreetState().getCurPlayer();
+        ClientAction fallback = ClientAction{player, CHECK, 0};
+        for (const auto& possible : game.getPossibleActions()) {
+            if (possible.type == CALL) fallback.type = CALL;
+        }
+
+        for (const auto& possible : game.getPossibleActions()) {
+            bool isAggressive = (possible.type == BET || possible.type == RAISE) && step % 5 == 2;
+            bool isFold = possible.type == FOLD && fallback.type == CALL && step % 4 == 1;
+            if (!isAggressive && !isFold) continue;
+
+            ClientAction action = ClientAction{player, possible.type, max<size_t>(possible.amount * 3, 4)};
+            if (game.processClientAction(action)) return;
+        }
+        ASSERT_TRUE(game.processClientAction(fallback));
+    }
+
+    // Plays decisions from step until numSteps, starting new rounds as needed.
+    // Collects every completed hand.
+    static void playUntil(GameController& game, size_t& step, size_t numSteps, vector<HandRecord>& hands) {
+        while (step < numSteps) {
+            if (!game.isRoundInProgress()) {
+                if (!game.getHandRecord().actions.empty()) game.setupNewRound();
+                if (!game.beginRound()) return;
+            }
+            if (game.isAwaitingAction()) playDecision(game, step++);
+            if (!game.isRoundInProgress()) hands.push_back(game.getHandRecord());
+        }
+    }
+
+    static vector<uint8_t> save(const GameController& game) {
+        vector<uint8_t> buffer(MAX_TABLE_SNAPSHOT_SIZE);
+        size_t size = TableSnapshot::save(game, buffer.data(), buffer.size());
+        EXPECT_GT(size, 0);
+        buffer.resize(size);
+        return buffer;
+    }
+
+    static vector<size_t> getChips(const GameController& game) {
+        vector<size_t> chips;
+        for (const auto& player : game.getGamePlayers()) chips.push_back(player->getChips());
+        return chips;
+    }
+};
+
+TEST_F(TableSnapshotTest, RestoredGamePlaysOnIdentically) {
+    // Snapshots are taken before the first round, mid street, and between rounds
+    for (size_t snapshotStep : {0, 1, 7, 23, 58, 111}) {
+        unique_ptr<GameController> original = createGame(21);
+        size_t step = 0;
+        vector<HandRecord> played;
+        playUntil(*original, step, snapshotStep, played);
+        vector<uint8_t> snapshot = save(*original);
+
+        unique_ptr<GameController> restored = make_unique<GameController>(5, 10);
+        ASSERT_TRUE(TableSnapshot::restore(*restored, snapshot.data(), snapshot.size())) << snapshotStep;
+        ASSERT_EQ(restored->isAwaitingAction(), original->isAwaitingAction());
+        ASSERT_EQ(restored->getPossibleActions(), original->getPossibleActions());
+        ASSERT_EQ(restored->getHandRecord(), original->getHandRecord());
+        ASSERT_EQ(getChips(*restored), getChips(*original));
+        if (original->isAwaitingAction()) {
+            ASSERT_EQ(restored->getStreetState().getCurPlayer()->getName(),
+                      original->getStreetState().getCurPlayer()->getName());
+        }
+
+        // Snapshotting the restored game gives back the same bytes
+        ASSERT_EQ(save(*restored), snapshot);
+
+        // Both go on to play the same hands with the same deals
+        size_t restoredStep = step;
+        vector<HandRecord> originalHands, restoredHands;
+        playUntil(*original, step, snapshotStep + 150, originalHands);
+        playUntil(*restored, restoredStep, snapshotStep + 150, restoredHands);
+        ASSERT_GT(originalHands.size(), 3);
+        ASSERT_EQ(restoredHands.size(), originalHands.size());
+        for (size_t i = 0; i < originalHands.size(); ++i) {
+            // Start times come from the clock, everything else must match exactly
+            restoredHands[i].startTime = originalHands[i].startTime;
+            ASSERT_EQ(restoredHands[i], originalHands[i]) << snapshotStep << " hand " << i;
+        }
+        ASSERT_EQ(getChips(*restored), getChips(*original));
+    }
+}
+
+TEST_F(TableSnapshotTest, CorruptSnapshotIsRejected) {
+    unique_ptr<GameController> original = createGame(5);
+    size_t step = 0;
+    vector<HandRecord> played;
+    playUntil(*original, step, 30, played);
+    vector<uint8_t> snapshot = save(*original);
+
+    for (size_t size : {size_t(0), size_t(8), snapshot.size() / 2, snapshot.size() - 1}) {
+        GameController game(5, 10);
+        ASSERT_FALSE(TableSnapshot::restore(game, snapshot.data(), size));
+    }
+
+    for (size_t i = 0; i < snapshot.size(); i += 7) {
+        vector<uint8_t> flipped = snapshot;
+        flipped[i] ^= 0x10;
+        GameController game(5, 10);
+        ASSERT_FALSE(TableSnapshot::restore(game, flipped.data(), flipped.size())) << i;
+    }
+
+    // Blinds are part of how the game was created, not of its state
+    GameController otherBlinds(10, 20);
+    ASSERT_FALSE(TableSnapshot::restore(otherBlinds, snapshot.data(), snapshot.size()));
+
+    uint8_t small[64];
+    ASSERT_EQ(TableSnapshot::save(*original, small, sizeof(small)), 0);
+}
+
+TEST_F(TableSnapshotTest, SnapshotFileIsReplacedWhole) {
+    string directory = testing::TempDir() + "table_snapshot_test";
+    filesystem::remove_all(directory);
+    filesystem::create_directories(directory);
+    string path = directory + "/table.snap";
+
+    unique_ptr<GameController> original = createGame(8);
+    size_t step = 0;
+    vector<HandRecord> played;
+    playUntil(*original, step, 10, played);
+    vector<uint8_t> first = save(*original);
+    playUntil(*original, step, 20, played);
+    vector<uint8_t> second = save(*original);
+
+    ASSERT_TRUE(writeFileAtomically(path, first.data(), first.size()));
+    ASSERT_TRUE(writeFileAtomically(path, second.data(), second.size()));
+    ASSERT_FALSE(filesystem::exists(path + ".tmp"));
+
+    vector<uint8_t> read;
+    ASSERT_TRUE(readWholeFile(path, read));
+    ASSERT_EQ(read, second);
+
+    GameController restored(5, 10);
+    ASSERT_TRUE(TableSnapshot::restore(restored, read.data(), read.size()));
+    ASSERT_EQ(getChips(restored), getChips(*original));
+
+    ASSERT_FALSE(readWholeFile(directory + "/missing.snap", read));
+    filesystem::remove_all(directory);
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include "../include/TableState.h"
+
+class TableStateTest : public ::testing::Test {
+protected:
+    uint8_t buffer[FRAME_HEADER_SIZE + MAX_FRAME_PAYLOAD];
+
+    void SetUp() override {
+        // The game narrates every step to stdout
+        cout.setstate(ios_base::badbit);
+    }
+
+    void TearDown() override {
+        cout.clear();
+    }
+
+    // Captures the game, publishes a delta and applies it to every client state.
+    // Returns the size of the delta frame (0 if nothing changed).
+    size_t publish(const GameController& game, uint32_t handNumber, TableStateStream& stream,
+                   vector<TableState*> clients) {
+        TableState state = stream.getPublishedState();
+        state.capture(game, handNumber);
+
+        WireWriter writer(buffer, sizeof(buffer));
+        if (!stream.encodeDelta(state, writer)) return 0;
+
+        FrameHeader header;
+        EXPECT_TRUE(decodeFrameHeader(buffer, writer.getSize(), header));
+        EXPECT_EQ(header.type, MSG_STATE_DELTA);
+        for (TableState* client : clients) {
+            EXPECT_TRUE(client->applyDelta(buffer + FRAME_HEADER_SIZE, header.payloadSize));
+        }
+        return writer.getSize();
+    }
+
+    // Plays the pending decision with a call (or check)
+    static void callOrCheck(GameController& game) {
+        ActionType choice = CHECK;
+        for (const auto& action : game.getPossibleActions()) {
+            if (action.type == CALL) choice = CALL;
+        }
+        ClientAction action = ClientAction{game.getStreetState().getCurPlayer(), choice, 0};
+        ASSERT_TRUE(game.processClientAction(action));
+    }
+};
+
+TEST_F(TableStateTest, DeltasReconstructState) {
+    GameController game(1, 2);
+    TableStateStream stream(0);
+    TableState client;
+
+    game.addPlayerToGame("alice", 100);
+    game.addPlayerToGame("bob", 200);
+    game.addPlayerToGame("carol", 300);
+    ASSERT_GT(publish(game, 0, stream, {&client}), 0);
+
+    ASSERT_TRUE(game.beginRound());
+    publish(game, 1, stream, {&client});
+
+    size_t numDeltas = 0;
+    size_t maxDeltaSize = 0;
+    while (game.isAwaitingAction()) {
+        callOrCheck(game);
+        size_t size = publish(game, 1, stream, {&client});
+        maxDeltaSize = max(maxDeltaSize, size);
+        numDeltas += size > 0;
+
+        ASSERT_TRUE(client.isSameState(stream.getPublishedState()));
+        ASSERT_EQ(client.sequence, stream.getPublishedState().sequence);
+    }
+
+    // The whole board and some chips made it through the deltas
+    ASSERT_EQ(client.numBoardCards, 5);
+    ASSERT_GT(numDeltas, 0);
+    uint32_t totalChips = 0;
+    for (const SeatState& seat : client.seats) totalChips += seat.chips;
+    ASSERT_EQ(totalChips, 600);
+
+    // A single action is far smaller than a full keyframe
+    WireWriter writer(buffer, sizeof(buffer));
+    stream.encodeKeyframe(writer);
+    ASSERT_LT(maxDeltaSize, writer.getSize());
+}
+
+TEST_F(TableStateTest, LateJoinerSyncsFromKeyframe) {
+    GameController game(1, 2);
+    TableStateStream stream(0);
+    TableState early;
+
+    game.addPlayerToGame("alice", 100);
+    game.addPlayerToGame("bob", 100);
+    ASSERT_TRUE(game.beginRound());
+    publish(game, 1, stream, {&early});
+    callOrCheck(game);
+    publish(game, 1, stream, {&early});
+
+    // A spectator arriving mid-hand starts from a keyframe of the published state
+    WireWriter writer(buffer, sizeof(buffer));
+    stream.encodeKeyframe(writer);
+    FrameHeader header;
+    ASSERT_TRUE(decodeFrameHeader(buffer, writer.getSize(), header));
+    ASSERT_EQ(header.type, MSG_STATE_KEYFRAME);
+
+    TableState late;
+    ASSERT_TRUE(late.decodeKeyframe(buffer + FRAME_HEADER_SIZE, header.payloadSize));
+    ASSERT_TRUE(late.isSameState(early));
+    ASSERT_EQ(late.sequence, early.sequence);
+    const SeatState* seat = late.findSeat(static_cast<uint8_t>(game.getGamePlayers()[0]->getPosition()));
+    ASSERT_NE(seat, nullptr);
+    ASSERT_EQ(seat->getName(), game.getGamePlayers()[0]->getName());
+
+    while (game.isAwaitingAction()) {
+        callOrCheck(game);
+        publish(game, 1, stream, {&early, &late});
+    }
+    ASSERT_TRUE(late.isSameState(early));
+    ASSERT_TRUE(late.isSameState(stream.getPublishedState()));
+}
+
+TEST_F(TableStateTest, PlayersKeepTheirSeatsAcrossHands) {
+    GameController game(1, 2);
+    TableStateStream stream(0);
+    TableState client;
+
+    game.addPlayerToGame("alice", 100);
+    game.addPlayerToGame("bob", 100);
+    game.addPlayerToGame("carol", 100);
+    ASSERT_TRUE(game.beginRound());
+    publish(game, 1, stream, {&client});
+    TableState firstHand = stream.getPublishedState();
+    while (game.isAwaitingAction()) {
+        callOrCheck(game);
+        publish(game, 1, stream, {&client});
+    }
+
+    // The button moves, so every position changes but nobody changes seat
+    game.setupNewRound();
+    ASSERT_TRUE(game.beginRound());
+    publish(game, 2, stream, {&client});
+    const TableState& secondHand = stream.getPublishedState();
+    for (size_t i = 0; i < secondHand.seats.size(); ++i) {
+        ASSERT_EQ(secondHand.seats[i].isOccupied, firstHand.seats[i].isOccupied);
+        if (!secondHand.seats[i].isOccupied) continue;
+        ASSERT_EQ(secondHand.seats[i].getName(), firstHand.seats[i].getName());
+        ASSERT_NE(secondHand.seats[i].position, firstHand.seats[i].position);
+    }
+    ASSERT_TRUE(client.isSameState(secondHand));
+
+    // A player who leaves frees their seat for the next to sit down, without moving anyone else
+    size_t bobSeat = find_if(secondHand.seats.begin(), secondHand.seats.end(),
+        [](const SeatState& seat) { return seat.getName() == "bob"; }) - secondHand.seats.begin();
+    while (game.isAwaitingAction()) {
+        callOrCheck(game);
+        publish(game, 2, stream, {&client});
+    }
+    game.setupNewRound();
+    game.removePlayerFromGame("bob");
+    game.addPlayerToGame("dave", 100);
+    publish(game, 2, stream, {&client});
+    ASSERT_EQ(stream.getPublishedState().seats[bobSeat].getName(), "dave");
+    ASSERT_TRUE(client.isSameState(stream.getPublishedState()));
+}
+
+TEST_F(TableStateTest, RejectsOutOfSequenceDeltas) {
+    GameController game(1, 2);
+    TableStateStream stream(0, 2);
+
+    game.addPlayerToGame("alice", 100);
+    TableState state;
+    state.capture(game, 0);
+    WireWriter first(buffer, sizeof(buffer));
+    ASSERT_TRUE(stream.encodeDelta(state, first));
+
+    // Nothing changed, nothing to send
+    WireWriter unchanged(buffer, sizeof(buffer));
+    ASSERT_FALSE(stream.encodeDelta(state, unchanged));
+    ASSERT_EQ(unchanged.getSize(), 0);
+
+    // A client that missed the first delta can't apply the second
+    game.addPlayerToGame("bob", 100);
+    state.capture(game, 0);
+    WireWriter second(buffer, sizeof(buffer));
+    ASSERT_TRUE(stream.encodeDelta(state, second));
+
+    TableState client;
+    ASSERT_FALSE(client.applyDelta(buffer + FRAME_HEADER_SIZE, second.getSize() - FRAME_HEADER_SIZE));
+    ASSERT_EQ(client.sequence, 0);
+
+    // Keyframes are due every two deltas
+    WireWriter keyframe(buffer, sizeof(buffer));
+    ASSERT_TRUE(stream.encodeKeyframeIfDue(keyframe));
+    ASSERT_TRUE(client.decodeKeyframe(buffer + FRAME_HEADER_SIZE, keyframe.getSize() - FRAME_HEADER_SIZE));
+    ASSERT_TRUE(client.isSameState(stream.getPublishedState()));
+    ASSERT_EQ(client.sequence, 2);
+
+    WireWriter notDue(buffer, sizeof(buffer));
+    ASSERT_FALSE(stream.encodeKeyframeIfDue(notDue));
+}
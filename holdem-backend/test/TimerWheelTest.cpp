@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+#include "../include/TimerWheel.h"
+#include "../include/GameTable.h"
+#include <mutex>
+#include <random>
+
+// Table that records the timer commands it receives
+class TimerTable : public TableActor {
+public:
+    mutex commandsMutex;
+    vector<size_t> amounts;
+
+    void handleCommand(const TableCommand& command) override {
+        lock_guard<mutex> lock(commandsMutex);
+        amounts.push_back(command.amount);
+    }
+
+    size_t getNumHandled() {
+        lock_guard<mutex> lock(commandsMutex);
+        return amounts.size();
+    }
+};
+
+// Keeps the frames a table sends to the first client
+class CapturingOutput : public TableOutput {
+public:
+    mutex framesMutex;
+    vector<vector<uint8_t>> frames;
+
+    void sendToClient(uint64_t clientId, const uint8_t* data, size_t size) override {
+        if (clientId != 1) return;
+        lock_guard<mutex> lock(framesMutex);
+        frames.emplace_back(data, data + size);
+    }
+
+    // Returns the decoded action results sent so far
+    vector<ActionResultMessage> getActionResults() {
+        lock_guard<mutex> lock(framesMutex);
+        vector<ActionResultMessage> results;
+        for (const auto& frame : frames) {
+            FrameHeader header;
+            ActionResultMessage result;
+            if (!decodeFrameHeader(frame.data(), frame.size(), header) || header.type != MSG_ACTION_RESULT) continue;
+            if (WireCodec::decodeActionResult(frame.data() + FRAME_HEADER_SIZE, header.payloadSize, result)) {
+                results.push_back(result);
+            }
+        }
+        return results;
+    }
+
+    size_t countFrames(MessageType type) {
+        lock_guard<mutex> lock(framesMutex);
+        size_t count = 0;
+        for (const auto& frame : frames) {
+            FrameHeader header;
+            count += decodeFrameHeader(frame.data(), frame.size(), header) && header.type == type;
+        }
+        return count;
+    }
+};
+
+TEST(TimerWheelTest, FiresInExpiryOrder) {
+    TimerWheel wheel;
+    vector<uint64_t> expired;
+
+    wheel.schedule(5, 5);
+    wheel.schedule(1, 1);
+    wheel.schedule(3, 3);
+    ASSERT_EQ(wheel.size(), 3);
+
+    wheel.advance(2, expired);
+    ASSERT_EQ(expired, vector<uint64_t>({1}));
+
+    wheel.advance(10, expired);
+    ASSERT_EQ(expired, vector<uint64_t>({1, 3, 5}));
+    ASSERT_EQ(wheel.size(), 0);
+    ASSERT_EQ(wheel.getCurrentTick(), 12);
+}
+
+TEST(TimerWheelTest, CancelledAndStaleHandles) {
+    TimerWheel wheel;
+    vector<uint64_t> expired;
+
+    TimerId a = wheel.schedule(10, 1);
+    TimerId b = wheel.schedule(10, 2);
+    ASSERT_TRUE(wheel.cancel(a));
+    ASSERT_FALSE(wheel.cancel(a));
+    ASSERT_FALSE(wheel.cancel(INVALID_TIMER));
+
+    // The freed node is reused, the old handle must not cancel the new timer
+    TimerId c = wheel.schedule(10, 3);
+    ASSERT_NE(a, c);
+    ASSERT_FALSE(wheel.cancel(a));
+
+    wheel.advance(10, expired);
+    ASSERT_EQ(expired.size(), 2);
+    ASSERT_FALSE(wheel.cancel(b));
+    ASSERT_FALSE(wheel.cancel(c));
+}
+
+TEST(TimerWheelTest, CascadesAcrossLevels) {
+    TimerWheel wheel;
+    vector<uint64_t> expired;
+
+    // Start just short of a level boundary so timers straddle every level
+    wheel.advance(TIMER_WHEEL_SLOTS * TIMER_WHEEL_SLOTS - 3, expired);
+
+    vector<uint64_t> delays = {1, 2, 3, 4, 63, 64, 65, 4095, 4096, 4097, 300000, 1000000};
+    for (uint64_t delay : delays) wheel.schedule(delay, wheel.getCurrentTick() + delay);
+
+    // Each timer fires on exactly its tick
+    while (wheel.size() > 0) {
+        expired.clear();
+        wheel.advance(1, expired);
+        for (uint64_t expiry : expired) ASSERT_EQ(expiry, wheel.getCurrentTick());
+    }
+}
+
+TEST(TimerWheelTest, ManyRandomTimers) {
+    TimerWheel wheel;
+    mt19937_64 rng(42);
+    const size_t numTimers = 200000;
+
+    // Shot clocks and time banks in 10ms ticks, a third cancelled as players act
+    vector<TimerId> ids;
+    vector<uint64_t> expiries;
+    vector<bool> isCancelled(numTimers, false);
+    for (size_t i = 0; i < numTimers; ++i) {
+        uint64_t delay = 1 + rng() % 6000;
+        ids.push_back(wheel.schedule(delay, i));
+        expiries.push_back(delay);
+    }
+    for (size_t i = 0; i < numTimers; i += 3) {
+        ASSERT_TRUE(wheel.cancel(ids[i]));
+        isCancelled[i] = true;
+    }
+
+    vector<uint64_t> expired;
+    size_t numFired = 0;
+    while (wheel.size() > 0) {
+        expired.clear();
+        wheel.advance(7, expired);
+        for (uint64_t i : expired) {
+            ASSERT_FALSE(isCancelled[i]);
+            ASSERT_LE(expiries[i], wheel.getCurrentTick());
+            ASSERT_GT(expiries[i] + 7, wheel.getCurrentTick());
+            numFired++;
+        }
+    }
+    ASSERT_EQ(numFired, numTimers - (numTimers + 2) / 3);
+}
+
+TEST(TimerWheelTest, SchedulerPostsAfterDelay) {
+    TableScheduler scheduler(2);
+    auto table = make_shared<TimerTable>();
+    scheduler.addTable(table);
+
+    auto start = chrono::steady_clock::now();
+    TableCommand command;
+    command.source = TIMER;
+    command.amount = 1;
+    table->postAfter(chrono::milliseconds(50), command);
+
+    // Cancelled timers never arrive
+    command.amount = 2;
+    uint64_t cancelled = table->postAfter(chrono::milliseconds(30), command);
+    table->cancelTimer(cancelled);
+
+    while (table->getNumHandled() == 0) this_thread::sleep_for(chrono::milliseconds(1));
+    ASSERT_GE(chrono::steady_clock::now() - start, chrono::milliseconds(50));
+    this_thread::sleep_for(chrono::milliseconds(50));
+
+    ASSERT_EQ(table->amounts, vector<size_t>({1}));
+    ASSERT_EQ(scheduler.getNumTimers(), 0);
+}
+
+TEST(TimerWheelTest, TimersDoNotNeedThreadsPerTable) {
+    const size_t numTables = 1000;
+    const size_t timersPerTable = 100;
+
+    TableScheduler scheduler(2);
+    vector<shared_ptr<TimerTable>> tables;
+    for (size_t i = 0; i < numTables; ++i) {
+        tables.push_back(make_shared<TimerTable>());
+        scheduler.addTable(tables.back());
+    }
+
+    // 100k clocks, most of which are cancelled as players act in time
+    vector<uint64_t> ids;
+    for (auto& table : tables) {
+        for (size_t i = 0; i < timersPerTable; ++i) {
+            ids.push_back(table->postAfter(chrono::milliseconds(500 + i % 50), TableCommand{}));
+            if (ids.size() % 10 != 1) table->cancelTimer(ids.back());
+        }
+    }
+
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+    size_t numHandled = 0;
+    while (chrono::steady_clock::now() < deadline) {
+        numHandled = 0;
+        for (auto& table : tables) numHandled += table->getNumHandled();
+        if (numHandled == ids.size() / 10 && scheduler.getNumTimers() == 0) break;
+        this_thread::sleep_for(chrono::milliseconds(5));
+    }
+    scheduler.waitUntilIdle();
+    ASSERT_EQ(numHandled, ids.size() / 10);
+    ASSERT_EQ(scheduler.getNumTimers(), 0);
+}
+
+TEST(TimerWheelTest, ExpiredClockChecksOrFolds) {
+    cout.setstate(ios_base::badbit);
+
+    CapturingOutput output;
+    TableScheduler scheduler(1);
+    auto table = make_shared<GameTable>(0, 1, 2, output);
+    table->setActionClock(chrono::milliseconds(20), chrono::milliseconds(30));
+    scheduler.addTable(table);
+
+    for (uint64_t clientId = 1; clientId <= 2; ++clientId) {
+        TableCommand join;
+        join.type = JOIN_TABLE;
+        join.clientId = clientId;
+        join.amount = 1000;
+        join.playerName = "idle" + to_string(clientId);
+        table->post(join);
+    }
+
+    // Nobody acts: the first decision draws on the time bank, then folds as there is a bet to face.
+    // Later decisions have no bank left and time out on the shot clock alone.
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+    vector<ActionResultMessage> results;
+    while (results.size() < 4 && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+        results = output.getActionResults();
+    }
+    scheduler.stop();
+    cout.clear();
+
+    ASSERT_GE(results.size(), 4);
+    ASSERT_EQ(results[0].type, FOLD);
+    for (const auto& result : results) {
+        ASSERT_TRUE(result.type == FOLD || result.type == CHECK);
+    }
+    ASSERT_GE(output.countFrames(MSG_TIME_BANK), 2);
+}
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include "../include/CardSubset.h"
+#include "../include/GameTable.h"
+#include "../include/WinProbabilityFeed.h"
+
+class WinProbabilityFeedTest : public ::testing::Test {
+protected:
+    vector<shared_ptr<Player>> players;
+    vector<Card> board;
+
+    void SetUp() override {
+        cout.setstate(ios_base::badbit);
+        players = {
+            createPlayer("alice", Position::SMALL_BLIND, Card(Suit::HEARTS, Value::ACE), Card(Suit::HEARTS, Value::KING)),
+            createPlayer("bob", Position::BIG_BLIND, Card(Suit::SPADES, Value::NINE), Card(Suit::CLUBS, Value::NINE)),
+            createPlayer("carol", Position::UTG, Card(Suit::DIAMONDS, Value::QUEEN), Card(Suit::CLUBS, Value::JACK)),
+            createPlayer("dave", Position::DEALER, Card(Suit::SPADES, Value::FOUR), Card(Suit::DIAMONDS, Value::FIVE))
+        };
+        board = {Card(Suit::HEARTS, Value::TEN), Card(Suit::HEARTS, Value::FOUR), Card(Suit::SPADES, Value::KING),
+                 Card(Suit::CLUBS, Value::TWO), Card(Suit::HEARTS, Value::NINE)};
+    }
+
+    void TearDown() override {
+        cout.clear();
+    }
+
+    static shared_ptr<Player> createPlayer(const string& name, Position position, Card first, Card second) {
+        auto player = make_shared<Player>(name, position, 1000);
+        player->addHoleCard(first);
+        player->addHoleCard(second);
+        return player;
+    }
+
+    // Exact equity of the live players, counting the cards of every hand dealt as dead
+    EquityResult enumerate(const vector<shared_ptr<Player>>& live, size_t numBoardCards) const {
+        vector<uint64_t> hands;
+        for (const auto& player : live) hands.push_back(HandRank::getMask(player->getHand()));
+        uint64_t dead = 0;
+        for (const auto& player : players) dead |= HandRank::getMask(player->getHand());
+        uint64_t known = HandRank::getMask(vector<Card>(board.begin(), board.begin() + numBoardCards));
+
+        // Folded hands can't come on the board, so the runouts are dealt here rather than by Equity
+        EquityResult total(hands.size());
+        for (uint64_t runout : CardSubsets(FULL_DECK_MASK & ~(dead | known), 5 - static_cast<int>(numBoardCards))) {
+            total.merge(Equity::computeExact(hands, known | runout));
+        }
+        return total;
+    }
+};
+
+TEST_F(WinProbabilityFeedTest, StreetsMatchExactEnumeration) {
+    WinProbabilityFeed feed(chrono::seconds(1));
+    ASSERT_TRUE(feed.update(players, {}, 1));
+    ASSERT_TRUE(feed.getProbabilities().positions.empty());
+    ASSERT_FALSE(feed.update(players, {}, 1));
+
+    vector<shared_ptr<Player>> live = players;
+    for (size_t numBoardCards = 3; numBoardCards <= 5; ++numBoardCards) {
+        // Someone folds before each of the later streets
+        if (numBoardCards > 3) live.erase(live.begin() + 1);
+
+        vector<Card> dealt(board.begin(), board.begin() + numBoardCards);
+        ASSERT_TRUE(feed.update(live, dealt, 1));
+        ASSERT_FALSE(feed.update(live, dealt, 1));
+        const WinProbabilities& probabilities = feed.getProbabilities();
+        ASSERT_TRUE(probabilities.isExact);
+        ASSERT_EQ(probabilities.numBoardCards, static_cast<int>(numBoardCards));
+        ASSERT_EQ(probabilities.positions.size(), live.size());
+        ASSERT_EQ(probabilities.positions[0], static_cast<uint8_t>(live[0]->getPosition()));
+
+        EquityResult expected = enumerate(live, numBoardCards);
+        ASSERT_EQ(probabilities.tally.numBoards, expected.numBoards);
+        ASSERT_EQ(probabilities.tally.wins, expected.wins);
+        ASSERT_EQ(probabilities.tally.ties, expected.ties);
+
+        // Outs to the next card, with the folded hands out of the deck
+        if (numBoardCards == 5) {
+            ASSERT_TRUE(probabilities.outs.empty());
+            continue;
+        }
+        vector<uint64_t> hands;
+        for (const auto& player : live) hands.push_back(HandRank::getMask(player->getHand()));
+        uint64_t folded = 0;
+        for (const auto& player : players) folded |= HandRank::getMask(player->getHand());
+        for (uint64_t hand : hands) folded &= ~hand;
+        OutsResult outs = Outs::compute(hands, HandRank::getMask(dealt), folded);
+        ASSERT_EQ(probabilities.outs, vector<uint64_t>(outs.outs, outs.outs + outs.numHands));
+    }
+
+    // A new hand on the same board starts over
+    ASSERT_TRUE(feed.update(players, vector<Card>(board.begin(), board.begin() + 3), 2));
+    ASSERT_EQ(feed.getProbabilities().positions.size(), players.size());
+}
+
+TEST_F(WinProbabilityFeedTest, BudgetCutsTheFlopShort) {
+    WinProbabilityFeed feed(chrono::microseconds(0));
+    ASSERT_TRUE(feed.update(players, vector<Card>(board.begin(), board.begin() + 3), 1));
+    const WinProbabilities& flop = feed.getProbabilities();
+    ASSERT_FALSE(flop.isExact);
+    ASSERT_GE(flop.tally.numBoards, static_cast<uint64_t>(WIN_PROBABILITY_CHECK_INTERVAL));
+    ASSERT_LT(flop.tally.numBoards, enumerate(players, 3).numBoards);
+
+    // Later streets rank whatever the flop didn't get to
+    ASSERT_TRUE(feed.update(players, vector<Card>(board.begin(), board.begin() + 4), 1));
+    ASSERT_TRUE(feed.getProbabilities().isExact);
+    ASSERT_EQ(feed.getProbabilities().tally.wins, enumerate(players, 4).wins);
+}
+
+TEST_F(WinProbabilityFeedTest, EncodesForTheWire) {
+    WinProbabilityFeed feed;
+    feed.update(players, vector<Card>(board.begin(), board.begin() + 4), 7);
+    const WinProbabilities& probabilities = feed.getProbabilities();
+
+    uint8_t buffer[FRAME_HEADER_SIZE + MAX_FRAME_PAYLOAD];
+    WireWriter writer(buffer, sizeof(buffer));
+    WireCodec::encodeWinProbabilities(writer, 3, probabilities);
+    FrameHeader header;
+    ASSERT_TRUE(decodeFrameHeader(buffer, writer.getSize(), header));
+    ASSERT_EQ(header.type, MSG_WIN_PROBABILITIES);
+
+    WinProbabilitiesMessage message;
+    ASSERT_TRUE(WireCodec::decodeWinProbabilities(buffer + FRAME_HEADER_SIZE, header.payloadSize, message));
+    ASSERT_EQ(message.tableId, 3u);
+    ASSERT_EQ(message.handNumber, 7u);
+    ASSERT_EQ(message.numBoardCards, 4);
+    ASSERT_TRUE(message.isExact);
+    ASSERT_EQ(message.numPlayers, players.size());
+    for (size_t i = 0; i < players.size(); ++i) {
+        ASSERT_EQ(message.players[i].position, probabilities.positions[i]);
+        ASSERT_NEAR(message.players[i].win / 10000.0, probabilities.tally.getWinFraction(i), 1e-4);
+        ASSERT_NEAR(message.players[i].tie / 10000.0, probabilities.tally.getTieFraction(i), 2e-4);
+        ASSERT_EQ(message.players[i].outs, probabilities.outs[i]);
+    }
+    ASSERT_FALSE(WireCodec::decodeWinProbabilities(buffer + FRAME_HEADER_SIZE, header.payloadSize - 1, message));
+}
+
+// Keeps every frame sent to clients
+class RecordingOutput : public TableOutput {
+public:
+    vector<vector<uint8_t>> frames;
+
+    void sendToClient(uint64_t clientId, const uint8_t* data, size_t size) override {
+        frames.emplace_back(data, data + size);
+    }
+};
+
+TEST_F(WinProbabilityFeedTest, OnlySpectatorsOfFeaturedTablesSeeIt) {
+    RecordingOutput output;
+    GameTable table(0, 1, 2, output);
+    table.setActionClock(chrono::milliseconds(0), chrono::milliseconds(0));
+    table.setWinProbabilityFeed();
+
+    BroadcastCursor cursor;
+    BroadcastRing& ring = table.getSpectatorRing();
+    for (uint64_t clientId = 1; clientId <= 3; ++clientId) {
+        TableCommand join;
+        join.type = JOIN_TABLE;
+        join.clientId = clientId;
+        join.amount = 1000;
+        join.playerName = "player" + to_string(clientId);
+        table.handleCommand(join);
+    }
+
+    // Everyone checks or calls down
+    const GameController& game = table.getGame();
+    while (game.isRoundInProgress() && game.getBoard().getCommunityCardCount() < 5) {
+        ASSERT_TRUE(game.isAwaitingAction());
+        const string& name = game.getStreetState().getCurPlayer()->getName();
+        TableCommand action;
+        action.clientId = stoull(name.substr(6));
+        action.action = CHECK;
+        for (const auto& possible : game.getPossibleActions()) {
+            if (possible.type == CALL) action.action = CALL;
+        }
+        table.handleCommand(action);
+    }
+
+    vector<int> streets;
+    for (shared_ptr<const BroadcastFrame> frame = ring.next(cursor); frame != nullptr; frame = ring.next(cursor)) {
+        FrameHeader header;
+        ASSERT_TRUE(decodeFrameHeader(frame->data.data(), frame->data.size(), header));
+        if (header.type != MSG_WIN_PROBABILITIES) continue;
+        WinProbabilitiesMessage message;
+        ASSERT_TRUE(WireCodec::decodeWinProbabilities(frame->data.data() + FRAME_HEADER_SIZE, header.payloadSize, message));
+        streets.push_back(message.numBoardCards);
+        if (message.numBoardCards >= 3) ASSERT_EQ(message.numPlayers, game.getContenders().size());
+    }
+    ASSERT_EQ(streets, (vector<int>{0, 3, 4, 5}));
+
+    for (const auto& frame : output.frames) {
+        FrameHeader header;
+        ASSERT_TRUE(decodeFrameHeader(frame.data(), frame.size(), header));
+        ASSERT_NE(header.type, MSG_WIN_PROBABILITIES);
+    }
+}
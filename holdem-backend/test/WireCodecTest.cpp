@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include "../include/WireCodec.h"
+
+class WireCodecTest : public ::testing::Test {
+protected:
+    uint8_t buffer[FRAME_HEADER_SIZE + MAX_FRAME_PAYLOAD];
+
+    // Checks the frame header and returns the payload size
+    size_t checkFrame(const WireWriter& writer, MessageType type) {
+        FrameHeader header;
+        EXPECT_FALSE(writer.isOverflow());
+        EXPECT_TRUE(decodeFrameHeader(buffer, writer.getSize(), header));
+        EXPECT_EQ(header.version, WIRE_PROTOCOL_VERSION);
+        EXPECT_EQ(header.type, type);
+        EXPECT_EQ(header.payloadSize + FRAME_HEADER_SIZE, writer.getSize());
+        return header.payloadSize;
+    }
+
+    const uint8_t* payload() const { return buffer + FRAME_HEADER_SIZE; }
+};
+
+TEST_F(WireCodecTest, CardRoundTrip) {
+    for (int suit = 0; suit < 4; ++suit) {
+        for (int value = 2; value <= 14; ++value) {
+            Card card(static_cast<Suit>(suit), static_cast<Value>(value));
+            uint8_t encoded = WireCodec::encodeCard(card);
+            ASSERT_LT(encoded, 52);
+            ASSERT_EQ(card.getBitMask(), 1ULL << encoded);
+            ASSERT_EQ(WireCodec::decodeCard(encoded), card);
+        }
+    }
+}
+
+TEST_F(WireCodecTest, SeatsAndHoleCards) {
+    auto playerA = make_shared<Player>("alice", Position::SMALL_BLIND, 1000);
+    auto playerB = make_shared<Player>("bob", Position::BIG_BLIND, 250);
+    playerB->addHoleCard(Card(Suit::SPADES, Value::ACE));
+    playerB->addHoleCard(Card(Suit::HEARTS, Value::TWO));
+
+    WireWriter writer(buffer, sizeof(buffer));
+    WireCodec::encodeSeats(writer, 7, {playerA, playerB});
+    size_t size = checkFrame(writer, MSG_SEATS);
+
+    SeatsMessage seats;
+    ASSERT_TRUE(WireCodec::decodeSeats(payload(), size, seats));
+    ASSERT_EQ(seats.tableId, 7);
+    ASSERT_EQ(seats.numSeats, 2);
+    ASSERT_EQ(seats.seats[0].name, "alice");
+    ASSERT_EQ(seats.seats[0].chips, 1000);
+    ASSERT_EQ(seats.seats[1].name, "bob");
+    ASSERT_EQ(seats.seats[1].position, static_cast<uint8_t>(Position::BIG_BLIND));
+
+    writer = WireWriter(buffer, sizeof(buffer));
+    WireCodec::encodeHoleCards(writer, 7, *playerB);
+    size = checkFrame(writer, MSG_HOLE_CARDS);
+
+    HoleCardsMessage holeCards;
+    ASSERT_TRUE(WireCodec::decodeHoleCards(payload(), size, holeCards));
+    ASSERT_EQ(holeCards.numCards, 2);
+    ASSERT_EQ(WireCodec::decodeCard(holeCards.cards[0]), Card(Suit::SPADES, Value::ACE));
+    ASSERT_EQ(WireCodec::decodeCard(holeCards.cards[1]), Card(Suit::HEARTS, Value::TWO));
+}
+
+TEST_F(WireCodecTest, BoardAndPots) {
+    Board board;
+    board.addCommunityCard(Card(Suit::CLUBS, Value::TEN));
+    board.addCommunityCard(Card(Suit::DIAMONDS, Value::JACK));
+    board.addCommunityCard(Card(Suit::HEARTS, Value::QUEEN));
+
+    WireWriter writer(buffer, sizeof(buffer));
+    WireCodec::encodeBoard(writer, 1, board);
+    size_t size = checkFrame(writer, MSG_BOARD);
+
+    BoardMessage boardMessage;
+    ASSERT_TRUE(WireCodec::decodeBoard(payload(), size, boardMessage));
+    ASSERT_EQ(boardMessage.numCards, 3);
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(WireCodec::decodeCard(boardMessage.cards[i]), board.getCommunityCards()[i]);
+    }
+
+    PotManager potManager;
+    auto playerA = make_shared<Player>("Player A", Position::SMALL_BLIND, 1000);
+    auto playerB = make_shared<Player>("Player B", Position::BIG_BLIND, 400);
+    auto playerC = make_shared<Player>("Player C", Position::UTG, 2000);
+    potManager.addPlayerBet(playerA, 900, false);
+    potManager.addPlayerBet(playerB, 400, true);
+    potManager.addPlayerBet(playerC, 900, false);
+    potManager.calculatePots();
+
+    writer = WireWriter(buffer, sizeof(buffer));
+    WireCodec::encodePots(writer, 1, potManager);
+    size = checkFrame(writer, MSG_POTS);
+
+    PotsMessage pots;
+    ASSERT_TRUE(WireCodec::decodePots(payload(), size, pots));
+    ASSERT_EQ(pots.numPots, potManager.getNumPots());
+    for (int i = 0; i < potManager.getNumPots(); ++i) {
+        const Pot& pot = potManager.getPot(i);
+        ASSERT_EQ(pots.pots[i].chips, pot.getChips());
+        for (const auto& player : pot.getEligiblePlayers()) {
+            ASSERT_TRUE(pots.pots[i].eligiblePositions & (1u << static_cast<int>(player->getPosition())));
+        }
+    }
+}
+
+TEST_F(WireCodecTest, ActionRequestAndResult) {
+    auto player = make_shared<Player>("alice", Position::UTG, 500);
+    StreetState streetState;
+    streetState.setStreet(Street::TURN);
+    streetState.setCurPlayer(player);
+    streetState.setActiveBet(40);
+    streetState.setPlayerInitialChips(500);
+    streetState.setBigStackAmongOthers(1200);
+    streetState.setPlayerCanRaise(true);
+    vector<PossibleAction> possibleActions = {{CALL, 40}, {RAISE, 80}, {FOLD, 0}};
+
+    WireWriter writer(buffer, sizeof(buffer));
+    WireCodec::encodeActionRequest(writer, 3, streetState, possibleActions);
+    size_t size = checkFrame(writer, MSG_ACTION_REQUEST);
+
+    ActionRequestMessage request;
+    ASSERT_TRUE(WireCodec::decodeActionRequest(payload(), size, request));
+    ASSERT_EQ(request.street, TURN);
+    ASSERT_EQ(request.position, static_cast<uint8_t>(Position::UTG));
+    ASSERT_EQ(request.flags, REQUEST_CAN_RAISE);
+    ASSERT_EQ(request.activeBet, 40);
+    ASSERT_EQ(request.playerInitialChips, 500);
+    ASSERT_EQ(request.bigStackAmongOthers, 1200);
+    ASSERT_EQ(request.numActions, 3);
+    ASSERT_EQ(request.actions[1].type, RAISE);
+    ASSERT_EQ(request.actions[1].amount, 80);
+
+    writer = WireWriter(buffer, sizeof(buffer));
+    WireCodec::encodeActionResult(writer, 3, ClientAction{player, RAISE, 120});
+    size = checkFrame(writer, MSG_ACTION_RESULT);
+
+    ActionResultMessage result;
+    ASSERT_TRUE(WireCodec::decodeActionResult(payload(), size, result));
+    ASSERT_EQ(result.type, RAISE);
+    ASSERT_EQ(result.amount, 120);
+    ASSERT_EQ(result.chips, 500);
+}
+
+TEST_F(WireCodecTest, RunoutEquity) {
+    StreetEquity equity;
+    equity.handNumber = 12;
+    equity.street = TURN;
+    equity.positions = {static_cast<uint8_t>(Position::SMALL_BLIND), static_cast<uint8_t>(Position::UTG)};
+    equity.equities = {0.31234, 0.68766};
+    equity.isExact = true;
+
+    WireWriter writer(buffer, sizeof(buffer));
+    WireCodec::encodeRunoutEquity(writer, 3, equity);
+    size_t size = checkFrame(writer, MSG_RUNOUT_EQUITY);
+
+    RunoutEquityMessage message;
+    ASSERT_TRUE(WireCodec::decodeRunoutEquity(payload(), size, message));
+    ASSERT_EQ(message.tableId, 3);
+    ASSERT_EQ(message.handNumber, 12);
+    ASSERT_EQ(message.street, TURN);
+    ASSERT_TRUE(message.isExact);
+    ASSERT_EQ(message.numPlayers, 2);
+    ASSERT_EQ(message.players[1].position, static_cast<uint8_t>(Position::UTG));
+    ASSERT_EQ(message.players[0].equity, 3123);
+    ASSERT_EQ(message.players[1].equity, 6877);
+    ASSERT_FALSE(WireCodec::decodeRunoutEquity(payload(), size - 1, message));
+
+    // Only the streets of a runout are dealt with equity known
+    buffer[FRAME_HEADER_SIZE + 8] = SHOWDOWN;
+    ASSERT_FALSE(WireCodec::decodeRunoutEquity(payload(), size, message));
+}
+
+TEST_F(WireCodecTest, RejectsMalformedPayloads) {
+    Board board;
+    board.addCommunityCard(Card(Suit::CLUBS, Value::TEN));
+    WireWriter writer(buffer, sizeof(buffer));
+    WireCodec::encodeBoard(writer, 1, board);
+    size_t size = checkFrame(writer, MSG_BOARD);
+
+    // Truncated
+    BoardMessage message;
+    ASSERT_FALSE(WireCodec::decodeBoard(payload(), size - 1, message));
+
+    // Card out of range
+    buffer[FRAME_HEADER_SIZE + 5] = 52;
+    ASSERT_FALSE(WireCodec::decodeBoard(payload(), size, message));
+
+    // Too many cards
+    buffer[FRAME_HEADER_SIZE + 4] = 6;
+    ASSERT_FALSE(WireCodec::decodeBoard(payload(), size, message));
+
+    // Writes past a small buffer are flagged rather than overrunning it
+    WireWriter smallWriter(buffer, FRAME_HEADER_SIZE + 2);
+    WireCodec::encodeBoard(smallWriter, 1, board);
+    ASSERT_TRUE(smallWriter.isOverflow());
+}